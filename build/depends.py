@@ -867,13 +867,15 @@ class MixxxCore(Feature):
                    "src/engine/enginepregain.cpp",
                    "src/engine/enginemaster.cpp",
                    "src/engine/enginedelay.cpp",
+                   "src/engine/engineprofiler.cpp",
+                   "src/engine/enginechannelprocessorpool.cpp",
                    "src/engine/enginevumeter.cpp",
                    "src/engine/enginesidechaincompressor.cpp",
                    "src/engine/sidechain/enginesidechain.cpp",
                    "src/engine/sidechain/networkoutputstreamworker.cpp",
                    "src/engine/sidechain/networkinputstreamworker.cpp",
                    "src/engine/enginexfader.cpp",
-                   "src/engine/channelmixer_autogen.cpp",
+                   "src/engine/channelmixer.cpp",
                    "src/engine/positionscratchcontroller.cpp",
                    "src/engine/controls/bpmcontrol.cpp",
                    "src/engine/controls/clockcontrol.cpp",
@@ -887,10 +889,12 @@ class MixxxCore(Feature):
                    "src/engine/enginetalkoverducking.cpp",
                    "src/engine/cachingreader/cachingreader.cpp",
                    "src/engine/cachingreader/cachingreaderchunk.cpp",
+                   "src/engine/cachingreader/cachingreaderchunkindex.cpp",
                    "src/engine/cachingreader/cachingreaderworker.cpp",
 
                    "src/analyzer/trackanalysisscheduler.cpp",
                    "src/analyzer/analyzerthread.cpp",
+                   "src/analyzer/analyzerpipeline.cpp",
                    "src/analyzer/analyzerwaveform.cpp",
                    "src/analyzer/analyzergain.cpp",
                    "src/analyzer/analyzerbeats.cpp",
@@ -945,6 +949,9 @@ class MixxxCore(Feature):
                    "src/sources/audiosource.cpp",
                    "src/sources/audiosourcestereoproxy.cpp",
                    "src/sources/metadatasourcetaglib.cpp",
+                   "src/sources/pcmcache.cpp",
+                   "src/sources/seekindexbuilder.cpp",
+                   "src/sources/seekindexfile.cpp",
                    "src/sources/soundsource.cpp",
                    "src/sources/soundsourceproviderregistry.cpp",
                    "src/sources/soundsourceproxy.cpp",
@@ -1034,6 +1041,7 @@ class MixxxCore(Feature):
                    "src/library/basesqltablemodel.cpp",
                    "src/library/basetrackcache.cpp",
                    "src/library/basetracktablemodel.cpp",
+                   "src/library/columnartrackindex.cpp",
                    "src/library/columncache.cpp",
                    "src/library/librarytablemodel.cpp",
                    "src/library/searchquery.cpp",
@@ -1111,6 +1119,7 @@ class MixxxCore(Feature):
                    "src/library/scanner/scannertask.cpp",
                    "src/library/scanner/importfilestask.cpp",
                    "src/library/scanner/recursivescandirectorytask.cpp",
+                   "src/library/scanner/directorywatcher.cpp",
 
                    "src/library/dao/cuedao.cpp",
                    "src/library/dao/trackdao.cpp",
@@ -1151,6 +1160,8 @@ class MixxxCore(Feature):
                    "src/waveform/sharedglcontext.cpp",
                    "src/waveform/waveform.cpp",
                    "src/waveform/waveformfactory.cpp",
+                   "src/waveform/waveformfile.cpp",
+                   "src/waveform/waveformpyramid.cpp",
                    "src/waveform/waveformwidgetfactory.cpp",
                    "src/waveform/vsyncthread.cpp",
                    "src/waveform/guitick.cpp",
@@ -1247,9 +1258,11 @@ class MixxxCore(Feature):
                    "src/mixer/basetrackplayer.cpp",
                    "src/mixer/deck.cpp",
                    "src/mixer/microphone.cpp",
+                   "src/mixer/offlinerenderer.cpp",
                    "src/mixer/playerinfo.cpp",
                    "src/mixer/playermanager.cpp",
                    "src/mixer/previewdeck.cpp",
+                   "src/mixer/renderscript.cpp",
                    "src/mixer/sampler.cpp",
                    "src/mixer/samplerbank.cpp",
 
@@ -1311,8 +1324,11 @@ class MixxxCore(Feature):
                    "src/util/db/sqlstringformatter.cpp",
                    "src/util/db/sqltransaction.cpp",
                    "src/util/sample.cpp",
+                   "src/util/sample_simd.cpp",
                    "src/util/samplebuffer.cpp",
                    "src/util/readaheadsamplebuffer.cpp",
+                   "src/util/realtimearena.cpp",
+                   "src/util/realtimeguard.cpp",
                    "src/util/rotary.cpp",
                    "src/util/logger.cpp",
                    "src/util/logging.cpp",
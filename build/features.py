@@ -479,6 +479,33 @@ class Sanitizers(Feature):
         build.env.Append(LINKFLAGS="-fsanitize=%s" % ','.join(sanitizers))
 
 
+class RealtimeAllocationDetector(Feature):
+    def description(self):
+        return "Realtime thread allocation and lock detector"
+
+    def enabled(self, build):
+        build.flags['rt_alloc_detector'] = util.get_flags(
+            build.env, 'rt_alloc_detector', 0)
+        if int(build.flags['rt_alloc_detector']):
+            return True
+        return False
+
+    def add_options(self, build, vars):
+        vars.Add("rt_alloc_detector", "Set to 1 to report memory allocations and locks on the realtime audio threads (Linux only).", 0)
+
+    def configure(self, build, conf):
+        if not self.enabled(build):
+            return
+
+        if not build.platform_is_linux:
+            raise Exception('The realtime allocation detector is only available on Linux.')
+
+        build.env.Append(CPPDEFINES='MIXXX_RT_ALLOC_DETECTOR')
+        build.env.Append(LIBS='dl')
+        # Symbols are needed to resolve the reported call stacks
+        build.env.Append(LINKFLAGS='-rdynamic')
+
+
 class PerfTools(Feature):
     def description(self):
         return "Google PerfTools"
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "util/assert.h"
+#include "util/cmdlineargs.h"
+#include "util/duration.h"
+#include "util/stat.h"
+#include "util/threadcputimer.h"
 #include "util/types.h"
 
 /*
@@ -34,6 +38,16 @@ class Analyzer {
     // but not finalize()!
     virtual bool processSamples(const CSAMPLE* pIn, const int iLen) = 0;
 
+    // Analyzers that only need a mono signal may override this method
+    // to use the mono downmix pMono of the stereo samples pIn, which
+    // contains iLen / 2 samples. The downmix is computed only once per
+    // chunk and shared by all analyzers.
+    virtual bool processDownmixedSamples(
+            const CSAMPLE* pIn, const int iLen, const CSAMPLE* pMono) {
+        Q_UNUSED(pMono);
+        return processSamples(pIn, iLen);
+    }
+
     // Update the track object with the analysis results after
     // processing finished successfully, i.e. all available audio
     // samples have been processed.
@@ -49,10 +63,15 @@ typedef std::unique_ptr<Analyzer> AnalyzerPtr;
 
 class AnalyzerWithState final {
   public:
-    explicit AnalyzerWithState(AnalyzerPtr analyzer)
+    // The CPU time that is spent by the analyzer for each track is
+    // reported to the StatsManager with the given name in developer mode.
+    explicit AnalyzerWithState(AnalyzerPtr analyzer, const QString& name = QString())
             : m_analyzer(std::move(analyzer)),
               m_active(false) {
         DEBUG_ASSERT(m_analyzer);
+        if (!name.isEmpty() && CmdlineArgs::Instance().getDeveloper()) {
+            m_cpuTimeStatKey = QString("%1 CPU time per track").arg(name);
+        }
     }
     AnalyzerWithState(const AnalyzerWithState&) = delete;
     AnalyzerWithState(AnalyzerWithState&&) = default;
@@ -68,12 +87,25 @@ class AnalyzerWithState final {
 
     bool initialize(TrackPointer tio, int sampleRate, int totalSamples) {
         DEBUG_ASSERT(!m_active);
+        m_cpuTime = mixxx::Duration();
         return m_active = m_analyzer->initialize(tio, sampleRate, totalSamples);
     }
 
-    void processSamples(const CSAMPLE* pIn, const int iLen) {
+    // The mono downmix pMono is optional
+    void processSamples(const CSAMPLE* pIn, const int iLen, const CSAMPLE* pMono = nullptr) {
         if (m_active) {
-            m_active = m_analyzer->processSamples(pIn, iLen);
+            ThreadCpuTimer cpuTimer;
+            if (!m_cpuTimeStatKey.isEmpty()) {
+                cpuTimer.start();
+            }
+            if (pMono) {
+                m_active = m_analyzer->processDownmixedSamples(pIn, iLen, pMono);
+            } else {
+                m_active = m_analyzer->processSamples(pIn, iLen);
+            }
+            if (!m_cpuTimeStatKey.isEmpty()) {
+                m_cpuTime += cpuTimer.elapsed();
+            }
             if (!m_active) {
                 // Ensure that cleanup() is invoked after processing
                 // failed and the analyzer became inactive!
@@ -84,9 +116,21 @@ class AnalyzerWithState final {
 
     void finish(TrackPointer tio) {
         if (m_active) {
+            ThreadCpuTimer cpuTimer;
+            if (!m_cpuTimeStatKey.isEmpty()) {
+                cpuTimer.start();
+            }
             m_analyzer->storeResults(tio);
             m_analyzer->cleanup();
             m_active = false;
+            if (!m_cpuTimeStatKey.isEmpty()) {
+                m_cpuTime += cpuTimer.elapsed();
+                Stat::track(m_cpuTimeStatKey,
+                        Stat::DURATION_NANOSEC,
+                        Stat::COUNT | Stat::SUM | Stat::AVERAGE |
+                                Stat::MAX | Stat::MIN,
+                        m_cpuTime.toIntegerNanos());
+            }
         }
     }
 
@@ -100,4 +144,6 @@ class AnalyzerWithState final {
   private:
     AnalyzerPtr m_analyzer;
     bool m_active;
+    QString m_cpuTimeStatKey;
+    mixxx::Duration m_cpuTime;
 };
@@ -179,6 +179,11 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer tio) const {
 }
 
 bool AnalyzerBeats::processSamples(const CSAMPLE *pIn, const int iLen) {
+    return processDownmixedSamples(pIn, iLen, nullptr);
+}
+
+bool AnalyzerBeats::processDownmixedSamples(
+        const CSAMPLE* pIn, const int iLen, const CSAMPLE* pMono) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
@@ -188,6 +193,9 @@ bool AnalyzerBeats::processSamples(const CSAMPLE *pIn, const int iLen) {
         return true; // silently ignore all remaining samples
     }
 
+    if (pMono) {
+        return m_pPlugin->processMonoSamples(pMono, iLen / mixxx::kAnalysisChannels);
+    }
     return m_pPlugin->processSamples(pIn, iLen);
 }
 
@@ -127,6 +127,11 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer tio) const {
 }
 
 bool AnalyzerKey::processSamples(const CSAMPLE *pIn, const int iLen) {
+    return processDownmixedSamples(pIn, iLen, nullptr);
+}
+
+bool AnalyzerKey::processDownmixedSamples(
+        const CSAMPLE* pIn, const int iLen, const CSAMPLE* pMono) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
@@ -136,6 +141,9 @@ bool AnalyzerKey::processSamples(const CSAMPLE *pIn, const int iLen) {
         return true; // silently ignore remaining samples
     }
 
+    if (pMono) {
+        return m_pPlugin->processMonoSamples(pMono, iLen / mixxx::kAnalysisChannels);
+    }
     return m_pPlugin->processSamples(pIn, iLen);
 }
 
@@ -21,6 +21,8 @@ class AnalyzerKey : public Analyzer {
 
     bool initialize(TrackPointer tio, int sampleRate, int totalSamples) override;
     bool processSamples(const CSAMPLE *pIn, const int iLen) override;
+    bool processDownmixedSamples(
+            const CSAMPLE* pIn, const int iLen, const CSAMPLE* pMono) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
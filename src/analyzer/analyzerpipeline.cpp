@@ -0,0 +1,135 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+AnalyzerPipeline::AnalyzerPipeline(
+        int ringCapacity,
+        SINT samplesPerChunk)
+        : m_committedChunks(0),
+          m_stopping(false),
+          m_discarding(false) {
+    DEBUG_ASSERT(ringCapacity > 0);
+    m_ring.reserve(ringCapacity);
+    for (int i = 0; i < ringCapacity; ++i) {
+        m_ring.emplace_back(samplesPerChunk);
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    if (isRunning()) {
+        stop(false);
+    }
+}
+
+void AnalyzerPipeline::start(std::vector<AnalyzerWithState>* pAnalyzers) {
+    DEBUG_ASSERT(pAnalyzers);
+    VERIFY_OR_DEBUG_ASSERT(!isRunning()) {
+        stop(false);
+    }
+    m_committedChunks = 0;
+    m_stopping = false;
+    m_discarding = false;
+    for (auto& chunk : m_ring) {
+        chunk.pendingConsumers = 0;
+    }
+    // Inactive analyzers do not need a consumer
+    std::vector<AnalyzerWithState*> activeAnalyzers;
+    for (auto& analyzer : *pAnalyzers) {
+        if (analyzer.isActive()) {
+            activeAnalyzers.push_back(&analyzer);
+        }
+    }
+    // Every consumer needs a thread of its own, otherwise the producer
+    // might wait forever for a consumer that has not been started
+    m_threadPool.setMaxThreadCount(
+            math_max(m_threadPool.maxThreadCount(),
+                    static_cast<int>(activeAnalyzers.size())));
+    m_consumers.reserve(activeAnalyzers.size());
+    for (auto* pAnalyzer : activeAnalyzers) {
+        m_consumers.push_back(QtConcurrent::run(&m_threadPool, [this, pAnalyzer] {
+            consume(pAnalyzer);
+        }));
+    }
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerPipeline::nextChunk() {
+    Chunk& chunk = m_ring[m_committedChunks % m_ring.size()];
+    QMutexLocker locker(&m_mutex);
+    while (chunk.pendingConsumers > 0) {
+        m_chunkReleased.wait(&m_mutex);
+    }
+    return mixxx::SampleBuffer::WritableSlice(chunk.buffer);
+}
+
+void AnalyzerPipeline::commitChunk(
+        const CSAMPLE* pSamples,
+        SINT sampleCount) {
+    Chunk& chunk = m_ring[m_committedChunks % m_ring.size()];
+    DEBUG_ASSERT(pSamples >= chunk.buffer.data());
+    DEBUG_ASSERT(pSamples + sampleCount <=
+            chunk.buffer.data() + chunk.buffer.size());
+    // The chunk is not in use by any consumer
+    SampleUtil::downmixStereoToMono(
+            chunk.downmixBuffer.data(),
+            pSamples,
+            sampleCount);
+    QMutexLocker locker(&m_mutex);
+    DEBUG_ASSERT(chunk.pendingConsumers == 0);
+    if (m_consumers.empty()) {
+        return;
+    }
+    chunk.pSamples = pSamples;
+    chunk.sampleCount = sampleCount;
+    chunk.pendingConsumers = static_cast<int>(m_consumers.size());
+    ++m_committedChunks;
+    m_chunkCommitted.wakeAll();
+}
+
+void AnalyzerPipeline::stop(bool drain) {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_discarding = !drain;
+        m_chunkCommitted.wakeAll();
+    }
+    for (auto& consumer : m_consumers) {
+        consumer.waitForFinished();
+    }
+    m_consumers.clear();
+}
+
+void AnalyzerPipeline::consume(AnalyzerWithState* pAnalyzer) {
+    qint64 consumedChunks = 0;
+    QMutexLocker locker(&m_mutex);
+    for (;;) {
+        while (consumedChunks == m_committedChunks && !m_stopping) {
+            m_chunkCommitted.wait(&m_mutex);
+        }
+        if (consumedChunks == m_committedChunks) {
+            // Stopped and all chunks have been processed
+            return;
+        }
+        Chunk& chunk = m_ring[consumedChunks % m_ring.size()];
+        if (!m_discarding) {
+            // The chunk is not modified until all consumers released it
+            locker.unlock();
+            // An analyzer that failed becomes inactive and ignores
+            // the remaining chunks
+            pAnalyzer->processSamples(
+                    chunk.pSamples,
+                    chunk.sampleCount,
+                    chunk.downmixBuffer.data());
+            locker.relock();
+        }
+        ++consumedChunks;
+        DEBUG_ASSERT(chunk.pendingConsumers > 0);
+        if (--chunk.pendingConsumers == 0) {
+            m_chunkReleased.wakeAll();
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QFuture>
+#include <QMutex>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "analyzer/constants.h"
+#include "util/class.h"
+#include "util/samplebuffer.h"
+
+// Runs the analyzers of a track concurrently, each as a consumer of a
+// shared ring of decoded chunks on a thread of its own. The audio is
+// decoded and downmixed to mono only once by the producer, i.e. the
+// AnalyzerThread, and the time for analyzing a track drops to roughly
+// the time of the slowest analyzer.
+//
+// Each chunk of the ring is reference-counted by the consumers that have
+// not processed it yet. The producer blocks while the next chunk is still
+// in use, which limits the memory and keeps decoding at most one ring
+// ahead of the slowest analyzer.
+class AnalyzerPipeline {
+  public:
+    AnalyzerPipeline(
+            int ringCapacity,
+            SINT samplesPerChunk);
+    ~AnalyzerPipeline();
+
+    // Starts a consumer for each of the analyzers. The analyzers must
+    // have been initialized and must not be accessed by the caller until
+    // stop() returns.
+    void start(std::vector<AnalyzerWithState>* pAnalyzers);
+
+    // Returns the buffer for the next chunk. Blocks until all consumers
+    // have processed the previous contents of the buffer.
+    mixxx::SampleBuffer::WritableSlice nextChunk();
+
+    // Passes the samples that have been written into the buffer that
+    // has been returned by nextChunk() to all consumers.
+    void commitChunk(
+            const CSAMPLE* pSamples,
+            SINT sampleCount);
+
+    // Waits for all consumers to exit. If drain is true the consumers
+    // process all committed chunks before, otherwise the remaining chunks
+    // are discarded.
+    void stop(bool drain);
+
+    bool isRunning() const {
+        return !m_consumers.empty();
+    }
+
+  private:
+    struct Chunk {
+        explicit Chunk(SINT samplesPerChunk)
+                : buffer(samplesPerChunk),
+                  downmixBuffer(samplesPerChunk / mixxx::kAnalysisChannels),
+                  pSamples(nullptr),
+                  sampleCount(0),
+                  pendingConsumers(0) {
+        }
+        mixxx::SampleBuffer buffer;
+        mixxx::SampleBuffer downmixBuffer;
+        const CSAMPLE* pSamples;
+        SINT sampleCount;
+        // The number of consumers that still need to process the chunk
+        int pendingConsumers;
+    };
+
+    void consume(AnalyzerWithState* pAnalyzer);
+
+    QMutex m_mutex;
+    // Signaled when a chunk has been committed or the pipeline is stopped
+    QWaitCondition m_chunkCommitted;
+    // Signaled when a chunk has been processed by all consumers
+    QWaitCondition m_chunkReleased;
+    std::vector<Chunk> m_ring;
+    qint64 m_committedChunks;
+    bool m_stopping;
+    bool m_discarding;
+
+    QThreadPool m_threadPool;
+    std::vector<QFuture<void>> m_consumers;
+
+    DISALLOW_COPY_AND_ASSIGN(AnalyzerPipeline);
+};
@@ -2,6 +2,11 @@
 
 #include <mutex>
 
+#ifdef __LINUX__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include "analyzer/analyzerbeats.h"
 #include "analyzer/analyzerebur128.h"
 #include "analyzer/analyzergain.h"
@@ -20,6 +25,7 @@
 #include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 #include "util/logger.h"
+#include "util/sample.h"
 #include "util/timer.h"
 
 namespace {
@@ -38,12 +44,41 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// The number of decoded chunks that the slowest analyzer might lag behind
+// the decoder in pipelined mode, i.e. ~1.5 sec of audio at 44.1 kHz. Each
+// chunk holds kAnalysisFramesPerChunk stereo frames and their mono downmix,
+// i.e. 16 * 4096 * (2 + 1) * sizeof(CSAMPLE) = 768 KB for the whole ring.
+constexpr int kPipelineChunks = 16;
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
     }
 }
 
+#ifdef __LINUX__
+// Not provided by glibc, see linux/ioprio.h
+constexpr int kIoprioWhoProcess = 1;
+constexpr int kIoprioClassIdle = 3;
+constexpr int kIoprioClassShift = 13;
+#endif
+
+// Lowers the I/O priority of the calling thread such that reading
+// audio files for analysis does not delay any other disk access,
+// e.g. loading a track into a deck.
+void setIdleIoPriorityForCurrentThread() {
+#ifdef __LINUX__
+    // A pid of 0 refers to the calling thread
+    if (syscall(SYS_ioprio_set,
+                kIoprioWhoProcess,
+                0,
+                kIoprioClassIdle << kIoprioClassShift) != 0) {
+        kLogger.warning()
+                << "Failed to set idle I/O priority for analyzer thread";
+    }
+#endif
+}
+
 std::once_flag registerMetaTypesOnceFlag;
 
 void registerMetaTypesOnce() {
@@ -85,11 +120,16 @@ AnalyzerThread::AnalyzerThread(
           m_modeFlags(modeFlags),
           m_nextTrack(2), // minimum capacity
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
+          m_downmixBuffer(mixxx::kAnalysisFramesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
 }
 
 void AnalyzerThread::doRun() {
+    if (m_modeFlags & AnalyzerModeFlags::Background) {
+        setIdleIoPriorityForCurrentThread();
+    }
+
     std::unique_ptr<AnalysisDao> pAnalysisDao;
     // The thread-local database connection  must not be closed
     // before returning from this function.
@@ -103,27 +143,38 @@ void AnalyzerThread::doRun() {
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection), "AnalyzerWaveform"));
     }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig), "AnalyzerGain"));
     }
     if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig), "AnalyzerEbur128"));
     }
     // BPM detection might be disabled in the config, but can be overridden
     // and enabled by explicitly setting the mode flag.
     const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
+    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection), "AnalyzerBeats"));
+    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig), "AnalyzerKey"));
+    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig), "AnalyzerSilence"));
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if (m_modeFlags & AnalyzerModeFlags::Pipelined) {
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(
+                kPipelineChunks,
+                mixxx::kAnalysisSamplesPerChunk);
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
     openParams.setChannelCount(mixxx::kAnalysisChannels);
+    // Only the tracks that are analyzed when loading them into a deck or
+    // sampler are cached. Batch analysis would evict them.
+    const auto pcmCacheMode = (m_modeFlags & AnalyzerModeFlags::Background)
+            ? SoundSourceProxy::PcmCacheMode::ReadOnly
+            : SoundSourceProxy::PcmCacheMode::ReadWrite;
 
     while (waitUntilWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack);
@@ -131,7 +182,8 @@ void AnalyzerThread::doRun() {
 
         // Get the audio
         const auto audioSource =
-                SoundSourceProxy(m_currentTrack).openAudioSource(openParams);
+                SoundSourceProxy(m_currentTrack).openAudioSource(
+                        openParams, pcmCacheMode);
         if (!audioSource) {
             kLogger.warning()
                     << "Failed to open file for analyzing:"
@@ -152,8 +204,19 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
+            if (m_pPipeline) {
+                m_pPipeline->start(&m_analyzers);
+            }
             const auto analysisResult = analyzeAudioSource(audioSource);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
+            if (m_pPipeline) {
+                // The analyzers must not be accessed before all consumers
+                // have exited
+                if (analysisResult == AnalysisResult::Finished) {
+                    emitBusyProgress(kAnalyzerProgressFinalizing);
+                }
+                m_pPipeline->stop(analysisResult == AnalysisResult::Finished);
+            }
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
                 // any errors or partial if it has been aborted due to a corrupt
@@ -181,6 +244,7 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pPipeline.reset();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -248,12 +312,17 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
-        // Request the next chunk of audio data
+        // Request the next chunk of audio data. In pipelined mode the
+        // chunk is decoded into the ring of the pipeline, which blocks
+        // while the slowest analyzer is still busy with its contents.
+        const auto writableSlice = m_pPipeline
+                ? m_pPipeline->nextChunk()
+                : mixxx::SampleBuffer::WritableSlice(m_sampleBuffer);
         const auto readableSampleFrames =
                 audioSourceProxy.readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                writableSlice));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange() <= chunkFrameRange);
 
@@ -297,10 +366,22 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            if (m_pPipeline) {
+                m_pPipeline->commitChunk(
+                        readableSampleFrames.readableData(),
+                        readableSampleFrames.readableLength());
+            } else {
+                // The mono downmix is shared by all analyzers
+                SampleUtil::downmixStereoToMono(
+                        m_downmixBuffer.data(),
                         readableSampleFrames.readableData(),
                         readableSampleFrames.readableLength());
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processSamples(
+                            readableSampleFrames.readableData(),
+                            readableSampleFrames.readableLength(),
+                            m_downmixBuffer.data());
+                }
             }
         }
 
@@ -5,6 +5,7 @@
 #include "rigtorp/SPSCQueue.h"
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "preferences/usersettings.h"
 #include "sources/audiosource.h"
@@ -20,6 +21,14 @@ enum AnalyzerModeFlags {
     WithBeats = 0x01,
     WithWaveform = 0x02,
     All = WithBeats | WithWaveform,
+    // Run the analyzers of a track concurrently on separate threads
+    // instead of one after another. Intended for analyzing the tracks
+    // that have just been loaded into a deck as fast as possible.
+    Pipelined = 0x04,
+    // Batch analysis in the background: The worker threads run with idle
+    // CPU and I/O priority and are throttled while the audio engine is
+    // busy.
+    Background = 0x08,
 };
 
 enum class AnalyzerThreadState {
@@ -116,6 +125,10 @@ class AnalyzerThread : public WorkerThread {
     std::vector<AnalyzerWithState> m_analyzers;
 
     mixxx::SampleBuffer m_sampleBuffer;
+    mixxx::SampleBuffer m_downmixBuffer;
+
+    // Only used with AnalyzerModeFlags::Pipelined
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
 
     TrackPointer m_currentTrack;
 
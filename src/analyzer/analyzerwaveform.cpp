@@ -109,8 +109,7 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
             if (analysis.type == AnalysisDao::TYPE_WAVEFORM) {
                 vc = WaveformFactory::waveformVersionToVersionClass(analysis.version);
                 if (missingWaveform && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveform = ConstWaveformPointer(
-                            WaveformFactory::loadWaveformFromAnalysis(analysis));
+                    pLoadedTrackWaveform = loadStoredWaveform(analysis);
                     missingWaveform = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -120,8 +119,7 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
             if (analysis.type == AnalysisDao::TYPE_WAVESUMMARY) {
                 vc = WaveformFactory::waveformSummaryVersionToVersionClass(analysis.version);
                 if (missingWavesummary && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveformSummary = ConstWaveformPointer(
-                            WaveformFactory::loadWaveformFromAnalysis(analysis));
+                    pLoadedTrackWaveformSummary = loadStoredWaveform(analysis);
                     missingWavesummary = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -145,6 +143,30 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer tio) const {
     return true;
 }
 
+ConstWaveformPointer AnalyzerWaveform::loadStoredWaveform(
+        const AnalysisDao::AnalysisInfo& analysis) const {
+    // Legacy blobs and files of version 1 have no pyramid
+    const bool outdated = !analysis.pWaveform ||
+            !analysis.pWaveform->getPyramid();
+    WaveformPointer pWaveform =
+            WaveformFactory::loadWaveformFromAnalysis(analysis);
+    if (outdated && pWaveform->isValid()) {
+        // Migrate the analysis in the background, i.e. on the analyzer
+        // thread, so that the waveform and its pyramid are mapped on the
+        // next load
+        AnalysisDao::AnalysisInfo migratedAnalysis = analysis;
+        migratedAnalysis.data.clear();
+        if (m_analysisDao.saveWaveformAnalysis(&migratedAnalysis, *pWaveform)) {
+            kLogger.debug()
+                    << "Migrated analysis"
+                    << analysis.analysisId
+                    << "of track"
+                    << analysis.trackId;
+        }
+    }
+    return pWaveform;
+}
+
 void AnalyzerWaveform::createFilters(int sampleRate) {
     // m_filter[Low] = new EngineFilterButterworth8(FILTER_LOWPASS, sampleRate, 200);
     // m_filter[Mid] = new EngineFilterButterworth8(FILTER_BANDPASS, sampleRate, 200, 2000);
@@ -268,6 +290,8 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
     if (m_waveform) {
         m_waveform->setSaveState(Waveform::SaveState::SavePending);
         m_waveform->setCompletion(m_waveform->getDataSize());
+        // The pyramid is stored next to the waveform
+        m_waveform->buildPyramid();
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
     }
@@ -149,6 +149,8 @@ class AnalyzerWaveform : public Analyzer {
 
   private:
     bool shouldAnalyze(TrackPointer tio) const;
+    ConstWaveformPointer loadStoredWaveform(
+            const AnalysisDao::AnalysisInfo& analysis) const;
 
     void storeCurrentStridePower();
     void resetCurrentStride();
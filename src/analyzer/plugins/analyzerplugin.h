@@ -42,6 +42,9 @@ class AnalyzerPlugin {
 
     virtual bool initialize(int samplerate) = 0;
     virtual bool processSamples(const CSAMPLE* pIn, const int iLen) = 0;
+    // Processes the mono downmix of the stereo input, i.e. one sample
+    // per frame, that is shared by all plugins
+    virtual bool processMonoSamples(const CSAMPLE* pIn, const int iLen) = 0;
     virtual bool finalize() = 0;
 };
 
@@ -61,6 +61,14 @@ bool AnalyzerQueenMaryBeats::processSamples(const CSAMPLE* pIn, const int iLen)
     return m_helper.processStereoSamples(pIn, iLen);
 }
 
+bool AnalyzerQueenMaryBeats::processMonoSamples(const CSAMPLE* pIn, const int iLen) {
+    if (!m_pDetectionFunction) {
+        return false;
+    }
+
+    return m_helper.processMonoSamples(pIn, iLen);
+}
+
 bool AnalyzerQueenMaryBeats::finalize() {
     m_helper.finalize();
 
@@ -35,6 +35,7 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
 
     bool initialize(int samplerate) override;
     bool processSamples(const CSAMPLE* pIn, const int iLen) override;
+    bool processMonoSamples(const CSAMPLE* pIn, const int iLen) override;
     bool finalize() override;
 
     bool supportsBeatTracking() const override {
@@ -87,6 +87,15 @@ bool AnalyzerQueenMaryKey::processSamples(const CSAMPLE* pIn, const int iLen) {
     return m_helper.processStereoSamples(pIn, iLen);
 }
 
+bool AnalyzerQueenMaryKey::processMonoSamples(const CSAMPLE* pIn, const int iLen) {
+    if (!m_pKeyMode) {
+        return false;
+    }
+
+    m_currentFrame += iLen;
+    return m_helper.processMonoSamples(pIn, iLen);
+}
+
 bool AnalyzerQueenMaryKey::finalize() {
     m_helper.finalize();
     m_pKeyMode.reset();
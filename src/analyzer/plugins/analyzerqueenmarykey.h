@@ -35,6 +35,7 @@ class AnalyzerQueenMaryKey : public AnalyzerKeyPlugin {
 
     bool initialize(int samplerate) override;
     bool processSamples(const CSAMPLE* pIn, const int iLen) override;
+    bool processMonoSamples(const CSAMPLE* pIn, const int iLen) override;
     bool finalize() override;
 
     KeyChangeList getKeyChanges() const override {
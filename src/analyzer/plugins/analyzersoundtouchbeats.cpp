@@ -17,7 +17,9 @@ AnalyzerSoundTouchBeats::~AnalyzerSoundTouchBeats() {
 
 bool AnalyzerSoundTouchBeats::initialize(int samplerate) {
     m_fResultBpm = 0.0f;
-    m_pSoundTouch = std::make_unique<soundtouch::BPMDetect>(2, samplerate);
+    // BPMDetect averages all channels before decimating, so analyzing
+    // the shared mono downmix gives the same results.
+    m_pSoundTouch = std::make_unique<soundtouch::BPMDetect>(1, samplerate);
     return true;
 }
 
@@ -26,15 +28,20 @@ bool AnalyzerSoundTouchBeats::processSamples(const CSAMPLE* pIn, const int iLen)
         return false;
     }
     DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
+    VERIFY_OR_DEBUG_ASSERT(iLen / kAnalysisChannels <= m_downmixBuffer.size()) {
+        return false;
+    }
     // We analyze a mono mixdown of the signal since we don't think stereo does
     // us any good.
+    SampleUtil::downmixStereoToMono(m_downmixBuffer.data(), pIn, iLen);
+    return processMonoSamples(m_downmixBuffer.data(), iLen / kAnalysisChannels);
+}
 
-    CSAMPLE* pDownmix = m_downmixBuffer.data();
-    for (int i = 0; i < iLen / 2; i += 2) {
-        pDownmix[i] = (pIn[i * 2] + pIn[i * 2 + 1]) * 0.5f;
+bool AnalyzerSoundTouchBeats::processMonoSamples(const CSAMPLE* pIn, const int iLen) {
+    if (!m_pSoundTouch) {
+        return false;
     }
-
-    m_pSoundTouch->inputSamples(pIn, iLen / 2);
+    m_pSoundTouch->inputSamples(pIn, iLen);
     return true;
 }
 
@@ -32,6 +32,7 @@ class AnalyzerSoundTouchBeats : public AnalyzerBeatsPlugin {
 
     bool initialize(int samplerate) override;
     bool processSamples(const CSAMPLE* pIn, const int iLen) override;
+    bool processMonoSamples(const CSAMPLE* pIn, const int iLen) override;
     bool finalize() override;
 
     bool supportsBeatTracking() const override {
@@ -21,7 +21,11 @@ bool DownmixAndOverlapHelper::initialize(size_t windowSize, size_t stepSize, Win
 
 bool DownmixAndOverlapHelper::processStereoSamples(const CSAMPLE* pInput, size_t inputStereoSamples) {
     const size_t numInputFrames = inputStereoSamples / 2;
-    return processInner(pInput, numInputFrames);
+    return processInner(pInput, numInputFrames, 2);
+}
+
+bool DownmixAndOverlapHelper::processMonoSamples(const CSAMPLE* pInput, size_t inputMonoSamples) {
+    return processInner(pInput, inputMonoSamples, 1);
 }
 
 bool DownmixAndOverlapHelper::finalize() {
@@ -32,19 +36,23 @@ bool DownmixAndOverlapHelper::finalize() {
     // instead of "m_windowSize / 2 - m_stepSize"
     size_t framesToFillWindow = m_windowSize - m_bufferWritePosition;
     size_t numInputFrames = math_max(framesToFillWindow, m_windowSize / 2 - 1);
-    return processInner(nullptr, numInputFrames);
+    return processInner(nullptr, numInputFrames, 0);
 }
 
 bool DownmixAndOverlapHelper::processInner(
-        const CSAMPLE* pInput, size_t numInputFrames) {
+        const CSAMPLE* pInput, size_t numInputFrames, size_t numInputChannels) {
     size_t inRead = 0;
     double* pDownmix = m_buffer.data();
 
     while (inRead < numInputFrames) {
-        size_t writeAvailable = math_min(numInputFrames,
+        size_t writeAvailable = math_min(numInputFrames - inRead,
                 m_windowSize - m_bufferWritePosition);
 
-        if (pInput) {
+        if (pInput && numInputChannels == 1) {
+            for (size_t i = 0; i < writeAvailable; ++i) {
+                pDownmix[m_bufferWritePosition + i] = pInput[inRead + i];
+            }
+        } else if (pInput) {
             for (size_t i = 0; i < writeAvailable; ++i) {
                 // We analyze a mono downmix of the signal since we don't think
                 // stereo does us any good.
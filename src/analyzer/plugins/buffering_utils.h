@@ -9,7 +9,8 @@ namespace mixxx {
 
 // This is used for downmixing a stereo buffer into mono and framing it into
 // overlapping windows as is typically necessary when taking a short-time
-// Fourier transform.
+// Fourier transform. A mono signal that has already been downmixed, e.g.
+// by the AnalyzerThread for all analyzers, is framed without downmixing.
 class DownmixAndOverlapHelper {
   public:
     DownmixAndOverlapHelper() = default;
@@ -25,10 +26,17 @@ class DownmixAndOverlapHelper {
             const CSAMPLE* pInput,
             size_t inputStereoSamples);
 
+    bool processMonoSamples(
+            const CSAMPLE* pInput,
+            size_t inputMonoSamples);
+
     bool finalize();
 
   private:
-    bool processInner(const CSAMPLE* pInput, size_t numInputFrames);
+    bool processInner(
+            const CSAMPLE* pInput,
+            size_t numInputFrames,
+            size_t numInputChannels);
 
     std::vector<double> m_buffer;
     // The window size in frames.
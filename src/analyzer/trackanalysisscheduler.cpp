@@ -1,9 +1,12 @@
 #include "analyzer/trackanalysisscheduler.h"
 
+#include "control/controlproxy.h"
+
 #include "library/library.h"
 #include "library/trackcollection.h"
 
 #include "util/logger.h"
+#include "util/math.h"
 
 
 namespace {
@@ -12,6 +15,20 @@ mixxx::Logger kLogger("TrackAnalysisScheduler");
 
 constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 
+constexpr QThread::Priority kBackgroundWorkerThreadPriority = QThread::IdlePriority;
+
+// All background workers are active while the audio engine spends less
+// than this fraction of its latency budget on processing. Above it the
+// number of active workers decreases linearly down to a single worker
+// at the upper bound. [Master],audio_latency_usage is clamped to the
+// range [0.0, 0.25], i.e. the upper bound is reached at its maximum.
+constexpr double kAudioLatencyUsageThrottleLowerBound = 0.125;
+constexpr double kAudioLatencyUsageThrottleUpperBound = 0.25;
+
+// Workers are throttled immediately, but only a single worker is added
+// again per interval to avoid oscillation
+constexpr int kThrottleIntervalMillis = 1000;
+
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
@@ -54,7 +71,9 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
           // The first signal should always be emitted
-          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration) {
+          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration),
+          m_activeWorkerLimit(numWorkerThreads),
+          m_pAudioLatencyUsage(nullptr) {
     VERIFY_OR_DEBUG_ASSERT(numWorkerThreads > 0) {
             kLogger.warning()
                     << "Invalid number of worker threads:"
@@ -76,10 +95,22 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         connect(m_workers.back().thread(), &AnalyzerThread::progress,
             this, &TrackAnalysisScheduler::onWorkerThreadProgress);
     }
+    const bool background = (modeFlags & AnalyzerModeFlags::Background) != 0;
     // 2nd pass: Start worker threads in a suspended state
     for (const auto& worker: m_workers) {
         worker.thread()->suspend();
-        worker.thread()->start(kWorkerThreadPriority);
+        worker.thread()->start(background
+                        ? kBackgroundWorkerThreadPriority
+                        : kWorkerThreadPriority);
+    }
+    if (background) {
+        m_pAudioLatencyUsage = new ControlProxy(
+                "[Master]", "audio_latency_usage", this);
+        connect(&m_throttleTimer,
+                &QTimer::timeout,
+                this,
+                &TrackAnalysisScheduler::onThrottleTimeout);
+        m_throttleTimer.start(kThrottleIntervalMillis);
     }
 }
 
@@ -163,7 +194,9 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
         }
     }
     const int totalTracksCount =
-            m_dequeuedTracksCount + m_queuedTrackIds.size();
+            m_dequeuedTracksCount +
+            m_queuedTrackIds.size() +
+            m_priorityQueuedTrackIds.size();
     DEBUG_ASSERT(m_currentTrackNumber <= m_dequeuedTracksCount);
     DEBUG_ASSERT(m_dequeuedTracksCount <= totalTracksCount);
     emit progress(
@@ -194,6 +227,7 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
         DEBUG_ASSERT(!trackId.isValid());
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
         worker.onAnalyzerProgress(analyzerProgress);
+        worker.onThreadIdle();
         submitNextTrack(&worker);
         break;
     case AnalyzerThreadState::Busy:
@@ -229,14 +263,59 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
     emitProgressOrFinished();
 }
 
-bool TrackAnalysisScheduler::scheduleTrackById(TrackId trackId) {
+//static
+int TrackAnalysisScheduler::backgroundWorkerLimit(
+        int numWorkerThreads, double audioLatencyUsage) {
+    if (audioLatencyUsage <= kAudioLatencyUsageThrottleLowerBound) {
+        return numWorkerThreads;
+    }
+    const double headroom =
+            (kAudioLatencyUsageThrottleUpperBound - audioLatencyUsage) /
+            (kAudioLatencyUsageThrottleUpperBound - kAudioLatencyUsageThrottleLowerBound);
+    return math_clamp(
+            static_cast<int>(std::floor(headroom * numWorkerThreads)),
+            math_min(1, numWorkerThreads),
+            numWorkerThreads);
+}
+
+void TrackAnalysisScheduler::onThrottleTimeout() {
+    DEBUG_ASSERT(m_pAudioLatencyUsage);
+    const int numWorkerThreads = static_cast<int>(m_workers.size());
+    const int workerLimit = backgroundWorkerLimit(
+            numWorkerThreads, m_pAudioLatencyUsage->get());
+    if (workerLimit < m_activeWorkerLimit) {
+        // Busy workers finish their current track
+        m_activeWorkerLimit = workerLimit;
+        kLogger.debug()
+                << "Throttling analysis down to"
+                << m_activeWorkerLimit
+                << "worker threads";
+    } else if (workerLimit > m_activeWorkerLimit) {
+        ++m_activeWorkerLimit;
+        kLogger.debug()
+                << "Throttling analysis up to"
+                << m_activeWorkerLimit
+                << "worker threads";
+        for (auto& worker : m_workers) {
+            if (worker && worker.isIdle()) {
+                submitNextTrack(&worker);
+            }
+        }
+    }
+}
+
+bool TrackAnalysisScheduler::scheduleTrackById(TrackId trackId, Priority priority) {
     VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
         qWarning()
                 << "Cannot schedule track with invalid id"
                 << trackId;
         return false;
     }
-    m_queuedTrackIds.push_back(trackId);
+    if (priority == Priority::High) {
+        m_priorityQueuedTrackIds.push_back(trackId);
+    } else {
+        m_queuedTrackIds.push_back(trackId);
+    }
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
@@ -270,8 +349,15 @@ void TrackAnalysisScheduler::resume() {
 
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
-    while (!m_queuedTrackIds.empty()) {
-        TrackId nextTrackId = m_queuedTrackIds.front();
+    if (worker->thread()->id() >= m_activeWorkerLimit) {
+        // Throttled
+        return false;
+    }
+    while (!m_priorityQueuedTrackIds.empty() || !m_queuedTrackIds.empty()) {
+        auto& queuedTrackIds = m_priorityQueuedTrackIds.empty()
+                ? m_queuedTrackIds
+                : m_priorityQueuedTrackIds;
+        TrackId nextTrackId = queuedTrackIds.front();
         DEBUG_ASSERT(nextTrackId.isValid());
         if (nextTrackId.isValid()) {
             TrackPointer nextTrack =
@@ -279,7 +365,7 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
             if (nextTrack) {
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
                     if (worker->submitNextTrack(std::move(nextTrack))) {
-                        m_queuedTrackIds.pop_front();
+                        queuedTrackIds.pop_front();
                         ++m_dequeuedTracksCount;
                         return true;
                     } else {
@@ -310,7 +396,7 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     << nextTrackId;
         }
         // Skip this track
-        m_queuedTrackIds.pop_front();
+        queuedTrackIds.pop_front();
         ++m_dequeuedTracksCount;
     }
     return false;
@@ -323,14 +409,22 @@ void TrackAnalysisScheduler::stop() {
     }
     // The worker threads are still running at this point
     // and m_workers must not be modified!
+    m_throttleTimer.stop();
     m_queuedTrackIds.clear();
+    m_priorityQueuedTrackIds.clear();
     m_pendingTrackIds.clear();
     DEBUG_ASSERT((allTracksFinished()));
 }
 
 QList<TrackId> TrackAnalysisScheduler::stopAndCollectScheduledTrackIds() {
     QList<TrackId> scheduledTrackIds;
-    scheduledTrackIds.reserve(m_queuedTrackIds.size() + m_pendingTrackIds.size());
+    scheduledTrackIds.reserve(
+            m_priorityQueuedTrackIds.size() +
+            m_queuedTrackIds.size() +
+            m_pendingTrackIds.size());
+    for (auto queuedTrackId: m_priorityQueuedTrackIds) {
+        scheduledTrackIds.append(std::move(queuedTrackId));
+    }
     for (auto queuedTrackId: m_queuedTrackIds) {
         scheduledTrackIds.append(std::move(queuedTrackId));
     }
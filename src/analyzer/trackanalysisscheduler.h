@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QList>
+#include <QTimer>
 
 #include <deque>
 #include <set>
@@ -12,12 +13,21 @@
 
 
 // forward declaration(s)
+class ControlProxy;
 class Library;
 
 class TrackAnalysisScheduler : public QObject {
     Q_OBJECT
 
   public:
+    // Tracks with a high priority are analyzed before all tracks with a
+    // normal priority, e.g. tracks that have been loaded into a deck
+    // before tracks that have been loaded into a sampler.
+    enum class Priority {
+        Normal,
+        High,
+    };
+
     typedef std::unique_ptr<TrackAnalysisScheduler, void(*)(TrackAnalysisScheduler*)> Pointer;
     // Subclass that provides a default constructor and nothing else
     class NullPointer: public Pointer {
@@ -40,9 +50,14 @@ class TrackAnalysisScheduler : public QObject {
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
     // the caller must invoke resume() once.
-    bool scheduleTrackById(TrackId trackId);
+    bool scheduleTrackById(TrackId trackId, Priority priority = Priority::Normal);
     int scheduleTracksById(const QList<TrackId>& trackIds);
 
+    // The number of worker threads that may analyze tracks in the
+    // background while the audio engine spends the given fraction of
+    // its latency budget on processing, i.e. [Master],audio_latency_usage.
+    static int backgroundWorkerLimit(int numWorkerThreads, double audioLatencyUsage);
+
     // Returns the scheduled tracks that have not yet been analyzed.
     // Includes both queued tracks as well as pending tracks that are
     // currently being analyzed. The result may contain duplicates.
@@ -70,6 +85,7 @@ class TrackAnalysisScheduler : public QObject {
 
   private slots:
     void onWorkerThreadProgress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress analyzerProgress);
+    void onThrottleTimeout();
 
   private:
     // Owns an analyzer thread and buffers the most recent progress update
@@ -80,7 +96,8 @@ class TrackAnalysisScheduler : public QObject {
       public:
         explicit Worker(AnalyzerThread::Pointer thread = AnalyzerThread::NullPointer())
             : m_thread(std::move(thread)),
-              m_analyzerProgress(kAnalyzerProgressUnknown) {
+              m_analyzerProgress(kAnalyzerProgressUnknown),
+              m_idle(false) {
         }
         Worker(const Worker&) = delete;
         Worker(Worker&&) = default;
@@ -98,10 +115,19 @@ class TrackAnalysisScheduler : public QObject {
             return m_analyzerProgress;
         }
 
+        // Idle workers are waiting for the next track
+        bool isIdle() const {
+            return m_idle;
+        }
+
         bool submitNextTrack(TrackPointer track) {
             DEBUG_ASSERT(track);
             DEBUG_ASSERT(m_thread);
-            return m_thread->submitNextTrack(std::move(track));
+            if (m_thread->submitNextTrack(std::move(track))) {
+                m_idle = false;
+                return true;
+            }
+            return false;
         }
 
         void suspendThread() {
@@ -127,15 +153,22 @@ class TrackAnalysisScheduler : public QObject {
             m_analyzerProgress = analyzerProgress;
         }
 
+        void onThreadIdle() {
+            DEBUG_ASSERT(m_thread);
+            m_idle = true;
+        }
+
         void onThreadExit() {
             DEBUG_ASSERT(m_thread);
             m_thread.reset();
             m_analyzerProgress = kAnalyzerProgressUnknown;
+            m_idle = false;
         }
 
       private:
         AnalyzerThread::Pointer m_thread;
         AnalyzerProgress m_analyzerProgress;
+        bool m_idle;
     };
 
     bool submitNextTrack(Worker* worker);
@@ -143,6 +176,7 @@ class TrackAnalysisScheduler : public QObject {
 
     bool allTracksFinished() const {
         return m_queuedTrackIds.empty() &&
+                m_priorityQueuedTrackIds.empty() &&
                 m_pendingTrackIds.empty();
     }
 
@@ -151,6 +185,7 @@ class TrackAnalysisScheduler : public QObject {
     std::vector<Worker> m_workers;
 
     std::deque<TrackId> m_queuedTrackIds;
+    std::deque<TrackId> m_priorityQueuedTrackIds;
 
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
@@ -164,4 +199,11 @@ class TrackAnalysisScheduler : public QObject {
 
     typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
+
+    // Only workers with a thread id below this limit receive new tracks
+    int m_activeWorkerLimit;
+
+    // Only used with AnalyzerModeFlags::Background
+    ControlProxy* m_pAudioLatencyUsage;
+    QTimer m_throttleTimer;
 };
@@ -11,7 +11,7 @@
 const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 
 //static
-const int MixxxDb::kRequiredSchemaVersion = 32;
+const int MixxxDb::kRequiredSchemaVersion = 33;
 
 namespace {
 
@@ -29,6 +29,11 @@ const QString kUserName = QStringLiteral("mixxx");
 
 const QString kPassword = QStringLiteral("mixxx");
 
+// Disabling the write-ahead log restores the rollback journal of earlier
+// versions, e.g. if the database is located on a network file system
+// where SQLite does not support WAL.
+const ConfigKey kWriteAheadLogConfigKey("[Library]", "DatabaseWriteAheadLog");
+
 // The connection parameters for the main Mixxx DB
 mixxx::DbConnection::Params dbConnectionParams(
         const UserSettingsPointer& pConfig,
@@ -57,11 +62,43 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    params.performanceProfile = MixxxDb::performanceProfile(pConfig);
     return params;
 }
 
 } // anonymous namespace
 
+//static
+mixxx::DbConnection::PerformanceProfile MixxxDb::performanceProfile(
+        const UserSettingsPointer& pConfig) {
+    mixxx::DbConnection::PerformanceProfile profile;
+    if (!pConfig->getValue(kWriteAheadLogConfigKey, true)) {
+        // The defaults of SQLite
+        profile.journalMode = QStringLiteral("delete");
+        // 2 = FULL: Required to not corrupt the database with a
+        // rollback journal on power loss
+        profile.synchronous = 2;
+    }
+    return profile;
+}
+
+//static
+bool MixxxDb::checkPerformanceProfile(
+        const QSqlDatabase& database,
+        const UserSettingsPointer& pConfig) {
+    SchemaManager schemaManager(database);
+    if (schemaManager.checkPerformanceProfile(performanceProfile(pConfig))) {
+        return true;
+    }
+    // Mixxx works with any settings, only slower
+    kLogger.warning()
+            << "The database does not use the configured settings."
+            << "Set"
+            << kWriteAheadLogConfigKey
+            << "to 0 if the journal mode cannot be changed.";
+    return false;
+}
+
 MixxxDb::MixxxDb(
         const UserSettingsPointer& pConfig,
         bool inMemoryConnection)
@@ -80,7 +117,8 @@ bool MixxxDb::initDatabaseSchema(
     QString helpEmail = tr("For help with database issues contact:") + "\n" +
                            "mixxx-devel@lists.sourceforge.net";
 
-    switch (SchemaManager(database).upgradeToSchemaVersion(schemaFile, schemaVersion)) {
+    SchemaManager schemaManager(database);
+    switch (schemaManager.upgradeToSchemaVersion(schemaFile, schemaVersion)) {
         case SchemaManager::Result::CurrentVersion:
         case SchemaManager::Result::UpgradeSucceeded:
         case SchemaManager::Result::NewerVersionBackwardsCompatible:
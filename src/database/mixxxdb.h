@@ -17,6 +17,23 @@ class MixxxDb : public QObject {
 
     static const int kRequiredSchemaVersion;
 
+    // The performance profile of all database connections. The write-ahead
+    // log is enabled unless [Library],DatabaseWriteAheadLog is 0. The
+    // journal mode is stored in mixxxdb.sqlite itself: While enabled SQLite
+    // keeps the files mixxxdb.sqlite-wal and mixxxdb.sqlite-shm next to the
+    // database, which must be copied along with it, and SQLite versions
+    // before 3.7.0 cannot open it. Disabling it converts the database back
+    // to the rollback journal when it is opened the next time.
+    static mixxx::DbConnection::PerformanceProfile performanceProfile(
+            const UserSettingsPointer& pConfig);
+
+    // Returns false and logs the differences if an open database does
+    // not use the configured performance profile, e.g. if another
+    // journal mode is not supported on the file system
+    static bool checkPerformanceProfile(
+            const QSqlDatabase& database,
+            const UserSettingsPointer& pConfig);
+
     static bool initDatabaseSchema(
             const QSqlDatabase& database,
             const QString& schemaFile = kDefaultSchemaFile,
@@ -64,6 +64,50 @@ bool SchemaManager::isBackwardsCompatibleWithVersion(int targetVersion) const {
     return iBackwardsCompatibleVersion <= targetVersion;
 }
 
+bool SchemaManager::checkPerformanceProfile(
+        const mixxx::DbConnection::PerformanceProfile& expectedProfile) const {
+    const mixxx::DbConnection::PerformanceProfile actualProfile =
+            mixxx::DbConnection::queryPerformanceProfile(m_database);
+    bool result = true;
+    if (actualProfile.journalMode != expectedProfile.journalMode &&
+            actualProfile.journalMode != QStringLiteral("memory")) {
+        kLogger.warning()
+                << "Database uses journal mode" << actualProfile.journalMode
+                << "instead of" << expectedProfile.journalMode;
+        result = false;
+    }
+    if (actualProfile.synchronous != expectedProfile.synchronous) {
+        kLogger.warning()
+                << "Database uses synchronous level" << actualProfile.synchronous
+                << "instead of" << expectedProfile.synchronous;
+        result = false;
+    }
+    if (actualProfile.mmapSize > expectedProfile.mmapSize) {
+        kLogger.warning()
+                << "Database maps" << actualProfile.mmapSize
+                << "bytes instead of" << expectedProfile.mmapSize;
+        result = false;
+    }
+    if (actualProfile.cacheSize != expectedProfile.cacheSize) {
+        kLogger.warning()
+                << "Database uses cache size" << actualProfile.cacheSize
+                << "instead of" << expectedProfile.cacheSize;
+        result = false;
+    }
+    if (actualProfile.tempStore != expectedProfile.tempStore) {
+        kLogger.warning()
+                << "Database uses temp store" << actualProfile.tempStore
+                << "instead of" << expectedProfile.tempStore;
+        result = false;
+    }
+    if (result) {
+        kLogger.info()
+                << "Database performance profile:"
+                << actualProfile;
+    }
+    return result;
+}
+
 SchemaManager::Result SchemaManager::upgradeToSchemaVersion(
         const QString& schemaFilename,
         int targetVersion) {
@@ -5,6 +5,7 @@
 
 #include "preferences/usersettings.h"
 #include "library/dao/settingsdao.h"
+#include "util/db/dbconnection.h"
 
 class SchemaManager {
   public:
@@ -32,6 +33,12 @@ class SchemaManager {
             const QString& schemaFilename,
             int targetVersion);
 
+    // Verifies that the connection uses the expected SQLite settings and
+    // logs a warning for each deviation. Memory mapping might be limited
+    // by SQLite and in-memory databases never use a write-ahead log.
+    bool checkPerformanceProfile(
+            const mixxx::DbConnection::PerformanceProfile& expectedProfile) const;
+
   private:
     QSqlDatabase m_database;
     SettingsDAO m_settingsDao;
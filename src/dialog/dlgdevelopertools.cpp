@@ -1,8 +1,10 @@
 #include "dialog/dlgdevelopertools.h"
 
 #include <QDateTime>
+#include <QFontDatabase>
 
 #include "control/control.h"
+#include "engine/engineprofiler.h"
 #include "util/cmdlineargs.h"
 #include "util/statsmanager.h"
 #include "util/logging.h"
@@ -81,6 +83,12 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
 
     m_logCursor = logTextView->textCursor();
 
+    engineProfileView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    connect(engineTraceExport,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotEngineTraceExport);
+
     // Update at 2FPS.
     startTimer(500);
 
@@ -123,6 +131,8 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
         if (pManager) {
             pManager->updateStats();
         }
+    } else if (toolTabWidget->currentWidget() == engineTab) {
+        engineProfileView->setPlainText(EngineProfiler::summary());
     }
 }
 
@@ -157,6 +167,16 @@ void DlgDeveloperTools::slotControlDump() {
     }
 }
 
+void DlgDeveloperTools::slotEngineTraceExport() {
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString traceFileName = m_pConfig->getSettingsPath() +
+            "/engine_trace_" + timestamp + ".json";
+    if (EngineProfiler::writeChromeTrace(traceFileName)) {
+        qDebug() << "Engine trace written to" << traceFileName;
+    }
+}
+
 void DlgDeveloperTools::slotLogSearch() {
     QString textToFind = logSearch->text();
     m_logCursor = logTextView->document()->find(textToFind, m_logCursor);
@@ -24,6 +24,7 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     void slotControlSearch(const QString& search);
     void slotLogSearch();
     void slotControlDump();
+    void slotEngineTraceExport();
 
   private:
     UserSettingsPointer m_pConfig;
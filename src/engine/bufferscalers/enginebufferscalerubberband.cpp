@@ -4,6 +4,8 @@
 
 #include <QtDebug>
 
+#include <cmath>
+
 #include "control/controlobject.h"
 #include "engine/readaheadmanager.h"
 #include "track/keyutils.h"
@@ -14,18 +16,51 @@
 
 using RubberBand::RubberBandStretcher;
 
+// RubberBand 3.0 reports the padding that a reset stretcher needs
+#if RUBBERBAND_API_MAJOR_VERSION > 2 || \
+        (RUBBERBAND_API_MAJOR_VERSION == 2 && RUBBERBAND_API_MINOR_VERSION >= 7)
+#define RUBBERBAND_HAS_START_PAD
+#endif
+
 namespace {
 
 // This is the default increment from RubberBand 1.8.1.
 size_t kRubberBandBlockSize = 256;
 
+// The largest block that is passed to RubberBand at once. The input for a
+// whole output buffer is read and processed in one go instead of one
+// increment at a time. RubberBand keeps the surplus for the next call.
+const SINT kMaxProcessFrames = 4096;
+
+// The number of silent frames that need to be fed after a reset to fill the
+// analysis window, before the first real frame.
+SINT getStartPad(const RubberBandStretcher& stretcher) {
+#ifdef RUBBERBAND_HAS_START_PAD
+    return static_cast<SINT>(stretcher.getPreferredStartPad());
+#else
+    // Half a window, which getLatency() reports divided by the pitch scale
+    return static_cast<SINT>(std::ceil(
+            stretcher.getLatency() * stretcher.getPitchScale()));
+#endif
+}
+
+// The number of output frames that correspond to the start pad
+SINT getStartDelay(const RubberBandStretcher& stretcher) {
+#ifdef RUBBERBAND_HAS_START_PAD
+    return static_cast<SINT>(stretcher.getStartDelay());
+#else
+    return static_cast<SINT>(stretcher.getLatency());
+#endif
+}
+
 }  // namespace
 
 EngineBufferScaleRubberBand::EngineBufferScaleRubberBand(
         ReadAheadManager* pReadAheadManager)
         : m_pReadAheadManager(pReadAheadManager),
           m_buffer_back(SampleUtil::alloc(MAX_BUFFER_LEN)),
-          m_bBackwards(false) {
+          m_bBackwards(false),
+          m_remainingPaddingInOutput(0) {
     m_retrieve_buffer[0] = SampleUtil::alloc(MAX_BUFFER_LEN);
     m_retrieve_buffer[1] = SampleUtil::alloc(MAX_BUFFER_LEN);
     // Initialize the internal buffers to prevent re-allocations
@@ -112,7 +147,7 @@ void EngineBufferScaleRubberBand::onSampleRateChanged() {
             getOutputSignal().getSampleRate(),
             getOutputSignal().getChannelCount(),
             RubberBandStretcher::OptionProcessRealTime);
-    m_pRubberBand->setMaxProcessSize(kRubberBandBlockSize);
+    m_pRubberBand->setMaxProcessSize(kMaxProcessFrames);
     // Setting the time ratio to a very high value will cause RubberBand
     // to preallocate buffers large enough to (almost certainly)
     // avoid memory reallocations during playback.
@@ -125,11 +160,37 @@ void EngineBufferScaleRubberBand::clear() {
         return;
     }
     m_pRubberBand->reset();
+
+    // A reset stretcher fades in the first window of its input and delays
+    // the output by half a window. Priming it with that much silence and
+    // dropping the corresponding output lets keylock playback start right
+    // at the new position with the first transient intact.
+    SampleUtil::clear(m_retrieve_buffer[0], kMaxProcessFrames);
+    SampleUtil::clear(m_retrieve_buffer[1], kMaxProcessFrames);
+    SINT remainingPadding = getStartPad(*m_pRubberBand);
+    while (remainingPadding > 0) {
+        const SINT frames = math_min(remainingPadding, kMaxProcessFrames);
+        m_pRubberBand->process(
+                (const float* const*)m_retrieve_buffer, frames, false);
+        remainingPadding -= frames;
+    }
+    m_remainingPaddingInOutput = getStartDelay(*m_pRubberBand);
 }
 
 SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
         CSAMPLE* pBuffer,
         SINT frames) {
+    while (m_remainingPaddingInOutput > 0) {
+        const SINT frames_to_drop = math_min(m_remainingPaddingInOutput,
+                math_min(static_cast<SINT>(m_pRubberBand->available()),
+                        kMaxProcessFrames));
+        if (frames_to_drop <= 0) {
+            return 0;
+        }
+        m_remainingPaddingInOutput -= static_cast<SINT>(m_pRubberBand->retrieve(
+                (float* const*)m_retrieve_buffer, frames_to_drop));
+    }
+
     SINT frames_available = m_pRubberBand->available();
     SINT frames_to_read = math_min(frames_available, frames);
     SINT received_frames = m_pRubberBand->retrieve(
@@ -183,8 +244,8 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         if (break_out_after_retrieve_and_reset_rubberband) {
             //qDebug() << "break_out_after_retrieve_and_reset_rubberband";
             // If we break out early then we have flushed RubberBand and need to
-            // reset it.
-            m_pRubberBand->reset();
+            // reset it. clear() also primes it and drops the start delay.
+            clear();
             break;
         }
 
@@ -203,12 +264,19 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         //qDebug() << "iLenFramesRequired" << iLenFramesRequired;
 
         if (remaining_frames > 0 && iLenFramesRequired > 0) {
+            // Feed the input for the rest of the output buffer at once
+            // rather than one increment per iteration.
+            const SINT framesForOutput = static_cast<SINT>(std::ceil(
+                    remaining_frames * m_dBaseRate * m_dTempoRatio));
+            const SINT framesToRead = math_min(
+                    math_max(static_cast<SINT>(iLenFramesRequired), framesForOutput),
+                    kMaxProcessFrames);
             SINT iAvailSamples = m_pReadAheadManager->getNextSamples(
                         // The value doesn't matter here. All that matters is we
                         // are going forward or backward.
                         (m_bBackwards ? -1.0 : 1.0) * m_dBaseRate * m_dTempoRatio,
                         m_buffer_back,
-                        getOutputSignal().frames2samples(iLenFramesRequired));
+                        getOutputSignal().frames2samples(framesToRead));
             SINT iAvailFrames = getOutputSignal().samples2frames(iAvailSamples);
 
             if (iAvailFrames > 0) {
@@ -26,7 +26,7 @@ class EngineBufferScaleRubberBand : public EngineBufferScale {
             CSAMPLE* pOutputBuffer,
             SINT iOutputBufferSize) override;
 
-    // Flush buffer.
+    // Flush buffer and prime the stretcher for playback from a new position.
     void clear() override;
 
   private:
@@ -46,6 +46,10 @@ class EngineBufferScaleRubberBand : public EngineBufferScale {
 
     // Holds the playback direction
     bool m_bBackwards;
+
+    // Output frames of the priming silence from clear() that still need
+    // to be dropped
+    SINT m_remainingPaddingInOutput;
 };
 
 
@@ -5,6 +5,8 @@
 #undef FALSE
 #include <SoundTouch.h>
 
+#include <cmath>
+
 #include "control/controlobject.h"
 #include "engine/engineobject.h"
 #include "engine/readaheadmanager.h"
@@ -24,6 +26,11 @@ namespace {
 // (Rubberband does not suffer this issue)
 const SINT kSeekOffsetFrames = 519;
 
+// The input for a whole output buffer is read and passed to SoundTouch at
+// once, in blocks of at least kMinReadFrames and at most kMaxReadFrames.
+const SINT kMinReadFrames = 256;
+const SINT kMaxReadFrames = 4096;
+
 }  // namespace
 
 EngineBufferScaleST::EngineBufferScaleST(ReadAheadManager *pReadAheadManager)
@@ -95,7 +102,7 @@ void EngineBufferScaleST::onSampleRateChanged() {
         return;
     }
     m_pSoundTouch->setSampleRate(getOutputSignal().getSampleRate());
-    const auto bufferSize = getOutputSignal().frames2samples(kSeekOffsetFrames);
+    const auto bufferSize = getOutputSignal().frames2samples(kMaxReadFrames);
     if (bufferSize > buffer_back.size()) {
         // grow buffer
         buffer_back = mixxx::SampleBuffer(bufferSize);
@@ -104,7 +111,8 @@ void EngineBufferScaleST::onSampleRateChanged() {
     // to preallocate buffers large enough to (almost certainly)
     // avoid memory reallocations during playback.
     m_pSoundTouch->setTempo(0.1);
-    m_pSoundTouch->putSamples(buffer_back.data(), kSeekOffsetFrames);
+    SampleUtil::clear(buffer_back.data(), buffer_back.size());
+    m_pSoundTouch->putSamples(buffer_back.data(), kMaxReadFrames);
     m_pSoundTouch->clear();
     m_pSoundTouch->setTempo(m_dTempoRatio);
 }
@@ -113,7 +121,8 @@ void EngineBufferScaleST::clear() {
     m_pSoundTouch->clear();
 
     // compensate seek offset for a rate of 1.0
-    SampleUtil::clear(buffer_back.data(), buffer_back.size());
+    SampleUtil::clear(buffer_back.data(),
+            getOutputSignal().frames2samples(kSeekOffsetFrames));
     m_pSoundTouch->putSamples(buffer_back.data(), kSeekOffsetFrames);
 }
 
@@ -142,12 +151,19 @@ double EngineBufferScaleST::scaleBuffer(
         read += getOutputSignal().frames2samples(received_frames);
 
         if (remaining_frames > 0) {
+            // Read the input for the rest of the output buffer at once.
+            // SoundTouch keeps the surplus for the next call.
+            const SINT framesToRead = math_clamp(
+                    static_cast<SINT>(std::ceil(
+                            remaining_frames * m_dBaseRate * m_dTempoRatio)),
+                    kMinReadFrames,
+                    kMaxReadFrames);
             SINT iAvailSamples = m_pReadAheadManager->getNextSamples(
                         // The value doesn't matter here. All that matters is we
                         // are going forward or backward.
                         (m_bBackwards ? -1.0 : 1.0) * m_dBaseRate * m_dTempoRatio,
                         buffer_back.data(),
-                        buffer_back.size());
+                        getOutputSignal().frames2samples(framesToRead));
             SINT iAvailFrames = getOutputSignal().samples2frames(iAvailSamples);
 
             if (iAvailFrames > 0) {
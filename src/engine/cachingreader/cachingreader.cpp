@@ -1,6 +1,10 @@
 #include <QtDebug>
 #include <QFileInfo>
 
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
 #include "engine/cachingreader/cachingreader.h"
 #include "control/controlobject.h"
 #include "track/track.h"
@@ -32,17 +36,69 @@ const SINT kDefaultHintFrames = 1024;
 // CachingReader must be multiplied by the number of decks to calculate
 // the total amount!
 //
-// NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
-// (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
-// to verify that the MRU/LRU cache works as expected. Even though
-// massive drop outs are expected to occur Mixxx should run reliably!
-const SINT kNumberOfCachedChunksInMemory = 80;
+// NOTE(uklotzde, 2019-09-05): Reduce the cache size to just few chunks
+// for testing purposes to verify that the MRU/LRU cache works as expected.
+// Even though massive drop outs are expected to occur Mixxx should run
+// reliably!
+const SINT kChunkSizeBytes = CachingReaderChunk::kSamples * sizeof(CSAMPLE);
+
+// Chunks must not be shared between cache lines. Chunk sizes are a multiple
+// of the cache line size, so it is sufficient to align the first chunk.
+const SINT kCacheLineSamples = 64 / sizeof(CSAMPLE);
+
+const QString kCacheHitsStatTag =
+        QStringLiteral("CachingReader::read() cache hits");
+const QString kCacheMissesStatTag =
+        QStringLiteral("CachingReader::read() cache misses");
+const QString kCacheEvictionsStatTag =
+        QStringLiteral("CachingReader chunk evictions");
+const QString kSeeksServedByPredictionStatTag =
+        QStringLiteral("CachingReader seeks served by prediction");
+const QString kSeeksServedFromCacheStatTag =
+        QStringLiteral("CachingReader seeks served from cache");
+const QString kSeeksMissedStatTag =
+        QStringLiteral("CachingReader seeks missed");
+
+// The maximum number of chunks that are requested per callback for hints
+// of potential seek targets. Predictions must not delay the reading of
+// imminently needed chunks, which compete for the same worker and FIFO.
+const int kMaxPredictedChunksPerCallback = 2;
+
+const SINT kInvalidChunkIndex = -1;
+
+SINT numberOfCachedChunks(const QString& group, const UserSettingsPointer& pConfig) {
+    int cacheSizeMB = CachingReader::kDefaultCacheSizeMB;
+    if (pConfig) {
+        cacheSizeMB = pConfig->getValue(
+                ConfigKey("[Controls]", CachingReader::kConfigKeyCacheSizeMB),
+                cacheSizeMB);
+        cacheSizeMB = pConfig->getValue(
+                ConfigKey(group, CachingReader::kConfigKeyCacheSizeMB),
+                cacheSizeMB);
+    }
+    cacheSizeMB = math_clamp(cacheSizeMB,
+            CachingReader::kMinCacheSizeMB,
+            CachingReader::kMaxCacheSizeMB);
+    return (static_cast<SINT>(cacheSizeMB) * 1024 * 1024) / kChunkSizeBytes;
+}
+
+CSAMPLE* alignToCacheLine(CSAMPLE* pSamples) {
+    const auto address = reinterpret_cast<std::uintptr_t>(pSamples);
+    const auto alignedAddress = (address + 63) & ~std::uintptr_t(63);
+    return reinterpret_cast<CSAMPLE*>(alignedAddress);
+}
 
 } // anonymous namespace
 
+const char* const CachingReader::kConfigKeyCacheSizeMB = "ReaderCacheSizeMB";
+const int CachingReader::kDefaultCacheSizeMB = 5;
+const int CachingReader::kMinCacheSizeMB = 1;
+const int CachingReader::kMaxCacheSizeMB = 512;
+
 CachingReader::CachingReader(QString group,
         UserSettingsPointer config)
         : m_pConfig(config),
+          m_numberOfCachedChunks(numberOfCachedChunks(group, config)),
           // Limit the number of in-flight requests to the worker. This should
           // prevent to overload the worker when it is not able to fetch those
           // requests from the FIFO timely. Otherwise outdated requests pile up
@@ -52,29 +108,51 @@ CachingReader::CachingReader(QString group,
           // buffer, where new requests replace old requests when full. Those
           // old requests need to be returned immediately to the CachingReader
           // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
+          m_chunkReadRequestFIFO(m_numberOfCachedChunks / 4),
           // The capacity of the back channel must be equal to the number of
           // allocated chunks, because the worker use writeBlocking(). Otherwise
           // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_readerStatusUpdateFIFO(m_numberOfCachedChunks),
           m_state(STATE_IDLE),
+          m_chunkStorage(new ChunkStorage[m_numberOfCachedChunks]),
+          m_allocatedCachingReaderChunks(m_numberOfCachedChunks),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
+          m_sampleBuffer(CachingReaderChunk::kSamples * m_numberOfCachedChunks +
+                  kCacheLineSamples),
+          m_cacheHits(0),
+          m_cacheMisses(0),
+          m_cacheEvictions(0),
+          m_seeksServedByPrediction(0),
+          m_seeksServedFromCache(0),
+          m_seeksMissed(0),
+          m_lastReadChunkIndex(kInvalidChunkIndex),
           m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+    kLogger.debug()
+            << group
+            << "caches"
+            << m_numberOfCachedChunks
+            << "chunks";
+    const SINT firstChunkOffset =
+            alignToCacheLine(m_sampleBuffer.data()) - m_sampleBuffer.data();
+    DEBUG_ASSERT(firstChunkOffset <= kCacheLineSamples);
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
+    m_chunks.reserve(m_numberOfCachedChunks);
+    m_freeChunks.reserve(m_numberOfCachedChunks);
+    for (SINT i = 0; i < m_numberOfCachedChunks; ++i) {
         CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
+                new (&m_chunkStorage[i]) CachingReaderChunkForOwner(
                         mixxx::SampleBuffer::WritableSlice(
                                 m_sampleBuffer,
-                                CachingReaderChunk::kSamples * i,
+                                firstChunkOffset + CachingReaderChunk::kSamples * i,
                                 CachingReaderChunk::kSamples));
         m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
+    }
+    // Chunks are taken from the back of the free list, start with the first.
+    for (auto it = m_chunks.crbegin(); it != m_chunks.crend(); ++it) {
+        m_freeChunks.push_back(*it);
     }
 
     // Forward signals from worker
@@ -93,7 +171,9 @@ CachingReader::CachingReader(QString group,
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
-    qDeleteAll(m_chunks);
+    for (const auto& pChunk: qAsConst(m_chunks)) {
+        pChunk->~CachingReaderChunkForOwner();
+    }
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
@@ -101,6 +181,7 @@ void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
     pChunk->free();
+    DEBUG_ASSERT(m_freeChunks.size() < m_freeChunks.capacity());
     m_freeChunks.push_back(pChunk);
 }
 
@@ -133,16 +214,20 @@ void CachingReader::freeAllChunks() {
     DEBUG_ASSERT(!m_lruCachingReaderChunk);
 
     m_allocatedCachingReaderChunks.clear();
+    m_lastReadChunkIndex = kInvalidChunkIndex;
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.isEmpty()) {
+    if (m_freeChunks.empty()) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.takeFirst();
+    CachingReaderChunkForOwner* pChunk = m_freeChunks.back();
+    m_freeChunks.pop_back();
     pChunk->init(chunkIndex);
 
-    m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
+    const bool inserted = m_allocatedCachingReaderChunks.insert(pChunk);
+    Q_UNUSED(inserted); // only used in DEBUG_ASSERT
+    DEBUG_ASSERT(inserted);
 
     return pChunk;
 }
@@ -152,6 +237,7 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     if (!pChunk) {
         if (m_lruCachingReaderChunk) {
             freeChunk(m_lruCachingReaderChunk);
+            ++m_cacheEvictions;
             pChunk = allocateChunk(chunkIndex);
         } else {
             kLogger.warning() << "No cached LRU chunk available for freeing";
@@ -164,8 +250,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
 }
 
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    auto pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
+    // Defaults to nullptr if it's not in the index.
+    auto pChunk = m_allocatedCachingReaderChunks.find(chunkIndex);
     DEBUG_ASSERT(!pChunk || pChunk->getIndex() == chunkIndex);
     return pChunk;
 }
@@ -382,6 +468,11 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
 
             const SINT firstChunkIndex =
                     CachingReaderChunk::indexForFrame(remainingFrameIndexRange.start());
+            // Reads during playback continue in the same or an adjacent
+            // chunk. Anything else has been caused by a seek.
+            const bool seeked = m_lastReadChunkIndex != kInvalidChunkIndex &&
+                    std::abs(firstChunkIndex - m_lastReadChunkIndex) > 1;
+            m_lastReadChunkIndex = firstChunkIndex;
             SINT lastChunkIndex =
                     CachingReaderChunk::indexForFrame(remainingFrameIndexRange.end() - 1);
             for (SINT chunkIndex = firstChunkIndex;
@@ -417,8 +508,17 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
+                CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    ++m_cacheHits;
+                    if (seeked && chunkIndex == firstChunkIndex) {
+                        if (pChunk->isPredicted()) {
+                            ++m_seeksServedByPrediction;
+                        } else {
+                            ++m_seeksServedFromCache;
+                        }
+                    }
+                    pChunk->setPredicted(false);
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -436,7 +536,10 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    ++m_cacheMisses;
+                    if (seeked && chunkIndex == firstChunkIndex) {
+                        ++m_seeksMissed;
+                    }
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -509,78 +612,136 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     }
 
     // For every chunk that the hints indicated, check if it is in the cache. If
-    // any are not, then wake.
+    // any are not, then wake. Imminent hints are handled first, so that
+    // their chunks are requested first and predictions never evict them.
     bool shouldWake = false;
-
+    int predictionBudget = kMaxPredictedChunksPerCallback;
     for (const auto& hint: hintList) {
-        SINT hintFrame = hint.frame;
-        SINT hintFrameCount = hint.frameCount;
-
-        // Handle some special length values
-        if (hintFrameCount == Hint::kFrameCountForward) {
-        	hintFrameCount = kDefaultHintFrames;
-        } else if (hintFrameCount == Hint::kFrameCountBackward) {
-        	hintFrame -= kDefaultHintFrames;
-        	hintFrameCount = kDefaultHintFrames;
-            if (hintFrame < 0) {
-            	hintFrameCount += hintFrame;
-                hintFrame = 0;
-            }
+        if (hint.priority < Hint::kPriorityPrediction) {
+            shouldWake |= hintChunks(hint, &predictionBudget);
         }
-
-        VERIFY_OR_DEBUG_ASSERT(hintFrameCount > 0) {
-            kLogger.warning() << "ERROR: Negative hint length. Ignoring.";
-            continue;
+    }
+    for (const auto& hint: hintList) {
+        if (hint.priority >= Hint::kPriorityPrediction) {
+            shouldWake |= hintChunks(hint, &predictionBudget);
         }
+    }
 
-        const auto readableFrameIndexRange = intersect(
-                m_readableFrameIndexRange,
-                mixxx::IndexRange::forward(hintFrame, hintFrameCount));
-        if (readableFrameIndexRange.empty()) {
-            continue;
+    // If there are chunks to be read, wake up.
+    if (shouldWake) {
+        m_worker.workReady();
+    }
+
+    reportCacheStatistics();
+}
+
+bool CachingReader::hintChunks(const Hint& hint, int* pPredictionBudget) {
+    SINT hintFrame = hint.frame;
+    SINT hintFrameCount = hint.frameCount;
+
+    // Handle some special length values
+    if (hintFrameCount == Hint::kFrameCountForward) {
+        hintFrameCount = kDefaultHintFrames;
+    } else if (hintFrameCount == Hint::kFrameCountBackward) {
+        hintFrame -= kDefaultHintFrames;
+        hintFrameCount = kDefaultHintFrames;
+        if (hintFrame < 0) {
+            hintFrameCount += hintFrame;
+            hintFrame = 0;
         }
+    }
 
-        const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
-        const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
-        for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
-            CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
-            if (!pChunk) {
-                shouldWake = true;
-                pChunk = allocateChunkExpireLRU(chunkIndex);
-                if (!pChunk) {
-                    kLogger.warning()
-                            << "Failed to allocate chunk"
-                            << chunkIndex
-                            << "for read request";
-                    continue;
-                }
-                // Do not insert the allocated chunk into the MRU/LRU list,
-                // because it will be handed over to the worker immediately
-                CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
-                if (kLogger.traceEnabled()) {
-                    kLogger.trace()
-                            << "Requesting read of chunk"
-                            << request.chunk;
-                }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
-                    kLogger.warning()
-                            << "Failed to submit read request for chunk"
-                            << chunkIndex;
-                    // Revoke the chunk from the worker and free it
-                    pChunk->takeFromWorker();
-                    freeChunk(pChunk);
+    VERIFY_OR_DEBUG_ASSERT(hintFrameCount > 0) {
+        kLogger.warning() << "ERROR: Negative hint length. Ignoring.";
+        return false;
+    }
+
+    const auto readableFrameIndexRange = intersect(
+            m_readableFrameIndexRange,
+            mixxx::IndexRange::forward(hintFrame, hintFrameCount));
+    if (readableFrameIndexRange.empty()) {
+        return false;
+    }
+
+    const bool prediction = hint.priority >= Hint::kPriorityPrediction;
+    bool shouldWake = false;
+    const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
+    const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
+    for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+        CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
+        if (!pChunk) {
+            if (prediction) {
+                if (*pPredictionBudget <= 0) {
+                    // Try again in one of the next callbacks
+                    return shouldWake;
                 }
-            } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+                --(*pPredictionBudget);
+            }
+            shouldWake = true;
+            pChunk = allocateChunkExpireLRU(chunkIndex);
+            if (!pChunk) {
+                kLogger.warning()
+                        << "Failed to allocate chunk"
+                        << chunkIndex
+                        << "for read request";
+                continue;
+            }
+            pChunk->setPredicted(prediction);
+            // Do not insert the allocated chunk into the MRU/LRU list,
+            // because it will be handed over to the worker immediately
+            CachingReaderChunkReadRequest request;
+            request.giveToWorker(pChunk);
+            if (kLogger.traceEnabled()) {
+                kLogger.trace()
+                        << "Requesting read of chunk"
+                        << request.chunk;
+            }
+            if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+                kLogger.warning()
+                        << "Failed to submit read request for chunk"
+                        << chunkIndex;
+                // Revoke the chunk from the worker and free it
+                pChunk->takeFromWorker();
+                freeChunk(pChunk);
+            }
+        } else {
+            if (!prediction) {
+                // The chunk is needed anyway
+                pChunk->setPredicted(false);
+            }
+            if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
                 // This will cause the chunk to be 'freshened' in the cache. The
                 // chunk will be moved to the end of the LRU list.
                 freshenChunk(pChunk);
             }
         }
     }
+    return shouldWake;
+}
 
-    // If there are chunks to be read, wake up.
-    if (shouldWake) {
-        m_worker.workReady();
+void CachingReader::reportCacheStatistics() {
+    if (m_cacheHits > 0) {
+        Counter(kCacheHitsStatTag).increment(m_cacheHits);
+        m_cacheHits = 0;
+    }
+    if (m_cacheMisses > 0) {
+        Counter(kCacheMissesStatTag).increment(m_cacheMisses);
+        m_cacheMisses = 0;
+    }
+    if (m_cacheEvictions > 0) {
+        Counter(kCacheEvictionsStatTag).increment(m_cacheEvictions);
+        m_cacheEvictions = 0;
+    }
+    if (m_seeksServedByPrediction > 0) {
+        Counter(kSeeksServedByPredictionStatTag).increment(m_seeksServedByPrediction);
+        m_seeksServedByPrediction = 0;
+    }
+    if (m_seeksServedFromCache > 0) {
+        Counter(kSeeksServedFromCacheStatTag).increment(m_seeksServedFromCache);
+        m_seeksServedFromCache = 0;
+    }
+    if (m_seeksMissed > 0) {
+        Counter(kSeeksMissedStatTag).increment(m_seeksMissed);
+        m_seeksMissed = 0;
     }
 }
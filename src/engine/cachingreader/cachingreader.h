@@ -5,17 +5,19 @@
 #define ENGINE_CACHINGREADER_H
 
 #include <QAtomicInt>
-#include <QHash>
-#include <QLinkedList>
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
 
+#include <memory>
+#include <vector>
+
 #include "util/types.h"
 #include "preferences/usersettings.h"
 #include "track/track.h"
 #include "engine/engineworker.h"
 #include "util/fifo.h"
+#include "engine/cachingreader/cachingreaderchunkindex.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 
 // A Hint is an indication to the CachingReader that a certain section of a
@@ -27,17 +29,21 @@ typedef struct Hint {
     // If a range of frames should be present, use frameCount to indicate that the
     // range (frame, frame + frameCount) should be present in memory.
     SINT frameCount;
-    // Currently unused -- but in the future could be used to prioritize certain
-    // hints over others. A priority of 1 is the highest priority and should be
-    // used for samples that will be read imminently. Hints for samples that
-    // have the potential to be read (i.e. a cue point) should be issued with
-    // priority >10.
+    // A priority of 1 is the highest priority and should be used for samples
+    // that will be read imminently. Hints for samples that have the potential
+    // to be read (i.e. a cue point) should be issued with a priority of at
+    // least kPriorityPrediction. These are only served after all imminent
+    // hints and only a limited number of chunks is requested for them per
+    // callback.
     int priority;
 
     // for the default frame count in forward direction
     static constexpr SINT kFrameCountForward = 0;
     static constexpr SINT kFrameCountBackward = -1;
 
+    // The lowest priority of hints for potential seek targets
+    static constexpr int kPriorityPrediction = 10;
+
 } Hint;
 
 // Note that we use a QVarLengthArray here instead of a QVector. Since this list
@@ -71,10 +77,23 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// All chunks share a single sample buffer that is allocated upfront. Chunks
+// are looked up through a fixed-capacity open addressing index, so neither
+// reading nor hinting allocates memory in the engine callback. The number of
+// chunks is configurable, see kConfigKeyCacheSizeMB.
 class CachingReader : public QObject {
     Q_OBJECT
 
   public:
+    // The size of the chunk cache per deck in MB. A value for the deck's
+    // group overrides the value for [Controls], which is set in the
+    // preferences. Changes take effect for newly created decks.
+    static const char* const kConfigKeyCacheSizeMB;
+    static const int kDefaultCacheSizeMB;
+    static const int kMinCacheSizeMB;
+    static const int kMaxCacheSizeMB;
+
     // Construct a CachingReader with the given group.
     CachingReader(QString group,
                   UserSettingsPointer _config);
@@ -112,6 +131,11 @@ class CachingReader : public QObject {
         m_worker.setScheduler(pScheduler);
     }
 
+    // Whether the worker has finished all pending track loads and reads.
+    bool isWorkerIdle() const {
+        return m_worker.isIdle();
+    }
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -121,6 +145,9 @@ class CachingReader : public QObject {
   private:
     const UserSettingsPointer m_pConfig;
 
+    // The number of chunks that are reserved for this reader.
+    const SINT m_numberOfCachedChunks;
+
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
@@ -151,6 +178,15 @@ class CachingReader : public QObject {
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // Requests the chunks for a single hint. Returns true if the worker needs
+    // to be woken up. Chunks that need to be read for predictions are counted
+    // against pPredictionBudget.
+    bool hintChunks(const Hint& hint, int* pPredictionBudget);
+
+    // Publishes the hit, miss and eviction counts that have been collected
+    // since the last call through the StatsManager.
+    void reportCacheStatistics();
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -159,24 +195,46 @@ class CachingReader : public QObject {
     };
     QAtomicInt m_state;
 
+    // Storage for all CachingReaderChunks in a single contiguous block. Each
+    // chunk starts on its own cache line and is constructed in place.
+    struct alignas(64) ChunkStorage {
+        unsigned char bytes[sizeof(CachingReaderChunkForOwner)];
+    };
+    std::unique_ptr<ChunkStorage[]> m_chunkStorage;
+
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    QLinkedList<CachingReaderChunkForOwner*> m_freeChunks;
+    // Stack of free chunks. The capacity is reserved for all chunks, so
+    // pushing and popping never allocates.
+    std::vector<CachingReaderChunkForOwner*> m_freeChunks;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
-    QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
+    CachingReaderChunkIndex m_allocatedCachingReaderChunks;
 
     // The linked list of recently-used chunks.
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
     CachingReaderChunkForOwner* m_lruCachingReaderChunk;
 
-    // The raw memory buffer which is divided up into chunks.
+    // The raw memory buffer which is divided up into chunks. The first
+    // chunk starts at the first cache line boundary within the buffer.
     mixxx::SampleBuffer m_sampleBuffer;
 
+    // Cache statistics that have not been reported yet.
+    int m_cacheHits;
+    int m_cacheMisses;
+    int m_cacheEvictions;
+    // The outcome of the first read after a seek: Either the chunk was in the
+    // cache only because it has been predicted, or it was in the cache
+    // anyway, or it was missing.
+    int m_seeksServedByPrediction;
+    int m_seeksServedFromCache;
+    int m_seeksMissed;
+
+    // The chunk of the last read to detect seeks.
+    SINT m_lastReadChunkIndex;
+
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
@@ -123,6 +123,7 @@ CachingReaderChunkForOwner::CachingReaderChunkForOwner(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : CachingReaderChunk(std::move(sampleBuffer)),
           m_state(FREE),
+          m_bPredicted(false),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
@@ -136,6 +137,7 @@ void CachingReaderChunkForOwner::init(SINT index) {
 
     CachingReaderChunk::init(index);
     m_state = READY;
+    m_bPredicted = false;
 }
 
 void CachingReaderChunkForOwner::free() {
@@ -147,6 +149,7 @@ void CachingReaderChunkForOwner::free() {
 
     CachingReaderChunk::init(kInvalidChunkIndex);
     m_state = FREE;
+    m_bPredicted = false;
 }
 
 void CachingReaderChunkForOwner::insertIntoListBefore(
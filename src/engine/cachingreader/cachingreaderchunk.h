@@ -122,6 +122,16 @@ public:
         m_state = READY;
     }
 
+    // A chunk is predicted if it has only been requested by a hint for a
+    // potential seek target and has not been read or hinted as imminent
+    // since then.
+    bool isPredicted() const {
+        return m_bPredicted;
+    }
+    void setPredicted(bool predicted) {
+        m_bPredicted = predicted;
+    }
+
     // Inserts a chunk into the double-linked list before the
     // given chunk and adjusts the head/tail pointers. The
     // chunk is inserted at the tail of the list if
@@ -138,6 +148,7 @@ public:
 
 private:
     State m_state;
+    bool m_bPredicted;
 
     CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
     CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
@@ -0,0 +1,118 @@
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+
+#include <QtGlobal>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "util/assert.h"
+
+namespace {
+
+// Chunk indices are never negative, so -1 marks an empty slot.
+const SINT kEmptySlotKey = -1;
+
+const SINT kMinSlots = 16;
+
+// 2^64 divided by the golden ratio for Fibonacci hashing. Consecutive chunk
+// indices are typical and would otherwise form long clusters.
+const quint64 kFibonacciMultiplier = 11400714819323198485ull;
+
+} // anonymous namespace
+
+CachingReaderChunkIndex::CachingReaderChunkIndex(SINT maxEntries)
+        : m_mask(0),
+          m_shift(64),
+          m_maxEntries(maxEntries),
+          m_size(0) {
+    DEBUG_ASSERT(maxEntries > 0);
+    SINT numSlots = kMinSlots;
+    while (numSlots < 2 * maxEntries) {
+        numSlots *= 2;
+    }
+    m_mask = numSlots - 1;
+    while ((SINT(1) << (64 - m_shift)) < numSlots) {
+        --m_shift;
+    }
+    const Slot emptySlot = {kEmptySlotKey, nullptr};
+    m_slots.assign(numSlots, emptySlot);
+}
+
+SINT CachingReaderChunkIndex::homeSlot(SINT chunkIndex) const {
+    return static_cast<SINT>(
+            (static_cast<quint64>(chunkIndex) * kFibonacciMultiplier) >> m_shift);
+}
+
+CachingReaderChunkForOwner* CachingReaderChunkIndex::find(SINT chunkIndex) const {
+    DEBUG_ASSERT(chunkIndex >= 0);
+    for (SINT slot = homeSlot(chunkIndex); ; slot = nextSlot(slot)) {
+        const Slot& entry = m_slots[slot];
+        if (entry.key == chunkIndex) {
+            return entry.pChunk;
+        }
+        if (entry.key == kEmptySlotKey) {
+            return nullptr;
+        }
+    }
+}
+
+bool CachingReaderChunkIndex::insert(CachingReaderChunkForOwner* pChunk) {
+    DEBUG_ASSERT(pChunk);
+    const SINT chunkIndex = pChunk->getIndex();
+    DEBUG_ASSERT(chunkIndex >= 0);
+    VERIFY_OR_DEBUG_ASSERT(m_size < m_maxEntries) {
+        return false;
+    }
+    for (SINT slot = homeSlot(chunkIndex); ; slot = nextSlot(slot)) {
+        Slot& entry = m_slots[slot];
+        if (entry.key == chunkIndex) {
+            return false;
+        }
+        if (entry.key == kEmptySlotKey) {
+            entry.key = chunkIndex;
+            entry.pChunk = pChunk;
+            ++m_size;
+            return true;
+        }
+    }
+}
+
+int CachingReaderChunkIndex::remove(SINT chunkIndex) {
+    DEBUG_ASSERT(chunkIndex >= 0);
+    SINT slot = homeSlot(chunkIndex);
+    for (;; slot = nextSlot(slot)) {
+        if (m_slots[slot].key == chunkIndex) {
+            break;
+        }
+        if (m_slots[slot].key == kEmptySlotKey) {
+            return 0;
+        }
+    }
+    // Backward shift deletion: Move subsequent entries of the same probe
+    // sequence into the hole, so that lookups never stop at it early.
+    SINT hole = slot;
+    for (SINT next = nextSlot(hole);
+            m_slots[next].key != kEmptySlotKey;
+            next = nextSlot(next)) {
+        const SINT home = homeSlot(m_slots[next].key);
+        const SINT distanceFromHome = (next - home) & m_mask;
+        const SINT distanceFromHole = (next - hole) & m_mask;
+        if (distanceFromHome >= distanceFromHole) {
+            m_slots[hole] = m_slots[next];
+            hole = next;
+        }
+    }
+    m_slots[hole].key = kEmptySlotKey;
+    m_slots[hole].pChunk = nullptr;
+    --m_size;
+    return 1;
+}
+
+void CachingReaderChunkIndex::clear() {
+    if (m_size == 0) {
+        return;
+    }
+    for (Slot& entry : m_slots) {
+        entry.key = kEmptySlotKey;
+        entry.pChunk = nullptr;
+    }
+    m_size = 0;
+}
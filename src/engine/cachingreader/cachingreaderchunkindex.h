@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include "util/types.h"
+
+class CachingReaderChunkForOwner;
+
+// Maps chunk indices to the chunks that CachingReader has allocated for them.
+//
+// The index is a fixed-capacity hash table with open addressing, linear
+// probing and backward shift deletion. All slots are allocated upfront and
+// no tombstones are needed, so lookups, insertions and removals are O(1)
+// on average and never allocate memory. This makes the index safe to use
+// from the engine callback, unlike QHash which may rehash on insert.
+class CachingReaderChunkIndex {
+  public:
+    // Constructs an index for up to maxEntries chunks. The table is kept at
+    // most half full to keep probe sequences short.
+    explicit CachingReaderChunkIndex(SINT maxEntries);
+
+    SINT size() const {
+        return m_size;
+    }
+
+    // Returns the chunk that is allocated for chunkIndex or nullptr.
+    CachingReaderChunkForOwner* find(SINT chunkIndex) const;
+
+    // Adds a chunk with the key pChunk->getIndex(). Returns false if another
+    // chunk is already stored for this key or if the index is full.
+    bool insert(CachingReaderChunkForOwner* pChunk);
+
+    // Removes the chunk stored for chunkIndex. Returns the number of removed
+    // entries, i.e. either 0 or 1.
+    int remove(SINT chunkIndex);
+
+    void clear();
+
+  private:
+    struct Slot {
+        SINT key;
+        CachingReaderChunkForOwner* pChunk;
+    };
+
+    SINT homeSlot(SINT chunkIndex) const;
+    SINT nextSlot(SINT slot) const {
+        return (slot + 1) & m_mask;
+    }
+
+    std::vector<Slot> m_slots;
+    SINT m_mask;
+    int m_shift;
+    SINT m_maxEntries;
+    SINT m_size;
+};
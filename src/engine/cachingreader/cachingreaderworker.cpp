@@ -26,6 +26,7 @@ CachingReaderWorker::CachingReaderWorker(
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
           m_newTrackAvailable(false),
+          m_idle(0),
           m_stop(0) {
 }
 
@@ -107,7 +108,9 @@ void CachingReaderWorker::run() {
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
         } else {
             Event::end(m_tag);
+            m_idle = 1;
             m_semaRun.acquire();
+            m_idle = 0;
             Event::start(m_tag);
         }
     }
@@ -149,7 +152,8 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 
     mixxx::AudioSource::OpenParams config;
     config.setChannelCount(CachingReaderChunk::kChannels);
-    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(
+            config, SoundSourceProxy::PcmCacheMode::ReadWrite);
     if (!m_pAudioSource) {
         kLogger.warning()
                 << m_group
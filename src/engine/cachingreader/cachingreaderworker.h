@@ -11,6 +11,7 @@
 #include "track/track.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
+#include "util/compatibility.h"
 #include "util/fifo.h"
 
 
@@ -112,6 +113,14 @@ class CachingReaderWorker : public EngineWorker {
 
     void quitWait();
 
+    // Whether the worker waits for work with no track load or read request
+    // pending. Used to render faster than realtime without cache misses.
+    bool isIdle() const {
+        return atomicLoadAcquire(m_idle) &&
+                !m_newTrackAvailable &&
+                m_pChunkReadRequestFIFO->readAvailable() == 0;
+    }
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -146,6 +155,7 @@ class CachingReaderWorker : public EngineWorker {
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
 
+    QAtomicInt m_idle;
     QAtomicInt m_stop;
 };
 
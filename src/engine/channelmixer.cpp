@@ -0,0 +1,168 @@
+#include "engine/channelmixer.h"
+
+#include "util/sample.h"
+
+namespace {
+
+// A channel that is mixed into a bus with its fader gain only.
+struct DirectMix {
+    const CSAMPLE* pBuffer;
+    CSAMPLE* pOutput;
+    CSAMPLE_GAIN oldGain;
+    CSAMPLE_GAIN newGain;
+};
+
+// A channel that passes the post-fader effects before it is mixed into a bus.
+struct EffectsMix {
+    EngineMaster::ChannelInfo* pChannelInfo;
+    const ChannelMixer::OutputBus* pBus;
+    CSAMPLE_GAIN oldGain;
+    CSAMPLE_GAIN newGain;
+};
+
+// Enough for every channel being routed to the headphones and
+// one crossfader orientation bus without allocating memory.
+const int kPreallocatedMixes = 2 * kPreallocatedChannels;
+
+void mixEffects(const EffectsMix& mix,
+        unsigned int iBufferSize,
+        unsigned int iSampleRate,
+        EngineEffectsManager* pEngineEffectsManager) {
+    EngineMaster::ChannelInfo* pChannelInfo = mix.pChannelInfo;
+    const ChannelMixer::OutputBus& bus = *mix.pBus;
+    if (bus.processEffectsInPlace) {
+        pEngineEffectsManager->processPostFaderInPlace(
+                pChannelInfo->m_handle, bus.outputHandle,
+                pChannelInfo->m_pBuffer,
+                iBufferSize, iSampleRate, pChannelInfo->m_features,
+                mix.oldGain, mix.newGain);
+        SampleUtil::add(bus.pOutput, pChannelInfo->m_pBuffer, iBufferSize);
+    } else {
+        pEngineEffectsManager->processPostFaderAndMix(
+                pChannelInfo->m_handle, bus.outputHandle,
+                pChannelInfo->m_pBuffer, bus.pOutput,
+                iBufferSize, iSampleRate, pChannelInfo->m_features,
+                mix.oldGain, mix.newGain);
+    }
+}
+
+} // anonymous namespace
+
+// static
+void ChannelMixer::mixChannels(
+        const OutputBus* pBuses, int numBuses,
+        unsigned int iBufferSize,
+        unsigned int iSampleRate,
+        EngineEffectsManager* pEngineEffectsManager) {
+    // Signal flow overview:
+    // 1. Clear the output buffer of each bus
+    // 2. Calculate the gain ramp of each channel on each bus and sort the
+    //    channels by whether any post-fader effects are enabled for them
+    // 3. Mix the channels without effects straight from their buffers. If a
+    //    channel feeds two buses, both are mixed in a single pass.
+    // 4. Pass the remaining channels to pEngineEffectsManager, which applies
+    //    the gain and the effects in a temporary buffer, or in place if
+    //    allowed by the bus, and mixes the result into the bus output.
+    QVarLengthArray<DirectMix, kPreallocatedMixes> directMixes;
+    QVarLengthArray<EffectsMix, kPreallocatedMixes> effectsMixes;
+
+    for (int b = 0; b < numBuses; ++b) {
+        const OutputBus& bus = pBuses[b];
+        SampleUtil::clear(bus.pOutput, iBufferSize);
+        for (EngineMaster::ChannelInfo* pChannelInfo : *bus.pActiveChannels) {
+            EngineMaster::GainCache& gainCache =
+                    (*bus.pChannelGainCache)[pChannelInfo->m_index];
+            const CSAMPLE_GAIN oldGain = gainCache.m_gain;
+            CSAMPLE_GAIN newGain;
+            if (gainCache.m_fadeout) {
+                newGain = 0;
+                gainCache.m_fadeout = false;
+            } else {
+                newGain = bus.pGainCalculator->getGain(pChannelInfo);
+            }
+            gainCache.m_gain = newGain;
+
+            if (!pEngineEffectsManager ||
+                    pEngineEffectsManager->isPostFaderBypassed(
+                            pChannelInfo->m_handle, bus.outputHandle)) {
+                if (pEngineEffectsManager) {
+                    pEngineEffectsManager->bypassPostFader(
+                            pChannelInfo->m_handle, bus.outputHandle);
+                }
+                DirectMix mix = {pChannelInfo->m_pBuffer, bus.pOutput,
+                        oldGain, newGain};
+                directMixes.append(mix);
+            } else {
+                EffectsMix mix = {pChannelInfo, &bus, oldGain, newGain};
+                effectsMixes.append(mix);
+            }
+        }
+    }
+
+    // All direct mixes read the original channel signal, so they must be
+    // done before any effects are processed in place.
+    for (int i = 0; i < directMixes.size(); ++i) {
+        const DirectMix& mix = directMixes[i];
+        if (!mix.pBuffer) {
+            // Already mixed together with a previous bus
+            continue;
+        }
+        bool mixed = false;
+        for (int j = i + 1; j < directMixes.size(); ++j) {
+            DirectMix& otherMix = directMixes[j];
+            if (otherMix.pBuffer == mix.pBuffer) {
+                SampleUtil::addToBothWithRampingGain(
+                        mix.pOutput, mix.oldGain, mix.newGain,
+                        otherMix.pOutput, otherMix.oldGain, otherMix.newGain,
+                        mix.pBuffer, iBufferSize);
+                otherMix.pBuffer = nullptr;
+                mixed = true;
+                break;
+            }
+        }
+        if (!mixed) {
+            SampleUtil::addWithRampingGain(mix.pOutput, mix.pBuffer,
+                    mix.oldGain, mix.newGain, iBufferSize);
+        }
+    }
+
+    // Buses that need the unprocessed channel buffer go first.
+    for (const EffectsMix& mix : effectsMixes) {
+        if (!mix.pBus->processEffectsInPlace) {
+            mixEffects(mix, iBufferSize, iSampleRate, pEngineEffectsManager);
+        }
+    }
+    for (const EffectsMix& mix : effectsMixes) {
+        if (mix.pBus->processEffectsInPlace) {
+            mixEffects(mix, iBufferSize, iSampleRate, pEngineEffectsManager);
+        }
+    }
+}
+
+// static
+void ChannelMixer::applyEffectsAndMixChannels(const EngineMaster::GainCalculator& gainCalculator,
+                                              QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* activeChannels,
+                                              QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>* channelGainCache,
+                                              CSAMPLE* pOutput,
+                                              const ChannelHandle& outputHandle,
+                                              unsigned int iBufferSize,
+                                              unsigned int iSampleRate,
+                                              EngineEffectsManager* pEngineEffectsManager) {
+    const OutputBus bus = {&gainCalculator, activeChannels, channelGainCache,
+            pOutput, outputHandle, false};
+    mixChannels(&bus, 1, iBufferSize, iSampleRate, pEngineEffectsManager);
+}
+
+// static
+void ChannelMixer::applyEffectsInPlaceAndMixChannels(const EngineMaster::GainCalculator& gainCalculator,
+                                                     QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* activeChannels,
+                                                     QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>* channelGainCache,
+                                                     CSAMPLE* pOutput,
+                                                     const ChannelHandle& outputHandle,
+                                                     unsigned int iBufferSize,
+                                                     unsigned int iSampleRate,
+                                                     EngineEffectsManager* pEngineEffectsManager) {
+    const OutputBus bus = {&gainCalculator, activeChannels, channelGainCache,
+            pOutput, outputHandle, true};
+    mixChannels(&bus, 1, iBufferSize, iSampleRate, pEngineEffectsManager);
+}
@@ -4,11 +4,39 @@
 #include <QVarLengthArray>
 
 #include "util/types.h"
+#include "engine/channelhandle.h"
 #include "engine/enginemaster.h"
 #include "effects/engineeffectsmanager.h"
 
 class ChannelMixer {
   public:
+    // An output bus that is mixed by mixChannels().
+    struct OutputBus {
+        const EngineMaster::GainCalculator* pGainCalculator;
+        QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* pActiveChannels;
+        QVarLengthArray<EngineMaster::GainCache, kPreallocatedChannels>* pChannelGainCache;
+        CSAMPLE* pOutput;
+        ChannelHandle outputHandle;
+        // If true, post-fader effects are processed in the channel buffers
+        // instead of a temporary buffer. The channel buffers are only modified
+        // after all buses that need the original signal have been mixed.
+        bool processEffectsInPlace;
+    };
+
+    // Mixes the active channels of all buses into the bus outputs.
+    //
+    // Channels without enabled post-fader effects for a bus are mixed
+    // with their fader gain ramp directly from the channel buffer. No
+    // temporary buffer is used, the channel buffer is not modified and
+    // a channel that feeds two buses is read only once for both of them.
+    // Only channels with enabled effects take the slower path through
+    // pEngineEffectsManager.
+    static void mixChannels(
+        const OutputBus* pBuses, int numBuses,
+        unsigned int iBufferSize,
+        unsigned int iSampleRate,
+        EngineEffectsManager* pEngineEffectsManager);
+
     // This does not modify the input channel buffers. All manipulation of the input
     // channel buffers is done after copying to a temporary buffer, then they are mixed
     // to make the output buffer.
@@ -20,7 +48,8 @@ class ChannelMixer {
         unsigned int iBufferSize,
         unsigned int iSampleRate,
         EngineEffectsManager* pEngineEffectsManager);
-    // This does modify the input channel buffers, then mixes them to make the output buffer.
+    // This may modify the input channel buffers if effects are enabled for
+    // them, then mixes them to make the output buffer.
     static void applyEffectsInPlaceAndMixChannels(
         const EngineMaster::GainCalculator& gainCalculator,
         QVarLengthArray<EngineMaster::ChannelInfo*, kPreallocatedChannels>* activeChannels,
@@ -13,6 +13,7 @@
 #include "util/assert.h"
 #include "util/math.h"
 #include "util/duration.h"
+#include "util/sample.h"
 
 namespace {
 
@@ -917,6 +918,36 @@ void BpmControl::notifySeek(double dNewPlaypos) {
     updateBeatDistance();
 }
 
+void BpmControl::hintReader(HintVector* pHintList) {
+    // See EngineBuffer::slotControlPlayRequest() and processSeek()
+    if (!m_pBeats || m_pPlayButton->toBool() || !m_pQuantize->toBool()) {
+        return;
+    }
+    // The in-phase position that getBeatMatchPosition() seeks to when
+    // starting playback is less than half a beat away from the current
+    // position. Hint that range instead of calculating the exact position,
+    // which would read the beats of the sync target from the callback.
+    const double dThisPosition = getSampleOfTrack().current;
+    double dThisBeatLength;
+    if (!getBeatContextNoLookup(
+                dThisPosition,
+                m_pPrevBeat->get(),
+                m_pNextBeat->get(),
+                &dThisBeatLength,
+                nullptr) ||
+            dThisBeatLength <= 0.0) {
+        return;
+    }
+    const SINT halfBeatFrames =
+            SampleUtil::floorPlayPosToFrame(dThisBeatLength / 2);
+    Hint syncHint;
+    syncHint.frame = math_max<SINT>(0,
+            SampleUtil::floorPlayPosToFrame(dThisPosition) - halfBeatFrames);
+    syncHint.frameCount = 2 * halfBeatFrames;
+    syncHint.priority = Hint::kPriorityPrediction;
+    pHintList->append(syncHint);
+}
+
 // called from an engine worker thread
 void BpmControl::trackLoaded(TrackPointer pNewTrack) {
     if (m_pTrack) {
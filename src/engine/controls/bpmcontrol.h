@@ -74,6 +74,9 @@ class BpmControl : public EngineControl {
     double getRateRatio() const;
     void notifySeek(double dNewPlaypos) override;
     void trackLoaded(TrackPointer pNewTrack) override;
+    // Hints the position a paused and quantized deck will jump to for
+    // matching the phase of its sync target when it starts playing.
+    void hintReader(HintVector* pHintList) override;
 
   private slots:
     void slotFileBpmChanged(double);
@@ -461,6 +461,34 @@ void LoopingControl::hintReader(HintVector* pHintList) {
             pHintList->append(loop_hint);
         }
     }
+
+    // Predict the targets of beatjumps in both directions. Inside an active
+    // loop a beatjump moves the loop instead, so the moved loop in point is
+    // the target.
+    BeatsPointer pBeats = m_pBeats;
+    const double beatJumpSize = m_pCOBeatJumpSize->get();
+    if (!pBeats || beatJumpSize <= 0) {
+        return;
+    }
+    const double currentSample = m_currentSample.getValue();
+    double jumpOrigin = currentSample;
+    if (m_bLoopingEnabled &&
+            loopSamples.start <= currentSample &&
+            loopSamples.end >= currentSample) {
+        jumpOrigin = loopSamples.start;
+    }
+    if (jumpOrigin < 0) {
+        return;
+    }
+    loop_hint.priority = Hint::kPriorityPrediction;
+    loop_hint.frameCount = Hint::kFrameCountForward;
+    for (const double beats : {beatJumpSize, -beatJumpSize}) {
+        const double target = pBeats->findNBeatsFromSample(jumpOrigin, beats);
+        if (target >= 0 && target < m_pTrackSamples->get()) {
+            loop_hint.frame = SampleUtil::floorPlayPosToFrame(target);
+            pHintList->append(loop_hint);
+        }
+    }
 }
 
 double LoopingControl::getSyncPositionInsideLoop(double dRequestedPlaypos, double dSyncedPlayPos) {
@@ -2,6 +2,7 @@
 
 #include "engine/effects/engineeffect.h"
 #include "util/defs.h"
+#include "util/realtimearena.h"
 #include "util/sample.h"
 
 EngineEffectChain::EngineEffectChain(const QString& id,
@@ -10,9 +11,7 @@ EngineEffectChain::EngineEffectChain(const QString& id,
         : m_id(id),
           m_enableState(EffectEnableState::Enabled),
           m_mixMode(EffectChainMixMode::DrySlashWet),
-          m_dMix(0),
-          m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+          m_dMix(0) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
@@ -261,6 +260,13 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         // after writing to the output buffer. This requires not to use the same buffer
         // for in and output: Also, ChannelMixer::applyEffectsAndMixChannels
         // requires that the input buffer does not get modified.
+        RealtimeArena::Frame scratch;
+        CSAMPLE* const pBuffer1 = scratch.allocateSamples(numSamples);
+        CSAMPLE* const pBuffer2 = scratch.allocateSamples(numSamples);
+        VERIFY_OR_DEBUG_ASSERT(pBuffer1 && pBuffer2) {
+            // Out of scratch memory, bypass the chain
+            return false;
+        }
         CSAMPLE* pIntermediateInput = pIn;
         CSAMPLE* pIntermediateOutput;
         bool firstAddDryToWetEffectProcessed = false;
@@ -268,10 +274,10 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         for (EngineEffect* pEffect: m_effects) {
             if (pEffect != nullptr) {
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pBuffer1) {
+                    pIntermediateOutput = pBuffer2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pBuffer1;
                 }
 
                 if (pEffect->process(inputHandle, outputHandle,
@@ -293,7 +299,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                                 && m_mixMode == EffectChainMixMode::DryPlusWet;
 
                         if (!skipAddingDry) {
-                            for (SINT i = 0; i <= static_cast<SINT>(numSamples); ++i) {
+                            for (SINT i = 0; i < static_cast<SINT>(numSamples); ++i) {
                                 pIntermediateOutput[i] += pIntermediateInput[i];
                             }
                         }
@@ -332,8 +338,9 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     channelStatus.oldMixKnob = currentMixKnob;
 
     // If the EffectProcessors have been sent a signal for the intermediate
-    // enabling/disabling state, set the channel state or chain state
-    // to the fully enabled/disabled state for the next engine callback.
+    // enabling/disabling state, set the channel state to the fully
+    // enabled/disabled state for the next engine callback. The chain state
+    // is shared by all channels and is updated in onCallbackEnd().
 
     EffectEnableState& chainOnChannelEnableState = channelStatus.enableState;
     if (chainOnChannelEnableState == EffectEnableState::Disabling) {
@@ -342,11 +349,33 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         chainOnChannelEnableState = EffectEnableState::Enabled;
     }
 
+    return processingOccured;
+}
+
+bool EngineEffectChain::isBypassedForChannel(const ChannelHandle& inputHandle,
+                                             const ChannelHandle& outputHandle) {
+    const ChannelStatus& channelStatus = getChannelStatus(inputHandle, outputHandle);
+    // Same as the effective enable state in process(), but without the
+    // intermediate states that need to be passed to the effects.
+    const bool disabledForChannel =
+            channelStatus.enableState == EffectEnableState::Disabled;
+    const bool disabledChain =
+            channelStatus.enableState == EffectEnableState::Enabled &&
+            m_enableState == EffectEnableState::Disabled;
+    return disabledForChannel || disabledChain;
+}
+
+void EngineEffectChain::bypassChannel(const ChannelHandle& inputHandle,
+                                      const ChannelHandle& outputHandle) {
+    DEBUG_ASSERT(isBypassedForChannel(inputHandle, outputHandle));
+    // The enable state of a bypassed channel does not change in process()
+    getChannelStatus(inputHandle, outputHandle).oldMixKnob = m_dMix;
+}
+
+void EngineEffectChain::onCallbackEnd() {
     if (m_enableState == EffectEnableState::Disabling) {
         m_enableState = EffectEnableState::Disabled;
     } else if (m_enableState == EffectEnableState::Enabling) {
         m_enableState = EffectEnableState::Enabled;
     }
-
-    return processingOccured;
 }
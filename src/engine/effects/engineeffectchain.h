@@ -34,6 +34,23 @@ class EngineEffectChain : public EffectsRequestHandler {
                  const unsigned int sampleRate,
                  const GroupFeatureState& groupFeatures);
 
+    // Returns true if process() would leave the signal from inputHandle to
+    // outputHandle untouched in this callback, because the chain is disabled
+    // for it and no enable state transition is pending.
+    bool isBypassedForChannel(const ChannelHandle& inputHandle,
+                              const ChannelHandle& outputHandle);
+
+    // Does the per channel bookkeeping of process() for a signal that is
+    // bypassed in this callback instead of calling process().
+    void bypassChannel(const ChannelHandle& inputHandle,
+                       const ChannelHandle& outputHandle);
+
+    // Completes an intermediate Enabling/Disabling transition of the chain's
+    // enable switch after every channel has been processed in this callback.
+    // This keeps the chain-wide state constant while channels are processed,
+    // which may happen concurrently.
+    void onCallbackEnd();
+
     const QString& id() const {
         return m_id;
     }
@@ -73,8 +90,6 @@ class EngineEffectChain : public EffectsRequestHandler {
     EffectChainMixMode m_mixMode;
     CSAMPLE m_dMix;
     QList<EngineEffect*> m_effects;
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectChain);
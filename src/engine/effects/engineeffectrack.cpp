@@ -1,12 +1,11 @@
 #include "engine/effects/engineeffectrack.h"
 #include "engine/effects/engineeffectchain.h"
 #include "util/defs.h"
+#include "util/realtimearena.h"
 #include "util/sample.h"
 
 EngineEffectRack::EngineEffectRack(int iRackNumber)
-        : m_iRackNumber(iRackNumber),
-          m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+        : m_iRackNumber(iRackNumber) {
     // Try to prevent memory allocation.
     m_chains.reserve(256);
 }
@@ -64,16 +63,23 @@ bool EngineEffectRack::process(const ChannelHandle& inputHandle,
         }
     } else {
         // Do not modify the input buffer; only fill the output buffer.
+        RealtimeArena::Frame scratch;
+        CSAMPLE* const pBuffer1 = scratch.allocateSamples(numSamples);
+        CSAMPLE* const pBuffer2 = scratch.allocateSamples(numSamples);
+        VERIFY_OR_DEBUG_ASSERT(pBuffer1 && pBuffer2) {
+            // Out of scratch memory, bypass the rack
+            return false;
+        }
         CSAMPLE* pIntermediateInput = pIn;
         CSAMPLE* pIntermediateOutput;
 
         for (EngineEffectChain* pChain : m_chains) {
             if (pChain != nullptr) {
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pBuffer1) {
+                    pIntermediateOutput = pBuffer2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pBuffer1;
                 }
 
                 if (pChain->process(inputHandle, outputHandle,
@@ -94,6 +100,26 @@ bool EngineEffectRack::process(const ChannelHandle& inputHandle,
     return processingOccured;
 }
 
+bool EngineEffectRack::isBypassedForChannel(const ChannelHandle& inputHandle,
+                                            const ChannelHandle& outputHandle) {
+    for (EngineEffectChain* pChain : m_chains) {
+        if (pChain != nullptr &&
+                !pChain->isBypassedForChannel(inputHandle, outputHandle)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EngineEffectRack::bypassChannel(const ChannelHandle& inputHandle,
+                                     const ChannelHandle& outputHandle) {
+    for (EngineEffectChain* pChain : m_chains) {
+        if (pChain != nullptr) {
+            pChain->bypassChannel(inputHandle, outputHandle);
+        }
+    }
+}
+
 bool EngineEffectRack::addEffectChain(EngineEffectChain* pChain, int iIndex) {
     if (iIndex < 0) {
         if (kEffectDebugOutput) {
@@ -27,6 +27,15 @@ class EngineEffectRack : public EffectsRequestHandler {
                  const unsigned int sampleRate,
                  const GroupFeatureState& groupFeatures);
 
+    // Returns true if all chains in this rack are disabled for the signal
+    // from inputHandle to outputHandle.
+    // See EngineEffectChain::isBypassedForChannel().
+    bool isBypassedForChannel(const ChannelHandle& inputHandle,
+                              const ChannelHandle& outputHandle);
+    // See EngineEffectChain::bypassChannel()
+    void bypassChannel(const ChannelHandle& inputHandle,
+                       const ChannelHandle& outputHandle);
+
     int number() const {
         return m_iRackNumber;
     }
@@ -42,8 +51,6 @@ class EngineEffectRack : public EffectsRequestHandler {
     int m_iRackNumber;
     QList<EngineEffectChain*> m_chains;
 
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectRack);
 };
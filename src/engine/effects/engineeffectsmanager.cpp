@@ -3,14 +3,14 @@
 #include "engine/effects/engineeffectrack.h"
 #include "engine/effects/engineeffectchain.h"
 #include "engine/effects/engineeffect.h"
+#include "engine/engineprofiler.h"
 
 #include "util/defs.h"
+#include "util/realtimearena.h"
 #include "util/sample.h"
 
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe* pResponsePipe)
-        : m_pResponsePipe(pResponsePipe),
-          m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+        : m_pResponsePipe(pResponsePipe) {
     // Try to prevent memory allocation.
     m_chains.reserve(256);
     m_effects.reserve(256);
@@ -119,6 +119,12 @@ void EngineEffectsManager::onCallbackStart() {
     }
 }
 
+void EngineEffectsManager::onCallbackEnd() {
+    for (EngineEffectChain* pChain : m_chains) {
+        pChain->onCallbackEnd();
+    }
+}
+
 void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHandle,
                                                   const ChannelHandle& outputHandle,
                                                   CSAMPLE* pInOut,
@@ -130,6 +136,7 @@ void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHand
     // of the GroupFeatureState, it will not sound the same as if it is loaded into
     // a StandardEffectRack.
     GroupFeatureState featureState;
+    EngineProfiler::ScopedStage profilerStage(EngineProfiler::Stage::Effects);
     processInner(SignalProcessingStage::Prefader,
                  inputHandle, outputHandle,
                  pInOut, pInOut,
@@ -145,6 +152,7 @@ void EngineEffectsManager::processPostFaderInPlace(
     const GroupFeatureState& groupFeatures,
     const CSAMPLE_GAIN oldGain,
     const CSAMPLE_GAIN newGain) {
+    EngineProfiler::ScopedStage profilerStage(EngineProfiler::Stage::Effects);
     processInner(SignalProcessingStage::Postfader,
                  inputHandle, outputHandle,
                  pInOut, pInOut,
@@ -161,6 +169,7 @@ void EngineEffectsManager::processPostFaderAndMix(
     const GroupFeatureState& groupFeatures,
     const CSAMPLE_GAIN oldGain,
     const CSAMPLE_GAIN newGain) {
+    EngineProfiler::ScopedStage profilerStage(EngineProfiler::Stage::Effects);
     processInner(SignalProcessingStage::Postfader,
                  inputHandle, outputHandle,
                  pIn, pOut,
@@ -168,6 +177,32 @@ void EngineEffectsManager::processPostFaderAndMix(
                  oldGain, newGain);
 }
 
+bool EngineEffectsManager::isPostFaderBypassed(
+    const ChannelHandle& inputHandle,
+    const ChannelHandle& outputHandle) {
+    const QList<EngineEffectRack*>& racks =
+            m_racksByStage.value(SignalProcessingStage::Postfader);
+    for (EngineEffectRack* pRack : racks) {
+        if (pRack != nullptr &&
+                !pRack->isBypassedForChannel(inputHandle, outputHandle)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EngineEffectsManager::bypassPostFader(
+    const ChannelHandle& inputHandle,
+    const ChannelHandle& outputHandle) {
+    const QList<EngineEffectRack*>& racks =
+            m_racksByStage.value(SignalProcessingStage::Postfader);
+    for (EngineEffectRack* pRack : racks) {
+        if (pRack != nullptr) {
+            pRack->bypassChannel(inputHandle, outputHandle);
+        }
+    }
+}
+
 void EngineEffectsManager::processInner(
     const SignalProcessingStage stage,
     const ChannelHandle& inputHandle,
@@ -199,7 +234,16 @@ void EngineEffectsManager::processInner(
         // 3. Mix the temporary buffer into pOut
         //    ChannelMixer::applyEffectsAndMixChannels use
         //    this to mix channels into pOut regardless of whether any effects were processed.
-        CSAMPLE* pIntermediateInput = m_buffer1.data();
+        RealtimeArena::Frame scratch;
+        CSAMPLE* const pBuffer1 = scratch.allocateSamples(numSamples);
+        CSAMPLE* const pBuffer2 = scratch.allocateSamples(numSamples);
+        VERIFY_OR_DEBUG_ASSERT(pBuffer1 && pBuffer2) {
+            // Out of scratch memory, mix the dry signal
+            SampleUtil::addWithRampingGain(pOut, pIn,
+                                           oldGain, newGain, numSamples);
+            return;
+        }
+        CSAMPLE* pIntermediateInput = pBuffer1;
         if (oldGain == CSAMPLE_GAIN_ONE && newGain == CSAMPLE_GAIN_ONE) {
             // Avoid an unnecessary copy. EngineEffectRack::process does not modify the
             // input buffer when its input & output buffers are different, so this is okay.
@@ -213,10 +257,10 @@ void EngineEffectsManager::processInner(
         for (EngineEffectRack* pRack : racks) {
             if (pRack != nullptr) {
                 // Select an unused intermediate buffer for the next output
-                if (pIntermediateInput == m_buffer1.data()) {
-                    pIntermediateOutput = m_buffer2.data();
+                if (pIntermediateInput == pBuffer1) {
+                    pIntermediateOutput = pBuffer2;
                 } else {
-                    pIntermediateOutput = m_buffer1.data();
+                    pIntermediateOutput = pBuffer1;
                 }
 
                 if (pRack->process(inputHandle, outputHandle,
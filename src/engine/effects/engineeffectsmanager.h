@@ -20,6 +20,7 @@ class EngineEffectsManager : public EffectsRequestHandler {
     virtual ~EngineEffectsManager();
 
     void onCallbackStart();
+    void onCallbackEnd();
 
     // Take a buffer of numSamples samples of audio from a channel, provided as
     // pInput, and apply each EffectChain enabled for this channel to it,
@@ -55,6 +56,17 @@ class EngineEffectsManager : public EffectsRequestHandler {
         const CSAMPLE_GAIN oldGain = CSAMPLE_GAIN_ONE,
         const CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE);
 
+    // Returns true if no post-fader effect chain is enabled for the signal
+    // from inputHandle to outputHandle. The caller may then mix the signal
+    // with its fader gain only and call bypassPostFader() instead of
+    // processPostFaderInPlace() or processPostFaderAndMix() for this callback.
+    bool isPostFaderBypassed(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle);
+    void bypassPostFader(
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle);
+
     bool processEffectsRequest(
         EffectsRequest& message,
         EffectsResponsePipe* pResponsePipe);
@@ -88,8 +100,6 @@ class EngineEffectsManager : public EffectsRequestHandler {
     QList<EngineEffectChain*> m_chains;
     QList<EngineEffect*> m_effects;
 
-    mixxx::SampleBuffer m_buffer1;
-    mixxx::SampleBuffer m_buffer2;
 };
 
 
@@ -24,6 +24,7 @@
 #include "engine/bufferscalers/enginebufferscalest.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/enginemaster.h"
+#include "engine/engineprofiler.h"
 #include "engine/engineworkerscheduler.h"
 #include "engine/readaheadmanager.h"
 #include "engine/sync/enginesync.h"
@@ -87,6 +88,7 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_iSeekPhaseQueued(0),
           m_iEnableSyncQueued(SYNC_REQUEST_NONE),
           m_iSyncModeQueued(SYNC_INVALID),
+          m_bProcessedConcurrently(false),
           m_iTrackLoading(0),
           m_bPlayAfterLoading(false),
           m_iSampleRate(0),
@@ -423,7 +425,10 @@ void EngineBuffer::readToCrossfadeBuffer(const int iBufferSize) {
     if (!m_bCrossfadeReady) {
         // Read buffer, as if there where no parameter change
         // (Must be called only once per callback)
-        m_pScale->scaleBuffer(m_pCrossfadeBuffer, iBufferSize);
+        {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Scalers);
+            m_pScale->scaleBuffer(m_pCrossfadeBuffer, iBufferSize);
+        }
         // Restore the original position that was lost due to scaleBuffer() above
         m_pReadAheadManager->notifySeek(m_filepos_play);
         m_bCrossfadeReady = true;
@@ -933,8 +938,11 @@ void EngineBuffer::processTrackLocked(
     // If the buffer is not paused, then scale the audio.
     if (!bCurBufferPaused) {
         // Perform scaling of Reader buffer into buffer.
-        double framesRead =
-                m_pScale->scaleBuffer(pOutput, iBufferSize);
+        double framesRead;
+        {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Scalers);
+            framesRead = m_pScale->scaleBuffer(pOutput, iBufferSize);
+        }
 
         // TODO(XXX): The result framesRead might not be an integer value.
         // Converting to samples here does not make sense. All positional
@@ -1009,6 +1017,16 @@ void EngineBuffer::processTrackLocked(
     hintReader(rate);
 }
 
+bool EngineBuffer::readsOtherDecks() const {
+    return m_pSyncControl->getSyncMode() != SYNC_NONE ||
+            m_pQuantize->toBool() ||
+            atomicLoadRelaxed(m_iEnableSyncQueued) != SYNC_REQUEST_NONE ||
+            atomicLoadRelaxed(m_iSyncModeQueued) != SYNC_INVALID ||
+            atomicLoadRelaxed(m_iSeekPhaseQueued) != 0 ||
+            (atomicLoadRelaxed(m_iSeekQueued) & SEEK_PHASE) ||
+            atomicLoadRelaxed(m_pChannelToCloneFrom) != nullptr;
+}
+
 void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     // Bail if we receive a buffer size with incomplete sample frames. Assert in debug builds.
     VERIFY_OR_DEBUG_ASSERT((iBufferSize % kSamplesPerFrame) == 0) {
@@ -1104,6 +1122,12 @@ void EngineBuffer::processSlip(int iBufferSize) {
 }
 
 void EngineBuffer::processSyncRequests() {
+    if (m_bProcessedConcurrently) {
+        // Changing the sync mode touches the other decks. Requests that
+        // arrived after EngineMaster checked readsOtherDecks() are processed
+        // in the next callback.
+        return;
+    }
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
                     m_iEnableSyncQueued.fetchAndStoreRelease(SYNC_REQUEST_NONE));
@@ -1131,9 +1155,13 @@ void EngineBuffer::processSyncRequests() {
 
 void EngineBuffer::processSeek(bool paused) {
     // Check if we are cloning another channel before doing any seeking.
-    EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(NULL);
-    if (pChannel) {
-        seekCloneBuffer(pChannel->getEngineBuffer());
+    // Cloning reads the other deck and is postponed while processed
+    // concurrently, see processSyncRequests().
+    if (!m_bProcessedConcurrently) {
+        EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(NULL);
+        if (pChannel) {
+            seekCloneBuffer(pChannel->getEngineBuffer());
+        }
     }
 
     // We need to read position just after reading seekType, to ensure that we
@@ -1153,7 +1181,7 @@ void EngineBuffer::processSeek(bool paused) {
     }
 
     // Add SEEK_PHASE bit, if any
-    if (m_iSeekPhaseQueued.fetchAndStoreRelease(0)) {
+    if (m_iSeekPhaseQueued.loadAcquire()) {
         seekType |= SEEK_PHASE;
     }
 
@@ -1177,10 +1205,16 @@ void EngineBuffer::processSeek(bool paused) {
             break;
         default:
             qWarning() << "Unhandled seek request type: " << seekType;
+            m_iSeekPhaseQueued.storeRelease(0);
             return;
     }
 
     if (!paused && (seekType & SEEK_PHASE)) {
+        if (m_bProcessedConcurrently) {
+            // Syncing the phase reads the other decks. Keep the seek queued
+            // for the next callback that processes this deck serially.
+            return;
+        }
         double requestedPosition = position;
         double syncPosition = m_pBpmControl->getBeatMatchPosition(position, true, true);
         position = m_pLoopingControl->getSyncPositionInsideLoop(requestedPosition, syncPosition);
@@ -1188,10 +1222,14 @@ void EngineBuffer::processSeek(bool paused) {
     if (position != m_filepos_play) {
         setNewPlaypos(position);
     }
+    m_iSeekPhaseQueued.storeRelease(0);
     m_iSeekQueued.storeRelease(SEEK_NONE);
 }
 
 void EngineBuffer::postProcess(const int iBufferSize) {
+    // All channels have been processed
+    m_bProcessedConcurrently = false;
+
     // The order of events here is very delicate.  It's necessary to update
     // some values before others, because the later updates may require
     // values from the first update.
@@ -1312,6 +1350,24 @@ bool EngineBuffer::isTrackLoaded() {
     return false;
 }
 
+bool EngineBuffer::isReaderIdle() const {
+    return m_pReader->isWorkerIdle();
+}
+
+void EngineBuffer::hintQueuedSeek() {
+    double seekPosition;
+    if (!getQueuedSeekPosition(&seekPosition)) {
+        return;
+    }
+    m_hintList.clear();
+    Hint seekHint;
+    seekHint.frame = SampleUtil::floorPlayPosToFrame(seekPosition);
+    seekHint.frameCount = Hint::kFrameCountForward;
+    seekHint.priority = 1;
+    m_hintList.append(seekHint);
+    m_pReader->hintAndMaybeWake(m_hintList);
+}
+
 bool EngineBuffer::getQueuedSeekPosition(double* pSeekPosition) {
     bool isSeekQueued = m_iSeekQueued.loadAcquire() != SEEK_NONE;
     if (isSeekQueued) {
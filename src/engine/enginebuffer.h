@@ -134,6 +134,23 @@ class EngineBuffer : public EngineObject {
     void requestSyncMode(SyncMode mode);
     void requestClonePosition(EngineChannel* pChannel);
 
+    // Whether the next process() call may read the state of other decks,
+    // e.g. for syncing, quantized seeks or cloning. Such decks must not be
+    // processed concurrently with other channels. Note that this is true for
+    // every deck with sync or quantize enabled, which is the common setup
+    // for mixing, so usually only samplers, decks without sync and quantize,
+    // microphones and auxiliary inputs are processed concurrently.
+    bool readsOtherDecks() const;
+    // Marks the next process() call as running concurrently with other
+    // channels. Requests that would read the state of other decks are then
+    // kept queued until the next callback.
+    void setProcessedConcurrently(bool concurrent) {
+        m_bProcessedConcurrently = concurrent;
+    }
+    bool isProcessedConcurrently() const {
+        return m_bProcessedConcurrently;
+    }
+
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const int iBufferSize);
     void processSlip(int iBufferSize);
@@ -141,6 +158,14 @@ class EngineBuffer : public EngineObject {
 
     QString getGroup();
     bool isTrackLoaded();
+    // Whether the reader has finished all pending track loads and reads.
+    // Not used by the audio callback.
+    bool isReaderIdle() const;
+    // Hints the reader about the target of a queued seek, so that its chunks
+    // can be read before the next process() call performs the seek. Must be
+    // called from the thread that calls process(), but not by the audio
+    // callback, which issues its hints while processing.
+    void hintQueuedSeek();
     // return true if a seek is currently cueued but not yet processed, false otherwise
     // if no seek was queued, the seek position is set to -1
     bool getQueuedSeekPosition(double* pSeekPosition);
@@ -260,6 +285,7 @@ class EngineBuffer : public EngineObject {
     FRIEND_TEST(LoopingControlTest, ReloopToggleButton_DoesNotJumpAhead);
     FRIEND_TEST(LoopingControlTest, ReloopAndStopButton);
     FRIEND_TEST(LoopingControlTest, Beatjump_JumpsByBeats);
+    FRIEND_TEST(LoopingControlTest, Beatjump_HintsJumpTargets);
     FRIEND_TEST(SyncControlTest, TestDetermineBpmMultiplier);
     FRIEND_TEST(EngineSyncTest, HalfDoubleBpmTest);
     FRIEND_TEST(EngineSyncTest, HalfDoubleThenPlay);
@@ -396,6 +422,8 @@ class EngineBuffer : public EngineObject {
     QAtomicInt m_iSyncModeQueued;
     ControlValueAtomic<double> m_queuedSeekPosition;
     QAtomicPointer<EngineChannel> m_pChannelToCloneFrom;
+    // Only accessed from the callback thread, see setProcessedConcurrently()
+    bool m_bProcessedConcurrently;
 
     // Is true if the previous buffer was silent due to pausing
     QAtomicInt m_iTrackLoading;
@@ -0,0 +1,291 @@
+#include "engine/enginechannelprocessorpool.h"
+
+#include <QtDebug>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/realtimearena.h"
+#include "util/realtimeguard.h"
+#include "util/rlimit.h"
+
+namespace {
+
+#ifdef __LINUX__
+// The CPUs the calling thread may run on. New threads inherit this mask.
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &cpuSet)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+#endif
+
+inline void cpuRelax() {
+#ifdef __SSE__
+    _mm_pause();
+#endif
+}
+
+inline unsigned int getFpuControlState() {
+#ifdef __SSE__
+    return _mm_getcsr();
+#else
+    return 0;
+#endif
+}
+
+inline void setFpuControlState(unsigned int state) {
+#ifdef __SSE__
+    if (_mm_getcsr() != state) {
+        _mm_setcsr(state);
+    }
+#else
+    Q_UNUSED(state);
+#endif
+}
+
+} // anonymous namespace
+
+class EngineChannelProcessorPool::HelperThread : public QThread {
+  public:
+    // cpu is the CPU to pin the thread to, or -1 to not pin it.
+    HelperThread(EngineChannelProcessorPool* pPool, int index, int cpu)
+            : m_pPool(pPool),
+              m_cpu(cpu),
+              m_priority(0) {
+        setObjectName(QString("EngineChannelProcessor %1").arg(index));
+    }
+
+    // Called by the callback thread after publishing a new batch, and on
+    // shutdown after m_bQuit has been set.
+    void wake() {
+        m_semaWake.release();
+    }
+
+  protected:
+    void run() override {
+        setAffinity();
+        RealtimeArena::Scope scratchScope(&m_scratchArena);
+
+        quint32 lastGeneration = m_pPool->currentGeneration();
+        while (true) {
+            // A token that was posted while the previous batch was still
+            // running only causes one spurious wakeup that finds no new
+            // batch.
+            m_semaWake.acquire();
+            if (m_pPool->m_bQuit.load()) {
+                return;
+            }
+            const quint32 generation = m_pPool->currentGeneration();
+            if (generation == lastGeneration) {
+                continue;
+            }
+            lastGeneration = generation;
+
+            updateScheduling();
+            setFpuControlState(m_pPool->m_fpuControlState.load());
+            ScopedRealtimeThread realtimeThread;
+            while (m_pPool->claimAndRunTask(generation)) {
+            }
+        }
+    }
+
+  private:
+    void setAffinity() {
+#ifdef __LINUX__
+        if (m_cpu < 0) {
+            return;
+        }
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(m_cpu, &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+            qWarning() << objectName() << "failed to pin thread to CPU" << m_cpu;
+        }
+#endif
+    }
+
+    // Follows the realtime priority of the callback thread, one level below
+    // it, so that a helper never preempts the thread that waits for it.
+    void updateScheduling() {
+#ifdef __LINUX__
+        const int callbackPriority = m_pPool->m_callbackPriority.load();
+        int priority = 0;
+        if (callbackPriority > 1) {
+            // Stay within RLIMIT_RTPRIO, 0 means no realtime scheduling
+            const unsigned int maxPriority = RLimit::getCurRtPrio();
+            priority = static_cast<unsigned int>(callbackPriority - 1) < maxPriority
+                    ? callbackPriority - 1
+                    : static_cast<int>(maxPriority);
+        }
+        if (priority == m_priority) {
+            return;
+        }
+        struct sched_param param;
+        param.sched_priority = priority;
+        if (pthread_setschedparam(pthread_self(),
+                    priority > 0 ? SCHED_FIFO : SCHED_OTHER,
+                    &param) != 0) {
+            qWarning() << objectName() << "failed to set realtime priority"
+                       << priority;
+        }
+        // Don't retry on every batch if this failed
+        m_priority = priority;
+#endif
+    }
+
+    EngineChannelProcessorPool* const m_pPool;
+    const int m_cpu;
+    // The realtime priority applied to this thread, 0 for SCHED_OTHER.
+    int m_priority;
+    QSemaphore m_semaWake;
+    // Scratch memory for the tasks that run on this thread
+    RealtimeArena m_scratchArena;
+};
+
+EngineChannelProcessorPool::EngineChannelProcessorPool(int numHelperThreads)
+        : m_taskState(0),
+          m_numTasks(0),
+          m_remainingTasks(0),
+          m_pFunction(nullptr),
+          m_pContext(nullptr),
+          m_fpuControlState(getFpuControlState()),
+          m_generation(0),
+          m_callbackPriority(-1),
+          m_bQuit(false) {
+#ifdef __LINUX__
+    const std::vector<int> cpus = allowedCpus();
+#endif
+    for (int i = 0; i < numHelperThreads; ++i) {
+        int cpu = -1;
+#ifdef __LINUX__
+        // Leave the first allowed CPU for the callback thread.
+        if (i + 1 < static_cast<int>(cpus.size())) {
+            cpu = cpus[i + 1];
+        }
+#endif
+        HelperThread* pThread = new HelperThread(this, i, cpu);
+        m_helperThreads.push_back(pThread);
+        pThread->start(QThread::TimeCriticalPriority);
+    }
+    qDebug() << "EngineChannelProcessorPool started"
+             << numHelperThreads << "helper threads";
+}
+
+EngineChannelProcessorPool::~EngineChannelProcessorPool() {
+    m_bQuit.store(true);
+    for (HelperThread* pThread : m_helperThreads) {
+        pThread->wake();
+    }
+    for (HelperThread* pThread : m_helperThreads) {
+        pThread->wait();
+        delete pThread;
+    }
+    qDebug() << "EngineChannelProcessorPool stopped";
+}
+
+// static
+int EngineChannelProcessorPool::defaultNumHelperThreads() {
+#ifdef __LINUX__
+    const int numCpus = static_cast<int>(allowedCpus().size());
+    if (numCpus > 0) {
+        return numCpus - 1;
+    }
+#endif
+    return math_max(QThread::idealThreadCount() - 1, 0);
+}
+
+void EngineChannelProcessorPool::updateCallbackPriority() {
+#ifdef __LINUX__
+    int policy = SCHED_OTHER;
+    struct sched_param param;
+    int priority = 0;
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0 &&
+            (policy == SCHED_FIFO || policy == SCHED_RR)) {
+        priority = param.sched_priority;
+    }
+    m_callbackPriority.store(priority, std::memory_order_relaxed);
+#else
+    m_callbackPriority.store(0, std::memory_order_relaxed);
+#endif
+}
+
+void EngineChannelProcessorPool::run(
+        TaskFunction pFunction, void* pContext, int numTasks) {
+    if (numTasks <= 0) {
+        return;
+    }
+    if (numTasks == 1 || m_helperThreads.empty()) {
+        for (int i = 0; i < numTasks; ++i) {
+            (*pFunction)(pContext, i);
+        }
+        return;
+    }
+
+    // The callback thread only gets its realtime priority once the sound
+    // device is running, so this can't be done when creating the pool.
+    if (m_callbackPriority.load(std::memory_order_relaxed) < 0) {
+        updateCallbackPriority();
+    }
+
+    // No batch is in flight here, because the previous call only returned
+    // after all of its tasks had been completed.
+    m_pFunction = pFunction;
+    m_pContext = pContext;
+    m_numTasks.store(numTasks, std::memory_order_relaxed);
+    m_remainingTasks.store(numTasks, std::memory_order_relaxed);
+    m_fpuControlState.store(getFpuControlState(), std::memory_order_relaxed);
+
+    // Publishing the new generation releases all of the above to the helpers.
+    const quint32 generation = ++m_generation;
+    m_taskState.store(static_cast<quint64>(generation) << 32);
+    // Wake at most as many helpers as there are tasks besides our own.
+    const int numHelpersToWake = math_min(numTasks - 1, numHelperThreads());
+    for (int i = 0; i < numHelpersToWake; ++i) {
+        m_helperThreads[i]->wake();
+    }
+
+    // Do our share of the work instead of idling.
+    while (claimAndRunTask(generation)) {
+    }
+    while (m_remainingTasks.load(std::memory_order_acquire) > 0) {
+        cpuRelax();
+    }
+}
+
+bool EngineChannelProcessorPool::claimAndRunTask(quint32 generation) {
+    quint64 state = m_taskState.load(std::memory_order_acquire);
+    int iTask;
+    do {
+        if (static_cast<quint32>(state >> 32) != generation) {
+            // A helper woke up late and missed its batch.
+            return false;
+        }
+        iTask = static_cast<int>(state & 0xFFFFFFFF);
+        if (iTask >= m_numTasks.load(std::memory_order_relaxed)) {
+            return false;
+        }
+    } while (!m_taskState.compare_exchange_weak(state, state + 1,
+            std::memory_order_acq_rel, std::memory_order_acquire));
+
+    (*m_pFunction)(m_pContext, iTask);
+    m_remainingTasks.fetch_sub(1, std::memory_order_release);
+    return true;
+}
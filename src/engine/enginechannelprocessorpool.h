@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+
+#include <atomic>
+#include <vector>
+
+#include "util/class.h"
+
+// EngineChannelProcessorPool runs a batch of independent tasks from the
+// engine callback on a set of helper threads and the callback thread itself,
+// and returns once every task of the batch has finished. EngineMaster uses it
+// to process its active channels concurrently.
+//
+// Dispatching a batch is lock-free: tasks are claimed from an atomic counter
+// that is tagged with a batch generation, and completion is signaled through
+// an atomic counter the callback thread spins on. The callback thread posts
+// a semaphore per helper thread to start a batch and then starts working on
+// the tasks itself. Helpers go back to sleep right after each batch instead
+// of spinning, because the next batch only arrives with the next callback.
+//
+// On Linux the helper threads are pinned to the CPUs of the affinity mask of
+// the creating thread, leaving the first one for the callback thread. Once
+// the callback thread has run a batch, the helpers adopt SCHED_FIFO with one
+// priority level below the callback thread if it runs with realtime
+// scheduling and RLIMIT_RTPRIO allows it.
+class EngineChannelProcessorPool {
+  public:
+    typedef void (*TaskFunction)(void* pContext, int iTask);
+
+    explicit EngineChannelProcessorPool(int numHelperThreads);
+    virtual ~EngineChannelProcessorPool();
+
+    // The number of helper threads that make sense on this machine, i.e. one
+    // less than the number of usable cores since the callback thread works
+    // too.
+    static int defaultNumHelperThreads();
+
+    int numHelperThreads() const {
+        return static_cast<int>(m_helperThreads.size());
+    }
+
+    // Calls pFunction(pContext, i) for every i in [0, numTasks) and returns
+    // after all calls have returned. Tasks may run in any order and
+    // concurrently. Only call this from the engine callback thread.
+    void run(TaskFunction pFunction, void* pContext, int numTasks);
+
+  private:
+    class HelperThread;
+
+    // Claims the next task of the given batch and runs it. Returns false if
+    // the batch has no tasks left or has already been superseded.
+    bool claimAndRunTask(quint32 generation);
+    quint32 currentGeneration() const {
+        return static_cast<quint32>(m_taskState.load() >> 32);
+    }
+    // Publishes the realtime priority of the calling callback thread to
+    // the helper threads.
+    void updateCallbackPriority();
+
+    // The upper 32 bits hold the generation of the current batch, the lower
+    // 32 bits the index of the next unclaimed task.
+    std::atomic<quint64> m_taskState;
+    std::atomic<int> m_numTasks;
+    std::atomic<int> m_remainingTasks;
+    // Only written by the callback thread while no batch is in flight.
+    TaskFunction m_pFunction;
+    void* m_pContext;
+    // The floating point control state (denormals mode) of the callback
+    // thread that helper threads copy, so that results are bit-identical to
+    // processing everything on the callback thread.
+    std::atomic<unsigned int> m_fpuControlState;
+    quint32 m_generation;
+    // The SCHED_FIFO/SCHED_RR priority of the callback thread, 0 if it does
+    // not use realtime scheduling, or -1 before the first batch.
+    std::atomic<int> m_callbackPriority;
+
+    std::atomic<bool> m_bQuit;
+    std::vector<HelperThread*> m_helperThreads;
+
+    DISALLOW_COPY_AND_ASSIGN(EngineChannelProcessorPool);
+};
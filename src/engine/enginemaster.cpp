@@ -3,6 +3,7 @@
 #include <QtDebug>
 #include <QList>
 #include <QPair>
+#include <QThread>
 
 #include "preferences/usersettings.h"
 #include "control/controlaudiotaperpot.h"
@@ -14,9 +15,11 @@
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginebuffer.h"
+#include "engine/enginechannelprocessorpool.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/channels/enginedeck.h"
 #include "engine/enginedelay.h"
+#include "engine/engineprofiler.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
@@ -24,11 +27,23 @@
 #include "engine/sidechain/enginesidechain.h"
 #include "engine/sync/enginesync.h"
 #include "mixer/playermanager.h"
+#include "util/counter.h"
 #include "util/defs.h"
 #include "util/sample.h"
 #include "util/timer.h"
 #include "util/trace.h"
 
+namespace {
+
+// The number of channels per callback that are processed concurrently and
+// serially while parallel channel processing is enabled
+const QString kParallelChannelsStatTag =
+        QStringLiteral("EngineMaster channels processed concurrently");
+const QString kSerialChannelsStatTag =
+        QStringLiteral("EngineMaster channels processed serially");
+
+} // anonymous namespace
+
 EngineMaster::EngineMaster(UserSettingsPointer pConfig,
                            const char* group,
                            EffectsManager* pEffectsManager,
@@ -36,6 +51,8 @@ EngineMaster::EngineMaster(UserSettingsPointer pConfig,
                            bool bEnableSidechain)
         : m_pChannelHandleFactory(pChannelHandleFactory),
           m_pEngineEffectsManager(pEffectsManager ? pEffectsManager->getEngineEffectsManager() : NULL),
+          m_pChannelProcessorPool(nullptr),
+          m_bChannelProcessorPoolInUse(false),
           m_masterGainOld(0.0),
           m_boothGainOld(0.0),
           m_headphoneMasterGainOld(0.0),
@@ -188,6 +205,15 @@ EngineMaster::EngineMaster(UserSettingsPointer pConfig,
     m_pHeadphoneEnabled = new ControlObject(ConfigKey(group, "headEnabled"));
     m_pHeadphoneEnabled->setReadOnly();
 
+    // Process independent channels concurrently on helper threads. The
+    // helper threads only exist while this is enabled.
+    m_pParallelChannelProcessing = new ControlObject(
+            ConfigKey(group, "parallel_channel_processing"),
+            true, false, true);  // persist = true
+    connect(m_pParallelChannelProcessing, &ControlObject::valueChanged,
+            this, &EngineMaster::slotParallelChannelProcessing);
+    slotParallelChannelProcessing(m_pParallelChannelProcessing->get());
+
     // Note: the EQ Rack is set in EffectsManager::setupDefaults();
 }
 
@@ -228,6 +254,9 @@ EngineMaster::~EngineMaster() {
     delete m_pMasterMonoMixdown;
     delete m_pMicMonitorMode;
     delete m_pHeadphoneEnabled;
+    // Stop the helper threads before the channels they process are deleted
+    destroyChannelProcessorPool();
+    delete m_pParallelChannelProcessing;
 
     SampleUtil::free(m_pHead);
     SampleUtil::free(m_pMaster);
@@ -347,19 +376,47 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    // Announce that the pool is in use before loading it, so that
+    // destroyChannelProcessorPool() waits until we are done with it.
+    m_bChannelProcessorPoolInUse.store(true);
+    EngineChannelProcessorPool* pPool = m_pChannelProcessorPool.load();
+    if (pPool) {
+        // The sync master has to be processed before all followers, because
+        // they read its beat distance and bpm. Decks that read the state of
+        // other decks (sync, quantize, cloning) are processed serially on the
+        // callback thread, before all remaining channels are processed
+        // concurrently, each into its own buffer.
+        m_parallelChannels.clear();
+        for (int i = activeChannelsStartIndex;
+                i < m_activeChannels.size(); ++i) {
+            ChannelInfo* pChannelInfo = m_activeChannels[i];
+            EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+            if (i == 0 || (pBuffer && pBuffer->readsOtherDecks())) {
+                processChannel(pChannelInfo, iBufferSize);
+            } else {
+                if (pBuffer) {
+                    pBuffer->setProcessedConcurrently(true);
+                }
+                m_parallelChannels.append(pChannelInfo);
+            }
+        }
+        // Reveals how many channels the serial decks leave for the helper
+        // threads, see EngineBuffer::readsOtherDecks().
+        const int numParallelChannels = m_parallelChannels.size();
+        const int numSerialChannels =
+                m_activeChannels.size() - activeChannelsStartIndex -
+                numParallelChannels;
+        Counter(kParallelChannelsStatTag).increment(numParallelChannels);
+        Counter(kSerialChannelsStatTag).increment(numSerialChannels);
+        pPool->run(&EngineMaster::processChannelTask, this,
+                numParallelChannels);
+    } else {
+        for (int i = activeChannelsStartIndex;
+                 i < m_activeChannels.size(); ++i) {
+            processChannel(m_activeChannels[i], iBufferSize);
         }
     }
+    m_bChannelProcessorPoolInUse.store(false);
 
     // After all the engines have been processed, trigger post-processing
     // which ensures that all channels are updating certain values at the
@@ -371,6 +428,55 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 }
 
+void EngineMaster::processChannel(ChannelInfo* pChannelInfo, int iBufferSize) {
+    EngineChannel* pChannel = pChannelInfo->m_pChannel;
+    pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
+void EngineMaster::slotParallelChannelProcessing(double v) {
+    if (v > 0.0) {
+        if (m_pChannelProcessorPool.load()) {
+            return;
+        }
+        const int numHelperThreads =
+                EngineChannelProcessorPool::defaultNumHelperThreads();
+        if (numHelperThreads > 0) {
+            m_pChannelProcessorPool.store(
+                    new EngineChannelProcessorPool(numHelperThreads));
+        }
+    } else {
+        destroyChannelProcessorPool();
+    }
+}
+
+void EngineMaster::destroyChannelProcessorPool() {
+    EngineChannelProcessorPool* pPool = m_pChannelProcessorPool.exchange(nullptr);
+    if (!pPool) {
+        return;
+    }
+    // The callback may have loaded the pool just before it was reset. Wait
+    // for it to finish its current batch.
+    while (m_bChannelProcessorPoolInUse.load()) {
+        QThread::yieldCurrentThread();
+    }
+    delete pPool;
+}
+
+// static
+void EngineMaster::processChannelTask(void* pContext, int iTask) {
+    EngineMaster* pEngineMaster = static_cast<EngineMaster*>(pContext);
+    pEngineMaster->processChannel(
+            pEngineMaster->m_parallelChannels[iTask],
+            pEngineMaster->m_iBufferSize);
+}
+
 void EngineMaster::process(const int iBufferSize) {
     static bool haveSetName = false;
     if (!haveSetName) {
@@ -378,6 +484,7 @@ void EngineMaster::process(const int iBufferSize) {
         haveSetName = true;
     }
     //Trace t("EngineMaster::process");
+    RealtimeArena::Scope scratchScope(&m_scratchArena);
 
     bool masterEnabled = m_pMasterEnabled->get();
     bool boothEnabled = m_pBoothEnabled->get();
@@ -389,6 +496,8 @@ void EngineMaster::process(const int iBufferSize) {
     const unsigned int kChannels = 2;
     const unsigned int iFrames = iBufferSize / kChannels;
 
+    EngineProfiler::beginCallback(iFrames, m_iSampleRate);
+
     if (m_pEngineEffectsManager) {
         m_pEngineEffectsManager->onCallbackStart();
     }
@@ -396,7 +505,10 @@ void EngineMaster::process(const int iBufferSize) {
     // Update internal master sync rate.
     m_pMasterSync->onCallbackStart(m_iSampleRate, m_iBufferSize);
     // Prepare each channel for output
-    processChannels(m_iBufferSize);
+    {
+        EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Channels);
+        processChannels(m_iBufferSize);
+    }
     // Do internal master sync post-processing
     m_pMasterSync->onCallbackEnd(m_iSampleRate, m_iBufferSize);
 
@@ -412,44 +524,13 @@ void EngineMaster::process(const int iBufferSize) {
         //          << ", master " << cmaster_gain;
     }
 
-    // Mix all the PFL enabled channels together.
+    // The gain for mixing all the PFL enabled channels together.
     m_headphoneGain.setGain(pflMixGainInHeadphones);
 
-    if (headphoneEnabled) {
-        // Process effects and mix PFL channels together for the headphones.
-        // Effects will be reprocessed post-fader for the crossfader busses
-        // and master mix, so the channel input buffers cannot be modified here.
-        ChannelMixer::applyEffectsAndMixChannels(
-            m_headphoneGain, &m_activeHeadphoneChannels,
-            &m_channelHeadphoneGainCache,
-            m_pHead, m_headphoneHandle.handle(),
-            m_iBufferSize, m_iSampleRate,
-            m_pEngineEffectsManager);
-
-        // Process headphone channel effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState headphoneFeatures;
-            // If there is only one channel in the headphone mix, use its features
-            // for effects processing. This allows for previewing how an effect will
-            // sound on a playing deck before turning up the dry/wet knob to make it
-            // audible on the master mix. Without this, the effect would sound different
-            // in headphones than how it would sound if it was enabled on the deck,
-            // for example with tempo synced effects.
-            if (m_activeHeadphoneChannels.size() == 1) {
-                headphoneFeatures = m_activeHeadphoneChannels.at(0)->m_features;
-            }
-            m_pEngineEffectsManager->processPostFaderInPlace(
-                m_headphoneHandle.handle(),
-                m_headphoneHandle.handle(),
-                m_pHead,
-                m_iBufferSize, m_iSampleRate,
-                headphoneFeatures);
-        }
-    }
-
     // Mix all the talkover enabled channels together.
-    // Effects processing is done in place to avoid unnecessary buffer copying.
-    ChannelMixer::applyEffectsInPlaceAndMixChannels(
+    // The channel input buffers cannot be modified here, because the
+    // headphone and crossfader buses are mixed from them below.
+    ChannelMixer::applyEffectsAndMixChannels(
             m_talkoverGain, &m_activeTalkoverChannels,
             &m_channelTalkoverGainCache,
             m_pTalkover, m_masterHandle.handle(),
@@ -486,13 +567,48 @@ void EngineMaster::process(const int iBufferSize) {
     m_masterGain.setGains(crossfaderLeftGain, 1.0, crossfaderRightGain,
                             m_pTalkoverDucking->getGain(m_iBufferSize / 2));
 
+    // Mix the PFL channels for the headphones and the channels of each
+    // crossfader orientation bus in a single pass over the channel buffers.
+    // Effects are processed separately for the headphones and the
+    // crossfader buses, so only the latter may modify the channel buffers.
+    ChannelMixer::OutputBus outputBuses[4];
+    int numOutputBuses = 0;
+    if (headphoneEnabled) {
+        outputBuses[numOutputBuses++] = {
+                &m_headphoneGain, &m_activeHeadphoneChannels,
+                &m_channelHeadphoneGainCache,
+                m_pHead, m_headphoneHandle.handle(), false};
+    }
     for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
-        ChannelMixer::applyEffectsInPlaceAndMixChannels(
-            m_masterGain,
-            &m_activeBusChannels[o],
-            &m_channelMasterGainCache, // no [o] because the old gain follows an orientation switch
-            m_pOutputBusBuffers[o], m_masterHandle.handle(),
+        outputBuses[numOutputBuses++] = {
+                &m_masterGain, &m_activeBusChannels[o],
+                // no [o] because the old gain follows an orientation switch
+                &m_channelMasterGainCache,
+                m_pOutputBusBuffers[o], m_masterHandle.handle(), true};
+    }
+    ChannelMixer::mixChannels(outputBuses, numOutputBuses,
             m_iBufferSize, m_iSampleRate, m_pEngineEffectsManager);
+
+    if (headphoneEnabled) {
+        // Process headphone channel effects
+        if (m_pEngineEffectsManager) {
+            GroupFeatureState headphoneFeatures;
+            // If there is only one channel in the headphone mix, use its features
+            // for effects processing. This allows for previewing how an effect will
+            // sound on a playing deck before turning up the dry/wet knob to make it
+            // audible on the master mix. Without this, the effect would sound different
+            // in headphones than how it would sound if it was enabled on the deck,
+            // for example with tempo synced effects.
+            if (m_activeHeadphoneChannels.size() == 1) {
+                headphoneFeatures = m_activeHeadphoneChannels.at(0)->m_features;
+            }
+            m_pEngineEffectsManager->processPostFaderInPlace(
+                m_headphoneHandle.handle(),
+                m_headphoneHandle.handle(),
+                m_pHead,
+                m_iBufferSize, m_iSampleRate,
+                headphoneFeatures);
+        }
     }
 
     // Process crossfader orientation bus channel effects
@@ -667,6 +783,7 @@ void EngineMaster::process(const int iBufferSize) {
         // so skip sending a buffer to m_pSidechain here.
         if (!m_bExternalRecordBroadcastInputConnected
             && m_pEngineSideChain != nullptr) {
+            EngineProfiler::ScopedStage stage(EngineProfiler::Stage::Sidechain);
             m_pEngineSideChain->writeSamples(m_pSidechainMix, iFrames);
         }
 
@@ -724,11 +841,23 @@ void EngineMaster::process(const int iBufferSize) {
         m_pBoothDelay->process(m_pBooth, m_iBufferSize);
     }
 
+    // All effects have been processed for this callback
+    if (m_pEngineEffectsManager) {
+        m_pEngineEffectsManager->onCallbackEnd();
+    }
+
+    EngineProfiler::endCallback();
+
     // We're close to the end of the callback. Wake up the engine worker
     // scheduler so that it runs the workers.
     m_pWorkerScheduler->runWorkers();
 }
 
+void EngineMaster::wakeWorkers() {
+    m_pWorkerScheduler->workerReady();
+    m_pWorkerScheduler->runWorkers();
+}
+
 void EngineMaster::applyMasterEffects() {
     // Apply master effects
     if (m_pEngineEffectsManager) {
@@ -21,6 +21,8 @@
 #include <QObject>
 #include <QVarLengthArray>
 
+#include <atomic>
+
 #include "preferences/usersettings.h"
 #include "control/controlobject.h"
 #include "control/controlpushbutton.h"
@@ -30,8 +32,10 @@
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
 #include "recording/recordingmanager.h"
+#include "util/realtimearena.h"
 
 class EngineWorkerScheduler;
+class EngineChannelProcessorPool;
 class EngineBuffer;
 class EngineChannel;
 class EngineDeck;
@@ -86,6 +90,11 @@ class EngineMaster : public QObject, public AudioSource {
 
     void process(const int iBufferSize);
 
+    // Wakes the engine workers again outside of the callback, e.g. when
+    // rendering offline without a sound device. The workers are woken at the
+    // end of every process() anyway.
+    void wakeWorkers();
+
     // Add an EngineChannel to the mixing engine. This is not thread safe --
     // only call it before the engine has started mixing.
     void addChannel(EngineChannel* pChannel);
@@ -262,13 +271,33 @@ class EngineMaster : public QObject, public AudioSource {
     ControlObject* m_pHeadphoneEnabled;
     ControlObject* m_pBoothEnabled;
 
+  private slots:
+    // Starts or stops the helper threads for processing channels
+    // concurrently.
+    void slotParallelChannelProcessing(double v);
+
   private:
     // Processes active channels. The master sync channel (if any) is processed
     // first and all others are processed after. Populates m_activeChannels,
     // m_activeBusChannels, m_activeHeadphoneChannels, and
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
+    //
+    // With parallel channel processing, the sync master and every deck that
+    // reads the state of other decks are processed serially first, and only
+    // the remaining channels concurrently. With sync or quantize enabled on
+    // all decks only samplers, microphones and auxiliary inputs run
+    // concurrently. The number of channels processed each way per callback
+    // is reported to the StatsManager.
     void processChannels(int iBufferSize);
+    // Processes a single channel into its buffer and collects its features.
+    // May be called concurrently for different channels.
+    void processChannel(ChannelInfo* pChannelInfo, int iBufferSize);
+    // EngineChannelProcessorPool::TaskFunction for processing
+    // m_parallelChannels[iTask].
+    static void processChannelTask(void* pContext, int iTask);
+    // Stops the helper threads once the callback no longer uses them.
+    void destroyChannelProcessorPool();
 
     ChannelHandleFactory* m_pChannelHandleFactory;
     void applyMasterEffects();
@@ -276,6 +305,18 @@ class EngineMaster : public QObject, public AudioSource {
 
     EngineEffectsManager* m_pEngineEffectsManager;
 
+    // Helper threads for processing channels concurrently. Only exists
+    // while [Master],parallel_channel_processing is enabled on a multi-core
+    // machine. Created and destroyed by the main thread.
+    std::atomic<EngineChannelProcessorPool*> m_pChannelProcessorPool;
+    // Set by the callback thread while it may use m_pChannelProcessorPool.
+    std::atomic<bool> m_bChannelProcessorPoolInUse;
+    ControlObject* m_pParallelChannelProcessing;
+
+    // Scratch memory for everything that runs on the callback thread. It is
+    // reset at the start of every callback.
+    RealtimeArena m_scratchArena;
+
     // List of channels added to the engine.
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_channels;
 
@@ -287,6 +328,8 @@ class EngineMaster : public QObject, public AudioSource {
 
     // Pre-allocated buffers for performing channel mixing in the callback.
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeChannels;
+    // The subset of m_activeChannels that is processed concurrently
+    QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_parallelChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeBusChannels[3];
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeHeadphoneChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeTalkoverChannels;
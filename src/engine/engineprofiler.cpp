@@ -0,0 +1,334 @@
+#include "engine/engineprofiler.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtDebug>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+const std::chrono::steady_clock::time_point EngineProfiler::s_epoch =
+        std::chrono::steady_clock::now();
+
+namespace {
+
+using Stage = EngineProfiler::Stage;
+constexpr int kNumStages = EngineProfiler::kNumStages;
+constexpr int kNumBuckets = EngineProfiler::kNumBuckets;
+constexpr int kNumRecords = EngineProfiler::kNumRecords;
+constexpr int kCallback = static_cast<int>(Stage::Callback);
+
+const qint64 kNoStart = std::numeric_limits<qint64>::max();
+
+// The stage times of the running callback, written by all realtime threads
+std::atomic<qint64> s_stageNanos[kNumStages];
+std::atomic<qint64> s_stageStartNanos[kNumStages];
+
+// Only touched by the engine thread
+qint64 s_callbackStartNanos = 0;
+qint64 s_callbackBudgetNanos = 0;
+double s_averageNanos[kNumStages];
+
+// A CallbackRecord that is written by the engine thread and read by the GUI
+// thread without locking. The sequence number is odd while the record is
+// being written.
+struct Slot {
+    std::atomic<quint32> sequence;
+    std::atomic<qint64> startNanos;
+    std::atomic<qint64> budgetNanos;
+    std::atomic<qint64> stageNanos[kNumStages];
+    std::atomic<qint64> stageOffsetNanos[kNumStages];
+    std::atomic<int> xrunStage;
+};
+
+Slot s_records[kNumRecords];
+std::atomic<quint64> s_numCallbacks(0);
+
+std::atomic<quint64> s_histograms[kNumStages][kNumBuckets];
+std::atomic<int> s_xrunCounts[kNumStages];
+std::atomic<bool> s_xrunPending(false);
+
+// Average durations adapt within a few hundred callbacks
+const double kAverageWeight = 1.0 / 64;
+
+// Increments a counter that has a single writer
+template<typename T>
+void increment(std::atomic<T>* pCounter) {
+    pCounter->store(pCounter->load(std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+}
+
+// Finds the stage that exceeded its average duration the most. The raw
+// excess of each stage is compared. Nested stages are not subtracted from
+// Channels, because Channels is the elapsed time on the engine thread while
+// the Scalers and Effects are summed over all threads, and the postfader
+// Effects run outside of Channels.
+int blameStage(const qint64 stageNanos[kNumStages]) {
+    double excess[kNumStages];
+    for (int i = 0; i < kNumStages; ++i) {
+        excess[i] = stageNanos[i] - s_averageNanos[i];
+    }
+
+    // If no stage took longer than usual, the time was spent outside of the
+    // stages or outside of the engine
+    int blamed = kCallback;
+    double maxExcess = 0.0;
+    for (int i = 0; i < kNumStages; ++i) {
+        if (i != kCallback && excess[i] > maxExcess) {
+            blamed = i;
+            maxExcess = excess[i];
+        }
+    }
+    return blamed;
+}
+
+void readRecord(const Slot& slot, EngineProfiler::CallbackRecord* pRecord) {
+    quint32 sequence;
+    do {
+        do {
+            sequence = slot.sequence.load(std::memory_order_acquire);
+        } while (sequence & 1);
+        pRecord->startNanos = slot.startNanos.load(std::memory_order_relaxed);
+        pRecord->budgetNanos = slot.budgetNanos.load(std::memory_order_relaxed);
+        for (int i = 0; i < kNumStages; ++i) {
+            pRecord->stageNanos[i] =
+                    slot.stageNanos[i].load(std::memory_order_relaxed);
+            pRecord->stageOffsetNanos[i] =
+                    slot.stageOffsetNanos[i].load(std::memory_order_relaxed);
+        }
+        pRecord->xrunStage = slot.xrunStage.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (slot.sequence.load(std::memory_order_relaxed) != sequence);
+}
+
+} // anonymous namespace
+
+// static
+const char* EngineProfiler::stageName(Stage stage) {
+    switch (stage) {
+    case Stage::Callback:
+        return "Callback";
+    case Stage::Channels:
+        return "Channels";
+    case Stage::Scalers:
+        return "Scalers";
+    case Stage::Effects:
+        return "Effects";
+    case Stage::Sidechain:
+        return "Sidechain";
+    case Stage::VuMeters:
+        return "VuMeters";
+    }
+    return "Unknown";
+}
+
+// static
+int EngineProfiler::bucketForNanos(qint64 nanos) {
+    quint64 micros = static_cast<quint64>(std::max<qint64>(nanos, 0)) / 1000 + 1;
+    int bucket = -1;
+    while (micros) {
+        micros >>= 1;
+        ++bucket;
+    }
+    return std::min(bucket, kNumBuckets - 1);
+}
+
+// static
+void EngineProfiler::beginCallback(int frames, int sampleRate) {
+    s_callbackStartNanos = now();
+    s_callbackBudgetNanos = sampleRate > 0 ?
+            static_cast<qint64>(frames) * 1000000000 / sampleRate : 0;
+}
+
+// static
+void EngineProfiler::addStageTime(Stage stage, qint64 startNanos, qint64 endNanos) {
+    const int i = static_cast<int>(stage);
+    s_stageNanos[i].fetch_add(endNanos - startNanos, std::memory_order_relaxed);
+    // The stage starts with its earliest invocation in the callback. The
+    // accumulators are reset to kNoStart, except before the first callback.
+    qint64 earliest = s_stageStartNanos[i].load(std::memory_order_relaxed);
+    while ((earliest == 0 || startNanos < earliest) &&
+            !s_stageStartNanos[i].compare_exchange_weak(
+                    earliest, startNanos, std::memory_order_relaxed)) {
+    }
+}
+
+// static
+void EngineProfiler::endCallback() {
+    addStageTime(Stage::Callback, s_callbackStartNanos, now());
+
+    qint64 stageNanos[kNumStages];
+    qint64 stageOffsetNanos[kNumStages];
+    for (int i = 0; i < kNumStages; ++i) {
+        stageNanos[i] = s_stageNanos[i].exchange(0, std::memory_order_relaxed);
+        const qint64 start = s_stageStartNanos[i].exchange(
+                kNoStart, std::memory_order_relaxed);
+        stageOffsetNanos[i] = stageNanos[i] > 0 ?
+                start - s_callbackStartNanos : 0;
+        if (stageNanos[i] > 0) {
+            increment(&s_histograms[i][bucketForNanos(stageNanos[i])]);
+        }
+    }
+
+    const quint64 numCallbacks = s_numCallbacks.load(std::memory_order_relaxed);
+
+    // A device reports an xrun in the callback after the one that was late
+    if (s_xrunPending.exchange(false, std::memory_order_relaxed) &&
+            numCallbacks > 0) {
+        Slot& previous = s_records[(numCallbacks - 1) % kNumRecords];
+        if (previous.xrunStage.load(std::memory_order_relaxed) < 0) {
+            qint64 previousNanos[kNumStages];
+            for (int i = 0; i < kNumStages; ++i) {
+                previousNanos[i] =
+                        previous.stageNanos[i].load(std::memory_order_relaxed);
+            }
+            const int blamed = blameStage(previousNanos);
+            previous.xrunStage.store(blamed, std::memory_order_relaxed);
+            increment(&s_xrunCounts[blamed]);
+        }
+    }
+
+    int xrunStage = -1;
+    if (s_callbackBudgetNanos > 0 && stageNanos[kCallback] > s_callbackBudgetNanos) {
+        xrunStage = blameStage(stageNanos);
+        increment(&s_xrunCounts[xrunStage]);
+    }
+
+    for (int i = 0; i < kNumStages; ++i) {
+        s_averageNanos[i] += (stageNanos[i] - s_averageNanos[i]) * kAverageWeight;
+    }
+
+    Slot& slot = s_records[numCallbacks % kNumRecords];
+    const quint32 sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.startNanos.store(s_callbackStartNanos, std::memory_order_relaxed);
+    slot.budgetNanos.store(s_callbackBudgetNanos, std::memory_order_relaxed);
+    for (int i = 0; i < kNumStages; ++i) {
+        slot.stageNanos[i].store(stageNanos[i], std::memory_order_relaxed);
+        slot.stageOffsetNanos[i].store(stageOffsetNanos[i], std::memory_order_relaxed);
+    }
+    slot.xrunStage.store(xrunStage, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    s_numCallbacks.store(numCallbacks + 1, std::memory_order_release);
+}
+
+// static
+void EngineProfiler::reportXrun() {
+    s_xrunPending.store(true, std::memory_order_relaxed);
+}
+
+// static
+void EngineProfiler::histogram(Stage stage, quint64 counts[kNumBuckets]) {
+    for (int i = 0; i < kNumBuckets; ++i) {
+        counts[i] = s_histograms[static_cast<int>(stage)][i].load(
+                std::memory_order_relaxed);
+    }
+}
+
+// static
+int EngineProfiler::xrunCount(Stage stage) {
+    return s_xrunCounts[static_cast<int>(stage)].load(std::memory_order_relaxed);
+}
+
+// static
+QVector<EngineProfiler::CallbackRecord> EngineProfiler::recentCallbacks() {
+    const quint64 numCallbacks = s_numCallbacks.load(std::memory_order_acquire);
+    // Leave out the oldest record, which may be overwritten while reading
+    const quint64 numRecords = std::min<quint64>(numCallbacks, kNumRecords - 1);
+    QVector<CallbackRecord> records(static_cast<int>(numRecords));
+    for (quint64 i = 0; i < numRecords; ++i) {
+        readRecord(s_records[(numCallbacks - numRecords + i) % kNumRecords],
+                &records[static_cast<int>(i)]);
+    }
+    return records;
+}
+
+// static
+QString EngineProfiler::summary() {
+    QString result = QString("Callbacks: %1\n\n%2%3").arg(
+            QString::number(s_numCallbacks.load(std::memory_order_relaxed)),
+            QString("Stage").leftJustified(12),
+            QString("xruns").rightJustified(6));
+    for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+        // The upper bound of the bucket
+        const quint64 upperMicros = (quint64(2) << bucket) - 1;
+        const QString bound = upperMicros < 1000 ?
+                QString("<%1us").arg(upperMicros) :
+                QString("<%1ms").arg(upperMicros / 1000);
+        result += bound.rightJustified(9);
+    }
+    result += "\n";
+    for (int stage = 0; stage < kNumStages; ++stage) {
+        quint64 counts[kNumBuckets];
+        histogram(static_cast<Stage>(stage), counts);
+        result += QString(stageName(stage)).leftJustified(12);
+        result += QString::number(xrunCount(static_cast<Stage>(stage))).rightJustified(6);
+        for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+            result += QString::number(counts[bucket]).rightJustified(9);
+        }
+        result += "\n";
+    }
+    return result;
+}
+
+// static
+bool EngineProfiler::writeChromeTrace(const QString& fileName) {
+    const QVector<CallbackRecord> records = recentCallbacks();
+
+    // Timestamps are in microseconds. Each stage gets its own track.
+    QJsonArray events;
+    for (int stage = 0; stage < kNumStages; ++stage) {
+        events.append(QJsonObject{
+                {"name", "thread_name"},
+                {"ph", "M"},
+                {"pid", 1},
+                {"tid", stage},
+                {"args", QJsonObject{{"name", stageName(stage)}}}});
+    }
+    for (const CallbackRecord& record : records) {
+        for (int stage = 0; stage < kNumStages; ++stage) {
+            if (record.stageNanos[stage] <= 0) {
+                continue;
+            }
+            QJsonObject event{
+                    {"name", stageName(stage)},
+                    {"cat", "engine"},
+                    {"ph", "X"},
+                    {"pid", 1},
+                    {"tid", stage},
+                    {"ts", (record.startNanos + record.stageOffsetNanos[stage]) / 1000.0},
+                    {"dur", record.stageNanos[stage] / 1000.0}};
+            if (stage == kCallback) {
+                event.insert("args", QJsonObject{
+                        {"budget_us", record.budgetNanos / 1000.0}});
+            }
+            events.append(event);
+        }
+        if (record.xrunStage >= 0) {
+            events.append(QJsonObject{
+                    {"name", "xrun"},
+                    {"cat", "engine"},
+                    {"ph", "i"},
+                    {"s", "g"},
+                    {"pid", 1},
+                    {"tid", kCallback},
+                    {"ts", record.startNanos / 1000.0},
+                    {"args", QJsonObject{{"stage", stageName(record.xrunStage)}}}});
+        }
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "EngineProfiler: failed to open" << fileName;
+        return false;
+    }
+    const QJsonObject trace{
+            {"traceEvents", events},
+            {"displayTimeUnit", "ms"}};
+    file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    return true;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+#include <chrono>
+
+#include "util/class.h"
+#include "util/types.h"
+
+// Always-on accounting of the time that each stage of the engine spends in
+// every audio callback.
+//
+// Stages are timed with a ScopedStage on whatever realtime thread they run,
+// including the helper threads of the EngineChannelProcessorPool, and summed
+// per callback with atomic additions. At the end of each callback the engine
+// thread folds the sums into one histogram per stage and writes a record
+// into a preallocated ring of the most recent callbacks. Nothing on the
+// audio threads allocates or takes a lock.
+//
+// When a callback takes longer than its buffer, or when a sound device
+// reports an xrun, the callback is tagged with the stage that exceeded its
+// usual duration the most. Stages may overlap, e.g. a slow deck is seen in
+// both Scalers and Channels, so the blamed stage is only a hint. The GUI reads the histograms, the xrun counts
+// and the ring at any time, and the ring can be exported as a Chrome trace
+// (chrome://tracing, Perfetto) with one track per stage.
+class EngineProfiler {
+  public:
+    enum class Stage {
+        // The whole EngineMaster::process()
+        Callback,
+        // All channels including their prefader effects
+        Channels,
+        // The buffer scalers of the decks
+        Scalers,
+        // All effect chains, prefader and postfader
+        Effects,
+        Sidechain,
+        VuMeters,
+    };
+    static constexpr int kNumStages = 6;
+
+    // Bucket i counts durations from 2^i - 1 up to 2^(i+1) - 1 microseconds
+    static constexpr int kNumBuckets = 20;
+
+    // About 95 seconds at 1024 frames and 44.1 kHz
+    static constexpr int kNumRecords = 4096;
+
+    struct CallbackRecord {
+        qint64 startNanos;
+        qint64 budgetNanos;
+        // Summed over all threads, zero if the stage did not run
+        qint64 stageNanos[kNumStages];
+        // The earliest start of each stage relative to startNanos
+        qint64 stageOffsetNanos[kNumStages];
+        // The stage blamed for an xrun, or -1
+        int xrunStage;
+    };
+
+    static const char* stageName(Stage stage);
+    static const char* stageName(int stage) {
+        return stageName(static_cast<Stage>(stage));
+    }
+
+    // Nanoseconds since the start of the process
+    static qint64 now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - s_epoch).count();
+    }
+
+    // Called by the engine thread at the start and the end of a callback
+    static void beginCallback(int frames, int sampleRate);
+    static void endCallback();
+
+    // May be called from any realtime thread between beginCallback() and
+    // endCallback()
+    static void addStageTime(Stage stage, qint64 startNanos, qint64 endNanos);
+
+    // Called by the sound devices when the driver reports an xrun. It is
+    // attributed to the last completed callback.
+    static void reportXrun();
+
+    // Readers for the GUI thread.
+    static void histogram(Stage stage, quint64 counts[kNumBuckets]);
+    static int xrunCount(Stage stage);
+    static QVector<CallbackRecord> recentCallbacks();
+    static QString summary();
+    // Writes the recent callbacks in the Chrome trace event format
+    static bool writeChromeTrace(const QString& fileName);
+
+    static int bucketForNanos(qint64 nanos);
+
+    class ScopedStage {
+      public:
+        explicit ScopedStage(Stage stage)
+                : m_stage(stage),
+                  m_startNanos(now()) {
+        }
+        ~ScopedStage() {
+            addStageTime(m_stage, m_startNanos, now());
+        }
+
+      private:
+        const Stage m_stage;
+        const qint64 m_startNanos;
+
+        DISALLOW_COPY_AND_ASSIGN(ScopedStage);
+    };
+
+  private:
+    static const std::chrono::steady_clock::time_point s_epoch;
+};
@@ -18,6 +18,7 @@
 
 #include "control/controlproxy.h"
 #include "control/controlpotmeter.h"
+#include "engine/engineprofiler.h"
 #include "util/math.h"
 #include "util/sample.h"
 
@@ -56,6 +57,7 @@ EngineVuMeter::~EngineVuMeter()
 }
 
 void EngineVuMeter::process(CSAMPLE* pIn, const int iBufferSize) {
+    EngineProfiler::ScopedStage stage(EngineProfiler::Stage::VuMeters);
     CSAMPLE fVolSumL, fVolSumR;
 
     int sampleRate = (int)m_pSampleRate->get();
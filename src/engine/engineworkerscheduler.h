@@ -1,6 +1,8 @@
 #ifndef ENGINEWORKERSCHEDULER_H
 #define ENGINEWORKERSCHEDULER_H
 
+#include <atomic>
+
 #include <QMutex>
 #include <QThreadPool>
 #include <QWaitCondition>
@@ -28,8 +30,10 @@ class EngineWorkerScheduler : public QThread {
 
   private:
     // Indicates whether workerReady has been called since the last time
-    // runWorkers was run. This should only be touched from the engine callback.
-    bool m_bWakeScheduler;
+    // runWorkers was run. This is only touched from the engine callback, but
+    // workerReady may be called concurrently from the threads of
+    // EngineChannelProcessorPool.
+    std::atomic<bool> m_bWakeScheduler;
 
     std::vector<EngineWorker*> m_workers;
 
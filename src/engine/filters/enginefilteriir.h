@@ -6,6 +6,7 @@
 #include <fidlib.h>
 
 #include "engine/engineobject.h"
+#include "engine/filters/stereodouble.h"
 #include "util/sample.h"
 
 // set to 1 to print some analysis data using qDebug()
@@ -74,11 +75,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        memcpy(m_oldBuf, m_buf, sizeof(m_buf));
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        clearBuffer(m_buf);
         m_doRamping = true;
     }
 
@@ -195,11 +194,20 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     virtual void process(const CSAMPLE* pIn, CSAMPLE* pOutput,
                          const int iBufferSize) {
+        // Both channels are processed at once in the lanes of a
+        // StereoDouble, with the same result as processing them one by one.
         if (!m_doRamping) {
+            // Work on local copies, which the compiler can keep in
+            // registers, because they cannot alias the output buffer.
+            double coef[SIZE + 1];
+            StereoDouble buf[SIZE];
+            memcpy(coef, m_coef, sizeof(coef));
+            memcpy(buf, m_buf, sizeof(buf));
             for (int i = 0; i < iBufferSize; i += 2) {
-                pOutput[i] = processSample(m_coef, m_buf1, pIn[i]);
-                pOutput[i+1] = processSample(m_coef, m_buf2, pIn[i + 1]);
+                processSample(coef, buf,
+                        StereoDouble::load(&pIn[i])).store(&pOutput[i]);
             }
+            memcpy(m_buf, buf, sizeof(buf));
         } else {
             double cross_mix = 0.0;
             double cross_inc = 4.0 / static_cast<double>(iBufferSize);
@@ -215,32 +223,25 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
-                double old1;
-                double old2;
+                const StereoDouble in = StereoDouble::load(&pIn[i]);
+                StereoDouble oldOut;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = processSample(m_oldCoef, m_oldBuf1, pIn[i]);
-                    old2 = processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]);
+                    oldOut = processSample(m_oldCoef, m_oldBuf, in);
                 } else {
                     if (m_startFromDry) {
-                        old1 = pIn[i];
-                        old2 = pIn[i + 1];
+                        oldOut = in;
                     } else {
-                        old1 = 0;
-                        old2 = 0;
+                        oldOut = StereoDouble::zero();
                     }
                 }
-                double new1 = processSample(m_coef, m_buf1, pIn[i]);
-                double new2 = processSample(m_coef, m_buf2, pIn[i + 1]);
+                const StereoDouble newOut = processSample(m_coef, m_buf, in);
 
                 if (i < iBufferSize / 2) {
-                    pOutput[i] = old1;
-                    pOutput[i + 1] = old2;
+                    oldOut.store(&pOutput[i]);
                 } else {
-                    pOutput[i] = new1 * cross_mix +
-                                 old1 * (1.0 - cross_mix);
-                    pOutput[i + 1] = new2  * cross_mix +
-                                     old2 * (1.0 - cross_mix);
+                    (newOut * cross_mix +
+                            oldOut * (1.0 - cross_mix)).store(&pOutput[i]);
                     cross_mix += cross_inc;
                 }
             }
@@ -250,28 +251,30 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    // Processes one stereo frame. The coefficients are shared by both
+    // channels, each lane of buf holds the state of one channel.
+    inline StereoDouble processSample(const double* coef, StereoDouble* buf,
+            StereoDouble val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        clearBuffer(m_buf);
         m_doRamping = true;
         m_doStart = true;
     }
+    static void clearBuffer(StereoDouble* buf) {
+        for (unsigned int i = 0; i < SIZE; ++i) {
+            buf[i] = StereoDouble::zero();
+        }
+    }
 
     double m_coef[SIZE + 1];
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
-
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    // Channel 1 and 2 state
+    StereoDouble m_buf[SIZE];
+    // Old channel buffer needed for ramping
+    StereoDouble m_oldBuf[SIZE];
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -282,10 +285,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<2, IIR_LP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -296,10 +299,10 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<2, IIR_BP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -310,10 +313,10 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<2, IIR_HP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -324,10 +327,10 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<4, IIR_LP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -343,10 +346,10 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<8, IIR_BP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -373,10 +376,10 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<4, IIR_HP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -392,10 +395,10 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<8, IIR_LP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -422,10 +425,10 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<16, IIR_BP>::processSample(const double* coef,
+                                                               StereoDouble* buf,
+                                                               StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -474,10 +477,10 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<8, IIR_HP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -505,10 +508,10 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<5, IIR_BP>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -519,10 +522,10 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<4, IIR_LPMO>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+   StereoDouble tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -545,10 +548,10 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<4, IIR_HPMO>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+   StereoDouble tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -570,10 +573,10 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<2, IIR_LP2>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -591,10 +594,10 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+inline StereoDouble EngineFilterIIR<2, IIR_HP2>::processSample(const double* coef,
+                                                              StereoDouble* buf,
+                                                              StereoDouble val) {
+    StereoDouble tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
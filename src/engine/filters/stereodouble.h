@@ -0,0 +1,163 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIXXX_STEREODOUBLE_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MIXXX_STEREODOUBLE_NEON
+#include <arm_neon.h>
+#endif
+
+#include "util/types.h"
+
+// The left and the right sample of a stereo frame in double precision, held
+// in the two lanes of a SIMD register where available.
+//
+// Each operation is applied to both lanes independently with exactly the
+// same IEEE rounding as the scalar double operation. Code written against
+// this type produces bit identical results for both channels compared to
+// processing them one after the other, but needs only half of the
+// instructions. This is used by EngineFilterIIR, where each channel is a
+// long chain of dependent multiplications and additions.
+class StereoDouble {
+  public:
+    StereoDouble() = default;
+    StereoDouble(double left, double right) {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        m_value = _mm_set_pd(right, left);
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        const double values[2] = {left, right};
+        m_value = vld1q_f64(values);
+#else
+        m_left = left;
+        m_right = right;
+#endif
+    }
+
+    static StereoDouble zero() {
+        return StereoDouble(0.0, 0.0);
+    }
+
+    // Converts an interleaved stereo frame
+    static StereoDouble load(const CSAMPLE* pFrame) {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        // _mm_loadl_epi64() may alias any type, unlike _mm_load_sd()
+        const __m128 frame = _mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)));
+        return StereoDouble(_mm_cvtps_pd(frame));
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        return StereoDouble(vcvt_f64_f32(vld1_f32(pFrame)));
+#else
+        return StereoDouble(pFrame[0], pFrame[1]);
+#endif
+    }
+
+    // Stores both lanes rounded to CSAMPLE as an interleaved stereo frame
+    void store(CSAMPLE* pFrame) const {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pFrame),
+                _mm_castps_si128(_mm_cvtpd_ps(m_value)));
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        vst1_f32(pFrame, vcvt_f32_f64(m_value));
+#else
+        pFrame[0] = static_cast<CSAMPLE>(m_left);
+        pFrame[1] = static_cast<CSAMPLE>(m_right);
+#endif
+    }
+
+    double left() const {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        return _mm_cvtsd_f64(m_value);
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        return vgetq_lane_f64(m_value, 0);
+#else
+        return m_left;
+#endif
+    }
+
+    double right() const {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        return _mm_cvtsd_f64(_mm_unpackhi_pd(m_value, m_value));
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        return vgetq_lane_f64(m_value, 1);
+#else
+        return m_right;
+#endif
+    }
+
+    StereoDouble operator+(const StereoDouble& other) const {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        return StereoDouble(_mm_add_pd(m_value, other.m_value));
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        return StereoDouble(vaddq_f64(m_value, other.m_value));
+#else
+        return StereoDouble(m_left + other.m_left, m_right + other.m_right);
+#endif
+    }
+
+    StereoDouble operator-(const StereoDouble& other) const {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        return StereoDouble(_mm_sub_pd(m_value, other.m_value));
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        return StereoDouble(vsubq_f64(m_value, other.m_value));
+#else
+        return StereoDouble(m_left - other.m_left, m_right - other.m_right);
+#endif
+    }
+
+    StereoDouble operator*(const StereoDouble& other) const {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        return StereoDouble(_mm_mul_pd(m_value, other.m_value));
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        return StereoDouble(vmulq_f64(m_value, other.m_value));
+#else
+        return StereoDouble(m_left * other.m_left, m_right * other.m_right);
+#endif
+    }
+
+    StereoDouble operator*(double factor) const {
+        return *this * StereoDouble(factor, factor);
+    }
+
+    StereoDouble operator-() const {
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+        // Flip the sign bits like the scalar negation does
+        return StereoDouble(_mm_xor_pd(m_value, _mm_set1_pd(-0.0)));
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+        return StereoDouble(vnegq_f64(m_value));
+#else
+        return StereoDouble(-m_left, -m_right);
+#endif
+    }
+
+    StereoDouble& operator+=(const StereoDouble& other) {
+        *this = *this + other;
+        return *this;
+    }
+
+    StereoDouble& operator-=(const StereoDouble& other) {
+        *this = *this - other;
+        return *this;
+    }
+
+  private:
+#if defined(MIXXX_STEREODOUBLE_SSE2)
+    explicit StereoDouble(__m128d value)
+            : m_value(value) {
+    }
+    __m128d m_value;
+#elif defined(MIXXX_STEREODOUBLE_NEON)
+    explicit StereoDouble(float64x2_t value)
+            : m_value(value) {
+    }
+    float64x2_t m_value;
+#else
+    double m_left;
+    double m_right;
+#endif
+};
+
+inline StereoDouble operator*(double factor, const StereoDouble& value) {
+    return value * factor;
+}
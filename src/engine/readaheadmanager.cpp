@@ -213,6 +213,18 @@ void ReadAheadManager::hintReader(double dRate, HintVector* pHintList) {
     // top priority, we need to read this data immediately
     current_position.priority = 1;
     pHintList->append(current_position);
+
+    // Reversing, reverse rolls and censoring continue in the opposite
+    // direction right at the play position.
+    Hint opposite_direction;
+    opposite_direction.frame =
+            static_cast<SINT>(floor(m_currentPosition / kNumChannels));
+    opposite_direction.frameCount = in_reverse ?
+            Hint::kFrameCountForward : Hint::kFrameCountBackward;
+    opposite_direction.priority = Hint::kPriorityPrediction;
+    if (opposite_direction.frame > 0) {
+        pHintList->append(opposite_direction);
+    }
 }
 
 // Not thread-save, call from engine thread only
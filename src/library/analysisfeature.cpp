@@ -24,7 +24,8 @@ const mixxx::Logger kLogger("AnalysisFeature");
 
 const QString kViewName = QStringLiteral("Analysis");
 
-// Utilize all available cores for batch analysis of tracks
+// Utilize all available cores for batch analysis of tracks. The scheduler
+// reduces the number of active threads while the audio engine is busy.
 const int kNumberOfAnalyzerThreads = math_max(1, QThread::idealThreadCount());
 
 inline
@@ -40,7 +41,7 @@ AnalyzerModeFlags getAnalyzerModeFlags(
     // NOTE(uklotzde, 2018-12-26): The previous comment just states the status-quo
     // of the existing code. We should rethink the configuration of analyzers when
     // refactoring/redesigning the analyzer framework.
-    int modeFlags = AnalyzerModeFlags::WithBeats;
+    int modeFlags = AnalyzerModeFlags::WithBeats | AnalyzerModeFlags::Background;
     if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
         modeFlags |= AnalyzerModeFlags::WithWaveform;
     }
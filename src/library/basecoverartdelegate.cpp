@@ -27,7 +27,8 @@ BaseCoverArtDelegate::BaseCoverArtDelegate(QTableView* parent)
         : TableItemDelegate(parent),
           m_pTrackModel(asTrackModel(parent)),
           m_pCache(CoverArtCache::instance()),
-          m_inhibitLazyLoading(false) {
+          m_inhibitLazyLoading(false),
+          m_coverWidth(0) {
     if (m_pCache) {
         connect(m_pCache,
                 &CoverArtCache::coverFound,
@@ -56,7 +57,19 @@ void BaseCoverArtDelegate::emitRowsChanged(
 void BaseCoverArtDelegate::slotInhibitLazyLoading(
         bool inhibitLazyLoading) {
     m_inhibitLazyLoading = inhibitLazyLoading;
-    if (m_inhibitLazyLoading || m_cacheMissRows.isEmpty()) {
+    if (m_inhibitLazyLoading) {
+        // The user started scrolling and the covers that have not been
+        // loaded yet are most likely no longer visible. Rows that are
+        // still visible are refreshed when scrolling stops.
+        if (m_pCache && !m_pendingCacheRows.isEmpty()) {
+            m_pCache->cancelPendingRequests(this);
+            m_cacheMissRows.append(m_pendingCacheRows.values());
+            m_pendingCacheRows.clear();
+        }
+        return;
+    }
+    prefetchCoversAroundViewport();
+    if (m_cacheMissRows.isEmpty()) {
         return;
     }
     // If we can request non-cache covers now, request updates
@@ -69,6 +82,39 @@ void BaseCoverArtDelegate::slotInhibitLazyLoading(
     emitRowsChanged(std::move(staleRows));
 }
 
+void BaseCoverArtDelegate::prefetchCoversAroundViewport() {
+    auto* pTableView = qobject_cast<QTableView*>(parent());
+    if (!m_pCache || !pTableView || m_coverWidth <= 0) {
+        return;
+    }
+    const QAbstractItemModel* pModel = pTableView->model();
+    const int rowCount = pModel ? pModel->rowCount() : 0;
+    const int firstVisibleRow = pTableView->rowAt(0);
+    if (firstVisibleRow < 0) {
+        return;
+    }
+    int lastVisibleRow = pTableView->rowAt(pTableView->viewport()->height() - 1);
+    if (lastVisibleRow < 0) {
+        lastVisibleRow = rowCount - 1;
+    }
+    // The visible rows are requested when painting them. The other
+    // rows are requested in order of their distance from the viewport.
+    const int margin = lastVisibleRow - firstVisibleRow + 1;
+    QList<CoverInfo> coverInfos;
+    for (int distance = 1; distance <= margin; ++distance) {
+        for (int row : {lastVisibleRow + distance, firstVisibleRow - distance}) {
+            if (row < 0 || row >= rowCount) {
+                continue;
+            }
+            CoverInfo coverInfo = coverInfoForIndex(pModel->index(row, 0));
+            if (CoverImageUtils::isValidHash(coverInfo.hash)) {
+                coverInfos.append(std::move(coverInfo));
+            }
+        }
+    }
+    m_pCache->prefetchCovers(this, coverInfos, m_coverWidth);
+}
+
 void BaseCoverArtDelegate::slotCoverFound(
         const QObject* pRequestor,
         const CoverInfo& coverInfo,
@@ -116,10 +162,11 @@ void BaseCoverArtDelegate::paintItem(
         }
         const double scaleFactor =
                 getDevicePixelRatioF(static_cast<QWidget*>(parent()));
+        m_coverWidth = option.rect.width() * scaleFactor;
         QPixmap pixmap = m_pCache->tryLoadCover(
                 this,
                 coverInfo,
-                option.rect.width() * scaleFactor,
+                m_coverWidth,
                 m_inhibitLazyLoading ? CoverArtCache::Loading::CachedOnly : CoverArtCache::Loading::Default);
         if (pixmap.isNull()) {
             // Cache miss
@@ -62,6 +62,10 @@ class BaseCoverArtDelegate : public TableItemDelegate {
     TrackPointer loadTrackByLocation(
             const QString& trackLocation) const;
 
+    // Prefetches the covers of the rows within one page above and below
+    // the visible rows of the table view.
+    void prefetchCoversAroundViewport();
+
     virtual CoverInfo coverInfoForIndex(
             const QModelIndex& index) const = 0;
 
@@ -72,4 +76,6 @@ class BaseCoverArtDelegate : public TableItemDelegate {
     // these are marked mutable.
     mutable QList<int> m_cacheMissRows;
     mutable QHash<mixxx::cache_key_t, int> m_pendingCacheRows;
+    // The width of the painted covers in device pixels
+    mutable int m_coverWidth;
 };
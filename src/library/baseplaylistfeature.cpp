@@ -586,11 +586,14 @@ void BasePlaylistFeature::slotExportTrackFiles() {
     pPlaylistTableModel->select();
 
     int rows = pPlaylistTableModel->rowCount();
-    QList<TrackPointer> tracks;
+    QList<TrackId> trackIds;
+    trackIds.reserve(rows);
     for (int i = 0; i < rows; ++i) {
         QModelIndex index = pPlaylistTableModel->index(i, 0);
-        tracks.push_back(pPlaylistTableModel->getTrack(index));
+        trackIds.push_back(pPlaylistTableModel->getTrackId(index));
     }
+    const TrackPointerList tracks =
+            m_pLibrary->trackCollections()->internalCollection()->getTracksById(trackIds);
 
     TrackExportWizard track_export(nullptr, m_pConfig, tracks);
     track_export.exportTracks();
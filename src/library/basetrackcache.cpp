@@ -3,6 +3,8 @@
 
 #include "library/basetrackcache.h"
 
+#include <algorithm>
+
 #include "library/trackcollection.h"
 #include "library/searchqueryparser.h"
 #include "library/queryutil.h"
@@ -30,6 +32,7 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_pQueryParser(new SearchQueryParser(pTrackCollection)),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
+          m_trackInfo(columns),
           m_database(pTrackCollection->database()) {
     m_searchColumns << "artist"
                     << "album"
@@ -97,7 +100,7 @@ void BaseTrackCache::slotTracksRemoved(QSet<TrackId> trackIds) {
         qDebug() << this << "slotTracksRemoved" << trackIds.size();
     }
     for (const auto& trackId : qAsConst(trackIds)) {
-        m_trackInfo.remove(trackId);
+        m_trackInfo.removeRow(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -149,7 +152,7 @@ const TrackPointer& BaseTrackCache::getRecentTrack(TrackId trackId) const {
     if (m_recentTrackId != trackId) {
         if (trackId.isValid()) {
             TrackPointer trackPtr =
-                    GlobalTrackCacheLocker().lookupTrackById(trackId);
+                    GlobalTrackCache::lookupTrackById(trackId);
             replaceRecentTrack(
                     std::move(trackId),
                     std::move(trackPtr));
@@ -230,13 +233,12 @@ bool BaseTrackCache::updateIndexWithTrackpointer(TrackPointer pTrack) {
 
     TrackId trackId = pTrack->getId();
     if (trackId.isValid()) {
-        // m_trackInfo[id] will insert a QVector<QVariant> into the
-        // m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        // preallocate memory for all columns at once
-        record.resize(numColumns);
+        const int row = m_trackInfo.insertRow(trackId);
         for (int i = 0; i < numColumns; ++i) {
-            getTrackValueForColumn(pTrack, i, record[i]);
+            // Columns that are not provided by the track keep their value
+            QVariant value = m_trackInfo.value(trackId, i);
+            getTrackValueForColumn(pTrack, i, value);
+            m_trackInfo.setValue(row, i, value);
         }
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), std::move(pTrack));
@@ -277,21 +279,17 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
 
     while (query.next()) {
         TrackId trackId(query.value(idColumn));
-
-        //m_trackInfo[id] will insert a QVector<QVariant> into the
-        //m_trackInfo HashTable with the key "id"
-        QVector<QVariant>& record = m_trackInfo[trackId];
-        record.resize(numColumns);
+        const int row = m_trackInfo.insertRow(trackId);
 
         for (int i = 0; i < numColumns; ++i) {
             if (fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_NATIVELOCATION) == i) {
                 // Database stores all locations with Qt separators: "/"
                 // Here we want to cache the display string with native separators.
                 QString location = query.value(i).toString();
-                record[i] = QDir::toNativeSeparators(location);
+                m_trackInfo.setValue(row, i, QDir::toNativeSeparators(location));
             }
             else {
-                record[i] = query.value(i);
+                m_trackInfo.setValue(row, i, query.value(i));
             }
         }
     }
@@ -452,11 +450,7 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
     if (!result.isValid()) {
-        auto it = m_trackInfo.constFind(trackId);
-        if (it != m_trackInfo.constEnd()) {
-            const QVector<QVariant>& fields = it.value();
-            result = fields.value(column, result);
-        }
+        result = m_trackInfo.value(trackId, column);
     }
     return result;
 }
@@ -477,72 +471,117 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
-    QStringList idStrings;
     // TODO(rryan) consider making this the data passed in and a separate
     // QVector for output
     QSet<TrackId> dirtyTracks;
     for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
         if (m_dirtyTracks.contains(trackId)) {
             dirtyTracks.insert(trackId);
         }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
+    // Sorting the tracks in memory is much faster than in SQL, which has to
+    // compare strings with the collation function
+    QVector<ColumnarTrackIndex::SortSpec> sortSpecs;
+    const bool sortInMemory = !orderByClause.isEmpty() &&
+            getSortSpecs(sortColumns, columnOffset, &sortSpecs) &&
+            m_trackInfo.canSort(sortSpecs);
 
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    m_searchColumns,
-                    queryFragments.join(" AND "));
+    m_trackOrder.resize(0); // keeps allocated memory
+    trackToIndex->clear();
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
+    // The search is also evaluated in memory unless the database is needed
+    // anyway for the filter or the sort order
+    std::unique_ptr<QueryNode> pQuery;
+    bool searchedInMemory = false;
+    if (extraFilter.isEmpty() && (orderByClause.isEmpty() || sortInMemory)) {
+        pQuery = m_pQueryParser->parseQuery(
+                searchQuery, m_searchColumns, QString());
+        PerformanceTimer timer;
+        timer.start();
+        searchedInMemory = searchIndex(*pQuery, trackIds);
+        if (sDebug && searchedInMemory) {
+            qDebug() << this << "searching" << trackIds.size() << "tracks took"
+                     << timer.elapsed().debugMillisWithUnit();
+        }
     }
 
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    if (!searchedInMemory) {
+        m_trackOrder.resize(0);
+        QStringList idStrings;
+        for (const auto& trackId: trackIds) {
+            idStrings << trackId.toString();
+        }
 
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
-    }
+        QStringList queryFragments;
+        if (!extraFilter.isNull() && extraFilter != "") {
+            queryFragments << QString("(%1)").arg(extraFilter);
+        }
+        if (idStrings.size() > 0) {
+            queryFragments << QString("%1 in (%2)")
+                    .arg(m_idColumn, idStrings.join(","));
+        }
 
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
+        pQuery = m_pQueryParser->parseQuery(
+                searchQuery,
+                m_searchColumns,
+                queryFragments.join(" AND "));
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
+        QString filter = pQuery->toSql();
+        if (!filter.isEmpty()) {
+            filter.prepend("WHERE ");
+        }
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
+        QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+                .arg(m_idColumn, m_tableName, filter,
+                        sortInMemory ? QString() : orderByClause);
 
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
-    }
+        if (sDebug) {
+            qDebug() << this << "select() executing:" << queryString;
+        }
 
-    m_trackOrder.resize(0); // keeps allocated memory
-    trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
-    }
+        QSqlQuery query(m_database);
+        // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+        // won't allocate a giant in-memory table that we won't use at all.
+        query.setForwardOnly(true);
+        query.prepare(queryString);
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+        }
+
+        int idColumn = query.record().indexOf(m_idColumn);
+        int rows = query.size();
+
+        if (sDebug) {
+            qDebug() << "Rows returned:" << rows;
+        }
+
+        if (rows > 0) {
+            m_trackOrder.reserve(rows);
+        }
+
+        while (query.next()) {
+            m_trackOrder.append(TrackId(query.value(idColumn)));
+        }
+    } else if (orderByClause.isEmpty()) {
+        // Without an order the result of the database would follow the
+        // table, which is ordered by id
+        std::sort(m_trackOrder.begin(), m_trackOrder.end());
+    }
+
+    if (sortInMemory) {
+        PerformanceTimer timer;
+        timer.start();
+        m_trackInfo.sort(&m_trackOrder, sortSpecs);
+        if (sDebug) {
+            qDebug() << this << "sorting" << m_trackOrder.size() << "tracks took"
+                     << timer.elapsed().debugMillisWithUnit();
+        }
+    }
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -620,6 +659,65 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+bool BaseTrackCache::searchIndex(const QueryNode& query,
+        const QSet<TrackId>& trackIds) {
+    QueryNode::IndexRows rows;
+    if (!query.search(m_trackInfo, &rows)) {
+        return false;
+    }
+    m_trackOrder.reserve(trackIds.size());
+    for (const auto& trackId: trackIds) {
+        const int row = m_trackInfo.row(trackId);
+        if (row < 0) {
+            // Only the database knows this track
+            return false;
+        }
+        if (rows.neutral || rows.matching.testBit(row)) {
+            m_trackOrder.append(trackId);
+        }
+    }
+    return true;
+}
+
+bool BaseTrackCache::getSortSpecs(const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QVector<ColumnarTrackIndex::SortSpec>* pSortSpecs) const {
+    for (const auto& sc : sortColumns) {
+        const int column = sc.m_column - columnOffset;
+        if (column <= 0 || column >= columnCount()) {
+            // The id, random order and columns of the table model
+            return false;
+        }
+        ColumnarTrackIndex::SortSpec spec{
+                column, sc.m_order, ColumnarTrackIndex::SortMode::Natural, {}};
+
+        // Mirror the sort expressions of ColumnCache
+        const QString columnName = columnNameForFieldIndex(column);
+        const QString columnSort = columnSortForFieldIndex(column);
+        if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
+            spec.column = fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID);
+            if (spec.column < 0) {
+                return false;
+            }
+            spec.mode = ColumnarTrackIndex::SortMode::Mapped;
+            const KeyUtils::KeyNotation keyNotation = m_columnCache.keyNotation();
+            for (int key = 0; key <= 24; ++key) {
+                spec.integerOrder.append(KeyUtils::keyToCircleOfFifthsOrder(
+                        static_cast<mixxx::track::io::key::ChromaticKey>(key),
+                        keyNotation));
+            }
+        } else if (columnSort == QString("lower(%1)").arg(columnName)) {
+            spec.mode = ColumnarTrackIndex::SortMode::Text;
+        } else if (columnSort == QString("cast(%1 as integer)").arg(columnName)) {
+            spec.mode = ColumnarTrackIndex::SortMode::Integer;
+        } else if (columnSort != columnName) {
+            return false;
+        }
+        pSortSpecs->append(spec);
+    }
+    return true;
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
@@ -11,11 +11,13 @@
 
 #include <memory>
 
+#include "library/columnartrackindex.h"
 #include "library/columncache.h"
 #include "track/track.h"
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -95,6 +97,14 @@ class BaseTrackCache : public QObject {
     void getTrackValueForColumn(TrackPointer pTrack, int column,
                                 QVariant& trackValue) const;
 
+    // Fills m_trackOrder with the tracks that match the query by searching
+    // the index. Returns false if the query or one of the tracks is not
+    // supported by the index.
+    bool searchIndex(const QueryNode& query, const QSet<TrackId>& trackIds);
+    // Returns false if the columns can only be sorted by SQL
+    bool getSortSpecs(const QList<SortColumn>& sortColumns,
+                      const int columnOffset,
+                      QVector<ColumnarTrackIndex::SortSpec>* pSortSpecs) const;
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -141,7 +151,7 @@ class BaseTrackCache : public QObject {
 
     bool m_bIndexBuilt;
     bool m_bIsCaching;
-    QHash<TrackId, QVector<QVariant> > m_trackInfo;
+    ColumnarTrackIndex m_trackInfo;
     QSqlDatabase m_database;
     ControlProxy* m_pKeyNotationCP;
 
@@ -0,0 +1,626 @@
+#include "library/columnartrackindex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+// Up to this many new strings of a column are inserted into the existing
+// collation order one by one. More are ranked from scratch.
+const int kMaxInsertedStrings = 256;
+
+// Like "cast(string as integer)" in SQLite: An optional sign and the
+// leading digits after whitespace, or 0
+qint64 leadingInteger(const QString& string) {
+    int i = 0;
+    while (i < string.size() && string[i].isSpace()) {
+        ++i;
+    }
+    bool negative = false;
+    if (i < string.size() && (string[i] == '-' || string[i] == '+')) {
+        negative = string[i] == '-';
+        ++i;
+    }
+    qint64 result = 0;
+    while (i < string.size() && string[i] >= '0' && string[i] <= '9') {
+        result = result * 10 + (string[i].unicode() - '0');
+        ++i;
+    }
+    return negative ? -result : result;
+}
+
+// The text of a number when SQLite converts it for LIKE
+QString sqliteText(double value) {
+    QString text = QString::number(value, 'g', 15);
+    if (std::isfinite(value) && !text.contains('.') && !text.contains('e')) {
+        text.append(".0");
+    }
+    return text;
+}
+
+// Like LIKE '%argument%' as generated by TextFilterNode, which appends a
+// '_' to a trailing space
+bool containsArgument(const QString& text, const QString& argument) {
+    if (argument.isEmpty() || !argument[argument.size() - 1].isSpace()) {
+        return text.contains(argument);
+    }
+    for (int pos = text.indexOf(argument); pos >= 0;
+            pos = text.indexOf(argument, pos + 1)) {
+        if (pos + argument.size() < text.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isTokenCharacter(QChar c) {
+    return c.isLetterOrNumber();
+}
+
+quint64 trigramKey(const QString& string, int pos) {
+    return (static_cast<quint64>(string[pos].unicode()) << 32) |
+            (static_cast<quint64>(string[pos + 1].unicode()) << 16) |
+            string[pos + 2].unicode();
+}
+
+} // anonymous namespace
+
+quint32 ColumnarTrackIndex::StringPool::intern(const QString& string) {
+    const auto it = m_ids.constFind(string);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+    const quint32 id = m_strings.size();
+    m_strings.append(string);
+    m_ids.insert(string, id);
+    return id;
+}
+
+void ColumnarTrackIndex::StringPool::clear() {
+    m_strings.clear();
+    m_ids.clear();
+    m_sortedIds.clear();
+    m_equalToPrevious.clear();
+    m_ranks.clear();
+    m_foldedStrings.clear();
+    m_tokens.clear();
+    m_tokenIds.clear();
+    m_stringsOfTokens.clear();
+    m_tokensOfTrigrams.clear();
+}
+
+void ColumnarTrackIndex::StringPool::updateRanks(const StringCollator& collator) {
+    const int numRanked = m_sortedIds.size();
+    const int numStrings = m_strings.size();
+    if (numRanked == numStrings) {
+        return;
+    }
+
+    if (numStrings - numRanked <= kMaxInsertedStrings) {
+        const auto compare = [this, &collator](quint32 lhs, quint32 rhs) {
+            return collator.compare(m_strings[lhs], m_strings[rhs]);
+        };
+        for (quint32 id = numRanked; id < static_cast<quint32>(numStrings); ++id) {
+            const int pos = std::upper_bound(
+                                    m_sortedIds.constBegin(),
+                                    m_sortedIds.constEnd(),
+                                    id,
+                                    [&compare](quint32 lhs, quint32 rhs) {
+                                        return compare(lhs, rhs) < 0;
+                                    }) -
+                    m_sortedIds.constBegin();
+            m_sortedIds.insert(pos, id);
+            m_equalToPrevious.insert(pos,
+                    pos > 0 && compare(m_sortedIds[pos - 1], id) == 0);
+            if (pos + 1 < m_sortedIds.size()) {
+                m_equalToPrevious[pos + 1] =
+                        compare(id, m_sortedIds[pos + 1]) == 0;
+            }
+        }
+    } else {
+        std::vector<QCollatorSortKey> keys;
+        keys.reserve(numStrings);
+        for (const auto& string : qAsConst(m_strings)) {
+            keys.push_back(collator.sortKey(string));
+        }
+        m_sortedIds.resize(numStrings);
+        std::iota(m_sortedIds.begin(), m_sortedIds.end(), 0);
+        std::sort(m_sortedIds.begin(),
+                m_sortedIds.end(),
+                [&keys](quint32 lhs, quint32 rhs) {
+                    return keys[lhs].compare(keys[rhs]) < 0;
+                });
+        m_equalToPrevious.resize(numStrings);
+        for (int i = 0; i < numStrings; ++i) {
+            m_equalToPrevious[i] = i > 0 &&
+                    keys[m_sortedIds[i - 1]].compare(keys[m_sortedIds[i]]) == 0;
+        }
+    }
+
+    m_ranks.resize(numStrings);
+    quint32 rank = 0;
+    for (int i = 0; i < numStrings; ++i) {
+        if (i > 0 && !m_equalToPrevious[i]) {
+            ++rank;
+        }
+        m_ranks[m_sortedIds[i]] = rank;
+    }
+}
+
+void ColumnarTrackIndex::StringPool::updateSearchIndex() const {
+    for (quint32 id = m_foldedStrings.size();
+            id < static_cast<quint32>(m_strings.size());
+            ++id) {
+        QString folded = m_strings[id];
+        mixxx::DbConnection::makeStringLatinLow(&folded);
+        int start = -1;
+        for (int i = 0; i <= folded.size(); ++i) {
+            const bool tokenCharacter = i < folded.size() && isTokenCharacter(folded[i]);
+            if (tokenCharacter && start < 0) {
+                start = i;
+            } else if (!tokenCharacter && start >= 0) {
+                addToken(folded.mid(start, i - start), id);
+                start = -1;
+            }
+        }
+        m_foldedStrings.append(folded);
+    }
+}
+
+void ColumnarTrackIndex::StringPool::addToken(
+        const QString& token, quint32 stringId) const {
+    const auto it = m_tokenIds.constFind(token);
+    if (it != m_tokenIds.constEnd()) {
+        QVector<quint32>& strings = m_stringsOfTokens[it.value()];
+        // A string may contain the same token more than once
+        if (strings.last() != stringId) {
+            strings.append(stringId);
+        }
+        return;
+    }
+    const quint32 tokenId = m_tokens.size();
+    m_tokens.append(token);
+    m_tokenIds.insert(token, tokenId);
+    m_stringsOfTokens.append(QVector<quint32>{stringId});
+    for (int pos = 0; pos + 3 <= token.size(); ++pos) {
+        QVector<quint32>& tokens = m_tokensOfTrigrams[trigramKey(token, pos)];
+        if (tokens.isEmpty() || tokens.last() != tokenId) {
+            tokens.append(tokenId);
+        }
+    }
+}
+
+QBitArray ColumnarTrackIndex::StringPool::stringsContaining(
+        const QString& argument) const {
+    updateSearchIndex();
+    QBitArray result(m_strings.size());
+    if (argument.isEmpty() ||
+            !std::all_of(argument.begin(), argument.end(), isTokenCharacter)) {
+        // The argument may span several tokens
+        for (int id = 0; id < m_foldedStrings.size(); ++id) {
+            if (containsArgument(m_foldedStrings[id], argument)) {
+                result.setBit(id);
+            }
+        }
+        return result;
+    }
+
+    // The argument can only be found within a token. Only the tokens that
+    // contain all trigrams of the argument need to be checked, which are
+    // among those of its rarest trigram.
+    const QVector<quint32>* pCandidates = nullptr;
+    for (int pos = 0; pos + 3 <= argument.size(); ++pos) {
+        const auto it = m_tokensOfTrigrams.constFind(trigramKey(argument, pos));
+        if (it == m_tokensOfTrigrams.constEnd()) {
+            return result;
+        }
+        if (!pCandidates || it.value().size() < pCandidates->size()) {
+            pCandidates = &it.value();
+        }
+    }
+    const auto addStringsOfToken = [this, &result](quint32 tokenId) {
+        for (quint32 id : qAsConst(m_stringsOfTokens[tokenId])) {
+            result.setBit(id);
+        }
+    };
+    if (pCandidates) {
+        for (quint32 tokenId : *pCandidates) {
+            if (m_tokens[tokenId].contains(argument)) {
+                addStringsOfToken(tokenId);
+            }
+        }
+    } else {
+        // Too short for trigrams, but the tokens are still far fewer than
+        // the strings
+        for (quint32 tokenId = 0; tokenId < static_cast<quint32>(m_tokens.size());
+                ++tokenId) {
+            if (m_tokens[tokenId].contains(argument)) {
+                addStringsOfToken(tokenId);
+            }
+        }
+    }
+    return result;
+}
+
+ColumnarTrackIndex::ColumnarTrackIndex(const QStringList& columnNames)
+        : m_columnNames(columnNames),
+          m_columns(columnNames.size()),
+          m_numRows(0) {
+}
+
+void ColumnarTrackIndex::clear() {
+    const int numColumns = m_columns.size();
+    m_columns.clear();
+    m_columns.resize(numColumns);
+    m_rowsByTrackId.clear();
+    m_freeRows.clear();
+    m_usedRows.clear();
+    m_numRows = 0;
+}
+
+int ColumnarTrackIndex::insertRow(TrackId trackId) {
+    const auto it = m_rowsByTrackId.constFind(trackId);
+    if (it != m_rowsByTrackId.constEnd()) {
+        return it.value();
+    }
+    int row;
+    if (m_freeRows.isEmpty()) {
+        row = m_numRows++;
+        Cell invalid;
+        invalid.integer = QVariant::Invalid;
+        for (auto& column : m_columns) {
+            column.types.push_back(CellType::Null);
+            column.cells.push_back(invalid);
+        }
+        m_usedRows.resize(m_numRows);
+    } else {
+        row = m_freeRows.takeLast();
+    }
+    m_usedRows.setBit(row);
+    m_rowsByTrackId.insert(trackId, row);
+    return row;
+}
+
+void ColumnarTrackIndex::removeRow(TrackId trackId) {
+    const auto it = m_rowsByTrackId.find(trackId);
+    if (it == m_rowsByTrackId.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_rowsByTrackId.erase(it);
+    for (int column = 0; column < m_columns.size(); ++column) {
+        setValue(row, column, QVariant());
+    }
+    m_freeRows.append(row);
+    m_usedRows.clearBit(row);
+}
+
+void ColumnarTrackIndex::countCell(Column* pColumn, CellType type, int delta) {
+    switch (type) {
+    case CellType::Bool:
+    case CellType::Int:
+    case CellType::UInt:
+    case CellType::LongLong:
+    case CellType::Double:
+        pColumn->numNumbers += delta;
+        break;
+    case CellType::Other:
+        pColumn->numOthers += delta;
+        break;
+    case CellType::Null:
+    case CellType::String:
+        break;
+    }
+}
+
+void ColumnarTrackIndex::setValue(int row, int column, const QVariant& value) {
+    VERIFY_OR_DEBUG_ASSERT(row >= 0 && row < m_numRows &&
+            column >= 0 && column < m_columns.size()) {
+        return;
+    }
+    Column& col = m_columns[column];
+    CellType& type = col.types[row];
+    Cell& cell = col.cells[row];
+    const CellType oldType = type;
+
+    if (value.isNull()) {
+        type = CellType::Null;
+        cell.integer = value.userType();
+    } else {
+        switch (value.type()) {
+        case QVariant::Bool:
+            type = CellType::Bool;
+            cell.integer = value.toBool();
+            break;
+        case QVariant::Int:
+            type = CellType::Int;
+            cell.integer = value.toInt();
+            break;
+        case QVariant::UInt:
+            type = CellType::UInt;
+            cell.integer = value.toUInt();
+            break;
+        case QVariant::LongLong:
+            type = CellType::LongLong;
+            cell.integer = value.toLongLong();
+            break;
+        case QVariant::Double:
+            type = CellType::Double;
+            cell.real = value.toDouble();
+            break;
+        case QVariant::String:
+            type = CellType::String;
+            cell.index = col.strings.intern(value.toString());
+            break;
+        default:
+            // Reuse the slot of a previous value
+            if (oldType == CellType::Other) {
+                col.others[cell.index] = value;
+            } else {
+                cell.index = col.others.size();
+                col.others.append(value);
+            }
+            type = CellType::Other;
+            break;
+        }
+    }
+
+    countCell(&col, oldType, -1);
+    countCell(&col, type, 1);
+}
+
+QVariant ColumnarTrackIndex::value(TrackId trackId, int column) const {
+    const int row = m_rowsByTrackId.value(trackId, -1);
+    if (row < 0 || column < 0 || column >= m_columns.size()) {
+        return QVariant();
+    }
+    return cellValue(m_columns[column], row);
+}
+
+QVariant ColumnarTrackIndex::cellValue(const Column& col, int row) const {
+    const Cell cell = col.cells[row];
+    switch (col.types[row]) {
+    case CellType::Null:
+        return QVariant(static_cast<int>(cell.integer), nullptr);
+    case CellType::Bool:
+        return QVariant(cell.integer != 0);
+    case CellType::Int:
+        return QVariant(static_cast<int>(cell.integer));
+    case CellType::UInt:
+        return QVariant(static_cast<uint>(cell.integer));
+    case CellType::LongLong:
+        return QVariant(static_cast<qlonglong>(cell.integer));
+    case CellType::Double:
+        return QVariant(cell.real);
+    case CellType::String:
+        return QVariant(col.strings.string(cell.index));
+    case CellType::Other:
+        return col.others[cell.index];
+    }
+    return QVariant();
+}
+
+bool ColumnarTrackIndex::canSort(const QVector<SortSpec>& specs) const {
+    for (const auto& spec : specs) {
+        if (spec.column < 0 || spec.column >= m_columns.size()) {
+            return false;
+        }
+        const Column& col = m_columns[spec.column];
+        if (col.numOthers > 0) {
+            return false;
+        }
+        if (spec.mode == SortMode::Text && col.numNumbers > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ColumnarTrackIndex::SortKey ColumnarTrackIndex::sortKey(
+        const SortSpec& spec, int row) const {
+    const SortKey null{0, 0.0};
+    if (row < 0) {
+        return null;
+    }
+    const Column& col = m_columns[spec.column];
+    const Cell cell = col.cells[row];
+    switch (col.types[row]) {
+    case CellType::Bool:
+    case CellType::Int:
+    case CellType::UInt:
+    case CellType::LongLong:
+        if (spec.mode == SortMode::Mapped) {
+            if (cell.integer < 0 || cell.integer >= spec.integerOrder.size()) {
+                return null;
+            }
+            return SortKey{1, static_cast<double>(spec.integerOrder[cell.integer])};
+        }
+        return SortKey{1, static_cast<double>(cell.integer)};
+    case CellType::Double:
+        if (spec.mode == SortMode::Mapped) {
+            return null;
+        }
+        if (spec.mode == SortMode::Integer) {
+            return SortKey{1, std::trunc(cell.real)};
+        }
+        return SortKey{1, cell.real};
+    case CellType::String:
+        if (spec.mode == SortMode::Mapped) {
+            return null;
+        }
+        if (spec.mode == SortMode::Integer) {
+            return SortKey{1,
+                    static_cast<double>(
+                            leadingInteger(col.strings.string(cell.index)))};
+        }
+        return SortKey{2, static_cast<double>(col.strings.rank(cell.index))};
+    case CellType::Null:
+    case CellType::Other:
+        break;
+    }
+    return null;
+}
+
+void ColumnarTrackIndex::sort(
+        QVector<TrackId>* pTrackIds, const QVector<SortSpec>& specs) {
+    DEBUG_ASSERT(canSort(specs));
+    for (const auto& spec : specs) {
+        if (spec.mode == SortMode::Natural || spec.mode == SortMode::Text) {
+            m_columns[spec.column].strings.updateRanks(m_collator);
+        }
+    }
+
+    // One key for every track and sort column
+    const int numTracks = pTrackIds->size();
+    const int numSpecs = specs.size();
+    std::vector<SortKey> keys(numTracks * numSpecs);
+    for (int i = 0; i < numTracks; ++i) {
+        const int row = m_rowsByTrackId.value(pTrackIds->at(i), -1);
+        for (int j = 0; j < numSpecs; ++j) {
+            keys[i * numSpecs + j] = sortKey(specs[j], row);
+        }
+    }
+
+    std::vector<int> order(numTracks);
+    std::iota(order.begin(), order.end(), 0);
+    const QVector<TrackId>& trackIds = *pTrackIds;
+    std::sort(order.begin(),
+            order.end(),
+            [&keys, &specs, &trackIds, numSpecs](int lhs, int rhs) {
+                const SortKey* pLhs = &keys[lhs * numSpecs];
+                const SortKey* pRhs = &keys[rhs * numSpecs];
+                for (int j = 0; j < numSpecs; ++j) {
+                    int compare = pLhs[j].typeOrder - pRhs[j].typeOrder;
+                    if (compare == 0 && pLhs[j].value != pRhs[j].value) {
+                        compare = pLhs[j].value < pRhs[j].value ? -1 : 1;
+                    }
+                    if (compare != 0) {
+                        return (specs[j].order == Qt::AscendingOrder) ==
+                                (compare < 0);
+                    }
+                }
+                return trackIds[lhs] < trackIds[rhs];
+            });
+
+    QVector<TrackId> sortedTrackIds;
+    sortedTrackIds.reserve(numTracks);
+    for (int i : order) {
+        sortedTrackIds.append(trackIds[i]);
+    }
+    pTrackIds->swap(sortedTrackIds);
+}
+
+QBitArray ColumnarTrackIndex::rowsOfTracks(
+        const std::vector<TrackId>& trackIds) const {
+    QBitArray rows(m_numRows);
+    for (const auto& trackId : trackIds) {
+        const int row = m_rowsByTrackId.value(trackId, -1);
+        if (row >= 0) {
+            rows.setBit(row);
+        }
+    }
+    return rows;
+}
+
+QBitArray ColumnarTrackIndex::rowsWithNull(int column) const {
+    QBitArray rows(m_numRows);
+    VERIFY_OR_DEBUG_ASSERT(column >= 0 && column < m_columns.size()) {
+        return rows;
+    }
+    const Column& col = m_columns[column];
+    for (int row = 0; row < m_numRows; ++row) {
+        if (col.types[row] == CellType::Null) {
+            rows.setBit(row);
+        }
+    }
+    // The rows of removed tracks are NULL, too
+    return rows & m_usedRows;
+}
+
+QBitArray ColumnarTrackIndex::rowsContaining(
+        int column, const QString& argument) const {
+    QBitArray rows(m_numRows);
+    VERIFY_OR_DEBUG_ASSERT(column >= 0 && column < m_columns.size()) {
+        return rows;
+    }
+    const Column& col = m_columns[column];
+    const QBitArray strings = col.strings.stringsContaining(argument);
+    for (int row = 0; row < m_numRows; ++row) {
+        const Cell cell = col.cells[row];
+        QString text;
+        switch (col.types[row]) {
+        case CellType::Null:
+            continue;
+        case CellType::String:
+            if (strings.testBit(cell.index)) {
+                rows.setBit(row);
+            }
+            continue;
+        case CellType::Bool:
+        case CellType::Int:
+        case CellType::UInt:
+        case CellType::LongLong:
+            text = QString::number(cell.integer);
+            break;
+        case CellType::Double:
+            text = sqliteText(cell.real);
+            break;
+        case CellType::Other:
+            text = col.others[cell.index].toString();
+            mixxx::DbConnection::makeStringLatinLow(&text);
+            break;
+        }
+        if (containsArgument(text, argument)) {
+            rows.setBit(row);
+        }
+    }
+    return rows;
+}
+
+QBitArray ColumnarTrackIndex::rowsMatching(int column,
+        const std::function<bool(double)>& numberPredicate,
+        const std::function<bool(const QString&)>& stringPredicate) const {
+    QBitArray rows(m_numRows);
+    VERIFY_OR_DEBUG_ASSERT(column >= 0 && column < m_columns.size()) {
+        return rows;
+    }
+    const Column& col = m_columns[column];
+    // 0: not evaluated yet, 1: match, 2: no match
+    std::vector<quint8> stringMatches(col.strings.size(), 0);
+    for (int row = 0; row < m_numRows; ++row) {
+        const Cell cell = col.cells[row];
+        bool match = false;
+        switch (col.types[row]) {
+        case CellType::Null:
+            break;
+        case CellType::Bool:
+        case CellType::Int:
+        case CellType::UInt:
+        case CellType::LongLong:
+            match = numberPredicate(static_cast<double>(cell.integer));
+            break;
+        case CellType::Double:
+            match = numberPredicate(cell.real);
+            break;
+        case CellType::String: {
+            quint8& stringMatch = stringMatches[cell.index];
+            if (stringMatch == 0) {
+                stringMatch = stringPredicate(col.strings.string(cell.index)) ? 1 : 2;
+            }
+            match = stringMatch == 1;
+            break;
+        }
+        case CellType::Other:
+            match = stringPredicate(col.others[cell.index].toString());
+            break;
+        }
+        if (match) {
+            rows.setBit(row);
+        }
+    }
+    return rows;
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+#include <functional>
+#include <vector>
+
+#include "track/trackid.h"
+#include "util/class.h"
+#include "util/string.h"
+
+// A typed, column oriented store for the rows of a BaseTrackCache.
+//
+// Every column holds a one byte type tag and an 8 byte cell per row instead
+// of a QVariant. Strings are interned per column, so the artists, albums
+// and genres that repeat all over a library are stored only once. Values
+// that are neither numbers nor strings are kept aside as QVariants.
+//
+// Sorting never compares QVariants or strings. Numbers are compared
+// directly and strings by their rank in the collation order of their
+// column, which is computed from collation sort keys on the first sort and
+// then maintained incrementally as strings are added.
+//
+// The search functions evaluate conditions for all rows at once and return
+// a bit per row. Text searches use a token and trigram index of the folded
+// strings of each column that is built on the first search of a column and
+// extended as strings are added.
+class ColumnarTrackIndex {
+  public:
+    enum class SortMode {
+        // NULL before numbers before strings, like SQLite
+        Natural,
+        // Like "lower(column)". Only supported if the column contains no
+        // numbers.
+        Text,
+        // Like "cast(column as integer)"
+        Integer,
+        // Integer values are mapped through SortSpec::integerOrder, all
+        // other values sort like NULL
+        Mapped,
+    };
+
+    struct SortSpec {
+        int column;
+        Qt::SortOrder order;
+        SortMode mode;
+        QVector<int> integerOrder;
+    };
+
+    explicit ColumnarTrackIndex(const QStringList& columnNames);
+
+    int columnCount() const {
+        return m_columns.size();
+    }
+    // Returns -1 for unknown columns
+    int columnIndex(const QString& columnName) const {
+        return m_columnNames.indexOf(columnName);
+    }
+    int size() const {
+        return m_rowsByTrackId.size();
+    }
+    bool contains(TrackId trackId) const {
+        return m_rowsByTrackId.contains(trackId);
+    }
+    // The number of rows including those of removed tracks, i.e. the size
+    // of the bit arrays returned by the search functions
+    int rowCount() const {
+        return m_numRows;
+    }
+    // Returns -1 for unknown tracks
+    int row(TrackId trackId) const {
+        return m_rowsByTrackId.value(trackId, -1);
+    }
+
+    // Removes all rows and all interned strings
+    void clear();
+
+    // Returns the row of the track, which is appended if needed. All
+    // values of a new row are invalid.
+    int insertRow(TrackId trackId);
+    void removeRow(TrackId trackId);
+
+    void setValue(int row, int column, const QVariant& value);
+    // Returns an invalid QVariant for unknown tracks or columns
+    QVariant value(TrackId trackId, int column) const;
+
+    // Whether sort() supports the specs with the current contents
+    bool canSort(const QVector<SortSpec>& specs) const;
+    // Sorts the tracks by the given columns. Ties are ordered by track id
+    // and unknown tracks sort like rows that contain only NULL.
+    void sort(QVector<TrackId>* pTrackIds, const QVector<SortSpec>& specs);
+
+    // The rows of all tracks
+    QBitArray allRows() const {
+        return m_usedRows;
+    }
+    QBitArray rowsOfTracks(const std::vector<TrackId>& trackIds) const;
+    QBitArray rowsWithNull(int column) const;
+    // Rows whose value contains the argument, like "column LIKE '%argument%'"
+    // with the LIKE function of DbConnection. The argument must be folded
+    // with DbConnection::makeStringLatinLow() and must not contain LIKE
+    // wildcards. A trailing space must be followed by another character.
+    QBitArray rowsContaining(int column, const QString& argument) const;
+    // Rows with a number that fulfills numberPredicate or with a string that
+    // fulfills stringPredicate. Values that are neither are passed to
+    // stringPredicate as text. The string predicate is evaluated only once
+    // for every distinct string.
+    QBitArray rowsMatching(int column,
+            const std::function<bool(double)>& numberPredicate,
+            const std::function<bool(const QString&)>& stringPredicate) const;
+
+  private:
+    enum class CellType : quint8 {
+        // The payload is the QVariant::Type of the null value
+        Null,
+        Bool,
+        Int,
+        UInt,
+        LongLong,
+        Double,
+        String,
+        Other,
+    };
+
+    union Cell {
+        qint64 integer;
+        double real;
+        quint32 index;
+    };
+
+    class StringPool {
+      public:
+        quint32 intern(const QString& string);
+        const QString& string(quint32 id) const {
+            return m_strings[id];
+        }
+        int size() const {
+            return m_strings.size();
+        }
+        void clear();
+
+        // Strings that are equal for the collator have the same rank
+        void updateRanks(const StringCollator& collator);
+        quint32 rank(quint32 id) const {
+            return m_ranks[id];
+        }
+
+        // Returns a bit for every string that contains the folded argument
+        QBitArray stringsContaining(const QString& argument) const;
+
+      private:
+        // Folds and tokenizes the strings that have been added since the
+        // last search
+        void updateSearchIndex() const;
+        void addToken(const QString& token, quint32 stringId) const;
+
+
+        QVector<QString> m_strings;
+        QHash<QString, quint32> m_ids;
+        // The ids of the ranked strings in collation order and whether
+        // each is equal to its predecessor
+        QVector<quint32> m_sortedIds;
+        QVector<bool> m_equalToPrevious;
+        QVector<quint32> m_ranks;
+
+        // The tokens are the maximal runs of letters and numbers of the
+        // folded strings. Every trigram maps to the tokens that contain it.
+        mutable QVector<QString> m_foldedStrings;
+        mutable QVector<QString> m_tokens;
+        mutable QHash<QString, quint32> m_tokenIds;
+        mutable QVector<QVector<quint32>> m_stringsOfTokens;
+        mutable QHash<quint64, QVector<quint32>> m_tokensOfTrigrams;
+    };
+
+    struct Column {
+        std::vector<CellType> types;
+        std::vector<Cell> cells;
+        StringPool strings;
+        QVector<QVariant> others;
+        int numNumbers = 0;
+        int numOthers = 0;
+    };
+
+    struct SortKey {
+        // 0: NULL, 1: number, 2: string, like SQLite
+        int typeOrder;
+        double value;
+    };
+
+    void countCell(Column* pColumn, CellType type, int delta);
+    QVariant cellValue(const Column& col, int row) const;
+    SortKey sortKey(const SortSpec& spec, int row) const;
+
+    const QStringList m_columnNames;
+    QVector<Column> m_columns;
+    QHash<TrackId, int> m_rowsByTrackId;
+    QVector<int> m_freeRows;
+    QBitArray m_usedRows;
+    int m_numRows;
+
+    const StringCollator m_collator;
+
+    DISALLOW_COPY_AND_ASSIGN(ColumnarTrackIndex);
+};
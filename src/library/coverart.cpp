@@ -1,5 +1,7 @@
 #include "library/coverart.h"
 
+#include <QImageReader>
+
 #include "library/coverartutils.h"
 #include "util/debug.h"
 #include "util/logger.h"
@@ -84,7 +86,8 @@ QDebug operator<<(QDebug dbg, const CoverInfoRelative& infoRelative) {
 }
 
 QImage CoverInfo::loadImage(
-        const SecurityTokenPointer& pTrackLocationToken) const {
+        const SecurityTokenPointer& pTrackLocationToken,
+        int desiredWidth) const {
     if (type == CoverInfo::METADATA) {
         VERIFY_OR_DEBUG_ASSERT(!trackLocation.isEmpty()) {
             kLogger.warning()
@@ -132,7 +135,14 @@ QImage CoverInfo::loadImage(
                 Sandbox::openSecurityToken(
                         coverFile,
                         true);
-        return QImage(coverFile.filePath());
+        QImageReader reader(coverFile.filePath());
+        const QSize size = reader.size();
+        if (desiredWidth > 0 && size.isValid() && size.width() > desiredWidth) {
+            // Preserve the aspect ratio like QImage::scaledToWidth()
+            reader.setScaledSize(QSize(desiredWidth,
+                    qMax(1, size.height() * desiredWidth / size.width())));
+        }
+        return reader.read();
     } else if (type == CoverInfo::NONE) {
         return QImage();
     } else {
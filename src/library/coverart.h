@@ -85,8 +85,12 @@ class CoverInfo : public CoverInfoRelative {
     CoverInfo(CoverInfo&&) = default;
     CoverInfo& operator=(CoverInfo&&) = default;
 
+    // Image files are decoded at the desired width (if > 0) if they are
+    // larger and their format supports it. Embedded images are always
+    // decoded at their original size.
     QImage loadImage(
-            const SecurityTokenPointer& pTrackLocationToken = SecurityTokenPointer()) const;
+            const SecurityTokenPointer& pTrackLocationToken = SecurityTokenPointer(),
+            int desiredWidth = 0) const;
 
     // Verify the image hash and update it if necessary.
     // If the corresponding image has already been loaded it
@@ -1,5 +1,4 @@
 #include <QFutureWatcher>
-#include <QPixmapCache>
 #include <QtConcurrentRun>
 #include <QtDebug>
 
@@ -13,14 +12,23 @@ namespace {
 
 mixxx::Logger kLogger("CoverArtCache");
 
-// The initial QPixmapCache limit is 10MB.
-// But it is not used just by the coverArt stuff,
-// it is also used by Qt to handle other things behind the scenes.
-// Consequently coverArt cache will always have less than those
-// 10MB available to store the pixmaps.
-// So, we must increase this size a bit more,
-// in order to allow CoverCache handle more covers (performance gain).
-constexpr int kPixmapCacheLimit = 20480;
+// The covers of the library table are cached in a dedicated LRU cache
+// instead of the QPixmapCache that is shared with Qt. A 64x64 cover
+// takes 16 KB, i.e. the budget is sufficient for ~1000 rows.
+constexpr int kPixmapCacheBudgetBytes = 16 * 1024 * 1024;
+
+// Covers are loaded by a few threads, most of them are decoded from
+// the same disk
+constexpr int kMaxConcurrentLoads = 2;
+
+// Requests beyond this limit are dropped, starting with the oldest
+// ones that belong to rows that have most likely been scrolled out of
+// view
+constexpr int kMaxPendingRequests = 256;
+
+int pixmapCost(const QPixmap& pixmap) {
+    return pixmap.width() * pixmap.height() * pixmap.depth() / 8;
+}
 
 QString pixmapCacheKey(quint16 hash, int width) {
     return QString("CoverArtCache_%1_%2")
@@ -37,8 +45,10 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
 
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
-    QPixmapCache::setCacheLimit(kPixmapCacheLimit);
+CoverArtCache::CoverArtCache()
+        : m_activeLoads(0),
+          m_pixmapCache(kPixmapCacheBudgetBytes) {
+    m_loaderThreadPool.setMaxThreadCount(kMaxConcurrentLoads);
 }
 
 //static
@@ -97,8 +107,16 @@ QPixmap CoverArtCache::tryLoadCover(
 
     // keep a list of trackIds for which a future is currently running
     // to avoid loading the same picture again while we are loading it
-    QPair<const QObject*, quint16> requestId = qMakePair(pRequestor, coverInfo.hash);
+    const RequestId requestId = qMakePair(pRequestor, coverInfo.hash);
     if (m_runningRequests.contains(requestId)) {
+        // A cover that is about to be displayed should no longer wait
+        // behind the visible ones if it has been prefetched.
+        for (int i = 0; i < m_prefetchRequests.size(); ++i) {
+            if (requestIdOf(m_prefetchRequests.at(i)) == requestId) {
+                enqueueRequest(&m_visibleRequests, m_prefetchRequests.takeAt(i));
+                break;
+            }
+        }
         return QPixmap();
     }
 
@@ -110,7 +128,8 @@ QPixmap CoverArtCache::tryLoadCover(
     QString cacheKey = pixmapCacheKey(coverInfo.hash, desiredWidth);
 
     QPixmap pixmap;
-    if (QPixmapCache::find(cacheKey, &pixmap)) {
+    if (const QPixmap* pCached = m_pixmapCache.object(cacheKey)) {
+        pixmap = *pCached;
         if (kLogger.traceEnabled()) {
             kLogger.trace()
                     << "requestCover cache hit"
@@ -132,27 +151,119 @@ QPixmap CoverArtCache::tryLoadCover(
 
     if (kLogger.traceEnabled()) {
         kLogger.trace()
-                << "requestCover starting future for"
+                << "requestCover queueing"
                 << coverInfo;
     }
     m_runningRequests.insert(requestId);
-    // The watcher will be deleted in coverLoaded()
-    QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
-    QFuture<FutureResult> future = QtConcurrent::run(
-            &CoverArtCache::loadCover,
-            pRequestor,
-            pTrack,
-            coverInfo,
-            desiredWidth,
-            loading == Loading::Default);
-    connect(watcher,
-            &QFutureWatcher<FutureResult>::finished,
-            this,
-            &CoverArtCache::coverLoaded);
-    watcher->setFuture(future);
+    Request request;
+    request.pRequestor = pRequestor;
+    request.pTrack = pTrack;
+    request.coverInfo = coverInfo;
+    request.desiredWidth = desiredWidth;
+    request.signalWhenDone = loading == Loading::Default;
+    enqueueRequest(&m_visibleRequests, std::move(request));
+    startPendingRequests();
     return QPixmap();
 }
 
+void CoverArtCache::prefetchCovers(
+        const QObject* pRequestor,
+        const QList<CoverInfo>& coverInfos,
+        int desiredWidth) {
+    // Previous prefetch requests are stale
+    removePendingRequests(&m_prefetchRequests, pRequestor);
+    if (desiredWidth <= 0) {
+        return;
+    }
+    for (const auto& coverInfo : coverInfos) {
+        if (coverInfo.type == CoverInfo::NONE ||
+                !CoverImageUtils::isValidHash(coverInfo.hash)) {
+            continue;
+        }
+        const RequestId requestId = qMakePair(pRequestor, coverInfo.hash);
+        if (m_runningRequests.contains(requestId) ||
+                m_pixmapCache.contains(
+                        pixmapCacheKey(coverInfo.hash, desiredWidth))) {
+            continue;
+        }
+        m_runningRequests.insert(requestId);
+        Request request;
+        request.pRequestor = pRequestor;
+        request.coverInfo = coverInfo;
+        request.desiredWidth = desiredWidth;
+        // The row might become visible while the cover is loading
+        request.signalWhenDone = true;
+        enqueueRequest(&m_prefetchRequests, std::move(request));
+    }
+    startPendingRequests();
+}
+
+void CoverArtCache::cancelPendingRequests(
+        const QObject* pRequestor) {
+    removePendingRequests(&m_visibleRequests, pRequestor);
+    removePendingRequests(&m_prefetchRequests, pRequestor);
+}
+
+void CoverArtCache::enqueueRequest(
+        QList<Request>* pQueue,
+        Request request) {
+    pQueue->append(std::move(request));
+    while (pQueue->size() > kMaxPendingRequests) {
+        m_runningRequests.remove(requestIdOf(pQueue->takeFirst()));
+    }
+}
+
+void CoverArtCache::removePendingRequests(
+        QList<Request>* pQueue,
+        const QObject* pRequestor) {
+    auto i = pQueue->begin();
+    while (i != pQueue->end()) {
+        if (i->pRequestor == pRequestor) {
+            m_runningRequests.remove(requestIdOf(*i));
+            i = pQueue->erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void CoverArtCache::startPendingRequests() {
+    while (m_activeLoads < kMaxConcurrentLoads) {
+        Request request;
+        if (!m_visibleRequests.isEmpty()) {
+            // The most recently painted rows are most likely still visible
+            request = m_visibleRequests.takeLast();
+        } else if (!m_prefetchRequests.isEmpty()) {
+            // Prefetch requests are queued in the order of their distance
+            // from the visible rows
+            request = m_prefetchRequests.takeFirst();
+        } else {
+            return;
+        }
+        if (kLogger.traceEnabled()) {
+            kLogger.trace()
+                    << "requestCover starting future for"
+                    << request.coverInfo;
+        }
+        ++m_activeLoads;
+        // The watcher will be deleted in coverLoaded()
+        QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
+        QFuture<FutureResult> future = QtConcurrent::run(
+                &m_loaderThreadPool,
+                &CoverArtCache::loadCover,
+                request.pRequestor,
+                request.pTrack,
+                request.coverInfo,
+                request.desiredWidth,
+                request.signalWhenDone);
+        connect(watcher,
+                &QFutureWatcher<FutureResult>::finished,
+                this,
+                &CoverArtCache::coverLoaded);
+        watcher->setFuture(future);
+    }
+}
+
 //static
 CoverArtCache::FutureResult CoverArtCache::loadCover(
         const QObject* pRequestor,
@@ -176,8 +287,12 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     res.signalWhenDone = signalWhenDone;
     DEBUG_ASSERT(!res.coverInfoUpdated);
 
+    // The hash of a cover is calculated from the original image. Only if
+    // it is known the image can be decoded at the requested size, which
+    // is much faster for large images.
     QImage image = coverInfo.loadImage(
-            pTrack ? pTrack->getSecurityToken() : SecurityTokenPointer());
+            pTrack ? pTrack->getSecurityToken() : SecurityTokenPointer(),
+            CoverImageUtils::isValidHash(coverInfo.hash) ? desiredWidth : 0);
 
     // Refresh hash before resizing the original image!
     res.coverInfoUpdated = coverInfo.refreshImageHash(image);
@@ -189,7 +304,7 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     }
 
     // Resize image to requested size
-    if (!image.isNull() && desiredWidth > 0) {
+    if (!image.isNull() && desiredWidth > 0 && image.width() != desiredWidth) {
         // Adjust the cover size according to the request
         // or downsize the image for efficiency.
         image = resizeImageWidth(image, desiredWidth);
@@ -211,6 +326,8 @@ void CoverArtCache::coverLoaded() {
         res = pFutureWatcher->result();
         pFutureWatcher->deleteLater();
     }
+    DEBUG_ASSERT(m_activeLoads > 0);
+    --m_activeLoads;
 
     if (kLogger.traceEnabled()) {
         kLogger.trace() << "coverLoaded" << res.cover;
@@ -231,7 +348,7 @@ void CoverArtCache::coverLoaded() {
         // because insert replaces the images with the same key
         QString cacheKey = pixmapCacheKey(
                 res.cover.hash, res.cover.resizedToWidth);
-        QPixmapCache::insert(cacheKey, pixmap);
+        m_pixmapCache.insert(cacheKey, new QPixmap(pixmap), pixmapCost(pixmap));
     }
 
     m_runningRequests.remove(qMakePair(res.pRequestor, res.requestedHash));
@@ -239,4 +356,6 @@ void CoverArtCache::coverLoaded() {
     if (res.signalWhenDone) {
         emit coverFound(res.pRequestor, res.cover, pixmap, res.requestedHash, res.coverInfoUpdated);
     }
+
+    startPendingRequests();
 }
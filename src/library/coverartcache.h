@@ -1,9 +1,12 @@
 #pragma once
 
+#include <QCache>
+#include <QList>
 #include <QObject>
 #include <QPair>
 #include <QPixmap>
 #include <QSet>
+#include <QThreadPool>
 #include <QtDebug>
 
 #include "library/coverart.h"
@@ -52,6 +55,21 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
                 loading);
     }
 
+    // Queues loading the covers of rows around the visible rows of a
+    // table view at the size of its delegate. Prefetch requests are only
+    // started when no visible covers are pending. They replace all
+    // previous prefetch requests of the requestor that have not been
+    // started yet.
+    void prefetchCovers(
+            const QObject* pRequestor,
+            const QList<CoverInfo>& coverInfos,
+            int desiredWidth);
+
+    // Drops all requests of the requestor that have not been started
+    // yet, e.g. for rows that have been scrolled out of view.
+    void cancelPendingRequests(
+            const QObject* pRequestor);
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -107,7 +125,47 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             int desiredWidth,
             Loading loading);
 
-    QSet<QPair<const QObject*, quint16> > m_runningRequests;
+    struct Request {
+        Request()
+                : pRequestor(nullptr),
+                  desiredWidth(0),
+                  signalWhenDone(false) {
+        }
+        const QObject* pRequestor;
+        TrackPointer pTrack;
+        CoverInfo coverInfo;
+        int desiredWidth;
+        bool signalWhenDone;
+    };
+    typedef QPair<const QObject*, quint16> RequestId;
+    static RequestId requestIdOf(const Request& request) {
+        return qMakePair(request.pRequestor, request.coverInfo.hash);
+    }
+
+    void enqueueRequest(
+            QList<Request>* pQueue,
+            Request request);
+    void removePendingRequests(
+            QList<Request>* pQueue,
+            const QObject* pRequestor);
+    // Starts loading the queued covers up to the limit of concurrent loads,
+    // visible covers first
+    void startPendingRequests();
+
+    // Requests that are either queued or running, to avoid loading the same
+    // picture again while we are loading it
+    QSet<RequestId> m_runningRequests;
+    // The most recent request is the last one
+    QList<Request> m_visibleRequests;
+    QList<Request> m_prefetchRequests;
+    int m_activeLoads;
+
+    // Loading covers must neither flood the global thread pool nor
+    // block it for other tasks
+    QThreadPool m_loaderThreadPool;
+
+    // Scaled covers of the library table, the cost is their size in bytes
+    QCache<QString, QPixmap> m_pixmapCache;
 };
 
 inline
@@ -769,11 +769,14 @@ void CrateFeature::slotExportTrackFiles() {
     pCrateTableModel->select();
 
     int rows = pCrateTableModel->rowCount();
-    QList<TrackPointer> trackpointers;
+    QList<TrackId> trackIds;
+    trackIds.reserve(rows);
     for (int i = 0; i < rows; ++i) {
-        QModelIndex index = m_crateTableModel.index(i, 0);
-        trackpointers.push_back(m_crateTableModel.getTrack(index));
+        QModelIndex index = pCrateTableModel->index(i, 0);
+        trackIds.push_back(pCrateTableModel->getTrackId(index));
     }
+    const TrackPointerList trackpointers =
+            m_pLibrary->trackCollections()->internalCollection()->getTracksById(trackIds);
 
     TrackExportWizard track_export(nullptr, m_pConfig, trackpointers);
     track_export.exportTracks();
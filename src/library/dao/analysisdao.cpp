@@ -8,6 +8,7 @@
 #include "preferences/waveformsettings.h"
 #include "util/performancetimer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformfile.h"
 
 const QString AnalysisDao::s_analysisTableName = "track_analysis";
 
@@ -84,6 +85,17 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         int checksum = query->value(dataChecksumColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
+        if (WaveformFile::isWaveformFile(dataPath)) {
+            info.pWaveform = WaveformFile::map(
+                    dataPath, static_cast<quint16>(checksum));
+            if (!info.pWaveform) {
+                qDebug() << "WARNING: Corrupt analysis mapped from" << dataPath;
+                continue;
+            }
+            bytes += info.pWaveform->getTextureSize() * sizeof(WaveformData);
+            analyses.append(info);
+            continue;
+        }
         QByteArray compressedData = loadDataFromFile(dataPath);
         int file_checksum = qChecksum(compressedData.constData(),
                                       compressedData.length());
@@ -118,6 +130,58 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     int checksum = qChecksum(compressedData.constData(),
                              compressedData.length());
 
+    if (!saveAnalysisRecord(info, checksum)) {
+        return false;
+    }
+
+    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
+        QString::number(info->analysisId));
+    if (!saveDataToFile(dataPath, compressedData)) {
+        qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
+        return false;
+    }
+
+    qDebug() << "AnalysisDAO saved analysis" << info->analysisId
+             << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
+                                                  QString::number(compressedData.length()))
+             << "bytes for track"
+             << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
+    return true;
+}
+
+bool AnalysisDao::saveWaveformAnalysis(
+        AnalysisDao::AnalysisInfo* info, const Waveform& waveform) {
+    if (!m_db.isOpen() || info == NULL) {
+        return false;
+    }
+
+    if (!info->trackId.isValid()) {
+        qDebug() << "Can't save analysis since trackId is invalid.";
+        return false;
+    }
+    PerformanceTimer time;
+    time.start();
+
+    // The checksum only covers the header, see WaveformFile
+    if (!saveAnalysisRecord(info, WaveformFile::headerChecksum(waveform))) {
+        return false;
+    }
+
+    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
+        QString::number(info->analysisId));
+    if (!WaveformFile::write(dataPath, waveform)) {
+        qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
+        return false;
+    }
+
+    qDebug() << "AnalysisDAO saved waveform analysis" << info->analysisId
+             << "for track"
+             << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
+    return true;
+}
+
+bool AnalysisDao::saveAnalysisRecord(
+        AnalysisDao::AnalysisInfo* info, int checksum) {
     QSqlQuery query(m_db);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -158,19 +222,6 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
             return false;
         }
     }
-
-    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
-        QString::number(info->analysisId));
-    if (!saveDataToFile(dataPath, compressedData)) {
-        qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
-        return false;
-    }
-
-    qDebug() << "AnalysisDAO saved analysis" << info->analysisId
-             << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
-                                                  QString::number(compressedData.length()))
-             << "bytes for track"
-             << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
     return true;
 }
 
@@ -329,8 +380,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
-    bool success = saveAnalysis(&analysis);
+    bool success = saveWaveformAnalysis(&analysis, *pWaveform);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
     }
@@ -344,9 +394,8 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
-    analysis.data = pWaveSummary->toByteArray();
 
-    success = saveAnalysis(&analysis);
+    success = saveWaveformAnalysis(&analysis, *pWaveSummary);
     if (success) {
         pWaveSummary->setSaveState(Waveform::SaveState::Saved);
     }
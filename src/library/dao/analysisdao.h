@@ -30,7 +30,11 @@ class AnalysisDao : public DAO {
         AnalysisType type;
         QString description;
         QString version;
+        // Legacy analyses that have been stored as compressed blobs
         QByteArray data;
+        // Analyses that have been stored in the format of WaveformFile
+        // are mapped instead of being read into data.
+        WaveformPointer pWaveform;
     };
 
     explicit AnalysisDao(UserSettingsPointer pConfig);
@@ -53,6 +57,9 @@ class AnalysisDao : public DAO {
     QList<AnalysisInfo> getAnalysesForTrackByType(TrackId trackId, AnalysisType type);
     QList<AnalysisInfo> getAnalysesForTrack(TrackId trackId);
     bool saveAnalysis(AnalysisInfo* analysis);
+    // Stores the waveform in the format of WaveformFile, replacing any
+    // legacy blob of an existing analysis.
+    bool saveWaveformAnalysis(AnalysisInfo* analysis, const Waveform& waveform);
     bool deleteAnalysis(const int analysisId);
     void deleteAnalyses(const QList<TrackId>& trackIds);
     bool deleteAnalysesForTrack(TrackId trackId);
@@ -67,6 +74,7 @@ class AnalysisDao : public DAO {
     QByteArray loadDataFromFile(const QString& fileName) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
+    bool saveAnalysisRecord(AnalysisInfo* analysis, int checksum);
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
 
     UserSettingsPointer m_pConfig;
@@ -96,42 +96,70 @@ CuePointer CueDAO::cueFromRow(const QSqlQuery& query) const {
 
 QList<CuePointer> CueDAO::getCuesForTrack(TrackId trackId) const {
     //qDebug() << "CueDAO::getCuesForTrack" << QThread::currentThread() << m_database.connectionName();
-    QList<CuePointer> cues;
+    return getCuesForTracks(QList<TrackId>{trackId}).value(trackId);
+}
+
+QHash<TrackId, QList<CuePointer>> CueDAO::getCuesForTracks(
+        const QList<TrackId>& trackIds) const {
+    QHash<TrackId, QList<CuePointer>> cuesByTrackId;
+    if (trackIds.isEmpty()) {
+        return cuesByTrackId;
+    }
+
+    QStringList idList;
+    idList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idList << trackId.toString();
+    }
+
+    // The rows of each track are adjacent and ordered like the
+    // rows of the former query for a single track.
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(QString("SELECT * FROM " CUE_TABLE
+                          " WHERE track_id IN (%1) ORDER BY track_id, id")
+                          .arg(idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return cuesByTrackId;
+    }
+
+    const int idColumn = query.record().indexOf("id");
+    const int trackIdColumn = query.record().indexOf("track_id");
+    const int hotcueIdColumn = query.record().indexOf("hotcue");
+    TrackId currentTrackId;
+    QList<CuePointer>* pCues = nullptr;
     // A hash from hotcue index to cue id and cue*, used to detect if more
     // than one cue has been assigned to a single hotcue id.
     QMap<int, QPair<int, CuePointer> > dupe_hotcues;
-
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM " CUE_TABLE " WHERE track_id = :id");
-    query.bindValue(":id", trackId.toVariant());
-    if (query.exec()) {
-        const int idColumn = query.record().indexOf("id");
-        const int hotcueIdColumn = query.record().indexOf("hotcue");
-        while (query.next()) {
-            CuePointer pCue;
-            int cueId = query.value(idColumn).toInt();
-            if (m_cues.contains(cueId)) {
-                pCue = m_cues[cueId];
-            }
-            if (!pCue) {
-                pCue = cueFromRow(query);
-            }
-            int hotcueId = query.value(hotcueIdColumn).toInt();
-            if (hotcueId != -1) {
-                if (dupe_hotcues.contains(hotcueId)) {
-                    m_cues.remove(dupe_hotcues[hotcueId].first);
-                    cues.removeOne(dupe_hotcues[hotcueId].second);
-                }
-                dupe_hotcues[hotcueId] = qMakePair(cueId, pCue);
-            }
-            if (pCue) {
-                cues.push_back(pCue);
+    while (query.next()) {
+        const TrackId trackId(query.value(trackIdColumn));
+        if (!pCues || trackId != currentTrackId) {
+            currentTrackId = trackId;
+            pCues = &cuesByTrackId[trackId];
+            dupe_hotcues.clear();
+        }
+        CuePointer pCue;
+        int cueId = query.value(idColumn).toInt();
+        if (m_cues.contains(cueId)) {
+            pCue = m_cues[cueId];
+        }
+        if (!pCue) {
+            pCue = cueFromRow(query);
+        }
+        int hotcueId = query.value(hotcueIdColumn).toInt();
+        if (hotcueId != -1) {
+            if (dupe_hotcues.contains(hotcueId)) {
+                m_cues.remove(dupe_hotcues[hotcueId].first);
+                pCues->removeOne(dupe_hotcues[hotcueId].second);
             }
+            dupe_hotcues[hotcueId] = qMakePair(cueId, pCue);
+        }
+        if (pCue) {
+            pCues->push_back(pCue);
         }
-    } else {
-        LOG_FAILED_QUERY(query);
     }
-    return cues;
+    return cuesByTrackId;
 }
 
 bool CueDAO::deleteCuesForTrack(TrackId trackId) {
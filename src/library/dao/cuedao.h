@@ -4,6 +4,7 @@
 #ifndef CUEDAO_H
 #define CUEDAO_H
 
+#include <QHash>
 #include <QMap>
 #include <QSqlDatabase>
 
@@ -25,6 +26,10 @@ class CueDAO : public DAO {
     int cueCount();
     int numCuesForTrack(TrackId trackId);
     QList<CuePointer> getCuesForTrack(TrackId trackId) const;
+    // Loads the cues of many tracks with a single query. Tracks without
+    // any cues are missing in the result.
+    QHash<TrackId, QList<CuePointer>> getCuesForTracks(
+            const QList<TrackId>& trackIds) const;
     bool deleteCuesForTrack(TrackId trackId);
     bool deleteCuesForTracks(const QList<TrackId>& trackIds);
     bool saveCue(Cue* cue);
@@ -145,6 +145,26 @@ void LibraryHashDAO::invalidateAllDirectories() {
     }
 }
 
+void LibraryHashDAO::invalidateDirectories(const QStringList& dirPaths,
+                                           bool includeSubdirectories) {
+    if (dirPaths.isEmpty()) {
+        return;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString("UPDATE LibraryHashes "
+                          "SET needs_verification=1 WHERE %1").arg(
+                                  formatDirectoryPathCondition(
+                                          FieldEscaper(m_database),
+                                          "directory_path",
+                                          dirPaths,
+                                          includeSubdirectories)));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't mark" << dirPaths.size()
+                << "directories as needing verification.";
+    }
+}
+
 void LibraryHashDAO::markUnverifiedDirectoriesAsDeleted() {
     //qDebug() << "LibraryHashDAO::markUnverifiedDirectoriesAsDeleted"
     //<< QThread::currentThread() << m_database.connectionName();
@@ -650,7 +650,36 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
     return trackId;
 }
 
+namespace {
+    // Copies everything that SoundSourceProxy::updateTrackFromSource()
+    // imports from the file
+    void adoptImportedTrack(Track* pTrack, const Track& importedTrack) {
+        DEBUG_ASSERT(pTrack);
+        pTrack->setType(importedTrack.getType());
+        mixxx::TrackMetadata trackMetadata;
+        bool metadataSynchronized = false;
+        importedTrack.readTrackMetadata(&trackMetadata, &metadataSynchronized);
+        pTrack->importMetadata(std::move(trackMetadata), QDateTime());
+        pTrack->setMetadataSynchronized(metadataSynchronized);
+        pTrack->setCoverInfo(importedTrack.getCoverInfo());
+    }
+} // anonymous namespace
+
 TrackPointer TrackDAO::addTracksAddFile(const TrackFile& trackFile, bool unremove) {
+    return addTracksAddTrackFile(trackFile, unremove, nullptr);
+}
+
+TrackPointer TrackDAO::addTracksAddImportedTrack(
+        const TrackPointer& pImportedTrack, bool unremove) {
+    DEBUG_ASSERT(pImportedTrack);
+    return addTracksAddTrackFile(
+            pImportedTrack->getFileInfo(), unremove, pImportedTrack.get());
+}
+
+TrackPointer TrackDAO::addTracksAddTrackFile(
+        const TrackFile& trackFile,
+        bool unremove,
+        const Track* pImportedTrack) {
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
     // the track is already in the library. A refactoring is
@@ -682,8 +711,12 @@ TrackPointer TrackDAO::addTracksAddFile(const TrackFile& trackFile, bool unremov
     // object is known and has been updated in the cache.
 
     // Initially (re-)import the metadata for the newly created track
-    // from the file.
-    SoundSourceProxy(pTrack).updateTrackFromSource();
+    // from the file unless this has already been done.
+    if (pImportedTrack) {
+        adoptImportedTrack(pTrack.get(), *pImportedTrack);
+    } else {
+        SoundSourceProxy(pTrack).updateTrackFromSource();
+    }
     if (!pTrack->isMetadataSynchronized()) {
         qWarning() << "TrackDAO::addTracksAddFile:"
                 << "Failed to parse track metadata from file"
@@ -1116,17 +1149,94 @@ struct ColumnPopulator {
     TrackPopulatorFn populator;
 };
 
-}  // namespace
+const ColumnPopulator kTrackColumns[] = {
+    // Location must be first.
+    { "track_locations.location", nullptr },
+    { "artist", setTrackArtist },
+    { "title", setTrackTitle },
+    { "album", setTrackAlbum },
+    { "album_artist", setTrackAlbumArtist },
+    { "year", setTrackYear },
+    { "genre", setTrackGenre },
+    { "composer", setTrackComposer },
+    { "grouping", setTrackGrouping },
+    { "tracknumber", setTrackNumber },
+    { "tracktotal", setTrackTotal },
+    { "filetype", setTrackFiletype },
+    { "rating", setTrackRating },
+    { "color", setTrackColor },
+    { "comment", setTrackComment },
+    { "url", setTrackUrl },
+    { "cuepoint", setTrackCuePoint },
+    { "replaygain", setTrackReplayGainRatio },
+    { "replaygain_peak", setTrackReplayGainPeak },
+    { "timesplayed", setTrackTimesPlayed },
+    { "played", setTrackPlayed },
+    { "datetime_added", setTrackDateAdded },
+    { "header_parsed", setTrackMetadataSynchronized },
+
+    // Audio properties are set together at once. Do not change the
+    // ordering of these columns or put other columns in between them!
+    { "channels", setTrackAudioProperties },
+    { "samplerate", nullptr },
+    { "bitrate", nullptr },
+    { "duration", nullptr },
+
+    // Beat detection columns are handled by setTrackBeats. Do not change
+    // the ordering of these columns or put other columns in between them!
+    { "bpm", setTrackBeats },
+    { "beats_version", nullptr },
+    { "beats_sub_version", nullptr },
+    { "beats", nullptr },
+    { "bpm_lock", nullptr },
+
+    // Beat detection columns are handled by setTrackKey. Do not change the
+    // ordering of these columns or put other columns in between them!
+    { "key", setTrackKey },
+    { "keys_version", nullptr },
+    { "keys_sub_version", nullptr },
+    { "keys", nullptr },
+
+    // Cover art columns are handled by setTrackCoverInfo. Do not change the
+    // ordering of these columns or put other columns in between them!
+    { "coverart_source", setTrackCoverInfo },
+    { "coverart_type", nullptr },
+    { "coverart_location", nullptr },
+    { "coverart_hash", nullptr }
+};
+
+const int kTrackColumnsCount = sizeof(kTrackColumns) / sizeof(kTrackColumns[0]);
+
+// Bounds both the length of the SQL statements and how long the
+// GlobalTrackCache stays locked when loading many tracks at once
+const int kMaxTracksPerBatchQuery = 100;
+
+QString trackColumnsSql() {
+    QString columnsStr;
+    int columnsSize = 0;
+    for (int i = 0; i < kTrackColumnsCount; ++i) {
+        columnsSize += qstrlen(kTrackColumns[i].name) + 1;
+    }
+    columnsStr.reserve(columnsSize);
+    for (int i = 0; i < kTrackColumnsCount; ++i) {
+        if (i > 0) {
+            columnsStr.append(QChar(','));
+        }
+        columnsStr.append(kTrackColumns[i].name);
+    }
+    return columnsStr;
+}
 
-#define ARRAYLENGTH(x) (sizeof(x) / sizeof(*x))
+}  // namespace
 
 TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     if (!trackId.isValid()) {
         return TrackPointer();
     }
 
-    // The GlobalTrackCache is only locked while executing the following line.
-    TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+    // Only a single shard of the GlobalTrackCache is locked while
+    // executing the following line.
+    TrackPointer pTrack = GlobalTrackCache::lookupTrackById(trackId);
     if (pTrack) {
         return pTrack;
     }
@@ -1138,80 +1248,10 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     ScopedTimer t("TrackDAO::getTrackById");
     QSqlQuery query(m_database);
 
-    ColumnPopulator columns[] = {
-        // Location must be first.
-        { "track_locations.location", nullptr },
-        { "artist", setTrackArtist },
-        { "title", setTrackTitle },
-        { "album", setTrackAlbum },
-        { "album_artist", setTrackAlbumArtist },
-        { "year", setTrackYear },
-        { "genre", setTrackGenre },
-        { "composer", setTrackComposer },
-        { "grouping", setTrackGrouping },
-        { "tracknumber", setTrackNumber },
-        { "tracktotal", setTrackTotal },
-        { "filetype", setTrackFiletype },
-        { "rating", setTrackRating },
-        { "color", setTrackColor },
-        { "comment", setTrackComment },
-        { "url", setTrackUrl },
-        { "cuepoint", setTrackCuePoint },
-        { "replaygain", setTrackReplayGainRatio },
-        { "replaygain_peak", setTrackReplayGainPeak },
-        { "timesplayed", setTrackTimesPlayed },
-        { "played", setTrackPlayed },
-        { "datetime_added", setTrackDateAdded },
-        { "header_parsed", setTrackMetadataSynchronized },
-
-        // Audio properties are set together at once. Do not change the
-        // ordering of these columns or put other columns in between them!
-        { "channels", setTrackAudioProperties },
-        { "samplerate", nullptr },
-        { "bitrate", nullptr },
-        { "duration", nullptr },
-
-        // Beat detection columns are handled by setTrackBeats. Do not change
-        // the ordering of these columns or put other columns in between them!
-        { "bpm", setTrackBeats },
-        { "beats_version", nullptr },
-        { "beats_sub_version", nullptr },
-        { "beats", nullptr },
-        { "bpm_lock", nullptr },
-
-        // Beat detection columns are handled by setTrackKey. Do not change the
-        // ordering of these columns or put other columns in between them!
-        { "key", setTrackKey },
-        { "keys_version", nullptr },
-        { "keys_sub_version", nullptr },
-        { "keys", nullptr },
-
-        // Cover art columns are handled by setTrackCoverInfo. Do not change the
-        // ordering of these columns or put other columns in between them!
-        { "coverart_source", setTrackCoverInfo },
-        { "coverart_type", nullptr },
-        { "coverart_location", nullptr },
-        { "coverart_hash", nullptr }
-    };
-
-    QString columnsStr;
-    int columnsSize = 0;
-    const int columnsCount = ARRAYLENGTH(columns);
-    for (int i = 0; i < columnsCount; ++i) {
-        columnsSize += qstrlen(columns[i].name) + 1;
-    }
-    columnsStr.reserve(columnsSize);
-    for (int i = 0; i < columnsCount; ++i) {
-        if (i > 0) {
-            columnsStr.append(QChar(','));
-        }
-        columnsStr.append(columns[i].name);
-    }
-
     query.prepare(QString(
             "SELECT %1 FROM Library "
             "INNER JOIN track_locations ON library.location = track_locations.id "
-            "WHERE library.id = %2").arg(columnsStr, trackId.toString()));
+            "WHERE library.id = %2").arg(trackColumnsSql(), trackId.toString()));
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query)
@@ -1223,11 +1263,8 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         return TrackPointer();
     }
 
-    QSqlRecord queryRecord = query.record();
-    int recordCount = queryRecord.count();
-    VERIFY_OR_DEBUG_ASSERT(recordCount == columnsCount) {
-        recordCount = math_min(recordCount, columnsCount);
-    }
+    const QSqlRecord queryRecord = query.record();
+    DEBUG_ASSERT(queryRecord.count() == kTrackColumnsCount);
 
     // Location is the first column.
     const QString trackLocation(queryRecord.value(0).toString());
@@ -1259,11 +1296,131 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     // is acceptable as a tradeoff for reduced lock contention. Otherwise the
     // global cache would need to be locked until the query and the population
     // of the properties has finished.
+    populateTrack(pTrack, queryRecord, m_cueDao.getCuesForTrack(trackId));
+
+    return pTrack;
+}
+
+TrackPointerList TrackDAO::getTracksById(
+        const QList<TrackId>& trackIds) const {
+    QHash<TrackId, TrackPointer> tracksById;
+    QList<TrackId> uncachedTrackIds;
+    QSet<TrackId> visitedTrackIds;
+    for (const auto& trackId : trackIds) {
+        if (!trackId.isValid() || visitedTrackIds.contains(trackId)) {
+            continue;
+        }
+        visitedTrackIds.insert(trackId);
+        TrackPointer pTrack = GlobalTrackCache::lookupTrackById(trackId);
+        if (pTrack) {
+            tracksById.insert(trackId, pTrack);
+        } else {
+            uncachedTrackIds.append(trackId);
+        }
+    }
+
+    if (!uncachedTrackIds.isEmpty()) {
+        ScopedTimer t("TrackDAO::getTracksById");
+        for (int i = 0; i < uncachedTrackIds.size(); i += kMaxTracksPerBatchQuery) {
+            loadTracksById(
+                    uncachedTrackIds.mid(i, kMaxTracksPerBatchQuery),
+                    &tracksById);
+        }
+    }
+
+    TrackPointerList tracks;
+    tracks.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        TrackPointer pTrack = tracksById.value(trackId);
+        if (pTrack) {
+            tracks.append(std::move(pTrack));
+        }
+    }
+    return tracks;
+}
+
+void TrackDAO::loadTracksById(
+        const QList<TrackId>& trackIds,
+        QHash<TrackId, TrackPointer>* pTracksById) const {
+    DEBUG_ASSERT(pTracksById);
+    QStringList idList;
+    idList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idList << trackId.toString();
+    }
+
+    // The id follows the columns that are consumed by populateTrack()
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(QString(
+            "SELECT %1,library.id FROM Library "
+            "INNER JOIN track_locations ON library.location = track_locations.id "
+            "WHERE library.id IN (%2)").arg(trackColumnsSql(), idList.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << QString("getTracks(%1)").arg(idList.join(","));
+        return;
+    }
+    QList<QSqlRecord> queryRecords;
+    queryRecords.reserve(trackIds.size());
+    while (query.next()) {
+        queryRecords.append(query.record());
+    }
+
+    // Like getTrackById() the cache is not locked while accessing the
+    // database. All tracks of the query are resolved while holding the
+    // lock only once and are populated afterwards.
+    QList<QPair<TrackPointer, QSqlRecord>> newTracks;
+    {
+        GlobalTrackCacheLocker cacheLocker;
+        for (const auto& queryRecord : queryRecords) {
+            DEBUG_ASSERT(queryRecord.count() == kTrackColumnsCount + 1);
+            const TrackId trackId(queryRecord.value(kTrackColumnsCount));
+            const QString trackLocation(queryRecord.value(0).toString());
+            // The resolver locks the recursive mutex of the cache once
+            // more and releases this lock when going out of scope.
+            GlobalTrackCacheResolver cacheResolver(TrackFile(trackLocation), trackId);
+            TrackPointer pTrack = cacheResolver.getTrack();
+            VERIFY_OR_DEBUG_ASSERT(pTrack) {
+                continue;
+            }
+            DEBUG_ASSERT(pTrack->getId() == trackId);
+            pTracksById->insert(trackId, pTrack);
+            if (cacheResolver.getLookupResult() == GlobalTrackCacheLookupResult::MISS) {
+                newTracks.append(qMakePair(pTrack, queryRecord));
+            }
+        }
+    }
+    if (newTracks.isEmpty()) {
+        return;
+    }
+
+    QList<TrackId> newTrackIds;
+    newTrackIds.reserve(newTracks.size());
+    for (const auto& newTrack : qAsConst(newTracks)) {
+        newTrackIds.append(newTrack.first->getId());
+    }
+    const auto cuesByTrackId = m_cueDao.getCuesForTracks(newTrackIds);
+    for (const auto& newTrack : qAsConst(newTracks)) {
+        populateTrack(
+                newTrack.first,
+                newTrack.second,
+                cuesByTrackId.value(newTrack.first->getId()));
+    }
+}
+
+void TrackDAO::populateTrack(
+        const TrackPointer& pTrack,
+        const QSqlRecord& queryRecord,
+        const QList<CuePointer>& cuePoints) const {
+    // Batch queries append the id of the track to the columns
+    DEBUG_ASSERT(queryRecord.count() >= kTrackColumnsCount);
+    const int recordCount = math_min(queryRecord.count(), kTrackColumnsCount);
 
     // For every column run its populator to fill the track in with the data.
     bool shouldDirty = false;
     for (int i = 0; i < recordCount; ++i) {
-        TrackPopulatorFn populator = columns[i].populator;
+        TrackPopulatorFn populator = kTrackColumns[i].populator;
         if (populator != nullptr) {
             // If any populator says the track should be dirty then we dirty it.
             if ((*populator)(queryRecord, i, pTrack)) {
@@ -1273,7 +1430,7 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     }
 
     // Populate track cues from the cues table.
-    pTrack->setCuePoints(m_cueDao.getCuesForTrack(trackId));
+    pTrack->setCuePoints(cuePoints);
 
     // Normally we will set the track as clean but sometimes when loading from
     // the database we need to perform upkeep that ought to be written back to
@@ -1317,12 +1474,10 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
     // track modifications above have been sent before the TrackDAO has been
     // connected to the track's signals and need to be replayed manually.
     if (pTrack->isDirty()) {
-        emit trackDirty(trackId);
+        emit trackDirty(pTrack->getId());
     } else {
-        emit trackClean(trackId);
+        emit trackClean(pTrack->getId());
     }
-
-    return pTrack;
 }
 
 TrackId TrackDAO::getTrackIdByRef(
@@ -1331,8 +1486,7 @@ TrackId TrackDAO::getTrackIdByRef(
         return trackRef.getId();
     }
     {
-        GlobalTrackCacheLocker cacheLocker;
-        const auto pTrack = cacheLocker.lookupTrackByRef(trackRef);
+        const auto pTrack = GlobalTrackCache::lookupTrackByRef(trackRef);
         if (pTrack) {
             return pTrack->getId();
         }
@@ -1346,8 +1500,7 @@ TrackPointer TrackDAO::getTrackByRef(
         return TrackPointer();
     }
     {
-        GlobalTrackCacheLocker cacheLocker;
-        auto pTrack = cacheLocker.lookupTrackByRef(trackRef);
+        auto pTrack = GlobalTrackCache::lookupTrackByRef(trackRef);
         if (pTrack) {
             return pTrack;
         }
@@ -1467,6 +1620,27 @@ void TrackDAO::invalidateTrackLocationsInLibrary() const {
     }
 }
 
+void TrackDAO::invalidateTrackLocationsInDirectories(
+        const QStringList& directories,
+        bool includeSubdirectories) const {
+    if (directories.isEmpty()) {
+        return;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString("UPDATE track_locations "
+                          "SET needs_verification=1 WHERE %1").arg(
+                                  formatDirectoryPathCondition(
+                                          FieldEscaper(m_database),
+                                          "directory",
+                                          directories,
+                                          includeSubdirectories)));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't mark tracks in" << directories.size()
+                << "directories as needing verification.";
+    }
+}
+
 void TrackDAO::markTrackLocationsAsVerified(const QStringList& locations) const {
     //qDebug() << "TrackDAO::markTrackLocationsAsVerified" << QThread::currentThread() << m_database.connectionName();
 
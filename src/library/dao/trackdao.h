@@ -2,6 +2,7 @@
 #define TRACKDAO_H
 
 #include <QFileInfo>
+#include <QHash>
 #include <QObject>
 #include <QSet>
 #include <QList>
@@ -15,6 +16,7 @@
 #include "util/class.h"
 #include "util/memory.h"
 
+class QSqlRecord;
 class SqlTransaction;
 class PlaylistDAO;
 class AnalysisDao;
@@ -97,6 +99,20 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             const QString& location) const;
     TrackPointer getTrackById(
             TrackId trackId) const;
+    // Loads many tracks with a few set-based queries instead of one query
+    // per track. The tracks are returned in the order of the ids, tracks
+    // that have not been found are omitted.
+    TrackPointerList getTracksById(
+            const QList<TrackId>& trackIds) const;
+    void loadTracksById(
+            const QList<TrackId>& trackIds,
+            QHash<TrackId, TrackPointer>* pTracksById) const;
+    // Populates a track that has just been added to the GlobalTrackCache
+    // with a row of the library and its cues
+    void populateTrack(
+            const TrackPointer& pTrack,
+            const QSqlRecord& queryRecord,
+            const QList<CuePointer>& cuePoints) const;
 
     // Loads a track from the database (by id if available, otherwise by location)
     // or adds it if not found in case the location is known. The (optional) out
@@ -114,6 +130,17 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackPointer addTracksAddFile(
             const TrackFile& trackFile,
             bool unremove);
+    // Adds a file whose metadata and cover art have already been imported
+    // into a temporary track, e.g. by a worker thread of the LibraryScanner.
+    TrackPointer addTracksAddImportedTrack(
+            const TrackPointer& pImportedTrack,
+            bool unremove);
+    // Shared implementation of addTracksAddFile() and
+    // addTracksAddImportedTrack()
+    TrackPointer addTracksAddTrackFile(
+            const TrackFile& trackFile,
+            bool unremove,
+            const Track* /*nullable*/ pImportedTrack);
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(Track* pTrack) const;
@@ -139,6 +166,9 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void markTrackLocationsAsVerified(const QStringList& locations) const;
     void markTracksInDirectoriesAsVerified(const QStringList& directories) const;
     void invalidateTrackLocationsInLibrary() const;
+    void invalidateTrackLocationsInDirectories(
+            const QStringList& directories,
+            bool includeSubdirectories) const;
     void markUnverifiedTracksAsDeleted();
 
     bool verifyRemainingTracks(
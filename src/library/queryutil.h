@@ -98,4 +98,26 @@ class FieldEscaper final {
     mutable QSqlField m_stringField;
 };
 
+// Formats a condition that is true if the column contains one of the
+// directory paths or, optionally, the path of one of their subdirectories.
+inline QString formatDirectoryPathCondition(
+        const FieldEscaper& escaper,
+        const QString& column,
+        const QStringList& dirPaths,
+        bool includeSubdirectories) {
+    QStringList conditions;
+    conditions << QString("%1 IN (%2)").arg(
+            column, escaper.escapeStrings(dirPaths).join(","));
+    if (includeSubdirectories) {
+        for (const auto& dirPath : dirPaths) {
+            // The paths within a directory sort between "dir/" and "dir0"
+            conditions << QString("(%1 >= %2 AND %1 < %3)").arg(
+                    column,
+                    escaper.escapeString(dirPath + '/'),
+                    escaper.escapeString(dirPath + '0'));
+        }
+    }
+    return conditions.join(" OR ");
+}
+
 #endif /* QUERYUTIL_H */
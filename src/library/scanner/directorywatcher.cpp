@@ -0,0 +1,308 @@
+#include "library/scanner/directorywatcher.h"
+
+#include <QDirIterator>
+#include <QFile>
+#include <QMutexLocker>
+#include <QSocketNotifier>
+
+#ifdef __LINUX__
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#endif
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("DirectoryWatcher");
+
+#ifdef __LINUX__
+// Only changes of the list of files matter, like for the directory hashes
+// of the LibraryScanner
+const uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+        IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+// inotify only reports changes that are made through the local kernel,
+// not those made by other clients of a network file system. The magic
+// numbers are not all available in <linux/magic.h>.
+const quint32 kRemoteFileSystemTypes[] = {
+        0x6969,     // NFS_SUPER_MAGIC
+        0x517B,     // SMB_SUPER_MAGIC
+        0xFF534D42, // CIFS_MAGIC_NUMBER
+        0xFE534D42, // SMB2_MAGIC_NUMBER
+        0x65735546, // FUSE_SUPER_MAGIC
+};
+#endif
+
+bool isWithinDirectory(const QString& path, const QString& dirPath) {
+    if (!path.startsWith(dirPath)) {
+        return false;
+    }
+    return path.size() == dirPath.size() ||
+            dirPath.endsWith('/') ||
+            path.at(dirPath.size()) == '/';
+}
+
+} // anonymous namespace
+
+DirectoryWatcher::DirectoryWatcher(QObject* parent)
+        : QObject(parent),
+          m_fd(-1),
+          m_pNotifier(nullptr),
+          m_synchronized(false),
+          m_eventsLost(false) {
+#ifdef __LINUX__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        kLogger.warning()
+                << "Failed to initialize inotify:"
+                << strerror(errno);
+        return;
+    }
+    m_pNotifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_pNotifier,
+            SIGNAL(activated(int)),
+            this,
+            SLOT(slotReadEvents()));
+#endif
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+    delete m_pNotifier;
+#ifdef __LINUX__
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+#endif
+}
+
+//static
+bool DirectoryWatcher::isSupported() {
+#ifdef __LINUX__
+    return true;
+#else
+    return false;
+#endif
+}
+
+//static
+bool DirectoryWatcher::isRemoteFileSystem(const QString& dirPath) {
+#ifdef __LINUX__
+    struct statfs fsInfo;
+    if (statfs(QFile::encodeName(dirPath).constData(), &fsInfo) != 0) {
+        return false;
+    }
+    const auto fsType = static_cast<quint32>(fsInfo.f_type);
+    for (const auto remoteFsType : kRemoteFileSystemTypes) {
+        if (fsType == remoteFsType) {
+            return true;
+        }
+    }
+    return false;
+#else
+    Q_UNUSED(dirPath);
+    return false;
+#endif
+}
+
+void DirectoryWatcher::watchDirectory(const QString& dirPath) {
+    QMutexLocker locker(&m_mutex);
+    addWatch(dirPath);
+}
+
+void DirectoryWatcher::reset() {
+    QMutexLocker locker(&m_mutex);
+    // Events for the removed watches are ignored
+    readEvents();
+#ifdef __LINUX__
+    for (auto it = m_pathsByWatch.keyBegin(); it != m_pathsByWatch.keyEnd(); ++it) {
+        inotify_rm_watch(m_fd, *it);
+    }
+#endif
+    m_pathsByWatch.clear();
+    m_watchesByPath.clear();
+    m_dirtyDirs.clear();
+    m_newDirs.clear();
+    m_rootDirs.clear();
+    m_synchronized = false;
+    m_eventsLost = false;
+}
+
+void DirectoryWatcher::setSynchronized(const QStringList& rootDirs) {
+    QMutexLocker locker(&m_mutex);
+    readEvents();
+    m_synchronized = m_fd >= 0 && !m_eventsLost;
+    m_rootDirs = rootDirs;
+    if (m_synchronized) {
+        kLogger.info()
+                << "Watching"
+                << m_watchesByPath.size()
+                << "directories for changes";
+    }
+}
+
+bool DirectoryWatcher::takeDirtyDirectories(
+        const QStringList& rootDirs,
+        QSet<QString>* pDirtyDirs) {
+    DEBUG_ASSERT(pDirtyDirs);
+    watchNewDirectories();
+    QMutexLocker locker(&m_mutex);
+    readEvents();
+    if (!m_synchronized || m_eventsLost || m_rootDirs != rootDirs) {
+        return false;
+    }
+    for (const auto& dirPath : qAsConst(m_dirtyDirs)) {
+        for (const auto& rootDir : rootDirs) {
+            if (isWithinDirectory(dirPath, rootDir)) {
+                pDirtyDirs->insert(dirPath);
+                break;
+            }
+        }
+    }
+    m_dirtyDirs.clear();
+    return true;
+}
+
+void DirectoryWatcher::slotReadEvents() {
+    QMutexLocker locker(&m_mutex);
+    readEvents();
+}
+
+void DirectoryWatcher::readEvents() {
+#ifdef __LINUX__
+    if (m_fd < 0) {
+        return;
+    }
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    for (;;) {
+        // Returns -1 with errno EAGAIN if no more events are queued
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+        const char* pNext = buffer;
+        while (pNext < buffer + length) {
+            const auto* pEvent = reinterpret_cast<const struct inotify_event*>(pNext);
+            pNext += sizeof(struct inotify_event) + pEvent->len;
+
+            if (pEvent->mask & IN_Q_OVERFLOW) {
+                kLogger.warning()
+                        << "The inotify event queue overflowed";
+                m_eventsLost = true;
+                continue;
+            }
+            // Unknown for removed watches
+            const QStringList dirPaths = m_pathsByWatch.values(pEvent->wd);
+            for (const auto& dirPath : dirPaths) {
+                m_dirtyDirs.insert(dirPath);
+                if (pEvent->len == 0 || !(pEvent->mask & IN_ISDIR)) {
+                    continue;
+                }
+                const QString subdirPath =
+                        dirPath + '/' + QFile::decodeName(pEvent->name);
+                if (pEvent->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    // Watch the directory before it is listed to not miss
+                    // any subdirectories that are created in the meantime.
+                    // Listing it might take long and is deferred to the
+                    // scanner thread.
+                    addWatch(subdirPath);
+                    m_dirtyDirs.insert(subdirPath);
+                    m_newDirs.insert(subdirPath);
+                } else {
+                    m_dirtyDirs.insert(subdirPath);
+                    removeWatchesRecursively(subdirPath);
+                }
+            }
+            if (pEvent->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                // The directory has been removed, moved or unmounted. The
+                // watches of moved subdirectories would report events with
+                // the old paths.
+                for (const auto& dirPath : dirPaths) {
+                    removeWatchesRecursively(dirPath);
+                }
+            }
+        }
+    }
+#endif
+}
+
+void DirectoryWatcher::addWatch(const QString& dirPath) {
+#ifdef __LINUX__
+    if (m_fd < 0 || m_watchesByPath.contains(dirPath)) {
+        return;
+    }
+    const int wd = inotify_add_watch(
+            m_fd, QFile::encodeName(dirPath).constData(), kWatchMask);
+    if (wd < 0) {
+        if (errno == ENOSPC || errno == ENOMEM) {
+            kLogger.warning()
+                    << "Failed to watch"
+                    << dirPath
+                    << "- the limit of inotify watches has been reached, see"
+                    << "/proc/sys/fs/inotify/max_user_watches";
+            m_eventsLost = true;
+        }
+        // Otherwise the directory is inaccessible and will not be scanned
+        return;
+    }
+    m_watchesByPath.insert(dirPath, wd);
+    m_pathsByWatch.insert(wd, dirPath);
+#else
+    Q_UNUSED(dirPath);
+#endif
+}
+
+void DirectoryWatcher::watchNewDirectories() {
+    for (;;) {
+        QSet<QString> newDirs;
+        {
+            QMutexLocker locker(&m_mutex);
+            readEvents();
+            if (m_eventsLost) {
+                // A full scan will follow
+                m_newDirs.clear();
+            }
+            newDirs.swap(m_newDirs);
+        }
+        if (newDirs.isEmpty()) {
+            return;
+        }
+        // The mutex is only locked per subdirectory, because walking a
+        // large directory tree that has been moved into the library takes
+        // long. Symbolic links are watched but not followed.
+        for (const auto& newDirPath : qAsConst(newDirs)) {
+            QDirIterator it(newDirPath,
+                    QDir::Dirs | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                const QString subdirPath = it.next();
+                QMutexLocker locker(&m_mutex);
+                addWatch(subdirPath);
+                m_dirtyDirs.insert(subdirPath);
+            }
+        }
+    }
+}
+
+void DirectoryWatcher::removeWatchesRecursively(const QString& dirPath) {
+    auto it = m_watchesByPath.begin();
+    while (it != m_watchesByPath.end()) {
+        if (!isWithinDirectory(it.key(), dirPath)) {
+            ++it;
+            continue;
+        }
+        const int wd = it.value();
+        m_pathsByWatch.remove(wd, it.key());
+#ifdef __LINUX__
+        if (!m_pathsByWatch.contains(wd)) {
+            // Fails harmlessly if the watch has already been removed
+            inotify_rm_watch(m_fd, wd);
+        }
+#endif
+        it = m_watchesByPath.erase(it);
+    }
+}
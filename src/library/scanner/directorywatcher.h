@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QHash>
+#include <QMultiHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "util/class.h"
+
+class QSocketNotifier;
+
+// Records the library directories whose list of files has changed between
+// two scans of the LibraryScanner. Changes are reported by inotify on Linux.
+//
+// The recorded changes are only complete after all directories have been
+// watched during a full scan. Until then, and whenever events might have
+// been lost, e.g. if the event queue of the kernel overflowed or the limit
+// of watches has been reached, the watcher is out of sync and the scanner
+// needs to walk the whole library again.
+//
+// On other platforms the watcher is never in sync. Changes on network file
+// systems that are made by other clients are not reported at all, see
+// isRemoteFileSystem().
+class DirectoryWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit DirectoryWatcher(QObject* parent = nullptr);
+    ~DirectoryWatcher() override;
+
+    static bool isSupported();
+
+    // True if the directory is located on a network file system like NFS,
+    // SMB/CIFS or FUSE mounts. The recorded changes are incomplete for
+    // these directories and they need to be walked on every scan.
+    static bool isRemoteFileSystem(const QString& dirPath);
+
+    // Starts watching a directory that is about to be scanned. Thread-safe.
+    void watchDirectory(const QString& dirPath);
+
+    // Removes all watches and recorded changes. The watcher is out of sync
+    // until the next call of setSynchronized().
+    void reset();
+
+    // Declares that every directory within the root directories has been
+    // watched since the last reset(), i.e. after a full scan. Has no effect
+    // if events have been lost in the meantime.
+    void setSynchronized(const QStringList& rootDirs);
+
+    // Returns false if the watcher is not in sync for the given root
+    // directories. Otherwise moves the changed directories within the root
+    // directories into pDirtyDirs. These include new directories, which
+    // might contain subdirectories that are reported separately, and
+    // directories that no longer exist.
+    //
+    // New directories are watched immediately when reported, but their
+    // subdirectories are only walked and watched here on the calling
+    // (scanner) thread.
+    bool takeDirtyDirectories(
+            const QStringList& rootDirs,
+            QSet<QString>* pDirtyDirs);
+
+  private slots:
+    void slotReadEvents();
+
+  private:
+    void readEvents();
+    void addWatch(const QString& dirPath);
+    void watchNewDirectories();
+    void removeWatchesRecursively(const QString& dirPath);
+
+    int m_fd;
+    QSocketNotifier* m_pNotifier;
+
+    QMutex m_mutex;
+    // A directory and its symbolic links share a single watch
+    QMultiHash<int, QString> m_pathsByWatch;
+    QHash<QString, int> m_watchesByPath;
+    QSet<QString> m_dirtyDirs;
+    // New directories whose subdirectories have not been watched yet
+    QSet<QString> m_newDirs;
+    QStringList m_rootDirs;
+    bool m_synchronized;
+    bool m_eventsLost;
+
+    DISALLOW_COPY_AND_ASSIGN(DirectoryWatcher);
+};
@@ -1,9 +1,34 @@
 #include "library/scanner/importfilestask.h"
 
 #include "library/scanner/libraryscanner.h"
+#include "sources/soundsourceproxy.h"
+#include "track/globaltrackcache.h"
 #include "track/trackfile.h"
 #include "util/timer.h"
 
+namespace {
+
+// Parses the metadata and guesses the cover art of a new file on the
+// calling worker thread. Files that are currently cached might have their
+// metadata exported while reading them and are left to the scanner thread,
+// which imports them while holding the lock of the GlobalTrackCache.
+TrackPointer importTemporaryTrack(
+        const TrackFile& trackFile,
+        const SecurityTokenPointer& pToken) {
+    if (!SoundSourceProxy::isFileSupported(trackFile)) {
+        return TrackPointer();
+    }
+    if (GlobalTrackCache::lookupTrackByRef(
+                TrackRef::fromFileInfo(trackFile))) {
+        return TrackPointer();
+    }
+    TrackPointer pTrack = Track::newTemporary(trackFile, pToken);
+    SoundSourceProxy(pTrack).updateTrackFromSource();
+    return pTrack;
+}
+
+} // anonymous namespace
+
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
                                  const ScannerGlobalPointer scannerGlobal,
                                  const QString& dirPath,
@@ -50,7 +75,13 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            TrackPointer pImportedTrack =
+                    importTemporaryTrack(TrackFile(fileInfo), m_pToken);
+            if (pImportedTrack) {
+                emit trackImported(pImportedTrack);
+            } else {
+                emit addNewTrack(trackLocation);
+            }
         }
     }
     // Insert or update the hash in the database.
@@ -18,8 +18,10 @@
 
 namespace {
 
-// TODO(rryan) make configurable
-const int kScannerThreadPoolSize = 1;
+// The number of imported tracks that are inserted into the database at
+// once. The scan runs within a single transaction, batching only reduces
+// the number of wake-ups and progress updates of the scanner thread.
+const int kImportedTracksBatchSize = 100;
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -52,11 +54,14 @@ LibraryScanner::LibraryScanner(
     // queue to our event loop.
     moveToThread(this);
     m_pool.moveToThread(this);
+    m_directoryWatcher.moveToThread(this);
 
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    // Directories are walked and the metadata of new files is parsed on
+    // all cores while the scanner thread inserts the parsed tracks.
+    m_pool.setMaxThreadCount(QThread::idealThreadCount());
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -71,6 +76,10 @@ LibraryScanner::LibraryScanner(
             &LibraryScanner::progressHashing,
             m_pProgressDlg.data(),
             &LibraryScannerDlg::slotUpdate);
+    connect(this,
+            &LibraryScanner::progressFiles,
+            m_pProgressDlg.data(),
+            &LibraryScannerDlg::slotUpdateFiles);
     connect(this,
             &LibraryScanner::scanStarted,
             m_pProgressDlg.data(),
@@ -167,6 +176,7 @@ void LibraryScanner::slotStartScan() {
         return;
     }
     changeScannerState(SCANNING);
+    DEBUG_ASSERT(m_importedTracks.isEmpty());
 
     QSet<QString> trackLocations = m_trackDao.getAllTrackLocations();
     QHash<QString, mixxx::cache_key_t> directoryHashes = m_libraryHashDao.getDirectoryHashes();
@@ -176,26 +186,83 @@ void LibraryScanner::slotStartScan() {
                     Qt::CaseInsensitive);
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
 
+    // Only the directories that have changed since the last scan need to
+    // be scanned if the DirectoryWatcher has recorded all changes.
+    // Otherwise all directories are watched again while walking the
+    // whole library.
+    QSet<QString> dirtyDirs;
+    const bool scanDirtyDirsOnly =
+            m_directoryWatcher.takeDirtyDirectories(m_libraryRootDirs, &dirtyDirs);
+    if (!scanDirtyDirsOnly) {
+        m_directoryWatcher.reset();
+    }
+    // Changes on network file systems are not recorded completely and
+    // these root directories are still walked and hashed every time.
+    QStringList remoteRootDirs;
+    if (scanDirtyDirsOnly) {
+        for (const auto& rootDir : qAsConst(m_libraryRootDirs)) {
+            if (DirectoryWatcher::isRemoteFileSystem(rootDir)) {
+                remoteRootDirs << rootDir;
+            }
+        }
+    }
+
     m_scannerGlobal = ScannerGlobalPointer(
             new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+                              coverExtensionFilter, directoryBlacklist,
+                              !scanDirtyDirsOnly, remoteRootDirs));
 
     m_scannerGlobal->startTimer();
 
     emit scanStarted();
 
-    // First, we're going to mark all the directories that we've previously
-    // hashed as needing verification. As we search through the directory tree
-    // when we rescan, we'll mark any directory that does still exist as
-    // verified.
-    m_libraryHashDao.invalidateAllDirectories();
-
-    // Mark all the tracks in the library as needing verification of their
-    // existence. (ie. we want to check they're still on your hard drive where
-    // we think they are)
-    m_trackDao.invalidateTrackLocationsInLibrary();
-
-    kLogger.debug() << "Recursively scanning library.";
+    QStringList changedDirs;
+    if (scanDirtyDirsOnly) {
+        // Only the changed directories need to be verified. The contents of
+        // removed directories including all their subdirectories are gone.
+        QStringList removedDirs;
+        for (const auto& dirPath : qAsConst(dirtyDirs)) {
+            if (m_scannerGlobal->scanSubdirectories(dirPath)) {
+                // Within a remote root directory
+                continue;
+            }
+            if (QDir(dirPath).exists()) {
+                changedDirs << dirPath;
+            } else {
+                removedDirs << dirPath;
+            }
+        }
+        kLogger.info()
+                << "Scanning"
+                << changedDirs.size()
+                << "changed and"
+                << removedDirs.size()
+                << "removed directories";
+        if (!remoteRootDirs.isEmpty()) {
+            kLogger.info()
+                    << "Scanning all directories on network file systems"
+                    << remoteRootDirs;
+        }
+        m_libraryHashDao.invalidateDirectories(changedDirs, false);
+        m_libraryHashDao.invalidateDirectories(removedDirs, true);
+        m_libraryHashDao.invalidateDirectories(remoteRootDirs, true);
+        m_trackDao.invalidateTrackLocationsInDirectories(changedDirs, false);
+        m_trackDao.invalidateTrackLocationsInDirectories(removedDirs, true);
+        m_trackDao.invalidateTrackLocationsInDirectories(remoteRootDirs, true);
+    } else {
+        // First, we're going to mark all the directories that we've previously
+        // hashed as needing verification. As we search through the directory tree
+        // when we rescan, we'll mark any directory that does still exist as
+        // verified.
+        m_libraryHashDao.invalidateAllDirectories();
+
+        // Mark all the tracks in the library as needing verification of their
+        // existence. (ie. we want to check they're still on your hard drive where
+        // we think they are)
+        m_trackDao.invalidateTrackLocationsInLibrary();
+
+        kLogger.debug() << "Recursively scanning library.";
+    }
 
     // Start scanning the library. This prepares insertion queries in TrackDAO
     // (must be called before calling addTracksAdd) and begins a transaction.
@@ -221,7 +288,22 @@ void LibraryScanner::slotStartScan() {
         // scanning so that relies on having an open bookmark for the containing
         // directory.
         MDir dir(dirPath);
-        if (!m_scannerGlobal->testAndMarkDirectoryScanned(dir.dir())) {
+        if (scanDirtyDirsOnly && !remoteRootDirs.contains(dirPath)) {
+            for (const auto& changedDirPath : qAsConst(changedDirs)) {
+                // Scan the changed directories within this root directory
+                // with its security token
+                const QDir changedDir(changedDirPath);
+                if (dir.dir().relativeFilePath(changedDirPath).startsWith("..") ||
+                        m_scannerGlobal->directoryBlacklisted(changedDirPath) ||
+                        m_scannerGlobal->testAndMarkDirectoryScanned(changedDir)) {
+                    continue;
+                }
+                queueTask(new RecursiveScanDirectoryTask(this, m_scannerGlobal,
+                                                         changedDir,
+                                                         dir.token(),
+                                                         false));
+            }
+        } else if (!m_scannerGlobal->testAndMarkDirectoryScanned(dir.dir())) {
             queueTask(new RecursiveScanDirectoryTask(this, m_scannerGlobal,
                                                      dir.dir(),
                                                      dir.token(),
@@ -372,6 +454,11 @@ void LibraryScanner::slotFinishUnhashedScan() {
         kLogger.debug() << "Recursive scanning interrupted by the user";
     }
 
+    // Tracks that have already been imported are added even if the scan
+    // has been cancelled, because the hashes of their directories have
+    // already been updated.
+    addImportedTracks();
+
     // Finish adding the tracks -- rollback the transaction if the scan did not
     // finish cleanly and the user did not cancel the transaction.
     m_trackDao.addTracksFinish(!m_scannerGlobal->shouldCancel() &&
@@ -383,8 +470,15 @@ void LibraryScanner::slotFinishUnhashedScan() {
 
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         kLogger.debug() << "Scan finished cleanly";
+        if (m_scannerGlobal->scanSubdirectories()) {
+            // All directories have been watched while walking the library
+            m_directoryWatcher.setSynchronized(m_libraryRootDirs);
+        }
     } else {
         kLogger.debug() << "Scan cancelled";
+        // The changes that have been taken from the watcher might not
+        // have been scanned
+        m_directoryWatcher.reset();
     }
 
     // TODO(XXX) doesn't take into account verifyRemainingTracks.
@@ -479,6 +573,10 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             &ScannerTask::addNewTrack,
             this,
             &LibraryScanner::slotAddNewTrack);
+    connect(pTask,
+            &ScannerTask::trackImported,
+            this,
+            &LibraryScanner::slotTrackImported);
 
     // Progress signals.
     // Pass directly to the main thread
@@ -512,6 +610,7 @@ void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
         m_libraryHashDao.updateDirectoryHash(directoryPath, hash, 0);
     }
     emit progressHashing(directoryPath);
+    reportFilesProgress();
 }
 
 void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
@@ -536,6 +635,47 @@ void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
     ScopedTimer timer("LibraryScanner::addNewTrack");
     // For statistics tracking and to detect moved tracks
     TrackPointer pTrack(m_trackDao.addTracksAddFile(trackPath, false));
+    acknowledgeAddedTrack(pTrack, trackPath);
+    if (pTrack) {
+        emit progressLoading(pTrack->getLocation());
+    }
+}
+
+void LibraryScanner::slotTrackImported(TrackPointer pImportedTrack) {
+    if (!m_scannerGlobal) {
+        return;
+    }
+    m_importedTracks.append(std::move(pImportedTrack));
+    if (m_importedTracks.size() >= kImportedTracksBatchSize) {
+        addImportedTracks();
+    }
+}
+
+void LibraryScanner::addImportedTracks() {
+    if (m_importedTracks.isEmpty()) {
+        return;
+    }
+    ScopedTimer timer("LibraryScanner::addImportedTracks");
+    const QList<TrackPointer> importedTracks = std::move(m_importedTracks);
+    m_importedTracks.clear();
+    QString lastTrackLocation;
+    for (const auto& pImportedTrack : importedTracks) {
+        TrackPointer pTrack(m_trackDao.addTracksAddImportedTrack(pImportedTrack, false));
+        acknowledgeAddedTrack(pTrack, pImportedTrack->getLocation());
+        if (pTrack) {
+            lastTrackLocation = pTrack->getLocation();
+        }
+    }
+    // The progress is only reported once per batch
+    if (!lastTrackLocation.isEmpty()) {
+        emit progressLoading(lastTrackLocation);
+    }
+    reportFilesProgress();
+}
+
+void LibraryScanner::acknowledgeAddedTrack(
+        const TrackPointer& pTrack,
+        const QString& trackPath) {
     if (pTrack) {
         // The track's actual location might differ from the
         // given trackPath
@@ -547,7 +687,6 @@ void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
         // Signal the main instance of TrackDAO, that there is
         // a new track in the database.
         emit trackAdded(pTrack);
-        emit progressLoading(trackLocation);
     } else {
         // Acknowledge failed track addition
         // TODO(XXX): Is it really intended to acknowledge a failed
@@ -561,6 +700,14 @@ void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
     }
 }
 
+void LibraryScanner::reportFilesProgress() {
+    if (m_scannerGlobal) {
+        emit progressFiles(
+                m_scannerGlobal->addedTracks().size() +
+                m_scannerGlobal->verifiedTracks().size());
+    }
+}
+
 bool LibraryScanner::changeScannerState(ScannerState newState) {
     switch (newState) {
     case IDLE:
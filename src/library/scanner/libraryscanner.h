@@ -14,6 +14,7 @@
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
 #include "library/dao/analysisdao.h"
+#include "library/scanner/directorywatcher.h"
 #include "library/scanner/scannerglobal.h"
 #include "track/track.h"
 #include "util/db/dbconnectionpool.h"
@@ -40,12 +41,20 @@ class LibraryScanner : public QThread {
     // Call from any thread to cancel the scan.
     void slotCancel();
 
+  public:
+    // Called by the ScannerTasks for every directory that they scan
+    void watchDirectory(const QString& dirPath) {
+        m_directoryWatcher.watchDirectory(dirPath);
+    }
+
   signals:
     void scanStarted();
     void scanFinished();
     void progressHashing(QString);
     void progressLoading(QString path);
     void progressCoverArt(QString file);
+    // The number of files that have been added or verified so far
+    void progressFiles(int numFiles);
     void trackAdded(TrackPointer pTrack);
     void tracksChanged(QSet<TrackId> changedTrackIds);
     void tracksRelocated(QList<RelocatedTrack> relocatedTracks);
@@ -71,6 +80,7 @@ class LibraryScanner : public QThread {
     void slotDirectoryUnchanged(const QString& directoryPath);
     void slotTrackExists(const QString& trackPath);
     void slotAddNewTrack(const QString& trackPath);
+    void slotTrackImported(TrackPointer pImportedTrack);
 
   private:
     enum ScannerState {
@@ -96,11 +106,21 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    // Inserts the pending imported tracks into the database
+    void addImportedTracks();
+    void acknowledgeAddedTrack(
+            const TrackPointer& pTrack,
+            const QString& trackPath);
+    void reportFilesProgress();
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
 
+    // Records the directories that have changed since the last scan
+    DirectoryWatcher m_directoryWatcher;
+
     // The library scanner thread's DAOs.
     LibraryHashDAO m_libraryHashDao;
     CueDAO m_cueDao;
@@ -120,6 +140,11 @@ class LibraryScanner : public QThread {
     volatile ScannerState m_state;
 
     QStringList m_libraryRootDirs;
+
+    // Tracks that have been imported by the worker threads and are
+    // inserted into the database in batches.
+    QList<TrackPointer> m_importedTracks;
+
     QScopedPointer<LibraryScannerDlg> m_pProgressDlg;
 };
 
@@ -48,6 +48,10 @@ LibraryScannerDlg::LibraryScannerDlg(QWidget* parent, Qt::WindowFlags f)
     pCurrent->setWordWrap(true);
     connect(this, &LibraryScannerDlg::progress, pCurrent, &QLabel::setText);
     pLayout->addWidget(pCurrent);
+
+    QLabel* pThroughput = new QLabel(this);
+    connect(this, &LibraryScannerDlg::throughput, pThroughput, &QLabel::setText);
+    pLayout->addWidget(pThroughput);
     setLayout(pLayout);
 }
 
@@ -80,6 +84,17 @@ void LibraryScannerDlg::slotUpdateCover(QString path) {
     }
 }
 
+void LibraryScannerDlg::slotUpdateFiles(int numFiles) {
+    if (isVisible()) {
+        const double elapsedSeconds = m_timer.elapsed().toDoubleSeconds();
+        const int filesPerSecond = elapsedSeconds > 0
+                ? static_cast<int>(numFiles / elapsedSeconds)
+                : 0;
+        emit throughput(tr("%1 files scanned (%2 files/s)")
+                .arg(QString::number(numFiles), QString::number(filesPerSecond)));
+    }
+}
+
 void LibraryScannerDlg::slotCancel() {
     qDebug() << "Cancelling library scan...";
     m_bCancelled = true;
@@ -90,6 +105,7 @@ void LibraryScannerDlg::slotCancel() {
 void LibraryScannerDlg::slotScanStarted() {
     m_bCancelled = false;
     m_timer.start();
+    emit throughput(QString());
 }
 
 void LibraryScannerDlg::slotScanFinished() {
@@ -34,6 +34,7 @@ class LibraryScannerDlg : public QWidget {
   public slots:
     void slotUpdate(QString path);
     void slotUpdateCover(QString path);
+    void slotUpdateFiles(int numFiles);
     void slotCancel();
     void slotScanFinished();
     void slotScanStarted();
@@ -41,6 +42,7 @@ class LibraryScannerDlg : public QWidget {
   signals:
     void scanCancelled();
     void progress(QString);
+    void throughput(QString);
 
   private:
     PerformanceTimer m_timer;
@@ -23,6 +23,10 @@ void RecursiveScanDirectoryTask::run() {
         return;
     }
 
+    // Watch the directory before listing it to not miss any changes
+    // until the next scan
+    m_pScanner->watchDirectory(m_dir.path());
+
     // For making the scanner slow
     //qDebug() << "Burn CPU";
     //for (int i = 0;i < 1000000000; i++) asm("nop");
@@ -104,7 +108,11 @@ void RecursiveScanDirectoryTask::run() {
         m_scannerGlobal->addUnhashedDir(m_dir, m_pToken);
     }
 
-    // Process all of the sub-directories.
+    // Process all of the sub-directories. Changed subdirectories are
+    // scanned separately if only changed directories are scanned.
+    if (!m_scannerGlobal->scanSubdirectories(dirPath)) {
+        dirsToScan.clear();
+    }
     foreach (const QDir& nextDir, dirsToScan) {
         // Atomically test and mark the directory as scanned to avoid
         // that the same directory is scanned multiple times by different
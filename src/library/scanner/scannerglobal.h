@@ -41,12 +41,16 @@ class ScannerGlobal {
                   const QHash<QString, mixxx::cache_key_t>& directoryHashes,
                   const QRegExp& supportedExtensionsMatcher,
                   const QRegExp& supportedCoverExtensionsMatcher,
-                  const QStringList& directoriesBlacklist)
+                  const QStringList& directoriesBlacklist,
+                  bool scanSubdirectories = true,
+                  const QStringList& remoteRootDirs = QStringList())
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_scanSubdirectories(scanSubdirectories),
+              m_remoteRootDirs(remoteRootDirs),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
@@ -67,6 +71,29 @@ class ScannerGlobal {
         return m_directoryHashes.value(directoryPath, -1);
     }
 
+    // False if only the directories that have changed since the last scan
+    // are scanned
+    bool scanSubdirectories() const {
+        return m_scanSubdirectories;
+    }
+
+    // The subdirectories of directories on network file systems are
+    // always scanned, because their changes are not recorded
+    bool scanSubdirectories(const QString& dirPath) const {
+        if (m_scanSubdirectories) {
+            return true;
+        }
+        for (const auto& rootDir : m_remoteRootDirs) {
+            if (dirPath.startsWith(rootDir) &&
+                    (dirPath.size() == rootDir.size() ||
+                            rootDir.endsWith('/') ||
+                            dirPath.at(rootDir.size()) == '/')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     inline bool directoryBlacklisted(const QString& directoryPath) const {
         return m_directoriesBlacklist.contains(directoryPath);
     }
@@ -203,6 +230,9 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const bool m_scanSubdirectories;
+    const QStringList m_remoteRootDirs;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -26,6 +26,8 @@ class ScannerTask : public QObject, public QRunnable {
     void directoryUnchanged(const QString& directoryPath);
     void trackExists(const QString& filePath);
     void addNewTrack(const QString& filePath);
+    // A temporary track with the metadata and cover art of a new file
+    void trackImported(TrackPointer pImportedTrack);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
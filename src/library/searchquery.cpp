@@ -2,6 +2,7 @@
 
 #include "library/searchquery.h"
 
+#include "library/columnartrackindex.h"
 #include "library/queryutil.h"
 #include "track/keyutils.h"
 #include "library/dao/trackschema.h"
@@ -10,6 +11,44 @@
 #include "util/db/dbconnection.h"
 
 
+namespace {
+
+void setNeutral(QueryNode::IndexRows* pRows) {
+    pRows->matching.clear();
+    pRows->unknown.clear();
+    pRows->neutral = true;
+}
+
+// Combines the results of the columns of a node like OR in SQL
+void setColumnRows(QueryNode::IndexRows* pRows,
+        const QBitArray& matching,
+        const QBitArray& unknown) {
+    pRows->matching = matching;
+    pRows->unknown = unknown & ~matching;
+    pRows->neutral = false;
+}
+
+bool isComparisonTrue(const QString& op, int comparison) {
+    if (op == "=") {
+        return comparison == 0;
+    } else if (op == "<") {
+        return comparison < 0;
+    } else if (op == ">") {
+        return comparison > 0;
+    } else if (op == "<=") {
+        return comparison <= 0;
+    } else if (op == ">=") {
+        return comparison >= 0;
+    }
+    return false;
+}
+
+int compareNumbers(double lhs, double rhs) {
+    return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+} // anonymous namespace
+
 QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& column) {
     if (column == LIBRARYTABLE_ARTIST) {
         return pTrack->getArtist();
@@ -87,6 +126,35 @@ bool AndNode::match(const TrackPointer& pTrack) const {
     return true;
 }
 
+bool AndNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    // A row is unknown if it is unknown for some nodes and matches all
+    // others, like in SQL
+    QBitArray matching = index.allRows();
+    QBitArray notFailing = matching;
+    bool neutral = true;
+    for (const auto& pNode: m_nodes) {
+        IndexRows rows;
+        if (!pNode->search(index, &rows)) {
+            return false;
+        }
+        if (rows.neutral) {
+            continue;
+        }
+        neutral = false;
+        matching &= rows.matching;
+        notFailing &= rows.matching | rows.unknown;
+    }
+    if (neutral) {
+        // Consistent with the empty SQL expression
+        setNeutral(pRows);
+        return true;
+    }
+    pRows->matching = matching;
+    pRows->unknown = notFailing & ~matching;
+    pRows->neutral = false;
+    return true;
+}
+
 QString AndNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -116,6 +184,30 @@ bool OrNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool OrNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    QBitArray matching(index.rowCount());
+    QBitArray unknown(index.rowCount());
+    bool neutral = true;
+    for (const auto& pNode: m_nodes) {
+        IndexRows rows;
+        if (!pNode->search(index, &rows)) {
+            return false;
+        }
+        if (rows.neutral) {
+            continue;
+        }
+        neutral = false;
+        matching |= rows.matching;
+        unknown |= rows.unknown;
+    }
+    if (neutral) {
+        setNeutral(pRows);
+        return true;
+    }
+    setColumnRows(pRows, matching, unknown);
+    return true;
+}
+
 QString OrNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -132,6 +224,22 @@ bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
 
+bool NotNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    IndexRows rows;
+    if (!m_pNode->search(index, &rows)) {
+        return false;
+    }
+    if (rows.neutral) {
+        *pRows = rows;
+        return true;
+    }
+    // NOT NULL is still NULL
+    pRows->matching = index.allRows() & ~(rows.matching | rows.unknown);
+    pRows->unknown = rows.unknown;
+    pRows->neutral = false;
+    return true;
+}
+
 QString NotNode::toSql() const {
     QString sql(m_pNode->toSql());
     if (sql.isEmpty()) {
@@ -188,6 +296,30 @@ QString TextFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool TextFilterNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    if (m_sqlColumns.isEmpty()) {
+        setNeutral(pRows);
+        return true;
+    }
+    if (m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne)) {
+        // The user typed LIKE wildcards
+        return false;
+    }
+    QBitArray matching(index.rowCount());
+    QBitArray unknown(index.rowCount());
+    for (const auto& sqlColumn: m_sqlColumns) {
+        const int column = index.columnIndex(sqlColumn);
+        if (column < 0) {
+            return false;
+        }
+        matching |= index.rowsContaining(column, m_argument);
+        unknown |= index.rowsWithNull(column);
+    }
+    setColumnRows(pRows, matching, unknown);
+    return true;
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -208,6 +340,26 @@ QString NullOrEmptyTextFilterNode::toSql() const {
     return QString();
 }
 
+bool NullOrEmptyTextFilterNode::search(
+        const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    if (m_sqlColumns.isEmpty()) {
+        setNeutral(pRows);
+        return true;
+    }
+    // only use the major column
+    const int column = index.columnIndex(m_sqlColumns.first());
+    if (column < 0) {
+        return false;
+    }
+    const QBitArray empty = index.rowsMatching(column,
+            [](double) { return false; },
+            [](const QString& text) { return text.isEmpty(); });
+    setColumnRows(pRows,
+            index.rowsWithNull(column) | empty,
+            QBitArray(index.rowCount()));
+    return true;
+}
+
 CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
                                  const QString& crateNameLike)
     : m_pCrateStorage(pCrateStorage),
@@ -215,7 +367,7 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
       m_matchInitialized(false) {
 }
 
-bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+const std::vector<TrackId>& CrateFilterNode::matchingTrackIds() const {
     if (!m_matchInitialized) {
         CrateTrackSelectResult crateTracks(
              m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
@@ -226,8 +378,19 @@ bool CrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+    return m_matchingTrackIds;
+}
+
+bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    const std::vector<TrackId>& trackIds = matchingTrackIds();
+    return std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
+}
 
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool CrateFilterNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    setColumnRows(pRows,
+            index.rowsOfTracks(matchingTrackIds()),
+            QBitArray(index.rowCount()));
+    return true;
 }
 
 QString CrateFilterNode::toSql() const {
@@ -241,7 +404,7 @@ NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
       m_matchInitialized(false) {
 }
 
-bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+const std::vector<TrackId>& NoCrateFilterNode::matchingTrackIds() const {
     if (!m_matchInitialized) {
         TrackSelectResult tracks(
                 m_pCrateStorage->selectAllTracksSorted());
@@ -252,8 +415,20 @@ bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+    return m_matchingTrackIds;
+}
+
+bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    const std::vector<TrackId>& trackIds = matchingTrackIds();
+    return !std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
+}
 
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool NoCrateFilterNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    // The ids of the tracks in crates
+    setColumnRows(pRows,
+            index.allRows() & ~index.rowsOfTracks(matchingTrackIds()),
+            QBitArray(index.rowCount()));
+    return true;
 }
 
 QString NoCrateFilterNode::toSql() const {
@@ -376,6 +551,63 @@ QString NumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NumericFilterNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    if (m_sqlColumns.isEmpty() ||
+            (!m_bNullQuery && !m_bOperatorQuery && !m_bRangeQuery)) {
+        setNeutral(pRows);
+        return true;
+    }
+    if (m_bNullQuery) {
+        // only use the major column
+        const int column = index.columnIndex(m_sqlColumns.first());
+        if (column < 0) {
+            return false;
+        }
+        setColumnRows(pRows, index.rowsWithNull(column), QBitArray(index.rowCount()));
+        return true;
+    }
+
+    // Compare with the literals of toSql(). Strings are compared as text
+    // like the values of a column with text affinity, e.g. the year.
+    std::function<bool(double)> numberPredicate;
+    std::function<bool(const QString&)> stringPredicate;
+    if (m_bOperatorQuery) {
+        const QString literal = QString::number(m_dOperatorArgument);
+        const double argument = literal.toDouble();
+        const QString op = m_operator;
+        numberPredicate = [op, argument](double value) {
+            return isComparisonTrue(op, compareNumbers(value, argument));
+        };
+        stringPredicate = [op, literal](const QString& text) {
+            return isComparisonTrue(op, text.compare(literal));
+        };
+    } else {
+        const QString lowLiteral = QString::number(m_dRangeLow);
+        const QString highLiteral = QString::number(m_dRangeHigh);
+        const double low = lowLiteral.toDouble();
+        const double high = highLiteral.toDouble();
+        numberPredicate = [low, high](double value) {
+            return value >= low && value <= high;
+        };
+        stringPredicate = [lowLiteral, highLiteral](const QString& text) {
+            return text.compare(lowLiteral) >= 0 && text.compare(highLiteral) <= 0;
+        };
+    }
+
+    QBitArray matching(index.rowCount());
+    QBitArray unknown(index.rowCount());
+    for (const auto& sqlColumn: m_sqlColumns) {
+        const int column = index.columnIndex(sqlColumn);
+        if (column < 0) {
+            return false;
+        }
+        matching |= index.rowsMatching(column, numberPredicate, stringPredicate);
+        unknown |= index.rowsWithNull(column);
+    }
+    setColumnRows(pRows, matching, unknown);
+    return true;
+}
+
 NullNumericFilterNode::NullNumericFilterNode(const QStringList& sqlColumns)
         : m_sqlColumns(sqlColumns) {
 }
@@ -400,6 +632,21 @@ QString NullNumericFilterNode::toSql() const {
 }
 
 
+bool NullNumericFilterNode::search(
+        const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    if (m_sqlColumns.isEmpty()) {
+        setNeutral(pRows);
+        return true;
+    }
+    // only use the major column
+    const int column = index.columnIndex(m_sqlColumns.first());
+    if (column < 0) {
+        return false;
+    }
+    setColumnRows(pRows, index.rowsWithNull(column), QBitArray(index.rowCount()));
+    return true;
+}
+
 DurationFilterNode::DurationFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns) {
@@ -458,3 +705,29 @@ QString KeyFilterNode::toSql() const {
     }
     return concatSqlClauses(searchClauses, "OR");
 }
+
+bool KeyFilterNode::search(const ColumnarTrackIndex& index, IndexRows* pRows) const {
+    if (m_matchKeys.isEmpty()) {
+        setNeutral(pRows);
+        return true;
+    }
+    const int column = index.columnIndex(LIBRARYTABLE_KEY_ID);
+    if (column < 0) {
+        return false;
+    }
+    const QList<mixxx::track::io::key::ChromaticKey> matchKeys = m_matchKeys;
+    const QBitArray matching = index.rowsMatching(column,
+            [matchKeys](double value) {
+                for (const auto& matchKey: matchKeys) {
+                    if (value == matchKey) {
+                        return true;
+                    }
+                }
+                return false;
+            },
+            // The key ids are integers
+            [](const QString&) { return false; });
+    // IS never evaluates to NULL
+    setColumnRows(pRows, matching, QBitArray(index.rowCount()));
+    return true;
+}
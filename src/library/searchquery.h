@@ -4,6 +4,7 @@
 #include <vector>
 #include <utility>
 
+#include <QBitArray>
 #include <QList>
 #include <QSqlDatabase>
 #include <QRegExp>
@@ -16,6 +17,8 @@
 #include "util/memory.h"
 #include "library/crate/cratestorage.h"
 
+class ColumnarTrackIndex;
+
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
 
 QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& column);
@@ -25,8 +28,21 @@ class QueryNode {
     QueryNode(const QueryNode&) = delete; // prevent copying
     virtual ~QueryNode() {}
 
+    // The rows of a ColumnarTrackIndex for which a node evaluates to TRUE
+    // and to NULL, following the three-valued logic of SQL. A node with an
+    // empty SQL expression is neutral, i.e. it is ignored by its parent.
+    struct IndexRows {
+        QBitArray matching;
+        QBitArray unknown;
+        bool neutral = false;
+    };
+
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
+    // Evaluates the node for all rows of the index with the same result as
+    // the database would evaluate toSql(). Returns false if the node can
+    // only be evaluated by the database.
+    virtual bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const = 0;
 
   protected:
     QueryNode() {}
@@ -52,12 +68,14 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 };
 
 class NotNode : public QueryNode {
@@ -69,6 +87,7 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -82,6 +101,7 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
   private:
     QSqlDatabase m_database;
@@ -99,6 +119,7 @@ class NullOrEmptyTextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
   private:
     QSqlDatabase m_database;
@@ -113,8 +134,11 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
   private:
+    const std::vector<TrackId>& matchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -127,8 +151,11 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
   private:
+    const std::vector<TrackId>& matchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -141,6 +168,7 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -171,6 +199,7 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
     QStringList m_sqlColumns;
 };
@@ -189,6 +218,7 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
@@ -214,6 +244,13 @@ class SqlNode : public QueryNode {
         return m_sql;
     }
 
+    bool search(const ColumnarTrackIndex& index, IndexRows* pRows) const override {
+        // Only the database can evaluate arbitrary SQL
+        Q_UNUSED(index);
+        Q_UNUSED(pRows);
+        return false;
+    }
+
   private:
     QString m_sql;
 };
@@ -534,6 +534,11 @@ TrackPointer TrackCollection::getTrackById(
     return m_trackDao.getTrackById(trackId);
 }
 
+TrackPointerList TrackCollection::getTracksById(
+        const QList<TrackId>& trackIds) const {
+    return m_trackDao.getTracksById(trackIds);
+}
+
 TrackPointer TrackCollection::getTrackByRef(
         const TrackRef& trackRef) const {
     return m_trackDao.getTrackByRef(trackRef);
@@ -84,6 +84,9 @@ class TrackCollection : public QObject,
 
     TrackPointer getTrackById(
             TrackId trackId) const;
+    // Prefer this over getTrackById() for loading many tracks at once
+    TrackPointerList getTracksById(
+            const QList<TrackId>& trackIds) const;
 
     TrackPointer getTrackByRef(
             const TrackRef& trackRef) const;
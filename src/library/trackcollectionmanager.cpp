@@ -4,6 +4,8 @@
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
 
+#include "sources/seekindexbuilder.h"
+#include "sources/seekindexfile.h"
 #include "sources/soundsourceproxy.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/logger.h"
@@ -115,10 +117,18 @@ TrackCollectionManager::TrackCollectionManager(
 
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
+
+#ifdef __MAD__
+        if (mixxx::SeekIndexFile::isEnabled()) {
+            m_pSeekIndexBuilder = std::make_unique<mixxx::SeekIndexBuilder>();
+        }
+#endif
     }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    m_pSeekIndexBuilder.reset();
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
@@ -408,6 +418,10 @@ void TrackCollectionManager::slotScanTrackAdded(TrackPointer pTrack) {
     DEBUG_ASSERT(pTrack);
     DEBUG_ASSERT(pTrack->getDateAdded().isValid());
 
+    if (m_pSeekIndexBuilder) {
+        m_pSeekIndexBuilder->enqueue(pTrack->getLocation());
+    }
+
     // Already added to m_pInternalCollection
     if (m_externalCollections.isEmpty()) {
         return;
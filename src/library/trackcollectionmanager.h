@@ -16,6 +16,12 @@ class LibraryScanner;
 class TrackCollection;
 class ExternalTrackCollection;
 
+namespace mixxx {
+
+class SeekIndexBuilder;
+
+} // namespace mixxx
+
 // Manages Mixxx's internal database of tracks as well as external track collections.
 //
 // All modifying operations that might affect external collections
@@ -102,4 +108,7 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    // Only available if MP3 files are decoded with libmad
+    std::unique_ptr<mixxx::SeekIndexBuilder> m_pSeekIndexBuilder;
 };
@@ -25,11 +25,15 @@
 
 #include "mixxx.h"
 #include "mixxxapplication.h"
+#include "mixer/offlinerenderer.h"
+#include "mixer/renderscript.h"
+#include "preferences/settingsmanager.h"
 #include "sources/soundsourceproxy.h"
 #include "errordialoghandler.h"
 #include "util/cmdlineargs.h"
 #include "util/console.h"
 #include "util/logging.h"
+#include "util/realtimeguard.h"
 #include "util/version.h"
 
 #ifdef Q_OS_LINUX
@@ -55,6 +59,17 @@ int runMixxx(MixxxApplication* app, const CmdlineArgs& args) {
     return result;
 }
 
+int runOfflineRender(const CmdlineArgs& args) {
+    RenderScript script;
+    if (!script.load(args.getRenderScriptPath())) {
+        qWarning() << "Invalid render script:" << script.errorString();
+        return 1;
+    }
+    SettingsManager settingsManager(nullptr, args.getSettingsPath());
+    OfflineRenderer renderer(settingsManager.settings(), script);
+    return renderer.render(args.getRenderOutputPath()) ? 0 : 1;
+}
+
 } // anonymous namespace
 
 int main(int argc, char * argv[]) {
@@ -103,10 +118,20 @@ int main(int argc, char * argv[]) {
                                args.getLogFlushLevel(),
                                args.getDebugAssertBreak());
 
+    // Offline rendering has no windows, also not on machines without a
+    // display
+    if (args.getRenderEnabled() && qgetenv("QT_QPA_PLATFORM").isEmpty()) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     MixxxApplication app(argc, argv);
 
     SoundSourceProxy::registerSoundSourceProviders();
 
+    // Reports allocations and locks on the audio threads in builds with
+    // the realtime allocation detector
+    RealtimeGuard::install();
+
 #ifdef __APPLE__
     QDir dir(QApplication::applicationDirPath());
     // Set the search path for Qt plugins to be in the bundle's PlugIns
@@ -127,10 +152,17 @@ int main(int argc, char * argv[]) {
     // When the last window is closed, terminate the Qt event loop.
     QObject::connect(&app, &MixxxApplication::lastWindowClosed, &app, &MixxxApplication::quit);
 
-    int result = runMixxx(&app, args);
+    int result;
+    if (args.getRenderEnabled()) {
+        result = runOfflineRender(args);
+    } else {
+        result = runMixxx(&app, args);
+    }
 
     qDebug() << "Mixxx shutdown complete with code" << result;
 
+    RealtimeGuard::uninstall();
+
     mixxx::Logging::shutdown();
 
     return result;
@@ -0,0 +1,284 @@
+#include "mixer/offlinerenderer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include <sndfile.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "control/controlobject.h"
+#include "effects/builtin/builtinbackend.h"
+#include "effects/effectrack.h"
+#include "effects/effectsmanager.h"
+#ifdef __LILV__
+#include "effects/lv2/lv2backend.h"
+#endif
+#include "engine/channelhandle.h"
+#include "engine/channels/enginedeck.h"
+#include "engine/enginebuffer.h"
+#include "engine/enginemaster.h"
+#include "mixer/deck.h"
+#include "mixer/playermanager.h"
+#include "soundio/soundmanagerutil.h"
+#include "sources/soundsourceproxy.h"
+#include "util/duration.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
+#include "waveform/guitick.h"
+#include "waveform/visualsmanager.h"
+
+namespace {
+
+const mixxx::Logger kLogger("OfflineRenderer");
+
+// A track that takes longer to open is considered broken
+const int kTrackLoadTimeoutMillis = 30000;
+
+} // anonymous namespace
+
+OfflineRenderer::OfflineRenderer(
+        UserSettingsPointer pConfig, const RenderScript& script)
+        : m_script(script) {
+    // The same setup as in MixxxMainWindow::initialize(), without sound
+    // devices, library and GUI.
+    m_pGuiTick = std::make_unique<GuiTick>();
+    m_pChannelHandleFactory = std::make_unique<ChannelHandleFactory>();
+    m_pNumDecks = std::make_unique<ControlObject>(
+            ConfigKey("[Master]", "num_decks"), true, true);
+
+    m_pEffectsManager = std::make_unique<EffectsManager>(
+            nullptr, pConfig, m_pChannelHandleFactory.get());
+    m_pEngine = std::make_unique<EngineMaster>(pConfig, "[Master]",
+            m_pEffectsManager.get(), m_pChannelHandleFactory.get(), false);
+    m_pEffectsManager->addEffectsBackend(
+            new BuiltInBackend(m_pEffectsManager.get()));
+#ifdef __LILV__
+    m_pEffectsManager->addEffectsBackend(
+            new LV2Backend(m_pEffectsManager.get()));
+#endif
+    m_pEffectsManager->setup();
+
+    m_pVisualsManager = std::make_unique<VisualsManager>();
+
+    // See PlayerManager::addDeckInner()
+    for (int i = 0; i < m_script.numDecks(); ++i) {
+        const QString group = PlayerManager::groupForDeck(i);
+        Deck* pDeck = new Deck(nullptr, pConfig, m_pEngine.get(),
+                m_pEffectsManager.get(), m_pVisualsManager.get(),
+                i % 2 == 0 ? EngineChannel::LEFT : EngineChannel::RIGHT,
+                group);
+        m_pEffectsManager->getEqualizerRack(0)->setupForGroup(group);
+        pDeck->setupEqControls();
+        m_pEffectsManager->getQuickEffectRack(0)->setupForGroup(group);
+        m_decks.append(pDeck);
+        m_pNumDecks->set(i + 1);
+    }
+
+    m_pEffectsManager->loadEffectChains();
+
+    // Usually done by SoundManager when the devices are opened
+    ControlObject::set(ConfigKey("[Master]", "samplerate"),
+            m_script.sampleRate());
+    m_pEngine->onOutputConnected(AudioOutput(AudioOutput::MASTER, 0, 2));
+}
+
+OfflineRenderer::~OfflineRenderer() {
+    // The engine deletes the EngineChannels of the decks
+    for (Deck* pDeck : m_decks) {
+        delete pDeck;
+    }
+    m_decks.clear();
+    m_pEngine.reset();
+    // Must be deleted after EngineMaster
+    m_pEffectsManager.reset();
+    m_pVisualsManager.reset();
+    m_pNumDecks.reset();
+    m_pGuiTick.reset();
+}
+
+SINT OfflineRenderer::framesForTime(double seconds) const {
+    return static_cast<SINT>(std::round(seconds * m_script.sampleRate()));
+}
+
+bool OfflineRenderer::render(const QString& outputFileName) {
+    SNDFILE* pOutputFile = nullptr;
+    if (!outputFileName.isEmpty()) {
+        SF_INFO sfInfo;
+        memset(&sfInfo, 0, sizeof(sfInfo));
+        sfInfo.samplerate = m_script.sampleRate();
+        sfInfo.channels = 2;
+        sfInfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        pOutputFile = sf_open(QFile::encodeName(outputFileName),
+                SFM_WRITE, &sfInfo);
+        if (!pOutputFile) {
+            kLogger.warning() << "Failed to open" << outputFileName
+                              << sf_strerror(nullptr);
+            return false;
+        }
+    }
+
+    const QList<RenderScript::Event>& events = m_script.events();
+    const SINT bufferFrames = m_script.bufferSize();
+    const SINT endFrame = framesForTime(m_script.endTime());
+    int nextEvent = 0;
+    SINT renderedFrames = 0;
+    qint64 numBuffers = 0;
+    bool success = true;
+
+    PerformanceTimer renderTimer;
+    PerformanceTimer processTimer;
+    mixxx::Duration processDuration;
+    renderTimer.start();
+    while (success && renderedFrames < endFrame) {
+        // The end event is the last one and never applied
+        while (nextEvent < events.size() - 1 &&
+                framesForTime(events[nextEvent].time) <
+                        renderedFrames + bufferFrames) {
+            if (!applyEvent(events[nextEvent])) {
+                success = false;
+                break;
+            }
+            ++nextEvent;
+        }
+        if (!success) {
+            break;
+        }
+        // Seeks and hotcues requested by the events are performed by the
+        // next callback, which reads at the new position immediately
+        for (Deck* pDeck : m_decks) {
+            pDeck->getEngineDeck()->getEngineBuffer()->hintQueuedSeek();
+        }
+        waitForReaders();
+
+        processTimer.start();
+        m_pEngine->process(bufferFrames * 2);
+        processDuration += processTimer.elapsed();
+        ++numBuffers;
+
+        const SINT frames = math_min(bufferFrames, endFrame - renderedFrames);
+        if (pOutputFile &&
+                sf_writef_float(pOutputFile, m_pEngine->getMasterBuffer(),
+                        frames) != frames) {
+            kLogger.warning() << "Failed to write" << outputFileName
+                              << sf_strerror(pOutputFile);
+            success = false;
+        }
+        renderedFrames += frames;
+
+        // Deliver the queued signals of the controls, as the event loop of
+        // the GUI thread does
+        QCoreApplication::processEvents();
+    }
+    const mixxx::Duration renderDuration = renderTimer.elapsed();
+
+    if (pOutputFile) {
+        sf_close(pOutputFile);
+    }
+    if (!success) {
+        return false;
+    }
+
+    const double renderedSeconds =
+            static_cast<double>(renderedFrames) / m_script.sampleRate();
+    fprintf(stdout,
+            "Rendered %.1f s of audio in %.3f s (%.1fx realtime)\n"
+            "Engine: %lld buffers of %d frames in %.3f s, "
+            "%.0f buffers/s (%.1fx realtime)\n",
+            renderedSeconds,
+            renderDuration.toDoubleSeconds(),
+            renderedSeconds / renderDuration.toDoubleSeconds(),
+            static_cast<long long>(numBuffers),
+            static_cast<int>(bufferFrames),
+            processDuration.toDoubleSeconds(),
+            numBuffers / processDuration.toDoubleSeconds(),
+            renderedSeconds / processDuration.toDoubleSeconds());
+    return true;
+}
+
+bool OfflineRenderer::applyEvent(const RenderScript::Event& event) {
+    switch (event.type) {
+    case RenderScript::Event::Type::Load:
+        return loadTrack(event);
+    case RenderScript::Event::Type::Set: {
+        ControlObject* pControl = ControlObject::getControl(
+                ConfigKey(event.group, event.item), false);
+        if (!pControl) {
+            kLogger.warning() << "Line" << event.line << ": unknown control"
+                              << event.group << event.item;
+            return false;
+        }
+        pControl->set(event.value);
+        return true;
+    }
+    case RenderScript::Event::Type::End:
+        break;
+    }
+    return true;
+}
+
+bool OfflineRenderer::loadTrack(const RenderScript::Event& event) {
+    Deck* pDeck = nullptr;
+    for (Deck* pCandidate : m_decks) {
+        if (pCandidate->getGroup() == event.group) {
+            pDeck = pCandidate;
+        }
+    }
+    if (!pDeck) {
+        kLogger.warning() << "Line" << event.line << ": unknown deck"
+                          << event.group;
+        return false;
+    }
+    // A failed load would open a message box
+    const QFileInfo fileInfo(event.location);
+    if (!fileInfo.exists() || !SoundSourceProxy::isFileSupported(fileInfo)) {
+        kLogger.warning() << "Line" << event.line << ": unsupported file"
+                          << event.location;
+        return false;
+    }
+
+    TrackPointer pTrack = SoundSourceProxy::importTemporaryTrack(
+            TrackFile(fileInfo));
+    pDeck->slotLoadTrack(pTrack, false);
+
+    // The deck is updated by a queued signal after the reader has opened
+    // the file
+    EngineBuffer* pEngineBuffer = pDeck->getEngineDeck()->getEngineBuffer();
+    PerformanceTimer timer;
+    timer.start();
+    while (pEngineBuffer->getLoadedTrack() != pTrack ||
+            pDeck->getLoadedTrack() != pTrack) {
+        if (timer.elapsed().toIntegerMillis() > kTrackLoadTimeoutMillis) {
+            kLogger.warning() << "Line" << event.line << ": failed to load"
+                              << event.location;
+            return false;
+        }
+        m_pEngine->wakeWorkers();
+        QCoreApplication::processEvents();
+        QThread::msleep(1);
+    }
+    return true;
+}
+
+void OfflineRenderer::waitForReaders() {
+    bool idle = false;
+    while (!idle) {
+        idle = true;
+        for (Deck* pDeck : m_decks) {
+            if (!pDeck->getEngineDeck()->getEngineBuffer()->isReaderIdle()) {
+                idle = false;
+                break;
+            }
+        }
+        if (!idle) {
+            // In case the wake up at the end of the callback was missed
+            m_pEngine->wakeWorkers();
+            QThread::yieldCurrentThread();
+        }
+    }
+}
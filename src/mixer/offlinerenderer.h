@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+#include <memory>
+
+#include "mixer/renderscript.h"
+#include "preferences/usersettings.h"
+#include "util/class.h"
+#include "util/types.h"
+
+class ChannelHandleFactory;
+class ControlObject;
+class Deck;
+class EffectsManager;
+class EngineMaster;
+class GuiTick;
+class VisualsManager;
+
+// Runs the mixing engine without a sound device or a GUI, as fast as the CPU
+// allows, and replays the control changes of a RenderScript. The master
+// output is written to a 32-bit float WAV file.
+//
+// Unlike a sound device callback, the renderer waits for the reader threads
+// of all decks to finish their pending work before every engine callback,
+// including the reads for seeks that the callback is going to perform. A
+// script therefore renders to the same output on every run and every
+// machine, no matter how fast it is. This is used to pre-render mixes, for
+// regression tests of the engine, and to measure the throughput of the
+// engine in buffers per second.
+class OfflineRenderer {
+  public:
+    OfflineRenderer(UserSettingsPointer pConfig, const RenderScript& script);
+    ~OfflineRenderer();
+
+    // Renders the whole script. If outputFileName is empty, nothing is
+    // written, which measures the throughput of the engine alone. Prints a
+    // summary to stdout and returns false on errors.
+    bool render(const QString& outputFileName);
+
+  private:
+    SINT framesForTime(double seconds) const;
+    bool applyEvent(const RenderScript::Event& event);
+    bool loadTrack(const RenderScript::Event& event);
+    // Waits until the readers of all decks have no pending work
+    void waitForReaders();
+
+    const RenderScript m_script;
+
+    std::unique_ptr<GuiTick> m_pGuiTick;
+    std::unique_ptr<ChannelHandleFactory> m_pChannelHandleFactory;
+    std::unique_ptr<ControlObject> m_pNumDecks;
+    std::unique_ptr<EffectsManager> m_pEffectsManager;
+    std::unique_ptr<VisualsManager> m_pVisualsManager;
+    std::unique_ptr<EngineMaster> m_pEngine;
+    QList<Deck*> m_decks;
+
+    DISALLOW_COPY_AND_ASSIGN(OfflineRenderer);
+};
@@ -129,7 +129,9 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
             pLibrary,
             kNumberOfAnalyzerThreads,
             m_pConfig,
-            AnalyzerModeFlags::WithWaveform);
+            static_cast<AnalyzerModeFlags>(
+                    AnalyzerModeFlags::WithWaveform |
+                    AnalyzerModeFlags::Pipelined));
 
     connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::trackProgress,
             this, &PlayerManager::onTrackAnalysisProgress);
@@ -672,7 +674,12 @@ void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrackById(track->getId())) {
+        // Tracks in decks, preview decks and decks controlled by AutoDJ
+        // are analyzed before tracks in samplers
+        const auto priority = qobject_cast<Sampler*>(sender())
+                ? TrackAnalysisScheduler::Priority::Normal
+                : TrackAnalysisScheduler::Priority::High;
+        if (m_pTrackAnalysisScheduler->scheduleTrackById(track->getId(), priority)) {
             m_pTrackAnalysisScheduler->resume();
         }
         // The first progress signal will suspend a running batch analysis
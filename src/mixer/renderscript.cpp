@@ -0,0 +1,205 @@
+#include "mixer/renderscript.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/defs.h"
+
+const int RenderScript::kDefaultSampleRate = 44100;
+const int RenderScript::kDefaultBufferSize = 1024;
+const int RenderScript::kDefaultNumDecks = 2;
+
+namespace {
+
+const int kMinSampleRate = 8000;
+const int kMaxSampleRate = 192000;
+const int kMaxNumDecks = 4;
+
+// <time> load <group> <file name, which may contain spaces>
+const QRegularExpression kLoadEventRegex(
+        "^(\\S+)\\s+load\\s+(\\S+)\\s+(.+)$");
+
+// Removes a comment that starts with a '#' outside of double quotes.
+// Returns false if a quote is not closed.
+bool stripComment(QString* pLine) {
+    bool quoted = false;
+    for (int i = 0; i < pLine->size(); ++i) {
+        const QChar c = pLine->at(i);
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (c == '#' && !quoted) {
+            pLine->truncate(i);
+            break;
+        }
+    }
+    return !quoted;
+}
+
+bool isGroup(const QString& group) {
+    return group.size() > 2 && group.startsWith('[') && group.endsWith(']');
+}
+
+} // anonymous namespace
+
+RenderScript::RenderScript()
+        : m_sampleRate(kDefaultSampleRate),
+          m_bufferSize(kDefaultBufferSize),
+          m_numDecks(kDefaultNumDecks) {
+}
+
+bool RenderScript::load(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_errorString = QString("Failed to open %1: %2").arg(
+                fileName, file.errorString());
+        return false;
+    }
+    QTextStream stream(&file);
+    return parse(stream.readAll(), QFileInfo(fileName).absolutePath());
+}
+
+bool RenderScript::parse(const QString& script, const QString& baseDir) {
+    m_events.clear();
+    m_errorString.clear();
+
+    const QStringList lines = script.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        QString line = lines.at(i);
+        if (!stripComment(&line)) {
+            m_events.clear();
+            return fail(i + 1, "Unterminated quote");
+        }
+        line = line.trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+        if (!parseLine(line, i + 1, baseDir)) {
+            m_events.clear();
+            return false;
+        }
+    }
+
+    if (m_events.isEmpty() || m_events.last().type != Event::Type::End) {
+        return fail(lines.size(), "The script does not end with an end event");
+    }
+    // The end event has the latest time and stays in place
+    std::stable_sort(m_events.begin(), m_events.end(),
+            [](const Event& a, const Event& b) {
+                return a.time < b.time;
+            });
+    return true;
+}
+
+bool RenderScript::parseLine(
+        const QString& line, int lineNumber, const QString& baseDir) {
+    const QStringList tokens = line.split(
+            QRegularExpression("\\s+"), QString::SkipEmptyParts);
+    DEBUG_ASSERT(!tokens.isEmpty());
+
+    const QString& first = tokens.at(0);
+    if (first == "samplerate" || first == "buffersize" || first == "decks") {
+        if (!m_events.isEmpty()) {
+            return fail(lineNumber, QString("%1 must precede all events").arg(first));
+        }
+        bool ok = false;
+        const int value = tokens.size() == 2 ? tokens.at(1).toInt(&ok) : 0;
+        if (!ok) {
+            return fail(lineNumber, QString("Expected: %1 <number>").arg(first));
+        }
+        if (first == "samplerate") {
+            if (value < kMinSampleRate || value > kMaxSampleRate) {
+                return fail(lineNumber, "Unsupported sample rate");
+            }
+            m_sampleRate = value;
+        } else if (first == "buffersize") {
+            // The engine processes interleaved stereo samples
+            if (value <= 0 || value * 2 > static_cast<int>(MAX_BUFFER_LEN)) {
+                return fail(lineNumber, "Unsupported buffer size");
+            }
+            m_bufferSize = value;
+        } else {
+            if (value < 1 || value > kMaxNumDecks) {
+                return fail(lineNumber, "Unsupported number of decks");
+            }
+            m_numDecks = value;
+        }
+        return true;
+    }
+
+    if (!m_events.isEmpty() && m_events.last().type == Event::Type::End) {
+        return fail(lineNumber, "Unexpected event after the end event");
+    }
+
+    Event event;
+    event.type = Event::Type::End;
+    event.value = 0.0;
+    event.line = lineNumber;
+    bool ok = false;
+    event.time = first.toDouble(&ok);
+    if (!ok || event.time < 0.0) {
+        return fail(lineNumber, QString("Invalid time: %1").arg(first));
+    }
+
+    const QString command = tokens.value(1);
+    if (command == "end") {
+        if (tokens.size() != 2) {
+            return fail(lineNumber, "Expected: <time> end");
+        }
+        if (event.time <= 0.0) {
+            return fail(lineNumber, "Nothing to render before the end event");
+        }
+        for (const Event& other : m_events) {
+            if (other.time > event.time) {
+                return fail(lineNumber, "The end event precedes other events");
+            }
+        }
+    } else if (command == "set") {
+        if (tokens.size() != 5) {
+            return fail(lineNumber, "Expected: <time> set <group> <item> <value>");
+        }
+        event.type = Event::Type::Set;
+        event.group = tokens.at(2);
+        event.item = tokens.at(3);
+        event.value = tokens.at(4).toDouble(&ok);
+        if (!ok) {
+            return fail(lineNumber, QString("Invalid value: %1").arg(tokens.at(4)));
+        }
+    } else if (command == "load") {
+        const QRegularExpressionMatch match = kLoadEventRegex.match(line);
+        if (!match.hasMatch()) {
+            return fail(lineNumber, "Expected: <time> load <group> <file>");
+        }
+        event.type = Event::Type::Load;
+        event.group = match.captured(2);
+        QString fileName = match.captured(3);
+        if (fileName.startsWith('"')) {
+            if (fileName.size() < 3 || !fileName.endsWith('"') ||
+                    fileName.count('"') != 2) {
+                return fail(lineNumber, "Expected: <time> load <group> \"<file>\"");
+            }
+            fileName = fileName.mid(1, fileName.size() - 2);
+        }
+        event.location = QDir(baseDir).absoluteFilePath(fileName);
+    } else {
+        return fail(lineNumber, QString("Unknown command: %1").arg(command));
+    }
+
+    if (event.type != Event::Type::End && !isGroup(event.group)) {
+        return fail(lineNumber, QString("Invalid group: %1").arg(event.group));
+    }
+    m_events.append(event);
+    return true;
+}
+
+bool RenderScript::fail(int lineNumber, const QString& message) {
+    m_errorString = QString("Line %1: %2").arg(
+            QString::number(lineNumber), message);
+    return false;
+}
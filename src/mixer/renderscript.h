@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+// A timed sequence of control changes that is replayed by the OfflineRenderer.
+//
+// The script is a text file with one statement per line. Empty lines and
+// everything after a '#' outside of double quotes are ignored. Settings
+// come first:
+//
+//   samplerate 44100      # the engine sample rate in Hz
+//   buffersize 1024       # the frames per engine callback
+//   decks 2               # the number of decks
+//
+// followed by events, each starting with a time in seconds:
+//
+//   0.0  load [Channel1] music/track.mp3
+//   0.0  load [Channel2] "music/track #2.mp3"
+//   0.0  set [Channel1] play 1
+//   30.5 set [Master] crossfader 0.25
+//   60.0 end
+//
+// File names that contain a '#' must be quoted. Relative file names are
+// resolved against the directory of the script.
+// Every event takes effect at the start of the engine callback that contains
+// its time. The script must end with an end event, which sets the length of
+// the rendered audio.
+class RenderScript {
+  public:
+    struct Event {
+        enum class Type {
+            Load,
+            Set,
+            End,
+        };
+
+        double time;
+        Type type;
+        QString group;
+        // The control for Set events
+        QString item;
+        // The value for Set events
+        double value;
+        // The absolute file name for Load events
+        QString location;
+        // The line number in the script for error messages
+        int line;
+    };
+
+    static const int kDefaultSampleRate;
+    static const int kDefaultBufferSize;
+    static const int kDefaultNumDecks;
+
+    RenderScript();
+
+    // Reads and parses a script file. Returns false and sets errorString()
+    // if the file cannot be read or the script is malformed.
+    bool load(const QString& fileName);
+    // Parses the script text. Relative file names are resolved against
+    // baseDir.
+    bool parse(const QString& script, const QString& baseDir);
+
+    int sampleRate() const {
+        return m_sampleRate;
+    }
+    int bufferSize() const {
+        return m_bufferSize;
+    }
+    int numDecks() const {
+        return m_numDecks;
+    }
+
+    // The events ordered by time. Events with the same time keep the order
+    // of the script. The last event is always the end event.
+    const QList<Event>& events() const {
+        return m_events;
+    }
+
+    double endTime() const {
+        return m_events.isEmpty() ? 0.0 : m_events.last().time;
+    }
+
+    const QString& errorString() const {
+        return m_errorString;
+    }
+
+  private:
+    bool parseLine(const QString& line, int lineNumber, const QString& baseDir);
+    bool fail(int lineNumber, const QString& message);
+
+    int m_sampleRate;
+    int m_bufferSize;
+    int m_numDecks;
+    QList<Event> m_events;
+    QString m_errorString;
+};
@@ -53,6 +53,7 @@
 #include "skin/legacyskinparser.h"
 #include "skin/skinloader.h"
 #include "soundio/soundmanager.h"
+#include "sources/seekindexfile.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "waveform/waveformwidgetfactory.h"
@@ -352,6 +353,25 @@ void MixxxMainWindow::initialize(QApplication* pApp, const CmdlineArgs& args) {
 
     CoverArtCache::createInstance();
 
+    // The cache of decoded audio data is disabled by default
+    const int pcmCacheSizeMB = pConfig->getValue<int>(
+            ConfigKey("[Library]", "PcmCacheSizeMB"), 0);
+    if (pcmCacheSizeMB > 0) {
+        SoundSourceProxy::setPcmCache(std::make_shared<mixxx::PcmCache>(
+                QDir(pConfig->getSettingsPath()).filePath("pcmcache"),
+                static_cast<qint64>(pcmCacheSizeMB) * 1024 * 1024));
+    }
+
+    // Scanning long MP3 files on every load is avoided by storing the
+    // positions of their frames
+    if (pConfig->getValue(ConfigKey("[Library]", "SeekIndex"), true)) {
+        const int seekIndexSizeMB = pConfig->getValue<int>(
+                ConfigKey("[Library]", "SeekIndexSizeMB"), 64);
+        mixxx::SeekIndexFile::setDirPath(
+                QDir(pConfig->getSettingsPath()).filePath("seekindex"),
+                static_cast<qint64>(seekIndexSizeMB) * 1024 * 1024);
+    }
+
     launchProgress(30);
 
     m_pTrackCollectionManager = new TrackCollectionManager(
@@ -728,6 +748,9 @@ void MixxxMainWindow::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting Library";
     delete m_pLibrary;
 
+    // Audio sources that are still open keep the cache alive
+    SoundSourceProxy::setPcmCache(mixxx::PcmCachePointer());
+
     // RecordingManager depends on config, engine
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting RecordingManager";
     delete m_pRecordingManager;
@@ -838,6 +861,8 @@ bool MixxxMainWindow::initializeDatabase() {
         return false;
     }
 
+    MixxxDb::checkPerformanceProfile(dbConnection, m_pSettingsManager->settings());
+
     kLogger.info() << "Initializing or upgrading database schema";
     return MixxxDb::initDatabaseSchema(dbConnection);
 }
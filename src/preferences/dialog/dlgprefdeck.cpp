@@ -9,6 +9,7 @@
 #include "control/controlobject.h"
 #include "control/controlproxy.h"
 #include "defs_urls.h"
+#include "engine/cachingreader/cachingreader.h"
 #include "engine/controls/ratecontrol.h"
 #include "engine/enginebuffer.h"
 #include "mixer/basetrackplayer.h"
@@ -353,6 +354,9 @@ DlgPrefDeck::DlgPrefDeck(QWidget * parent, MixxxMainWindow * mixxx,
     connect(checkBoxResetPitch, SIGNAL(toggled(bool)),
             this, SLOT(slotUpdatePitchAutoReset(bool)));
 
+    spinBoxReaderCacheSize->setMinimum(CachingReader::kMinCacheSizeMB);
+    spinBoxReaderCacheSize->setMaximum(CachingReader::kMaxCacheSizeMB);
+
     slotUpdate();
 }
 
@@ -433,6 +437,10 @@ void DlgPrefDeck::slotUpdate() {
     spinBoxTemporaryRateFine->setValue(RateControl::getTemporaryRateChangeFineAmount());
     spinBoxPermanentRateCoarse->setValue(RateControl::getPermanentRateChangeCoarseAmount());
     spinBoxPermanentRateFine->setValue(RateControl::getPermanentRateChangeFineAmount());
+
+    spinBoxReaderCacheSize->setValue(m_pConfig->getValue(
+            ConfigKey("[Controls]", CachingReader::kConfigKeyCacheSizeMB),
+            CachingReader::kDefaultCacheSizeMB));
 }
 
 void DlgPrefDeck::slotResetToDefaults() {
@@ -468,6 +476,8 @@ void DlgPrefDeck::slotResetToDefaults() {
     spinBoxPermanentRateCoarse->setValue(0.50);
     spinBoxPermanentRateFine->setValue(0.05);
 
+    spinBoxReaderCacheSize->setValue(CachingReader::kDefaultCacheSizeMB);
+
     checkBoxResetSpeed->setChecked(false);
     checkBoxResetPitch->setChecked(true);
 
@@ -628,6 +638,10 @@ void DlgPrefDeck::slotApply() {
     m_pConfig->setValue(ConfigKey("[Controls]", "CloneDeckOnLoadDoubleTap"),
             m_bCloneDeckOnLoadDoubleTap);
 
+    // Only used when a deck is created, i.e. after restarting Mixxx
+    m_pConfig->setValue(ConfigKey("[Controls]", CachingReader::kConfigKeyCacheSizeMB),
+            spinBoxReaderCacheSize->value());
+
     // Set rate range
     setRateRangeForAllDecks(m_iRateRangePercent);
     m_pConfig->setValue(ConfigKey("[Controls]", "RateRangePercent"),
@@ -176,6 +176,17 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent, SoundManager* pSoundManager,
             this, SLOT(masterOutputModeComboBoxChanged(int)));
     m_pMasterMonoMixdown->connectValueChanged(this, &DlgPrefSound::masterMonoMixdownChanged);
 
+    m_pParallelChannelProcessing =
+            new ControlProxy("[Master]", "parallel_channel_processing", this);
+    channelProcessingComboBox->addItem(tr("Disabled"));
+    channelProcessingComboBox->addItem(tr("Enabled"));
+    channelProcessingComboBox->setCurrentIndex(
+            m_pParallelChannelProcessing->get() ? 1 : 0);
+    connect(channelProcessingComboBox, SIGNAL(currentIndexChanged(int)),
+            this, SLOT(channelProcessingComboBoxChanged(int)));
+    m_pParallelChannelProcessing->connectValueChanged(
+            this, &DlgPrefSound::parallelChannelProcessingChanged);
+
     m_pKeylockEngine =
             new ControlProxy("[Master]", "keylock_engine", this);
 
@@ -600,6 +611,9 @@ void DlgPrefSound::slotResetToDefaults() {
     masterMixComboBox->setCurrentIndex(1);
     m_pMasterEnabled->set(1.0);
 
+    channelProcessingComboBox->setCurrentIndex(0);
+    m_pParallelChannelProcessing->set(0.0);
+
     masterDelaySpinBox->setValue(0.0);
     m_pMasterDelay->set(0.0);
 
@@ -665,6 +679,14 @@ void DlgPrefSound::masterMonoMixdownChanged(double value) {
     masterOutputModeComboBox->setCurrentIndex(value ? 1 : 0);
 }
 
+void DlgPrefSound::channelProcessingComboBoxChanged(int value) {
+    m_pParallelChannelProcessing->set((double)value);
+}
+
+void DlgPrefSound::parallelChannelProcessingChanged(double value) {
+    channelProcessingComboBox->setCurrentIndex(value ? 1 : 0);
+}
+
 void DlgPrefSound::micMonitorModeComboBoxChanged(int value) {
     EngineMaster::MicMonitorMode newMode =
         static_cast<EngineMaster::MicMonitorMode>(
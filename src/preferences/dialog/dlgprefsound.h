@@ -69,6 +69,8 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     void masterEnabledChanged(double value);
     void masterOutputModeComboBoxChanged(int value);
     void masterMonoMixdownChanged(double value);
+    void channelProcessingComboBoxChanged(int value);
+    void parallelChannelProcessingChanged(double value);
     void micMonitorModeComboBoxChanged(int value);
 
   private slots:
@@ -107,6 +109,7 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     ControlProxy* m_pKeylockEngine;
     ControlProxy* m_pMasterEnabled;
     ControlProxy* m_pMasterMonoMixdown;
+    ControlProxy* m_pParallelChannelProcessing;
     ControlProxy* m_pMicMonitorMode;
     QList<SoundDevicePointer> m_inputDevices;
     QList<SoundDevicePointer> m_outputDevices;
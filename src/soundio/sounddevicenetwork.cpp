@@ -14,6 +14,7 @@
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
 #include "util/logger.h"
+#include "util/realtimeguard.h"
 #include "util/sample.h"
 
 namespace {
@@ -443,6 +444,9 @@ void SoundDeviceNetwork::callbackProcessClkRef() {
 #endif
     }
 
+    // The one time setup above may allocate
+    ScopedRealtimeThread realtimeThread;
+
     m_pSoundManager->readProcess();
 
     {
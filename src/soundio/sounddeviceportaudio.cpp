@@ -38,6 +38,7 @@
 #include "util/timer.h"
 #include "util/trace.h"
 #include "util/math.h"
+#include "util/realtimeguard.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "waveform/visualplayposition.h"
 
@@ -710,6 +711,7 @@ int SoundDevicePortAudio::callbackProcessDrift(
         const PaStreamCallbackTimeInfo *timeInfo,
         PaStreamCallbackFlags statusFlags) {
     Q_UNUSED(timeInfo);
+    ScopedRealtimeThread realtimeThread;
     Trace trace("SoundDevicePortAudio::callbackProcessDrift %1",
             m_deviceId.debugName());
 
@@ -843,6 +845,7 @@ int SoundDevicePortAudio::callbackProcess(const SINT framesPerBuffer,
         const PaStreamCallbackTimeInfo *timeInfo,
         PaStreamCallbackFlags statusFlags) {
     Q_UNUSED(timeInfo);
+    ScopedRealtimeThread realtimeThread;
     Trace trace("SoundDevicePortAudio::callbackProcess %1", m_deviceId.debugName());
 
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
@@ -952,6 +955,9 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 #endif
 #endif
 
+    // The one time setup above may allocate
+    ScopedRealtimeThread realtimeThread;
+
     if (statusFlags & (paOutputUnderflow | paInputOverflow)) {
         m_pSoundManager->underflowHappened(6);
     }
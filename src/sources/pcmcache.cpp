@@ -0,0 +1,512 @@
+#include "sources/pcmcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "sources/audiosourceproxy.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("PcmCache");
+
+const QByteArray kMagic = QByteArrayLiteral("MIXXXPCM");
+
+const QString kFileSuffix = QStringLiteral(".pcm");
+
+struct Header {
+    Header()
+            : formatVersion(0),
+              headerSize(0),
+              requestedChannelCount(0),
+              requestedSampleRate(0),
+              channelCount(0),
+              sampleRate(0),
+              bitrate(0),
+              frameIndexStart(0),
+              frameIndexEnd(0),
+              sourceFileSize(0),
+              sourceModifiedMsecs(0) {
+    }
+    quint32 formatVersion;
+    // The offset of the samples
+    quint32 headerSize;
+    // The signal properties that have been requested when decoding
+    // the source, 0 if unspecified. Decoders might ignore them.
+    quint32 requestedChannelCount;
+    quint32 requestedSampleRate;
+    // The actual signal properties of the samples
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 frameIndexStart;
+    qint64 frameIndexEnd;
+    // Identify the contents of the source file
+    qint64 sourceFileSize;
+    qint64 sourceModifiedMsecs;
+};
+
+QByteArray serializeHeader(const Header& header) {
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(kMagic.constData(), kMagic.size());
+    stream << header.formatVersion
+           << header.headerSize
+           << header.requestedChannelCount
+           << header.requestedSampleRate
+           << header.channelCount
+           << header.sampleRate
+           << header.bitrate
+           << header.frameIndexStart
+           << header.frameIndexEnd
+           << header.sourceFileSize
+           << header.sourceModifiedMsecs;
+    DEBUG_ASSERT(bytes.size() <= PcmCache::kHeaderSize);
+    // Reserved for future use
+    bytes.append(PcmCache::kHeaderSize - bytes.size(), '\0');
+    return bytes;
+}
+
+bool deserializeHeader(const QByteArray& bytes, Header* pHeader) {
+    if (bytes.size() < PcmCache::kHeaderSize ||
+            !bytes.startsWith(kMagic)) {
+        return false;
+    }
+    QDataStream stream(bytes);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.skipRawData(kMagic.size());
+    stream >> pHeader->formatVersion
+           >> pHeader->headerSize
+           >> pHeader->requestedChannelCount
+           >> pHeader->requestedSampleRate
+           >> pHeader->channelCount
+           >> pHeader->sampleRate
+           >> pHeader->bitrate
+           >> pHeader->frameIndexStart
+           >> pHeader->frameIndexEnd
+           >> pHeader->sourceFileSize
+           >> pHeader->sourceModifiedMsecs;
+    return stream.status() == QDataStream::Ok;
+}
+
+qint64 sampleDataSize(const Header& header) {
+    return (header.frameIndexEnd - header.frameIndexStart) *
+            header.channelCount * static_cast<qint64>(sizeof(CSAMPLE));
+}
+
+// The cached samples are only valid for the source file that has been
+// decoded
+void initSourceFileProperties(const QUrl& url, Header* pHeader) {
+    const QFileInfo fileInfo(url.toLocalFile());
+    pHeader->sourceFileSize = fileInfo.size();
+    pHeader->sourceModifiedMsecs = fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+bool matchesSourceFile(const QUrl& url, const Header& header) {
+    Header sourceFileHeader;
+    initSourceFileProperties(url, &sourceFileHeader);
+    return header.sourceFileSize == sourceFileHeader.sourceFileSize &&
+            header.sourceModifiedMsecs == sourceFileHeader.sourceModifiedMsecs;
+}
+
+// Decoders that do not support the requested value will decode the
+// source with the same actual value again
+bool matchesRequestedValue(
+        SINT requestedValue,
+        quint32 cachedRequestedValue,
+        quint32 cachedValue) {
+    return requestedValue <= 0 ||
+            static_cast<quint32>(requestedValue) == cachedValue ||
+            static_cast<quint32>(requestedValue) == cachedRequestedValue;
+}
+
+bool matchesOpenParams(
+        const AudioSource::OpenParams& params,
+        const Header& header) {
+    const auto& signalInfo = params.getSignalInfo();
+    // Invalid values are 0
+    return matchesRequestedValue(
+                   signalInfo.getChannelCount(),
+                   header.requestedChannelCount,
+                   header.channelCount) &&
+            matchesRequestedValue(
+                    signalInfo.getSampleRate(),
+                    header.requestedSampleRate,
+                    header.sampleRate);
+}
+
+// Reads the samples from a cache file that is mapped into memory
+class CachedAudioSource : public AudioSource {
+  public:
+    CachedAudioSource(
+            const QUrl& url,
+            const QString& filePath,
+            const Header& header)
+            : AudioSource(url),
+              m_filePath(filePath),
+              m_header(header),
+              m_pSamples(nullptr) {
+    }
+    ~CachedAudioSource() override {
+        close();
+    }
+
+    void close() override {
+        // Closing the file also unmaps the samples
+        m_pFile.reset();
+        m_pSamples = nullptr;
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        auto pFile = std::make_unique<QFile>(m_filePath);
+        if (!pFile->open(QIODevice::ReadOnly)) {
+            return OpenResult::Failed;
+        }
+        const qint64 dataSize = sampleDataSize(m_header);
+        if (pFile->size() < m_header.headerSize + dataSize) {
+            kLogger.warning()
+                    << "Truncated file"
+                    << m_filePath;
+            return OpenResult::Failed;
+        }
+        if (dataSize > 0) {
+            uchar* pMapped = pFile->map(m_header.headerSize, dataSize);
+            if (!pMapped) {
+                kLogger.warning()
+                        << "Failed to map"
+                        << m_filePath
+                        << pFile->errorString();
+                return OpenResult::Failed;
+            }
+            m_pSamples = reinterpret_cast<const CSAMPLE*>(pMapped);
+        }
+        if (!initChannelCountOnce(static_cast<SINT>(m_header.channelCount)) ||
+                !initSampleRateOnce(static_cast<SINT>(m_header.sampleRate)) ||
+                !initBitrateOnce(static_cast<SINT>(m_header.bitrate)) ||
+                !initFrameIndexRangeOnce(IndexRange::between(
+                        m_header.frameIndexStart,
+                        m_header.frameIndexEnd))) {
+            return OpenResult::Failed;
+        }
+        m_pFile = std::move(pFile);
+        return OpenResult::Succeeded;
+    }
+
+    ReadableSampleFrames readSampleFramesClamped(
+            WritableSampleFrames writableSampleFrames) override {
+        const SINT sampleOffset = getSignalInfo().frames2samples(
+                writableSampleFrames.frameIndexRange().start() - frameIndexMin());
+        const SINT sampleCount = getSignalInfo().frames2samples(
+                writableSampleFrames.frameLength());
+        const CSAMPLE* pSamples = m_pSamples + sampleOffset;
+        if (writableSampleFrames.writableData()) {
+            DEBUG_ASSERT(writableSampleFrames.writableLength() >= sampleCount);
+            SampleUtil::copy(
+                    writableSampleFrames.writableData(),
+                    pSamples,
+                    sampleCount);
+            pSamples = writableSampleFrames.writableData();
+        }
+        return ReadableSampleFrames(
+                writableSampleFrames.frameIndexRange(),
+                SampleBuffer::ReadableSlice(pSamples, sampleCount));
+    }
+
+  private:
+    const QString m_filePath;
+    const Header m_header;
+
+    std::unique_ptr<QFile> m_pFile;
+    const CSAMPLE* m_pSamples;
+};
+
+// Writes the samples into a cache file while they are read sequentially
+// from the wrapped source. The file is only committed after all samples
+// have been read and is discarded otherwise.
+class CachingAudioSource : public AudioSourceProxy {
+  public:
+    CachingAudioSource(
+            PcmCachePointer pCache,
+            const QString& filePath,
+            const Header& header,
+            AudioSourcePointer&& pAudioSource)
+            : AudioSourceProxy(std::move(pAudioSource)),
+              m_pCache(std::move(pCache)),
+              m_header(header),
+              m_nextFrameIndex(frameIndexMin()) {
+        m_header.frameIndexStart = frameIndexMin();
+        m_header.frameIndexEnd = frameIndexMax();
+        const qint64 fileSize = m_header.headerSize + sampleDataSize(m_header);
+        if (frameIndexRange().empty() || fileSize > m_pCache->getByteBudget()) {
+            return;
+        }
+        m_pFile = std::make_unique<QSaveFile>(filePath);
+        // The header is written again when all samples have been written
+        const QByteArray headerBytes = serializeHeader(m_header);
+        if (!m_pFile->open(QIODevice::WriteOnly) ||
+                m_pFile->write(headerBytes) != headerBytes.size()) {
+            kLogger.warning()
+                    << "Failed to write"
+                    << filePath
+                    << m_pFile->errorString();
+            m_pFile.reset();
+        }
+    }
+    ~CachingAudioSource() override {
+        finishWriting();
+    }
+
+    void close() override {
+        finishWriting();
+        AudioSourceProxy::close();
+    }
+
+  protected:
+    ReadableSampleFrames readSampleFramesClamped(
+            WritableSampleFrames writableSampleFrames) override {
+        const ReadableSampleFrames readableSampleFrames =
+                AudioSourceProxy::readSampleFramesClamped(writableSampleFrames);
+        if (m_pFile) {
+            writeSampleFrames(readableSampleFrames);
+        }
+        return readableSampleFrames;
+    }
+
+  private:
+    void writeSampleFrames(const ReadableSampleFrames& readableSampleFrames) {
+        DEBUG_ASSERT(m_pFile);
+        const IndexRange readRange = readableSampleFrames.frameIndexRange();
+        if (readRange.empty()) {
+            return;
+        }
+        const SINT sampleCount = getSignalInfo().frames2samples(readRange.length());
+        if (readRange.start() != m_nextFrameIndex ||
+                frameIndexMin() != m_header.frameIndexStart ||
+                !readableSampleFrames.readableData() ||
+                readableSampleFrames.readableLength() < sampleCount) {
+            // Seeking or skipping would leave a gap in the file
+            cancelWriting();
+            return;
+        }
+        const qint64 byteCount = sampleCount * static_cast<qint64>(sizeof(CSAMPLE));
+        if (m_pFile->write(
+                    reinterpret_cast<const char*>(readableSampleFrames.readableData()),
+                    byteCount) != byteCount) {
+            kLogger.warning()
+                    << "Failed to write"
+                    << m_pFile->fileName()
+                    << m_pFile->errorString();
+            cancelWriting();
+            return;
+        }
+        m_nextFrameIndex = readRange.end();
+        if (m_nextFrameIndex == frameIndexMax()) {
+            finishWriting();
+        }
+    }
+
+    void finishWriting() {
+        if (!m_pFile) {
+            return;
+        }
+        // The frame index range might have been shrinked by failed reads
+        if (frameIndexMin() != m_header.frameIndexStart ||
+                m_nextFrameIndex != frameIndexMax()) {
+            cancelWriting();
+            return;
+        }
+        m_header.frameIndexEnd = frameIndexMax();
+        const QByteArray headerBytes = serializeHeader(m_header);
+        if (!m_pFile->seek(0) ||
+                m_pFile->write(headerBytes) != headerBytes.size() ||
+                !m_pFile->commit()) {
+            kLogger.warning()
+                    << "Failed to write"
+                    << m_pFile->fileName()
+                    << m_pFile->errorString();
+            cancelWriting();
+            return;
+        }
+        if (kLogger.debugEnabled()) {
+            kLogger.debug()
+                    << "Cached"
+                    << frameLength()
+                    << "decoded frames of"
+                    << getUrl().toString();
+        }
+        m_pFile.reset();
+        m_pCache->evictLeastRecentlyUsed();
+    }
+
+    void cancelWriting() {
+        if (m_pFile) {
+            m_pFile->cancelWriting();
+            m_pFile.reset();
+        }
+    }
+
+    const PcmCachePointer m_pCache;
+    Header m_header;
+
+    std::unique_ptr<QSaveFile> m_pFile;
+    SINT m_nextFrameIndex;
+};
+
+} // anonymous namespace
+
+PcmCache::PcmCache(
+        const QString& dirPath,
+        qint64 byteBudget)
+        : m_dirPath(dirPath),
+          m_byteBudget(byteBudget) {
+    QDir dir(m_dirPath);
+    if (!dir.mkpath(".")) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << m_dirPath;
+    }
+    // Remove leftovers of files that have not been committed
+    const QStringList tempFileNames = dir.entryList(
+            QStringList() << ("*" + kFileSuffix + ".*"),
+            QDir::Files);
+    for (const auto& fileName : tempFileNames) {
+        dir.remove(fileName);
+    }
+}
+
+// static
+cache_key_t PcmCache::cacheKey(const QUrl& url) {
+    const QString filePath = QFileInfo(url.toLocalFile()).canonicalFilePath();
+    return cacheKeyFromMessageDigest(QCryptographicHash::hash(
+            filePath.toUtf8(), QCryptographicHash::Sha1));
+}
+
+QString PcmCache::cacheFilePath(const QUrl& url) const {
+    return QDir(m_dirPath).filePath(
+            QString::number(cacheKey(url), 16) + kFileSuffix);
+}
+
+AudioSourcePointer PcmCache::openAudioSource(
+        const QUrl& url,
+        const AudioSource::OpenParams& params) {
+    if (!url.isLocalFile()) {
+        return AudioSourcePointer();
+    }
+    const QString filePath = cacheFilePath(url);
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return AudioSourcePointer();
+    }
+    Header header;
+    if (!deserializeHeader(file.read(kHeaderSize), &header) ||
+            header.formatVersion != static_cast<quint32>(kFormatVersion) ||
+            header.headerSize < static_cast<quint32>(kHeaderSize) ||
+            header.frameIndexStart > header.frameIndexEnd ||
+            !matchesSourceFile(url, header)) {
+        kLogger.info()
+                << "Discarding outdated or invalid file"
+                << filePath;
+        file.close();
+        QFile::remove(filePath);
+        return AudioSourcePointer();
+    }
+    if (!matchesOpenParams(params, header)) {
+        return AudioSourcePointer();
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    // The modification time of the cache files orders them by their
+    // last use for the eviction
+    file.setFileTime(
+            QDateTime::currentDateTime(),
+            QFileDevice::FileModificationTime);
+#endif
+    file.close();
+    auto pAudioSource = std::make_shared<CachedAudioSource>(
+            url, filePath, header);
+    if (pAudioSource->open(AudioSource::OpenMode::Strict, params) !=
+            AudioSource::OpenResult::Succeeded) {
+        return AudioSourcePointer();
+    }
+    return pAudioSource;
+}
+
+AudioSourcePointer PcmCache::createCachingAudioSource(
+        const QUrl& url,
+        const AudioSource::OpenParams& params,
+        AudioSourcePointer pAudioSource) {
+    DEBUG_ASSERT(pAudioSource);
+    if (!url.isLocalFile()) {
+        return pAudioSource;
+    }
+    const auto& requestedSignalInfo = params.getSignalInfo();
+    const auto& signalInfo = pAudioSource->getSignalInfo();
+    Header header;
+    header.formatVersion = kFormatVersion;
+    header.headerSize = kHeaderSize;
+    if (requestedSignalInfo.getChannelCount().isValid()) {
+        header.requestedChannelCount = requestedSignalInfo.getChannelCount();
+    }
+    if (requestedSignalInfo.getSampleRate().isValid()) {
+        header.requestedSampleRate = requestedSignalInfo.getSampleRate();
+    }
+    header.channelCount = signalInfo.getChannelCount();
+    header.sampleRate = signalInfo.getSampleRate();
+    if (pAudioSource->getBitrate().isValid()) {
+        header.bitrate = pAudioSource->getBitrate();
+    }
+    initSourceFileProperties(url, &header);
+    return std::make_shared<CachingAudioSource>(
+            shared_from_this(),
+            cacheFilePath(url),
+            header,
+            std::move(pAudioSource));
+}
+
+void PcmCache::evictLeastRecentlyUsed() {
+    QMutexLocker locker(&m_mutex);
+    QDir dir(m_dirPath);
+    // Most recently used first
+    const QFileInfoList fileInfos = dir.entryInfoList(
+            QStringList() << ("*" + kFileSuffix),
+            QDir::Files,
+            QDir::Time);
+    qint64 totalSize = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+        if (totalSize <= m_byteBudget) {
+            continue;
+        }
+        // Mapped files remain readable until they are closed
+        if (dir.remove(fileInfo.fileName())) {
+            kLogger.debug()
+                    << "Evicted"
+                    << fileInfo.fileName();
+        }
+    }
+}
+
+void PcmCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    QDir dir(m_dirPath);
+    const QStringList fileNames = dir.entryList(
+            QStringList() << ("*" + kFileSuffix),
+            QDir::Files);
+    for (const auto& fileName : fileNames) {
+        dir.remove(fileName);
+    }
+}
+
+} // namespace mixxx
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QUrl>
+
+#include <memory>
+
+#include "sources/audiosource.h"
+#include "util/cache.h"
+#include "util/class.h"
+
+namespace mixxx {
+
+// Stores the decoded audio data of tracks uncompressed in files that are
+// mapped into memory when the same track is opened again. Reading from a
+// cached track only copies samples and does not need to decode the source
+// file again.
+//
+// Each cache file starts with a fixed size header (little-endian) that
+// records the stream properties and the size and modification time of the
+// source file. Entries of modified source files are discarded. The samples
+// are stored in the native byte order, i.e. the files are not portable
+// between machines.
+//
+// A cache file is only written while a source is decoded sequentially from
+// the first to the last frame, e.g. while analyzing a track that has been
+// loaded into a deck. SoundSourceProxy does not populate the cache during
+// batch analysis. The least recently used files are deleted when the total
+// size exceeds the byte budget.
+//
+// All functions are thread-safe.
+class PcmCache : public std::enable_shared_from_this<PcmCache> {
+  public:
+    static constexpr int kFormatVersion = 1;
+    static constexpr int kHeaderSize = 96;
+
+    PcmCache(
+            const QString& dirPath,
+            qint64 byteBudget);
+
+    const QString& getDirPath() const {
+        return m_dirPath;
+    }
+
+    qint64 getByteBudget() const {
+        return m_byteBudget;
+    }
+
+    static cache_key_t cacheKey(const QUrl& url);
+
+    QString cacheFilePath(const QUrl& url) const;
+
+    // Opens a cached source that matches the requested signal properties.
+    // Returns a null pointer if the track is not cached or if the cached
+    // data is outdated.
+    AudioSourcePointer openAudioSource(
+            const QUrl& url,
+            const AudioSource::OpenParams& params);
+
+    // Wraps an opened source into a proxy that writes the decoded data
+    // into the cache while it is read. The params are the ones that have
+    // been used for opening the source.
+    AudioSourcePointer createCachingAudioSource(
+            const QUrl& url,
+            const AudioSource::OpenParams& params,
+            AudioSourcePointer pAudioSource);
+
+    // Deletes the least recently used files until the total size of all
+    // files fits into the byte budget.
+    void evictLeastRecentlyUsed();
+
+    // Deletes all files
+    void clear();
+
+  private:
+    const QString m_dirPath;
+    const qint64 m_byteBudget;
+
+    // Serializes the eviction
+    QMutex m_mutex;
+
+    DISALLOW_COPY_AND_ASSIGN(PcmCache);
+};
+
+typedef std::shared_ptr<PcmCache> PcmCachePointer;
+
+} // namespace mixxx
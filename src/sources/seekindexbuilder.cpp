@@ -0,0 +1,83 @@
+#include "sources/seekindexbuilder.h"
+
+#include <QFileInfo>
+#include <QThread>
+#include <QUrl>
+#include <QtConcurrentRun>
+
+#include "sources/seekindexfile.h"
+#ifdef __MAD__
+#include "sources/soundsourcemp3.h"
+#endif
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SeekIndexBuilder");
+
+// Listing the directory is too expensive for doing it after every file
+const int kFilesPerEviction = 256;
+
+void buildSeekIndex(const QString& filePath) {
+    QThread::currentThread()->setPriority(QThread::LowestPriority);
+    SeekIndex seekIndex;
+    if (SeekIndexFile::load(filePath, &seekIndex)) {
+        return;
+    }
+#ifdef __MAD__
+    // Opening the file scans all frame headers and saves the index
+    SoundSourceMp3 soundSource(QUrl::fromLocalFile(filePath));
+    if (soundSource.open(AudioSource::OpenMode::Strict) !=
+            AudioSource::OpenResult::Succeeded) {
+        kLogger.info()
+                << "Failed to build the seek index of"
+                << filePath;
+        return;
+    }
+    soundSource.close();
+#endif
+}
+
+} // anonymous namespace
+
+SeekIndexBuilder::SeekIndexBuilder()
+        : m_numEnqueuedSinceEviction(0) {
+    // Scanning is limited by I/O, multiple threads would only compete
+    // with the decks for the bandwidth of the disk
+    m_threadPool.setMaxThreadCount(1);
+    enqueueEviction();
+}
+
+SeekIndexBuilder::~SeekIndexBuilder() {
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+}
+
+void SeekIndexBuilder::enqueue(const QString& filePath) {
+    if (!SeekIndexFile::isEnabled() ||
+            QFileInfo(filePath).suffix().compare(
+                    QStringLiteral("mp3"), Qt::CaseInsensitive) != 0) {
+        return;
+    }
+    QtConcurrent::run(&m_threadPool, [filePath] {
+        buildSeekIndex(filePath);
+    });
+    if (++m_numEnqueuedSinceEviction >= kFilesPerEviction) {
+        enqueueEviction();
+    }
+}
+
+void SeekIndexBuilder::enqueueEviction() {
+    m_numEnqueuedSinceEviction = 0;
+    if (!SeekIndexFile::isEnabled()) {
+        return;
+    }
+    QtConcurrent::run(&m_threadPool, [] {
+        QThread::currentThread()->setPriority(QThread::LowestPriority);
+        SeekIndexFile::evictLeastRecentlyUsed();
+    });
+}
+
+} // namespace mixxx
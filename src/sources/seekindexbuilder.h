@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QString>
+#include <QThreadPool>
+
+#include "util/class.h"
+
+namespace mixxx {
+
+// Builds the seek indexes of MP3 files on a low priority background
+// thread. Files are queued when they are added to the library, so that
+// the first time they are loaded into a deck the whole file does not
+// need to be scanned. Only MP3 files that are decoded with libmad use
+// seek indexes.
+//
+// The thread also keeps the directory of seek indexes within its byte
+// budget, once upon startup and periodically while files are queued.
+class SeekIndexBuilder {
+  public:
+    SeekIndexBuilder();
+    // Discards all pending files and waits for the current one
+    ~SeekIndexBuilder();
+
+    // Ignores files that do not need a seek index
+    void enqueue(const QString& filePath);
+
+  private:
+    void enqueueEviction();
+
+    QThreadPool m_threadPool;
+    int m_numEnqueuedSinceEviction;
+
+    DISALLOW_COPY_AND_ASSIGN(SeekIndexBuilder);
+};
+
+} // namespace mixxx
@@ -0,0 +1,292 @@
+#include "sources/seekindexfile.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <limits>
+
+#include "util/assert.h"
+#include "util/cache.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SeekIndexFile");
+
+const QByteArray kMagic = QByteArrayLiteral("MIXXSEEK");
+
+const QString kFileSuffix = QStringLiteral(".seek");
+
+// quint32 byte distance + quint16 frame distance
+const int kSeekFrameSize = 6;
+
+struct Header {
+    Header()
+            : formatVersion(0),
+              headerSize(0),
+              channelCount(0),
+              sampleRate(0),
+              bitrate(0),
+              seekFrameCount(0),
+              frameLength(0),
+              sourceFileSize(0),
+              sourceModifiedMsecs(0),
+              seekFrameInterval(0) {
+    }
+    quint32 formatVersion;
+    // The offset of the seek frames
+    quint32 headerSize;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    quint32 seekFrameCount;
+    qint64 frameLength;
+    // Identify the contents of the audio file
+    qint64 sourceFileSize;
+    qint64 sourceModifiedMsecs;
+    quint32 seekFrameInterval;
+};
+
+void initSourceFileProperties(const QString& audioFilePath, Header* pHeader) {
+    const QFileInfo fileInfo(audioFilePath);
+    pHeader->sourceFileSize = fileInfo.size();
+    pHeader->sourceModifiedMsecs = fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+} // anonymous namespace
+
+/*static*/ QString SeekIndexFile::s_dirPath;
+/*static*/ qint64 SeekIndexFile::s_byteBudget = 0;
+
+// static
+void SeekIndexFile::setDirPath(
+        const QString& dirPath,
+        qint64 byteBudget) {
+    if (!dirPath.isEmpty() && !QDir().mkpath(dirPath)) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << dirPath;
+    }
+    s_dirPath = dirPath;
+    s_byteBudget = byteBudget;
+}
+
+// static
+QString SeekIndexFile::filePath(const QString& audioFilePath) {
+    DEBUG_ASSERT(isEnabled());
+    const QString canonicalFilePath = QFileInfo(audioFilePath).canonicalFilePath();
+    const cache_key_t cacheKey = cacheKeyFromMessageDigest(
+            QCryptographicHash::hash(
+                    canonicalFilePath.toUtf8(),
+                    QCryptographicHash::Sha1));
+    return QDir(s_dirPath).filePath(
+            QString::number(cacheKey, 16) + kFileSuffix);
+}
+
+// static
+bool SeekIndexFile::load(
+        const QString& audioFilePath,
+        SeekIndex* pSeekIndex) {
+    DEBUG_ASSERT(pSeekIndex);
+    if (!isEnabled()) {
+        return false;
+    }
+    const QString fileName = filePath(audioFilePath);
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray bytes = file.readAll();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    // The modification time of the index files orders them by their
+    // last use for the eviction
+    file.setFileTime(
+            QDateTime::currentDateTime(),
+            QFileDevice::FileModificationTime);
+#endif
+    file.close();
+
+    QDataStream stream(bytes);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    if (!bytes.startsWith(kMagic) ||
+            stream.skipRawData(kMagic.size()) != kMagic.size()) {
+        return false;
+    }
+    Header header;
+    stream >> header.formatVersion
+           >> header.headerSize
+           >> header.channelCount
+           >> header.sampleRate
+           >> header.bitrate
+           >> header.seekFrameCount
+           >> header.frameLength
+           >> header.sourceFileSize
+           >> header.sourceModifiedMsecs
+           >> header.seekFrameInterval;
+    Header sourceFileHeader;
+    initSourceFileProperties(audioFilePath, &sourceFileHeader);
+    if (stream.status() != QDataStream::Ok ||
+            header.formatVersion != static_cast<quint32>(kFormatVersion) ||
+            header.headerSize < static_cast<quint32>(kHeaderSize) ||
+            header.seekFrameInterval < 1 ||
+            header.sourceFileSize != sourceFileHeader.sourceFileSize ||
+            header.sourceModifiedMsecs != sourceFileHeader.sourceModifiedMsecs ||
+            bytes.size() != header.headerSize +
+                            static_cast<qint64>(header.seekFrameCount) * kSeekFrameSize) {
+        kLogger.info()
+                << "Discarding outdated or invalid file"
+                << fileName;
+        QFile::remove(fileName);
+        return false;
+    }
+
+    SeekIndex seekIndex;
+    seekIndex.channelCount = header.channelCount;
+    seekIndex.sampleRate = header.sampleRate;
+    seekIndex.bitrate = header.bitrate;
+    seekIndex.frameLength = header.frameLength;
+    seekIndex.seekFrameInterval = header.seekFrameInterval;
+    seekIndex.seekFrames.reserve(header.seekFrameCount);
+    stream.device()->seek(header.headerSize);
+    SeekIndex::SeekFrame seekFrame;
+    seekFrame.frameIndex = 0;
+    seekFrame.byteOffset = 0;
+    for (quint32 i = 0; i < header.seekFrameCount; ++i) {
+        quint32 byteDistance;
+        quint16 frameDistance;
+        stream >> byteDistance >> frameDistance;
+        // The distances are unsigned, i.e. the seek frames are ordered.
+        // Subsequent frames may share a position like the frames found
+        // when scanning the file, which save() accepts.
+        seekFrame.byteOffset += byteDistance;
+        seekFrame.frameIndex += frameDistance;
+        seekIndex.seekFrames.push_back(seekFrame);
+    }
+    if (stream.status() != QDataStream::Ok ||
+            seekIndex.seekFrames.empty() ||
+            seekFrame.byteOffset >= header.sourceFileSize ||
+            seekFrame.frameIndex >= seekIndex.frameLength) {
+        kLogger.warning()
+                << "Inconsistent seek frames in"
+                << fileName;
+        return false;
+    }
+    *pSeekIndex = std::move(seekIndex);
+    return true;
+}
+
+// static
+bool SeekIndexFile::save(
+        const QString& audioFilePath,
+        const SeekIndex& seekIndex) {
+    if (!isEnabled()) {
+        return false;
+    }
+    Header header;
+    header.formatVersion = kFormatVersion;
+    header.headerSize = kHeaderSize;
+    header.channelCount = seekIndex.channelCount;
+    header.sampleRate = seekIndex.sampleRate;
+    header.bitrate = seekIndex.bitrate;
+    header.seekFrameCount = static_cast<quint32>(seekIndex.seekFrames.size());
+    header.frameLength = seekIndex.frameLength;
+    header.seekFrameInterval = static_cast<quint32>(seekIndex.seekFrameInterval);
+    initSourceFileProperties(audioFilePath, &header);
+    VERIFY_OR_DEBUG_ASSERT(header.seekFrameInterval >= 1) {
+        return false;
+    }
+
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(kMagic.constData(), kMagic.size());
+    stream << header.formatVersion
+           << header.headerSize
+           << header.channelCount
+           << header.sampleRate
+           << header.bitrate
+           << header.seekFrameCount
+           << header.frameLength
+           << header.sourceFileSize
+           << header.sourceModifiedMsecs
+           << header.seekFrameInterval;
+    DEBUG_ASSERT(bytes.size() <= kHeaderSize);
+    // Reserved for future use
+    const QByteArray padding(kHeaderSize - bytes.size(), '\0');
+    stream.writeRawData(padding.constData(), padding.size());
+
+    SeekIndex::SeekFrame prevSeekFrame;
+    prevSeekFrame.frameIndex = 0;
+    prevSeekFrame.byteOffset = 0;
+    for (const auto& seekFrame : seekIndex.seekFrames) {
+        const qint64 byteDistance = seekFrame.byteOffset - prevSeekFrame.byteOffset;
+        const SINT frameDistance = seekFrame.frameIndex - prevSeekFrame.frameIndex;
+        VERIFY_OR_DEBUG_ASSERT(byteDistance >= 0 && frameDistance >= 0) {
+            return false;
+        }
+        if (byteDistance > std::numeric_limits<quint32>::max() ||
+                frameDistance > std::numeric_limits<quint16>::max()) {
+            kLogger.info()
+                    << "Unable to store the seek index of"
+                    << audioFilePath;
+            return false;
+        }
+        stream << static_cast<quint32>(byteDistance)
+               << static_cast<quint16>(frameDistance);
+        prevSeekFrame = seekFrame;
+    }
+
+    const QString fileName = filePath(audioFilePath);
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(bytes) != bytes.size() ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to write"
+                << fileName
+                << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// static
+void SeekIndexFile::evictLeastRecentlyUsed() {
+    if (!isEnabled() || s_byteBudget <= 0) {
+        return;
+    }
+    QDir dir(s_dirPath);
+    // Most recently used first
+    const QFileInfoList fileInfos = dir.entryInfoList(
+            QStringList() << ("*" + kFileSuffix),
+            QDir::Files,
+            QDir::Time);
+    qint64 totalSize = 0;
+    int numEvicted = 0;
+    for (const auto& fileInfo : fileInfos) {
+        totalSize += fileInfo.size();
+        if (totalSize <= s_byteBudget) {
+            continue;
+        }
+        if (dir.remove(fileInfo.fileName())) {
+            ++numEvicted;
+        }
+    }
+    if (numEvicted > 0) {
+        kLogger.info()
+                << "Evicted"
+                << numEvicted
+                << "of"
+                << fileInfos.size()
+                << "files";
+    }
+}
+
+} // namespace mixxx
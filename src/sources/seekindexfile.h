@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+#include "util/types.h"
+
+namespace mixxx {
+
+// The positions of all frames of a compressed audio stream, i.e. the result
+// of scanning the frame headers of the whole file, together with the stream
+// properties that have been derived from these headers.
+struct SeekIndex {
+    struct SeekFrame {
+        SINT frameIndex;
+        // Relative to the start of the file
+        qint64 byteOffset;
+    };
+
+    SeekIndex()
+            : channelCount(0),
+              sampleRate(0),
+              bitrate(0),
+              frameLength(0),
+              seekFrameInterval(1) {
+    }
+
+    SINT channelCount;
+    SINT sampleRate;
+    // in kbps, 0 if unknown
+    SINT bitrate;
+    // The total number of sample frames
+    SINT frameLength;
+    // The number of frames of the compressed stream from one seek frame
+    // to the next, 1 if the index contains all frames. Decoders need to
+    // decode up to this many frames more when seeking.
+    SINT seekFrameInterval;
+    // Ordered by both frameIndex and byteOffset. Subsequent frames might
+    // share the same frameIndex or byteOffset.
+    std::vector<SeekFrame> seekFrames;
+};
+
+// Stores the SeekIndex of an audio file in a small file in the directory
+// of seek indexes. The files are named after the cache key of the audio
+// file's path and record its size and modification time. Indexes of
+// modified audio files are discarded when loading them.
+//
+// The header of the file is followed by the distances between subsequent
+// seek frames in bytes and sample frames, i.e. 6 bytes per seek frame.
+// Decoders only store a sparse index with every n-th frame of the stream.
+// The least recently used files are deleted when the total size exceeds
+// the byte budget.
+class SeekIndexFile {
+  public:
+    static constexpr int kFormatVersion = 2;
+    static constexpr int kHeaderSize = 64;
+
+    // Enables loading and saving of seek indexes in the given directory.
+    // An empty path disables seek indexes. A byte budget of 0 is unlimited.
+    // Not thread-safe, must only be called upon startup.
+    static void setDirPath(
+            const QString& dirPath,
+            qint64 byteBudget = 0);
+
+    static bool isEnabled() {
+        return !s_dirPath.isEmpty();
+    }
+
+    // Returns false if there is no valid index for the audio file
+    static bool load(
+            const QString& audioFilePath,
+            SeekIndex* pSeekIndex);
+
+    // Replaces the file atomically
+    static bool save(
+            const QString& audioFilePath,
+            const SeekIndex& seekIndex);
+
+    static QString filePath(const QString& audioFilePath);
+
+    // Deletes the least recently loaded or saved files until the total
+    // size of all files fits into the byte budget
+    static void evictLeastRecentlyUsed();
+
+  private:
+    SeekIndexFile() = delete;
+
+    static QString s_dirPath;
+    static qint64 s_byteBudget;
+};
+
+} // namespace mixxx
@@ -1,5 +1,6 @@
 #include "sources/soundsourcemp3.h"
 #include "sources/mp3decoding.h"
+#include "sources/seekindexfile.h"
 
 #include "util/logger.h"
 #include "util/math.h"
@@ -84,6 +85,11 @@ const SINT kSecondsPerMinute = 60;      // fixed
 const SINT kMaxMp3FramesPerSecond = 39; // fixed: 1 MP3 frame = 26 ms -> ~ 1000 / 26
 const SINT kSeekFrameListCapacity = kMinutesPerFile * kSecondsPerMinute * kMaxMp3FramesPerSecond;
 
+// Only every n-th MP3 frame is stored in a seek index, which needs about
+// 4 KB for a track of 5 minutes. Seeking with the index decodes up to
+// n - 1 additional frames.
+const SINT kSeekIndexFrameInterval = 16;
+
 inline QString formatHeaderFlags(int headerFlags) {
     return QString("0x%1").arg(headerFlags, 4, 16, QLatin1Char('0'));
 }
@@ -164,6 +170,7 @@ SoundSourceMp3::SoundSourceMp3(const QUrl& url)
           m_fileSize(0),
           m_pFileData(nullptr),
           m_avgSeekFrameCount(0),
+          m_seekFramePrefetchCount(kMp3SeekFramePrefetchCount),
           m_curFrameIndex(0),
           m_madSynthCount(0),
           m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD) {
@@ -215,7 +222,43 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
 
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
+    m_seekFramePrefetchCount = kMp3SeekFramePrefetchCount;
     m_curFrameIndex = 0;
+
+    // Scanning the frame headers requires reading the whole file,
+    // which is only done once if the result is stored in a seek index
+    SeekIndex seekIndex;
+    if (!SeekIndexFile::load(m_file.fileName(), &seekIndex) ||
+            !initSeekFrameListFromIndex(seekIndex)) {
+        const OpenResult scanResult = scanFrameHeaders();
+        if (scanResult != OpenResult::Succeeded) {
+            return scanResult;
+        }
+        saveSeekIndex();
+    }
+
+    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+
+    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
+    m_avgSeekFrameCount = frameLength() / m_seekFrameList.size();
+
+    // Terminate m_seekFrameList
+    addSeekFrame(m_curFrameIndex, 0);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+
+    if (m_curFrameIndex != frameIndexMin()) {
+        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        // Abort
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+SoundSource::OpenResult SoundSourceMp3::scanFrameHeaders() {
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -376,11 +419,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         return OpenResult::Failed;
     }
     initSampleRateOnce(getSampleRateByIndex(mostCommonSampleRateIndex));
-    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
-
-    // Calculate average bitrate values
-    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
-    m_avgSeekFrameCount = frameLength() / m_seekFrameList.size();
     if (cntBitrateFrames > 0) {
         const unsigned long avgBitrate = sumBitrateFrames / cntBitrateFrames;
         initBitrateOnce(avgBitrate / 1000); // bps -> kbps
@@ -388,20 +426,60 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         kLogger.warning() << "Bitrate cannot be calculated from headers";
     }
 
-    // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, 0);
-    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
-
-    // Restart decoding at the beginning of the audio stream
-    restartDecoding(m_seekFrameList.front());
+    return OpenResult::Succeeded;
+}
 
-    if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
-        // Abort
-        return OpenResult::Failed;
+bool SoundSourceMp3::initSeekFrameListFromIndex(const SeekIndex& seekIndex) {
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    if (seekIndex.seekFrames.empty() ||
+            seekIndex.seekFrames.front().frameIndex != 0 ||
+            quint64(seekIndex.seekFrames.back().byteOffset) >= m_fileSize ||
+            seekIndex.channelCount < 1 ||
+            seekIndex.channelCount > kChannelCountMax ||
+            getIndexBySampleRate(audio::SampleRate(seekIndex.sampleRate)) >=
+                    kSampleRateCount) {
+        kLogger.warning() << "Ignoring invalid seek index of"
+                          << m_file.fileName();
+        return false;
+    }
+    for (const auto& seekFrame : seekIndex.seekFrames) {
+        addSeekFrame(seekFrame.frameIndex, m_pFileData + seekFrame.byteOffset);
     }
+    // Restart decoding at least kMp3SeekFramePrefetchCount MP3 frames
+    // before the target position
+    m_seekFramePrefetchCount =
+            (kMp3SeekFramePrefetchCount + seekIndex.seekFrameInterval - 1) /
+            seekIndex.seekFrameInterval;
+    m_curFrameIndex = seekIndex.frameLength;
+    initChannelCountOnce(seekIndex.channelCount);
+    initSampleRateOnce(seekIndex.sampleRate);
+    if (seekIndex.bitrate > 0) {
+        initBitrateOnce(seekIndex.bitrate);
+    }
+    return true;
+}
 
-    return OpenResult::Succeeded;
+void SoundSourceMp3::saveSeekIndex() const {
+    if (!SeekIndexFile::isEnabled()) {
+        return;
+    }
+    SeekIndex seekIndex;
+    seekIndex.channelCount = getSignalInfo().getChannelCount();
+    seekIndex.sampleRate = getSignalInfo().getSampleRate();
+    seekIndex.bitrate = getBitrate();
+    seekIndex.frameLength = m_curFrameIndex;
+    seekIndex.seekFrameInterval = kSeekIndexFrameInterval;
+    seekIndex.seekFrames.reserve(
+            m_seekFrameList.size() / kSeekIndexFrameInterval + 1);
+    for (std::size_t i = 0; i < m_seekFrameList.size();
+            i += kSeekIndexFrameInterval) {
+        const auto& seekFrame = m_seekFrameList[i];
+        SeekIndex::SeekFrame indexFrame;
+        indexFrame.frameIndex = seekFrame.frameIndex;
+        indexFrame.byteOffset = seekFrame.pInputData - m_pFileData;
+        seekIndex.seekFrames.push_back(indexFrame);
+    }
+    SeekIndexFile::save(m_file.fileName(), seekIndex);
 }
 
 void SoundSourceMp3::close() {
@@ -532,15 +610,15 @@ ReadableSampleFrames SoundSourceMp3::readSampleFramesClamped(
         // some consistency checks
         DEBUG_ASSERT((curSeekFrameIndex >= seekFrameIndex) || (m_curFrameIndex < firstFrameIndex));
         DEBUG_ASSERT((curSeekFrameIndex <= seekFrameIndex) || (m_curFrameIndex > firstFrameIndex));
-        if ((frameIndexMax() <= m_curFrameIndex) ||                                    // out of range
-                (firstFrameIndex < m_curFrameIndex) ||                                 // seek backward
-                (seekFrameIndex > (curSeekFrameIndex + kMp3SeekFramePrefetchCount))) { // jump forward
+        if ((frameIndexMax() <= m_curFrameIndex) ||                                        // out of range
+                (firstFrameIndex < m_curFrameIndex) ||                                     // seek backward
+                (seekFrameIndex > (curSeekFrameIndex + m_seekFramePrefetchCount))) {       // jump forward
 
             // Adjust the seek frame index for prefetching
-            if (kMp3SeekFramePrefetchCount < seekFrameIndex) {
-                // Restart decoding kMp3SeekFramePrefetchCount seek frames
+            if (m_seekFramePrefetchCount < seekFrameIndex) {
+                // Restart decoding m_seekFramePrefetchCount seek frames
                 // before the expected sync position
-                seekFrameIndex -= kMp3SeekFramePrefetchCount;
+                seekFrameIndex -= m_seekFramePrefetchCount;
             } else {
                 // Restart decoding at the beginning of the audio stream
                 seekFrameIndex = 0;
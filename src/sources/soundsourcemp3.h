@@ -17,6 +17,8 @@
 
 namespace mixxx {
 
+struct SeekIndex;
+
 class SoundSourceMp3 final : public SoundSource {
   public:
     explicit SoundSourceMp3(const QUrl& url);
@@ -33,6 +35,15 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    // Decodes the headers of all MP3 frames to build the seek frame
+    // list and to determine the stream properties
+    OpenResult scanFrameHeaders();
+
+    // Reuses the seek frame list of a previous scan. Returns false
+    // if the index does not fit the file.
+    bool initSeekFrameListFromIndex(const SeekIndex& seekIndex);
+    void saveSeekIndex() const;
+
     QFile m_file;
     quint64 m_fileSize;
     unsigned char* m_pFileData;
@@ -51,6 +62,10 @@ class SoundSourceMp3 final : public SoundSource {
     typedef std::vector<SeekFrameType> SeekFrameList;
     SeekFrameList m_seekFrameList; // ordered-by frameIndex
     SINT m_avgSeekFrameCount;      // avg. sample frames per MP3 frame
+    // The number of seek frames to restart decoding before the target
+    // position. Less than kMp3SeekFramePrefetchCount if the list has been
+    // loaded from a sparse seek index.
+    SINT m_seekFramePrefetchCount;
 
     void addSeekFrame(SINT frameIndex, const unsigned char* pInputData);
 
@@ -46,6 +46,7 @@
 /*static*/ mixxx::SoundSourceProviderRegistry SoundSourceProxy::s_soundSourceProviders;
 /*static*/ QStringList SoundSourceProxy::s_supportedFileNamePatterns;
 /*static*/ QRegExp SoundSourceProxy::s_supportedFileNamesRegex;
+/*static*/ mixxx::PcmCachePointer SoundSourceProxy::s_pPcmCache;
 
 namespace {
 
@@ -130,6 +131,13 @@ void SoundSourceProxy::registerSoundSourceProviders() {
             QRegExp(supportedFileExtensionsRegex, Qt::CaseInsensitive);
 }
 
+// static
+void SoundSourceProxy::setPcmCache(mixxx::PcmCachePointer pPcmCache) {
+    // Audio sources are opened concurrently by the reader and analyzer
+    // threads
+    std::atomic_store(&s_pPcmCache, std::move(pPcmCache));
+}
+
 // static
 bool SoundSourceProxy::isUrlSupported(const QUrl& url) {
     return isFileSupported(TrackFile::fromUrl(url));
@@ -468,8 +476,26 @@ QImage SoundSourceProxy::importCoverImage() const {
     return QImage();
 }
 
-mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(const mixxx::AudioSource::OpenParams& params) {
+mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
+        const mixxx::AudioSource::OpenParams& params,
+        PcmCacheMode pcmCacheMode) {
     DEBUG_ASSERT(m_pTrack);
+    const mixxx::PcmCachePointer pPcmCache = std::atomic_load(&s_pPcmCache);
+    if (pPcmCache && m_pSoundSource && !m_pAudioSource) {
+        mixxx::AudioSourcePointer pCachedAudioSource =
+                pPcmCache->openAudioSource(m_url, params);
+        if (pCachedAudioSource) {
+            kLogger.debug() << "Opening cached audio data of file"
+                            << getUrl().toString();
+            m_pAudioSource = mixxx::AudioSourceTrackProxy::create(
+                    m_pTrack, std::move(pCachedAudioSource));
+            if (m_pTrack) {
+                m_pTrack->updateAudioPropertiesFromStream(
+                        m_pAudioSource->getStreamInfo());
+            }
+            return m_pAudioSource;
+        }
+    }
     auto openMode = mixxx::SoundSource::OpenMode::Strict;
     while (m_pSoundSource && !m_pAudioSource) {
         // NOTE(uklotzde): Log unconditionally (with debug level) to
@@ -504,7 +530,13 @@ mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(const mixxx::AudioSo
             continue; // try again
         }
         if ((openResult == mixxx::SoundSource::OpenResult::Succeeded) && m_pSoundSource->verifyReadable()) {
-            m_pAudioSource = mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
+            mixxx::AudioSourcePointer pAudioSource = m_pSoundSource;
+            if (pPcmCache && pcmCacheMode == PcmCacheMode::ReadWrite) {
+                pAudioSource = pPcmCache->createCachingAudioSource(
+                        m_url, params, std::move(pAudioSource));
+            }
+            m_pAudioSource = mixxx::AudioSourceTrackProxy::create(
+                    m_pTrack, std::move(pAudioSource));
             DEBUG_ASSERT(m_pAudioSource);
             if (m_pAudioSource->frameIndexRange().empty()) {
                 kLogger.warning() << "File is empty"
@@ -540,7 +572,8 @@ mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(const mixxx::AudioSo
 void SoundSourceProxy::closeAudioSource() {
     if (m_pAudioSource) {
         DEBUG_ASSERT(m_pSoundSource);
-        m_pSoundSource->close();
+        // Closes the SoundSource or the cached audio data
+        m_pAudioSource->close();
         m_pAudioSource = mixxx::AudioSourcePointer();
         if (kLogger.debugEnabled()) {
             kLogger.debug() << "Closed AudioSource for file"
@@ -2,6 +2,7 @@
 
 #include "track/track.h"
 
+#include "sources/pcmcache.h"
 #include "sources/soundsourceproviderregistry.h"
 
 // Creates sound sources for tracks. Only intended to be used
@@ -23,6 +24,11 @@ class SoundSourceProxy {
         return s_supportedFileNamesRegex;
     }
 
+    // Enables caching of decoded audio data for all subsequently opened
+    // audio sources. A null pointer disables the cache. Thread-safe, audio
+    // sources that are still open keep the previous cache alive.
+    static void setPcmCache(mixxx::PcmCachePointer pPcmCache);
+
     static bool isUrlSupported(const QUrl& url);
     static bool isFileSupported(const TrackFile& trackFile);
     static bool isFileSupported(const QFileInfo& fileInfo);
@@ -94,11 +100,21 @@ class SoundSourceProxy {
     // the referenced track.
     mixxx::MetadataSource::ImportResult importTrackMetadata(mixxx::TrackMetadata* pTrackMetadata) const;
 
+    // Whether the decoded audio data may be written into the PcmCache.
+    // Only tracks that are loaded into decks and samplers should populate
+    // the cache, so that batch analysis of the library does not evict their
+    // entries. Cached data is read in both modes.
+    enum class PcmCacheMode {
+        ReadOnly,
+        ReadWrite,
+    };
+
     // Opening the audio source through the proxy will update the
     // audio properties of the corresponding track object. Returns
     // a null pointer on failure.
     mixxx::AudioSourcePointer openAudioSource(
-            const mixxx::AudioSource::OpenParams& params = mixxx::AudioSource::OpenParams());
+            const mixxx::AudioSource::OpenParams& params = mixxx::AudioSource::OpenParams(),
+            PcmCacheMode pcmCacheMode = PcmCacheMode::ReadOnly);
 
     void closeAudioSource();
 
@@ -106,6 +122,7 @@ class SoundSourceProxy {
     static mixxx::SoundSourceProviderRegistry s_soundSourceProviders;
     static QStringList s_supportedFileNamePatterns;
     static QRegExp s_supportedFileNamesRegex;
+    static mixxx::PcmCachePointer s_pPcmCache;
 
     friend class TrackCollectionManager;
     static ExportTrackMetadataResult exportTrackMetadataBeforeSaving(Track* pTrack);
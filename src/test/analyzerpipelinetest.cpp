@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <QThread>
+
+#include <vector>
+
+#include "analyzer/analyzerpipeline.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kRingCapacity = 4;
+constexpr SINT kSamplesPerChunk = 8;
+constexpr int kChunkCount = 100;
+
+// Records the first sample of each chunk and the threads it has been
+// invoked on
+class RecordingAnalyzer : public Analyzer {
+  public:
+    explicit RecordingAnalyzer(int failAfterChunks = -1)
+            : m_failAfterChunks(failAfterChunks) {
+    }
+
+    bool initialize(TrackPointer tio, int sampleRate, int totalSamples) override {
+        Q_UNUSED(tio);
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(totalSamples);
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, const int iLen) override {
+        EXPECT_EQ(kSamplesPerChunk, iLen);
+        m_firstSamples.push_back(pIn[0]);
+        m_pThread = QThread::currentThread();
+        // Give the other consumers a chance to overtake
+        QThread::yieldCurrentThread();
+        return m_failAfterChunks < 0 ||
+                static_cast<int>(m_firstSamples.size()) < m_failAfterChunks;
+    }
+
+    void storeResults(TrackPointer tio) override {
+        Q_UNUSED(tio);
+    }
+
+    void cleanup() override {
+    }
+
+    std::vector<CSAMPLE> m_firstSamples;
+    QThread* m_pThread = nullptr;
+
+  private:
+    const int m_failAfterChunks;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    AnalyzerPipelineTest()
+            : m_pipeline(kRingCapacity, kSamplesPerChunk) {
+    }
+
+    RecordingAnalyzer* addAnalyzer(int failAfterChunks = -1) {
+        auto pAnalyzer = std::make_unique<RecordingAnalyzer>(failAfterChunks);
+        RecordingAnalyzer* pRecorder = pAnalyzer.get();
+        m_analyzers.push_back(AnalyzerWithState(std::move(pAnalyzer)));
+        m_analyzers.back().initialize(TrackPointer(), 44100, kChunkCount * kSamplesPerChunk);
+        return pRecorder;
+    }
+
+    void produceChunks(int chunkCount) {
+        for (int i = 0; i < chunkCount; ++i) {
+            const auto slice = m_pipeline.nextChunk();
+            ASSERT_GE(slice.length(), kSamplesPerChunk);
+            for (SINT j = 0; j < kSamplesPerChunk; ++j) {
+                slice[j] = static_cast<CSAMPLE>(i);
+            }
+            m_pipeline.commitChunk(slice.data(), kSamplesPerChunk);
+        }
+    }
+
+    void TearDown() override {
+        for (auto& analyzer : m_analyzers) {
+            analyzer.cancel();
+        }
+    }
+
+    AnalyzerPipeline m_pipeline;
+    std::vector<AnalyzerWithState> m_analyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, AllAnalyzersProcessAllChunksInOrder) {
+    std::vector<RecordingAnalyzer*> recorders;
+    for (int i = 0; i < 3; ++i) {
+        recorders.push_back(addAnalyzer());
+    }
+
+    m_pipeline.start(&m_analyzers);
+    EXPECT_TRUE(m_pipeline.isRunning());
+    produceChunks(kChunkCount);
+    m_pipeline.stop(true);
+    EXPECT_FALSE(m_pipeline.isRunning());
+
+    for (const auto* pRecorder : recorders) {
+        ASSERT_EQ(kChunkCount, static_cast<int>(pRecorder->m_firstSamples.size()));
+        for (int i = 0; i < kChunkCount; ++i) {
+            EXPECT_EQ(static_cast<CSAMPLE>(i), pRecorder->m_firstSamples[i]);
+        }
+        // Each analyzer runs on a separate thread
+        EXPECT_NE(QThread::currentThread(), pRecorder->m_pThread);
+    }
+    EXPECT_NE(recorders[0]->m_pThread, recorders[1]->m_pThread);
+    EXPECT_NE(recorders[1]->m_pThread, recorders[2]->m_pThread);
+    for (const auto& analyzer : m_analyzers) {
+        EXPECT_TRUE(analyzer.isActive());
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, FailingAnalyzerDoesNotBlockOthers) {
+    RecordingAnalyzer* pFailing = addAnalyzer(10);
+    RecordingAnalyzer* pRecorder = addAnalyzer();
+
+    m_pipeline.start(&m_analyzers);
+    produceChunks(kChunkCount);
+    m_pipeline.stop(true);
+
+    EXPECT_EQ(10, static_cast<int>(pFailing->m_firstSamples.size()));
+    EXPECT_FALSE(m_analyzers[0].isActive());
+    EXPECT_EQ(kChunkCount, static_cast<int>(pRecorder->m_firstSamples.size()));
+    EXPECT_TRUE(m_analyzers[1].isActive());
+}
+
+TEST_F(AnalyzerPipelineTest, StopWithoutDrainingDiscardsChunks) {
+    RecordingAnalyzer* pRecorder = addAnalyzer();
+
+    m_pipeline.start(&m_analyzers);
+    produceChunks(kRingCapacity);
+    m_pipeline.stop(false);
+
+    // Chunks are processed in order without gaps, but not necessarily all
+    EXPECT_LE(static_cast<int>(pRecorder->m_firstSamples.size()), kRingCapacity);
+    for (int i = 0; i < static_cast<int>(pRecorder->m_firstSamples.size()); ++i) {
+        EXPECT_EQ(static_cast<CSAMPLE>(i), pRecorder->m_firstSamples[i]);
+    }
+
+    // The pipeline can be restarted for the next track
+    pRecorder->m_firstSamples.clear();
+    m_pipeline.start(&m_analyzers);
+    produceChunks(kRingCapacity * 2);
+    m_pipeline.stop(true);
+    EXPECT_EQ(kRingCapacity * 2, static_cast<int>(pRecorder->m_firstSamples.size()));
+}
+
+} // namespace
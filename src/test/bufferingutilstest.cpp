@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/plugins/buffering_utils.h"
+
+namespace {
+
+using mixxx::DownmixAndOverlapHelper;
+
+class DownmixAndOverlapHelperTest : public testing::Test {
+  protected:
+    static constexpr size_t kWindowSize = 8;
+    static constexpr size_t kStepSize = 4;
+    // Spans several windows in a single chunk
+    static constexpr size_t kNumFrames = 5 * kWindowSize + 3;
+
+    typedef std::vector<std::vector<double>> Windows;
+
+    void initialize(DownmixAndOverlapHelper* pHelper, Windows* pWindows) {
+        ASSERT_TRUE(pHelper->initialize(kWindowSize, kStepSize,
+                [pWindows](double* pBuffer, size_t frames) {
+                    pWindows->emplace_back(pBuffer, pBuffer + frames);
+                    return true;
+                }));
+    }
+
+    static CSAMPLE monoSample(size_t frame) {
+        return static_cast<CSAMPLE>(frame + 1);
+    }
+
+    // The first window is centered on the first frame, i.e. it starts
+    // with half a window of silence.
+    static Windows expectedWindows() {
+        Windows windows;
+        for (size_t start = 0;
+                start + kWindowSize <= kNumFrames + kWindowSize / 2;
+                start += kStepSize) {
+            std::vector<double> window;
+            for (size_t i = 0; i < kWindowSize; ++i) {
+                const size_t position = start + i;
+                window.push_back(position < kWindowSize / 2
+                                ? 0.0
+                                : monoSample(position - kWindowSize / 2));
+            }
+            windows.push_back(window);
+        }
+        return windows;
+    }
+};
+
+TEST_F(DownmixAndOverlapHelperTest, StereoChunkSpanningSeveralWindows) {
+    std::vector<CSAMPLE> stereo;
+    for (size_t frame = 0; frame < kNumFrames; ++frame) {
+        // Downmixed to (L + R) / 2 == monoSample(frame)
+        stereo.push_back(monoSample(frame) + 0.5f);
+        stereo.push_back(monoSample(frame) - 0.5f);
+    }
+
+    DownmixAndOverlapHelper helper;
+    Windows windows;
+    initialize(&helper, &windows);
+    EXPECT_TRUE(helper.processStereoSamples(stereo.data(), stereo.size()));
+
+    EXPECT_EQ(expectedWindows(), windows);
+}
+
+TEST_F(DownmixAndOverlapHelperTest, MonoChunkSpanningSeveralWindows) {
+    std::vector<CSAMPLE> mono;
+    for (size_t frame = 0; frame < kNumFrames; ++frame) {
+        mono.push_back(monoSample(frame));
+    }
+
+    DownmixAndOverlapHelper helper;
+    Windows windows;
+    initialize(&helper, &windows);
+    EXPECT_TRUE(helper.processMonoSamples(mono.data(), mono.size()));
+
+    EXPECT_EQ(expectedWindows(), windows);
+}
+
+TEST_F(DownmixAndOverlapHelperTest, StereoAndMonoChunksGiveSameWindows) {
+    std::vector<CSAMPLE> stereo;
+    std::vector<CSAMPLE> mono;
+    for (size_t frame = 0; frame < kNumFrames; ++frame) {
+        stereo.push_back(monoSample(frame));
+        stereo.push_back(monoSample(frame));
+        mono.push_back(monoSample(frame));
+    }
+
+    DownmixAndOverlapHelper stereoHelper;
+    Windows stereoWindows;
+    initialize(&stereoHelper, &stereoWindows);
+    EXPECT_TRUE(stereoHelper.processStereoSamples(stereo.data(), stereo.size()));
+    EXPECT_TRUE(stereoHelper.finalize());
+
+    DownmixAndOverlapHelper monoHelper;
+    Windows monoWindows;
+    initialize(&monoHelper, &monoWindows);
+    EXPECT_TRUE(monoHelper.processMonoSamples(mono.data(), mono.size()));
+    EXPECT_TRUE(monoHelper.finalize());
+
+    EXPECT_FALSE(monoWindows.empty());
+    EXPECT_EQ(stereoWindows, monoWindows);
+}
+
+} // namespace
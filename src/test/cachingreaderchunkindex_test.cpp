@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const SINT kNumChunks = 8;
+
+class CachingReaderChunkIndexTest : public testing::Test {
+  protected:
+    CachingReaderChunkIndexTest()
+            : m_sampleBuffer(CachingReaderChunk::kSamples * kNumChunks) {
+        for (SINT i = 0; i < kNumChunks; ++i) {
+            m_chunks.push_back(std::make_unique<CachingReaderChunkForOwner>(
+                    mixxx::SampleBuffer::WritableSlice(
+                            m_sampleBuffer,
+                            CachingReaderChunk::kSamples * i,
+                            CachingReaderChunk::kSamples)));
+        }
+    }
+
+    CachingReaderChunkForOwner* chunk(SINT i, SINT chunkIndex) {
+        m_chunks[i]->init(chunkIndex);
+        return m_chunks[i].get();
+    }
+
+    mixxx::SampleBuffer m_sampleBuffer;
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> m_chunks;
+};
+
+TEST_F(CachingReaderChunkIndexTest, InsertFindRemove) {
+    CachingReaderChunkIndex index(kNumChunks);
+    EXPECT_EQ(0, index.size());
+    EXPECT_EQ(nullptr, index.find(0));
+
+    auto pChunk = chunk(0, 42);
+    EXPECT_TRUE(index.insert(pChunk));
+    EXPECT_FALSE(index.insert(pChunk));
+    EXPECT_EQ(1, index.size());
+    EXPECT_EQ(pChunk, index.find(42));
+    EXPECT_EQ(nullptr, index.find(41));
+
+    EXPECT_EQ(1, index.remove(42));
+    EXPECT_EQ(0, index.remove(42));
+    EXPECT_EQ(0, index.size());
+    EXPECT_EQ(nullptr, index.find(42));
+}
+
+TEST_F(CachingReaderChunkIndexTest, RemoveKeepsProbeSequences) {
+    CachingReaderChunkIndex index(kNumChunks);
+    // Consecutive chunk indices like the ones a playing deck requests
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        EXPECT_TRUE(index.insert(chunk(i, 1000 + i)));
+    }
+    EXPECT_EQ(kNumChunks, index.size());
+
+    // Remove every other entry and verify that all others are still found
+    for (SINT i = 0; i < kNumChunks; i += 2) {
+        EXPECT_EQ(1, index.remove(1000 + i));
+    }
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        if (i % 2 == 0) {
+            EXPECT_EQ(nullptr, index.find(1000 + i));
+        } else {
+            EXPECT_EQ(m_chunks[i].get(), index.find(1000 + i));
+        }
+    }
+
+    // Reuse the free slots for other keys
+    for (SINT i = 0; i < kNumChunks; i += 2) {
+        EXPECT_TRUE(index.insert(chunk(i, 5000 + i)));
+        EXPECT_EQ(m_chunks[i].get(), index.find(5000 + i));
+    }
+    EXPECT_EQ(kNumChunks, index.size());
+}
+
+TEST_F(CachingReaderChunkIndexTest, Clear) {
+    CachingReaderChunkIndex index(kNumChunks);
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        EXPECT_TRUE(index.insert(chunk(i, i * 7)));
+    }
+    index.clear();
+    EXPECT_EQ(0, index.size());
+    for (SINT i = 0; i < kNumChunks; ++i) {
+        EXPECT_EQ(nullptr, index.find(i * 7));
+    }
+    EXPECT_TRUE(index.insert(chunk(0, 7)));
+    EXPECT_EQ(m_chunks[0].get(), index.find(7));
+}
+
+} // namespace
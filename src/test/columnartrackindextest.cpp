@@ -0,0 +1,289 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+
+#include "library/columnartrackindex.h"
+
+namespace {
+
+using SortMode = ColumnarTrackIndex::SortMode;
+using SortSpec = ColumnarTrackIndex::SortSpec;
+
+const int kArtistColumn = 0;
+const int kNumberColumn = 1;
+const int kTrackNumberColumn = 2;
+const int kNumColumns = 3;
+
+const QStringList kColumnNames = {"artist", "number", "tracknumber"};
+
+class ColumnarTrackIndexTest : public testing::Test {
+  protected:
+    ColumnarTrackIndexTest()
+            : m_index(kColumnNames) {
+    }
+
+    void addTrack(int id, const QVariant& artist, const QVariant& number,
+            const QVariant& trackNumber = QVariant()) {
+        const int row = m_index.insertRow(TrackId(id));
+        m_index.setValue(row, kArtistColumn, artist);
+        m_index.setValue(row, kNumberColumn, number);
+        m_index.setValue(row, kTrackNumberColumn, trackNumber);
+    }
+
+    QList<int> sorted(const QVector<SortSpec>& specs) {
+        QVector<TrackId> trackIds;
+        for (int id : m_ids) {
+            trackIds.append(TrackId(id));
+        }
+        EXPECT_TRUE(m_index.canSort(specs));
+        m_index.sort(&trackIds, specs);
+        QList<int> result;
+        for (const auto& trackId : trackIds) {
+            result.append(trackId.value());
+        }
+        return result;
+    }
+
+    QList<int> tracksOf(const QBitArray& rows) const {
+        EXPECT_EQ(m_index.rowCount(), rows.size());
+        QList<int> result;
+        for (int id : m_ids) {
+            const int row = m_index.row(TrackId(id));
+            if (row >= 0 && rows.testBit(row)) {
+                result.append(id);
+            }
+        }
+        return result;
+    }
+
+    QList<int> tracksContaining(int column, const QString& argument) const {
+        return tracksOf(m_index.rowsContaining(column, argument));
+    }
+
+    static SortSpec spec(int column,
+            Qt::SortOrder order = Qt::AscendingOrder,
+            SortMode mode = SortMode::Natural) {
+        return SortSpec{column, order, mode, {}};
+    }
+
+    ColumnarTrackIndex m_index;
+    QList<int> m_ids;
+};
+
+TEST_F(ColumnarTrackIndexTest, StoresValuesWithTheirTypes) {
+    const QDateTime dateTime = QDateTime::currentDateTimeUtc();
+    addTrack(1, "Artist", 2.5, 7);
+    addTrack(2, QVariant(QVariant::String), qlonglong(1) << 40, true);
+    addTrack(3, "", dateTime);
+
+    EXPECT_EQ(QVariant("Artist"), m_index.value(TrackId(1), kArtistColumn));
+    EXPECT_EQ(QVariant(2.5), m_index.value(TrackId(1), kNumberColumn));
+    EXPECT_EQ(QVariant::Int, m_index.value(TrackId(1), kTrackNumberColumn).type());
+    EXPECT_EQ(7, m_index.value(TrackId(1), kTrackNumberColumn).toInt());
+
+    const QVariant nullString = m_index.value(TrackId(2), kArtistColumn);
+    EXPECT_TRUE(nullString.isNull());
+    EXPECT_EQ(QVariant::String, nullString.type());
+    EXPECT_EQ(QVariant(qlonglong(1) << 40), m_index.value(TrackId(2), kNumberColumn));
+    EXPECT_EQ(QVariant(true), m_index.value(TrackId(2), kTrackNumberColumn));
+
+    EXPECT_EQ(QVariant(""), m_index.value(TrackId(3), kArtistColumn));
+    EXPECT_FALSE(m_index.value(TrackId(3), kArtistColumn).isNull());
+    EXPECT_EQ(QVariant(dateTime), m_index.value(TrackId(3), kNumberColumn));
+    EXPECT_FALSE(m_index.value(TrackId(3), kTrackNumberColumn).isValid());
+
+    EXPECT_FALSE(m_index.value(TrackId(4), kArtistColumn).isValid());
+    EXPECT_FALSE(m_index.value(TrackId(1), kNumColumns).isValid());
+}
+
+TEST_F(ColumnarTrackIndexTest, ReusesRowsOfRemovedTracks) {
+    addTrack(1, "A", 1);
+    addTrack(2, "B", 2);
+    EXPECT_EQ(2, m_index.size());
+    const int row = m_index.insertRow(TrackId(1));
+
+    m_index.removeRow(TrackId(1));
+    EXPECT_FALSE(m_index.contains(TrackId(1)));
+    EXPECT_FALSE(m_index.value(TrackId(1), kArtistColumn).isValid());
+    EXPECT_EQ(1, m_index.size());
+
+    EXPECT_EQ(row, m_index.insertRow(TrackId(3)));
+    EXPECT_FALSE(m_index.value(TrackId(3), kArtistColumn).isValid());
+    EXPECT_EQ(QVariant("B"), m_index.value(TrackId(2), kArtistColumn));
+
+    m_index.clear();
+    EXPECT_EQ(0, m_index.size());
+    EXPECT_FALSE(m_index.contains(TrackId(2)));
+}
+
+TEST_F(ColumnarTrackIndexTest, SortsLikeSqlite) {
+    addTrack(1, "beta", 3);
+    addTrack(2, "Alpha", QVariant());
+    addTrack(3, QVariant(QVariant::String), 1.5);
+    addTrack(4, "ALPHA", 1);
+    addTrack(5, "gamma", "text");
+    m_ids = {1, 2, 3, 4, 5};
+
+    // NULL first, case-insensitive ties by id
+    EXPECT_EQ(QList<int>({3, 2, 4, 1, 5}), sorted({spec(kArtistColumn)}));
+    EXPECT_EQ(QList<int>({5, 1, 2, 4, 3}),
+            sorted({spec(kArtistColumn, Qt::DescendingOrder)}));
+    // Ties are sorted by the next column
+    EXPECT_EQ(QList<int>({3, 4, 2, 1, 5}),
+            sorted({spec(kArtistColumn),
+                    spec(kNumberColumn, Qt::DescendingOrder)}));
+    // Numbers before strings
+    EXPECT_EQ(QList<int>({2, 4, 3, 1, 5}), sorted({spec(kNumberColumn)}));
+}
+
+TEST_F(ColumnarTrackIndexTest, SortsTextAsIntegers) {
+    addTrack(1, "A", 0, "10");
+    addTrack(2, "B", 0, "9/12");
+    addTrack(3, "C", 0, " -1");
+    addTrack(4, "D", 0, "");
+    addTrack(5, "E", 0, QVariant());
+    m_ids = {1, 2, 3, 4, 5};
+
+    EXPECT_EQ(QList<int>({5, 3, 4, 2, 1}),
+            sorted({spec(kTrackNumberColumn, Qt::AscendingOrder, SortMode::Integer)}));
+}
+
+TEST_F(ColumnarTrackIndexTest, SortsMappedIntegers) {
+    addTrack(1, "A", 0);
+    addTrack(2, "B", 1);
+    addTrack(3, "C", 2);
+    addTrack(4, "D", 7);
+    m_ids = {1, 2, 3, 4};
+
+    SortSpec mapped = spec(kNumberColumn, Qt::AscendingOrder, SortMode::Mapped);
+    mapped.integerOrder = {2, 0, 1};
+    EXPECT_EQ(QList<int>({4, 2, 3, 1}), sorted({mapped}));
+}
+
+TEST_F(ColumnarTrackIndexTest, KeepsRanksOfNewStrings) {
+    for (int i = 0; i < 500; ++i) {
+        addTrack(i, QString("Artist %1").arg(i, 3, 10, QChar('0')), 0);
+        m_ids.append(i);
+    }
+    QList<int> expected = m_ids;
+    EXPECT_EQ(expected, sorted({spec(kArtistColumn)}));
+
+    // Few new strings are inserted into the existing order
+    addTrack(1000, "Artist 250b", 0);
+    addTrack(1001, "artist 000", 0);
+    addTrack(1002, "0", 0);
+    m_ids.append({1000, 1001, 1002});
+    expected.insert(251, 1000);
+    expected.insert(1, 1001);
+    expected.prepend(1002);
+    EXPECT_EQ(expected, sorted({spec(kArtistColumn)}));
+}
+
+TEST_F(ColumnarTrackIndexTest, SortsOnlySupportedColumns) {
+    addTrack(1, "A", 1);
+    addTrack(2, "B", QDateTime::currentDateTimeUtc());
+    EXPECT_TRUE(m_index.canSort({spec(kArtistColumn, Qt::AscendingOrder, SortMode::Text)}));
+    // lower() would turn the numbers into strings
+    EXPECT_FALSE(m_index.canSort({spec(kNumberColumn, Qt::AscendingOrder, SortMode::Text)}));
+    EXPECT_FALSE(m_index.canSort({spec(kNumberColumn)}));
+    EXPECT_FALSE(m_index.canSort({spec(kNumColumns)}));
+
+    m_index.setValue(m_index.insertRow(TrackId(2)), kNumberColumn, 2);
+    EXPECT_TRUE(m_index.canSort({spec(kNumberColumn)}));
+}
+
+TEST_F(ColumnarTrackIndexTest, FindsColumnsByName) {
+    EXPECT_EQ(kNumColumns, m_index.columnCount());
+    EXPECT_EQ(kTrackNumberColumn, m_index.columnIndex("tracknumber"));
+    EXPECT_EQ(-1, m_index.columnIndex("title"));
+}
+
+TEST_F(ColumnarTrackIndexTest, SearchesTextLikeSql) {
+    addTrack(1, "Daft Punk", 1);
+    addTrack(2, "R\u00F6yksopp", 128.0);
+    addTrack(3, QVariant(QVariant::String), 2);
+    addTrack(4, "Punks & P\u00FCnktchen", "x");
+    addTrack(5, "Deadmau5", QVariant());
+    m_ids = {1, 2, 3, 4, 5};
+
+    // Within a token, with and without trigrams
+    EXPECT_EQ(QList<int>({1, 4}), tracksContaining(kArtistColumn, "punk"));
+    EXPECT_EQ(QList<int>({1, 4}), tracksContaining(kArtistColumn, "pu"));
+    EXPECT_EQ(QList<int>({2}), tracksContaining(kArtistColumn, "oyk"));
+    // Accents are folded
+    EXPECT_EQ(QList<int>({4}), tracksContaining(kArtistColumn, "punkt"));
+    // Across tokens
+    EXPECT_EQ(QList<int>({1}), tracksContaining(kArtistColumn, "t p"));
+    EXPECT_EQ(QList<int>({4}), tracksContaining(kArtistColumn, "& p"));
+    // A trailing space must be followed by another character
+    EXPECT_EQ(QList<int>({1}), tracksContaining(kArtistColumn, "daft "));
+    EXPECT_EQ(QList<int>(), tracksContaining(kArtistColumn, "punk "));
+    // Numbers are searched as text like in SQLite
+    EXPECT_EQ(QList<int>({2}), tracksContaining(kNumberColumn, "128.0"));
+    EXPECT_EQ(QList<int>({1, 2}), tracksContaining(kNumberColumn, "1"));
+
+    EXPECT_EQ(QList<int>({3}), tracksOf(m_index.rowsWithNull(kArtistColumn)));
+    EXPECT_EQ(QList<int>({5}), tracksOf(m_index.rowsWithNull(kNumberColumn)));
+
+    // New strings and removed tracks
+    addTrack(6, "Punk Rock", 0);
+    m_ids.append(6);
+    m_index.removeRow(TrackId(1));
+    EXPECT_EQ(QList<int>({4, 6}), tracksContaining(kArtistColumn, "punk"));
+    EXPECT_EQ(QList<int>({2, 3, 4, 5, 6}), tracksOf(m_index.allRows()));
+    EXPECT_EQ(QList<int>({5}), tracksOf(m_index.rowsWithNull(kNumberColumn)));
+}
+
+TEST_F(ColumnarTrackIndexTest, MatchesEveryStringOnce) {
+    addTrack(1, "A", 120.5, "2001");
+    addTrack(2, "B", 90, "1999");
+    addTrack(3, "C", QVariant(), "2001");
+    m_ids = {1, 2, 3};
+
+    EXPECT_EQ(QList<int>({1}),
+            tracksOf(m_index.rowsMatching(
+                    kNumberColumn,
+                    [](double value) { return value > 100; },
+                    [](const QString&) { return true; })));
+
+    int numEvaluated = 0;
+    EXPECT_EQ(QList<int>({1, 3}),
+            tracksOf(m_index.rowsMatching(
+                    kTrackNumberColumn,
+                    [](double) { return true; },
+                    [&numEvaluated](const QString& text) {
+                        ++numEvaluated;
+                        return text == "2001";
+                    })));
+    EXPECT_EQ(2, numEvaluated);
+    EXPECT_EQ(QList<int>({1, 3}),
+            tracksOf(m_index.rowsOfTracks({TrackId(1), TrackId(3), TrackId(4)})));
+}
+
+static void BM_ColumnarTrackIndexSort(benchmark::State& state) {
+    const int numTracks = state.range(0);
+    ColumnarTrackIndex index(kColumnNames);
+    QVector<TrackId> trackIds;
+    for (int i = 0; i < numTracks; ++i) {
+        const int row = index.insertRow(TrackId(i));
+        // About 10 tracks per artist
+        index.setValue(row, kArtistColumn,
+                QString("Artist %1").arg((i * 7919) % (numTracks / 10 + 1)));
+        index.setValue(row, kNumberColumn, (i * 31) % 1000);
+        trackIds.append(TrackId(i));
+    }
+    const QVector<SortSpec> specs = {
+            SortSpec{kArtistColumn, Qt::AscendingOrder, SortMode::Text, {}},
+            SortSpec{kNumberColumn, Qt::DescendingOrder, SortMode::Natural, {}}};
+
+    while (state.KeepRunning()) {
+        QVector<TrackId> sortedTrackIds = trackIds;
+        index.sort(&sortedTrackIds, specs);
+        benchmark::DoNotOptimize(sortedTrackIds);
+    }
+    state.SetItemsProcessed(state.iterations() * numTracks);
+}
+BENCHMARK(BM_ColumnarTrackIndexSort)->Range(1000, 256000);
+
+} // namespace
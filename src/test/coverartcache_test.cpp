@@ -77,3 +77,33 @@ TEST_F(CoverArtCacheTest, loadCover) {
     loadCoverFromFile(kTrackLocationTest, kCoverFileTest, kCoverLocationTest); //relative
     loadCoverFromFile(QString(), kCoverLocationTest, kCoverLocationTest); //absolute
 }
+
+TEST_F(CoverArtCacheTest, loadCoverFromFileAtDesiredWidth) {
+    const QImage img = QImage(kCoverLocationTest);
+    ASSERT_FALSE(img.isNull());
+    const int desiredWidth = img.width() / 4;
+    ASSERT_GT(desiredWidth, 0);
+
+    CoverInfo info;
+    info.type = CoverInfo::FILE;
+    info.source = CoverInfo::GUESSED;
+    info.coverLocation = kCoverLocationTest;
+    info.hash = 39287; // actual cover image hash!
+
+    // The image is decoded at the desired width
+    CoverArtCache::FutureResult res =
+            CoverArtCache::loadCover(nullptr, TrackPointer(), info, desiredWidth, false);
+    EXPECT_EQ(info.hash, res.cover.hash);
+    EXPECT_FALSE(res.coverInfoUpdated);
+    EXPECT_EQ(desiredWidth, res.cover.resizedToWidth);
+    EXPECT_EQ(desiredWidth, res.cover.image.width());
+    EXPECT_NEAR(img.height() * desiredWidth / img.width(),
+            res.cover.image.height(), 1);
+
+    // Without a valid hash the original image is needed to calculate it
+    info.hash = CoverImageUtils::defaultHash();
+    res = CoverArtCache::loadCover(nullptr, TrackPointer(), info, desiredWidth, false);
+    EXPECT_TRUE(res.coverInfoUpdated);
+    EXPECT_EQ(39287, res.cover.hash);
+    EXPECT_EQ(desiredWidth, res.cover.image.width());
+}
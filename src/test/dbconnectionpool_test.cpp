@@ -1,14 +1,24 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include "test/mixxxtest.h"
 
 #include "database/mixxxdb.h"
 #include "util/db/dbconnectionpooler.h"
 #include "util/db/dbconnectionpooled.h"
+#include "util/db/sqltransaction.h"
 
 #include "library/dao/settingsdao.h"
 
 #include "util/assert.h"
+#include "util/performancetimer.h"
 
 
 class DbConnectionPoolTest : public MixxxTest {
@@ -35,3 +45,172 @@ TEST_F(DbConnectionPoolTest, MoveSemantics) {
     EXPECT_TRUE(p1.isPooling());
     EXPECT_FALSE(p2.isPooling());
 }
+
+TEST_F(DbConnectionPoolTest, AppliesPerformanceProfileToEveryConnection) {
+    const mixxx::DbConnectionPoolPtr pPool = m_mixxxDb.connectionPool();
+    const mixxx::DbConnectionPooler pooler(pPool);
+    const mixxx::DbConnection::PerformanceProfile profile =
+            mixxx::DbConnection::queryPerformanceProfile(
+                    mixxx::DbConnectionPooled(pPool));
+    EXPECT_EQ("wal", profile.journalMode.toStdString());
+    EXPECT_EQ(mixxx::DbConnection::PerformanceProfile().cacheSize, profile.cacheSize);
+    EXPECT_EQ(mixxx::DbConnection::PerformanceProfile().tempStore, profile.tempStore);
+
+    mixxx::DbConnection::PerformanceProfile otherProfile;
+    otherProfile.journalMode.clear();
+    std::thread thread([pPool, &otherProfile] {
+        const mixxx::DbConnectionPooler pooler(pPool);
+        otherProfile = mixxx::DbConnection::queryPerformanceProfile(
+                mixxx::DbConnectionPooled(pPool));
+    });
+    thread.join();
+    EXPECT_TRUE(profile == otherProfile);
+}
+
+namespace {
+
+const int kScannerBatchSize = 500;
+const int kNumGuiQueries = 100;
+
+// The defaults of SQLite
+mixxx::DbConnection::PerformanceProfile rollbackJournalProfile() {
+    mixxx::DbConnection::PerformanceProfile profile;
+    profile.journalMode = "delete";
+    profile.synchronous = 2;
+    profile.mmapSize = 0;
+    profile.cacheSize = -2000;
+    profile.tempStore = 0;
+    return profile;
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t index = std::min(values.size() - 1,
+            static_cast<size_t>(fraction * values.size()));
+    return values[index];
+}
+
+// Adds tracks in large transactions like the library scanner
+void replayScanner(mixxx::DbConnectionPoolPtr pPool,
+        const std::atomic<bool>* pStop,
+        int* pNextTrack) {
+    const mixxx::DbConnectionPooler pooler(pPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(pPool);
+    QSqlQuery insertLocation(database);
+    insertLocation.prepare(
+            "INSERT INTO track_locations "
+            "(location, filename, directory, filesize, fs_deleted, needs_verification) "
+            "VALUES (:location, :filename, '/music', 0, 0, 0)");
+    QSqlQuery insertTrack(database);
+    insertTrack.prepare(
+            "INSERT INTO library (artist, title, location, mixxx_deleted) "
+            "VALUES (:artist, :title, :location, 0)");
+    while (!pStop->load()) {
+        SqlTransaction transaction(database);
+        for (int i = 0; i < kScannerBatchSize; ++i) {
+            const int track = (*pNextTrack)++;
+            const QString fileName = QString("%1.mp3").arg(track);
+            insertLocation.bindValue(":location", "/music/" + fileName);
+            insertLocation.bindValue(":filename", fileName);
+            insertLocation.exec();
+            insertTrack.bindValue(":artist", QString("Artist %1").arg(track % 1000));
+            insertTrack.bindValue(":title", QString("Title %1").arg(track));
+            insertTrack.bindValue(":location", insertLocation.lastInsertId());
+            insertTrack.exec();
+        }
+        transaction.commit();
+    }
+}
+
+// Stores results in small transactions like the analyzers
+void replayAnalyzer(mixxx::DbConnectionPoolPtr pPool,
+        const std::atomic<bool>* pStop,
+        std::vector<double>* pLatencies) {
+    const mixxx::DbConnectionPooler pooler(pPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(pPool);
+    int track = 1;
+    while (!pStop->load()) {
+        PerformanceTimer timer;
+        timer.start();
+        SqlTransaction transaction(database);
+        QSqlQuery insertAnalysis(database);
+        insertAnalysis.prepare(
+                "INSERT INTO track_analysis "
+                "(track_id, type, description, version, data_checksum) "
+                "VALUES (:track_id, 'waveform', 'Waveform', '1', '')");
+        insertAnalysis.bindValue(":track_id", track);
+        insertAnalysis.exec();
+        QSqlQuery updateTrack(database);
+        updateTrack.prepare("UPDATE library SET bpm = :bpm WHERE id = :id");
+        updateTrack.bindValue(":bpm", 120.0 + track % 10);
+        updateTrack.bindValue(":id", track);
+        updateTrack.exec();
+        transaction.commit();
+        pLatencies->push_back(timer.elapsed().toDoubleMillis());
+        ++track;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+// Reads a page of the library table like the GUI
+double replayGuiQuery(const QSqlDatabase& database) {
+    PerformanceTimer timer;
+    timer.start();
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.exec(
+            "SELECT library.id, artist, title, track_locations.location "
+            "FROM library INNER JOIN track_locations "
+            "ON library.location = track_locations.id "
+            "ORDER BY library.id DESC LIMIT 200");
+    while (query.next()) {
+    }
+    return timer.elapsed().toDoubleMillis();
+}
+
+} // anonymous namespace
+
+// Replays the scanner, analyzer and GUI workloads concurrently. The
+// argument selects the rollback journal defaults of SQLite (0) or the
+// performance profile of Mixxx (1). The counters are latency percentiles
+// in milliseconds.
+static void BM_ConcurrentDbWorkload(benchmark::State& state) {
+    QTemporaryDir tempDir;
+    mixxx::DbConnection::Params params;
+    params.type = "QSQLITE";
+    params.filePath = tempDir.filePath("mixxxdb.sqlite");
+    if (state.range(0) == 0) {
+        params.performanceProfile = rollbackJournalProfile();
+    }
+    const auto pPool = mixxx::DbConnectionPool::create(params, "ConcurrentDbWorkload");
+    const mixxx::DbConnectionPooler pooler(pPool);
+    const QSqlDatabase database = mixxx::DbConnectionPooled(pPool);
+    MixxxDb::initDatabaseSchema(database);
+
+    int nextTrack = 0;
+    std::vector<double> guiLatencies;
+    std::vector<double> analyzerLatencies;
+    while (state.KeepRunning()) {
+        std::atomic<bool> stop(false);
+        std::thread scanner(replayScanner, pPool, &stop, &nextTrack);
+        std::thread analyzer(replayAnalyzer, pPool, &stop, &analyzerLatencies);
+        for (int i = 0; i < kNumGuiQueries; ++i) {
+            guiLatencies.push_back(replayGuiQuery(database));
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        stop.store(true);
+        scanner.join();
+        analyzer.join();
+    }
+
+    state.SetLabel(state.range(0) == 0 ? "rollback journal" : "performance profile");
+    state.counters["gui_p50_ms"] = percentile(guiLatencies, 0.5);
+    state.counters["gui_p99_ms"] = percentile(guiLatencies, 0.99);
+    state.counters["analyzer_p50_ms"] = percentile(analyzerLatencies, 0.5);
+    state.counters["analyzer_p99_ms"] = percentile(analyzerLatencies, 0.99);
+    state.counters["scanned_tracks"] = nextTrack;
+}
+BENCHMARK(BM_ConcurrentDbWorkload)->Arg(0)->Arg(1)->Iterations(5)->UseRealTime();
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "library/scanner/directorywatcher.h"
+
+#include "test/mixxxtest.h"
+
+using ::testing::UnorderedElementsAre;
+
+namespace {
+
+class DirectoryWatcherTest : public MixxxTest {
+  protected:
+    DirectoryWatcherTest()
+            : m_rootDir(m_tempDir.path()) {
+        m_rootDir.mkpath("album/cd1");
+        m_rootDir.mkpath("single");
+    }
+
+    QString path(const QString& relativePath) const {
+        return m_rootDir.filePath(relativePath);
+    }
+
+    // Watches all directories like a full scan
+    void synchronize() {
+        m_watcher.reset();
+        m_watcher.watchDirectory(m_rootDir.path());
+        m_watcher.watchDirectory(path("album"));
+        m_watcher.watchDirectory(path("album/cd1"));
+        m_watcher.watchDirectory(path("single"));
+        m_watcher.setSynchronized({m_rootDir.path()});
+    }
+
+    void touch(const QString& relativePath) {
+        QFile file(path(relativePath));
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    }
+
+    QTemporaryDir m_tempDir;
+    QDir m_rootDir;
+    DirectoryWatcher m_watcher;
+};
+
+TEST_F(DirectoryWatcherTest, NotSynchronizedWithoutFullScan) {
+    QSet<QString> dirtyDirs;
+    EXPECT_FALSE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+
+    if (!DirectoryWatcher::isSupported()) {
+        return;
+    }
+    synchronize();
+    EXPECT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_TRUE(dirtyDirs.isEmpty());
+    // Other root directories need a full scan
+    EXPECT_FALSE(m_watcher.takeDirtyDirectories({path("album")}, &dirtyDirs));
+
+    m_watcher.reset();
+    EXPECT_FALSE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+}
+
+TEST_F(DirectoryWatcherTest, RecordsChangedDirectories) {
+    if (!DirectoryWatcher::isSupported()) {
+        return;
+    }
+    synchronize();
+
+    touch("album/cd1/track.mp3");
+    QSet<QString> dirtyDirs;
+    ASSERT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_THAT(dirtyDirs, UnorderedElementsAre(path("album/cd1")));
+
+    // Changes are only reported once
+    dirtyDirs.clear();
+    ASSERT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_TRUE(dirtyDirs.isEmpty());
+
+    // New directories are reported with all their subdirectories, which
+    // are watched from now on
+    m_rootDir.mkpath("compilation/cd1");
+    ASSERT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_THAT(dirtyDirs,
+            UnorderedElementsAre(m_rootDir.path(),
+                    path("compilation"),
+                    path("compilation/cd1")));
+    dirtyDirs.clear();
+    touch("compilation/cd1/track.mp3");
+    ASSERT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_THAT(dirtyDirs, UnorderedElementsAre(path("compilation/cd1")));
+}
+
+TEST_F(DirectoryWatcherTest, RecordsRemovedAndMovedDirectories) {
+    if (!DirectoryWatcher::isSupported()) {
+        return;
+    }
+    synchronize();
+
+    ASSERT_TRUE(QDir(path("single")).removeRecursively());
+    QSet<QString> dirtyDirs;
+    ASSERT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_THAT(dirtyDirs, UnorderedElementsAre(m_rootDir.path(), path("single")));
+
+    dirtyDirs.clear();
+    ASSERT_TRUE(m_rootDir.rename("album", "renamed"));
+    ASSERT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_THAT(dirtyDirs,
+            UnorderedElementsAre(m_rootDir.path(),
+                    path("album"),
+                    path("renamed"),
+                    path("renamed/cd1")));
+
+    // The moved directory is watched with its new path
+    dirtyDirs.clear();
+    touch("renamed/cd1/track.mp3");
+    ASSERT_TRUE(m_watcher.takeDirtyDirectories({m_rootDir.path()}, &dirtyDirs));
+    EXPECT_THAT(dirtyDirs, UnorderedElementsAre(path("renamed/cd1")));
+}
+
+} // namespace
@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "engine/bufferscalers/enginebufferscalerubberband.h"
+#include "engine/bufferscalers/enginebufferscalest.h"
+#include "engine/enginebuffer.h"
+#include "engine/readaheadmanager.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/memory.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+const SINT kBufferFrames = 1024;
+const CSAMPLE kAmplitude = 0.5f;
+
+// Plays an endless stereo sine wave
+class SineReadAheadManager : public ReadAheadManager {
+  public:
+    SineReadAheadManager()
+            : m_frame(0) {
+    }
+
+    SINT getNextSamples(double dRate, CSAMPLE* buffer, SINT requested_samples) override {
+        Q_UNUSED(dRate);
+        for (SINT i = 0; i < requested_samples / 2; ++i) {
+            const CSAMPLE value = kAmplitude *
+                    static_cast<CSAMPLE>(std::sin(2 * M_PI * 440 * m_frame++ / kSampleRate));
+            buffer[2 * i] = value;
+            buffer[2 * i + 1] = value;
+        }
+        return requested_samples;
+    }
+
+  private:
+    SINT m_frame;
+};
+
+std::unique_ptr<EngineBufferScale> makeScaler(
+        EngineBuffer::KeylockEngine engine,
+        ReadAheadManager* pReadAheadManager) {
+    std::unique_ptr<EngineBufferScale> pScaler;
+    if (engine == EngineBuffer::SOUNDTOUCH) {
+        pScaler = std::make_unique<EngineBufferScaleST>(pReadAheadManager);
+    } else {
+        pScaler = std::make_unique<EngineBufferScaleRubberBand>(pReadAheadManager);
+    }
+    pScaler->setSampleRate(mixxx::audio::SampleRate(kSampleRate));
+    return pScaler;
+}
+
+void setTempo(EngineBufferScale* pScaler, double tempo) {
+    // Keylock: the tempo does not affect the pitch
+    double tempoRatio = tempo;
+    double pitchRatio = 1.0;
+    pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+}
+
+CSAMPLE peak(const CSAMPLE* pBuffer, SINT samples) {
+    CSAMPLE result = 0;
+    for (SINT i = 0; i < samples; ++i) {
+        result = math_max(result, std::fabs(pBuffer[i]));
+    }
+    return result;
+}
+
+class EngineBufferScaleKeylockTest
+        : public MixxxTest,
+          public testing::WithParamInterface<EngineBuffer::KeylockEngine> {
+  protected:
+    void SetUp() override {
+        m_pScaler = makeScaler(GetParam(), &m_readAheadManager);
+    }
+
+    SineReadAheadManager m_readAheadManager;
+    std::unique_ptr<EngineBufferScale> m_pScaler;
+};
+
+TEST_P(EngineBufferScaleKeylockTest, FillsEveryBuffer) {
+    mixxx::SampleBuffer output(2 * kBufferFrames);
+    for (double tempo : {1.0, 1.08, 0.92}) {
+        setTempo(m_pScaler.get(), tempo);
+        m_pScaler->clear();
+        for (int i = 0; i < 20; ++i) {
+            const double framesRead = m_pScaler->scaleBuffer(
+                    output.data(), output.size());
+            EXPECT_DOUBLE_EQ(tempo * kBufferFrames, framesRead);
+        }
+        // The sine has reached the output
+        EXPECT_GT(peak(output.data(), output.size()), kAmplitude / 2);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(KeylockEngines,
+        EngineBufferScaleKeylockTest,
+        testing::Values(EngineBuffer::SOUNDTOUCH, EngineBuffer::RUBBERBAND));
+
+// SoundTouch compensates its latency with a fixed seek offset instead of
+// priming, so this only applies to RubberBand
+class EngineBufferScaleRubberBandTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pScaler = makeScaler(EngineBuffer::RUBBERBAND, &m_readAheadManager);
+    }
+
+    SineReadAheadManager m_readAheadManager;
+    std::unique_ptr<EngineBufferScale> m_pScaler;
+};
+
+TEST_F(EngineBufferScaleRubberBandTest, StartsWithoutPrimingLatency) {
+    setTempo(m_pScaler.get(), 1.0);
+    m_pScaler->clear();
+    mixxx::SampleBuffer output(2 * kBufferFrames);
+    m_pScaler->scaleBuffer(output.data(), output.size());
+    // Without priming, the first window would be faded in or silent
+    EXPECT_GT(peak(output.data() + kBufferFrames, kBufferFrames),
+            kAmplitude / 2);
+}
+
+// The arguments are the keylock engine and the tempo in percent. The
+// cpu_per_deck counter is the share of one CPU core that one deck needs
+// for realtime playback.
+static void BM_ScaleKeylock(benchmark::State& state) {
+    const auto engine = static_cast<EngineBuffer::KeylockEngine>(state.range(0));
+    SineReadAheadManager readAheadManager;
+    std::unique_ptr<EngineBufferScale> pScaler =
+            makeScaler(engine, &readAheadManager);
+    setTempo(pScaler.get(), state.range(1) / 100.0);
+    pScaler->clear();
+    mixxx::SampleBuffer output(2 * kBufferFrames);
+
+    while (state.KeepRunning()) {
+        pScaler->scaleBuffer(output.data(), output.size());
+    }
+
+    state.SetLabel(engine == EngineBuffer::SOUNDTOUCH ? "SoundTouch" : "RubberBand");
+    state.counters["cpu_per_deck"] = benchmark::Counter(
+            static_cast<double>(kBufferFrames) / kSampleRate,
+            benchmark::Counter::kIsIterationInvariantRate |
+                    benchmark::Counter::kInvert);
+}
+
+static void KeylockArguments(benchmark::internal::Benchmark* b) {
+    for (int engine : {EngineBuffer::SOUNDTOUCH, EngineBuffer::RUBBERBAND}) {
+        for (int tempo : {100, 108, 92}) {
+            b->Args({engine, tempo});
+        }
+    }
+}
+BENCHMARK(BM_ScaleKeylock)->Apply(KeylockArguments);
+
+}  // namespace
@@ -1,12 +1,41 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
+#include "engine/filters/enginefilterbessel8.h"
 #include "engine/filters/enginefilterbiquad1.h"
+#include "util/sample.h"
 
 namespace {
 
 class EngineFilterBiquadTest : public testing::Test {
 };
 
+// Exposes the coefficients to compare against a scalar reference
+class TestBiquad1Peaking : public EngineFilterBiquad1Peaking {
+  public:
+    TestBiquad1Peaking(int sampleRate, double centerFreq, double Q)
+            : EngineFilterBiquad1Peaking(sampleRate, centerFreq, Q) {
+    }
+    const double* coefs() const {
+        return m_coef;
+    }
+};
+
+// The former per channel implementation of EngineFilterIIR<5, IIR_BP>
+double processSampleReference(const double* coef, double* buf, double val) {
+    double tmp, fir, iir;
+    tmp = buf[0]; buf[0] = buf[1];
+    iir = val * coef[0];
+    iir -= coef[1] * tmp; fir = coef[2] * tmp;
+    iir -= coef[3] * buf[0]; fir += coef[4] * buf[0];
+    fir += coef[5] * iir;
+    buf[1] = iir; val = fir;
+    return val;
+}
+
 TEST_F(EngineFilterBiquadTest, fidlibInputRespectsLocale) {
     char spec[FIDSPEC_LENGTH];
 
@@ -19,4 +48,70 @@ TEST_F(EngineFilterBiquadTest, fidspecLengthIsLongEnough) {
     ASSERT_TRUE(FIDSPEC_LENGTH > strlen("LsBq/1.2200000000/-12.0000000000"));
 }
 
+TEST_F(EngineFilterBiquadTest, stereoProcessingMatchesPerChannelReference) {
+    const int kBufferSize = 1024;
+    TestBiquad1Peaking filter(44100, 1000, 1.75);
+    filter.setFrequencyCorners(44100, 1000, 1.75, 6);
+    filter.assumeSettled();
+
+    double bufLeft[5] = {};
+    double bufRight[5] = {};
+    std::vector<CSAMPLE> input(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+    for (int callback = 0; callback < 4; ++callback) {
+        for (int i = 0; i < kBufferSize; i += 2) {
+            input[i] = std::sin((callback * kBufferSize + i) * 0.01f);
+            input[i + 1] = std::cos((callback * kBufferSize + i) * 0.037f);
+        }
+        filter.process(input.data(), output.data(), kBufferSize);
+        for (int i = 0; i < kBufferSize; i += 2) {
+            // Both channels have to be bit identical
+            const CSAMPLE left = static_cast<CSAMPLE>(processSampleReference(
+                    filter.coefs(), bufLeft, input[i]));
+            const CSAMPLE right = static_cast<CSAMPLE>(processSampleReference(
+                    filter.coefs(), bufRight, input[i + 1]));
+            ASSERT_EQ(left, output[i]);
+            ASSERT_EQ(right, output[i + 1]);
+        }
+    }
+}
+
+template<typename FilterType>
+void runFilterBenchmark(benchmark::State& state, FilterType* pFilter) {
+    const int bufferSize = static_cast<int>(state.range(0));
+    CSAMPLE* pInput = SampleUtil::alloc(bufferSize);
+    CSAMPLE* pOutput = SampleUtil::alloc(bufferSize);
+    for (int i = 0; i < bufferSize; ++i) {
+        pInput[i] = std::sin(i * 0.01f);
+    }
+    pFilter->assumeSettled();
+
+    while (state.KeepRunning()) {
+        pFilter->process(pInput, pOutput, bufferSize);
+    }
+    state.SetItemsProcessed(state.iterations() * bufferSize);
+
+    SampleUtil::free(pInput);
+    SampleUtil::free(pOutput);
+}
+
+static void BM_EngineFilterBiquad1Peaking(benchmark::State& state) {
+    EngineFilterBiquad1Peaking filter(44100, 1000, 1.75);
+    filter.setFrequencyCorners(44100, 1000, 1.75, 6);
+    runFilterBenchmark(state, &filter);
+}
+BENCHMARK(BM_EngineFilterBiquad1Peaking)->Range(64, 4096);
+
+static void BM_EngineFilterBessel8Low(benchmark::State& state) {
+    EngineFilterBessel8Low filter(44100, 246);
+    runFilterBenchmark(state, &filter);
+}
+BENCHMARK(BM_EngineFilterBessel8Low)->Range(64, 4096);
+
+static void BM_EngineFilterBessel8Band(benchmark::State& state) {
+    EngineFilterBessel8Band filter(44100, 246, 2484);
+    runFilterBenchmark(state, &filter);
+}
+BENCHMARK(BM_EngineFilterBessel8Band)->Range(64, 4096);
+
 }
@@ -1,17 +1,24 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <QThread>
 #include <QtDebug>
 
+#include <atomic>
+#include <vector>
+
 #include "control/controlproxy.h"
 #include "engine/channels/enginechannel.h"
+#include "engine/enginechannelprocessorpool.h"
 #include "engine/enginemaster.h"
 #include "test/mixxxtest.h"
 #include "test/signalpathtest.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 #include "util/types.h"
 
+using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::_;
 
@@ -39,6 +46,25 @@ class EngineChannelMock : public EngineChannel {
     MOCK_METHOD1(postProcess, void(const int iBufferSize));
 };
 
+// A channel that claims to be backed by the given EngineBuffer
+class EngineChannelWithBufferMock : public EngineChannelMock {
+  public:
+    EngineChannelWithBufferMock(const QString& group,
+                                ChannelOrientation defaultOrientation,
+                                EngineMaster* pMaster,
+                                EngineBuffer* pBuffer)
+            : EngineChannelMock(group, defaultOrientation, pMaster),
+              m_pBuffer(pBuffer) {
+    }
+
+    EngineBuffer* getEngineBuffer() override {
+        return m_pBuffer;
+    }
+
+  private:
+    EngineBuffer* const m_pBuffer;
+};
+
 class EngineMasterTest : public BaseSignalPathTest {
   protected:
     void assertMasterBufferMatchesGolden(const QString& testName) {
@@ -316,6 +342,104 @@ TEST_F(EngineMasterTest, ThreeChannelOutputWorks) {
     assertHeadphoneBufferMatchesGolden(testName);
 }
 
+TEST_F(EngineMasterTest, ParallelOutputMatchesSerialOutput) {
+    // Channel 1 pretends to be a deck with quantize enabled, i.e. a deck that
+    // reads the state of other decks and must be processed serially before
+    // the independent channels 2 and 3.
+    ControlObject::set(ConfigKey(m_sGroup1, "quantize"), 1.0);
+    EngineChannelMock* pChannel1 = new EngineChannelWithBufferMock(
+            "[Test1]", EngineChannel::CENTER, m_pEngineMaster,
+            m_pChannel1->getEngineBuffer());
+    m_pEngineMaster->addChannel(pChannel1);
+    EngineChannelMock* pChannel2 = new EngineChannelMock(
+            "[Test2]", EngineChannel::CENTER, m_pEngineMaster);
+    m_pEngineMaster->addChannel(pChannel2);
+    EngineChannelMock* pChannel3 = new EngineChannelMock(
+            "[Test3]", EngineChannel::CENTER, m_pEngineMaster);
+    m_pEngineMaster->addChannel(pChannel3);
+
+    const bool hasHelperThreads =
+            EngineChannelProcessorPool::defaultNumHelperThreads() > 0;
+    bool parallel = false;
+    QThread* threads[3];
+    int order[3];
+    std::atomic<int> sequence(0);
+    std::atomic<int> parallelChannelsStarted(0);
+    auto processAs = [&](int channel, CSAMPLE value, bool independent) {
+        return [&, channel, value, independent](CSAMPLE* pInOut, const int iBufferSize) {
+            threads[channel] = QThread::currentThread();
+            order[channel] = sequence++;
+            if (parallel && independent && hasHelperThreads) {
+                // Wait until the other independent channel has been picked up
+                // as well, which forces them onto different threads.
+                ++parallelChannelsStarted;
+                PerformanceTimer timer;
+                timer.start();
+                while (parallelChannelsStarted.load() < 2 &&
+                        timer.elapsed().toIntegerSeconds() < 5) {
+                    QThread::yieldCurrentThread();
+                }
+            }
+            SampleUtil::fill(pInOut, value, iBufferSize);
+        };
+    };
+
+    for (EngineChannelMock* pChannel : {pChannel1, pChannel2, pChannel3}) {
+        EXPECT_CALL(*pChannel, isActive())
+                .WillRepeatedly(Return(true));
+        EXPECT_CALL(*pChannel, isMasterEnabled())
+                .WillRepeatedly(Return(true));
+        EXPECT_CALL(*pChannel, isPflEnabled())
+                .WillRepeatedly(Return(false));
+    }
+    EXPECT_CALL(*pChannel1, process(_, MAX_BUFFER_LEN))
+            .WillRepeatedly(Invoke(processAs(0, 0.1f, false)));
+    EXPECT_CALL(*pChannel2, process(_, MAX_BUFFER_LEN))
+            .WillRepeatedly(Invoke(processAs(1, 0.2f, true)));
+    EXPECT_CALL(*pChannel3, process(_, MAX_BUFFER_LEN))
+            .WillRepeatedly(Invoke(processAs(2, 0.3f, true)));
+
+    // The first callback ramps the channel gains, compare the second one.
+    m_pEngineMaster->process(MAX_BUFFER_LEN);
+    m_pEngineMaster->process(MAX_BUFFER_LEN);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(QThread::currentThread(), threads[i]);
+    }
+    const std::vector<CSAMPLE> serialMaster(
+            m_pEngineMaster->getMasterBuffer(),
+            m_pEngineMaster->getMasterBuffer() + MAX_BUFFER_LEN);
+
+    parallel = true;
+    ControlObject::set(ConfigKey("[Master]", "parallel_channel_processing"), 1.0);
+    sequence = 0;
+    m_pEngineMaster->process(MAX_BUFFER_LEN);
+    const std::vector<CSAMPLE> parallelMaster(
+            m_pEngineMaster->getMasterBuffer(),
+            m_pEngineMaster->getMasterBuffer() + MAX_BUFFER_LEN);
+
+    // Processing channels concurrently must produce exactly the same output
+    // as processing them serially.
+    EXPECT_EQ(serialMaster, parallelMaster);
+
+    // The serial deck runs on the callback thread before the independent
+    // channels are started.
+    EXPECT_EQ(QThread::currentThread(), threads[0]);
+    EXPECT_EQ(0, order[0]);
+    EXPECT_LT(order[0], order[1]);
+    EXPECT_LT(order[0], order[2]);
+    if (hasHelperThreads) {
+        // The callback thread and a helper thread took one channel each
+        EXPECT_EQ(2, parallelChannelsStarted.load());
+        EXPECT_NE(threads[1], threads[2]);
+        EXPECT_TRUE(threads[1] != QThread::currentThread() ||
+                threads[2] != QThread::currentThread());
+    } else {
+        // Without helper threads everything runs on the callback thread
+        EXPECT_EQ(QThread::currentThread(), threads[1]);
+        EXPECT_EQ(QThread::currentThread(), threads[2]);
+    }
+}
+
 TEST_F(EngineMasterTest, ThreeChannelPFLOutputWorks) {
     const QString testName = "ThreeChannelPFLOutputWorks";
 
@@ -392,4 +516,43 @@ TEST_F(EngineMasterTest, ThreeChannelPFLOutputWorks) {
     assertHeadphoneBufferMatchesGolden(testName);
 }
 
+TEST_F(EngineMasterTest, MixingDoesNotModifyChannelBuffer) {
+    EngineChannelMock* pChannel = new EngineChannelMock(
+            "[Test1]", EngineChannel::LEFT, m_pEngineMaster);
+    m_pEngineMaster->addChannel(pChannel);
+
+    CSAMPLE* pChannelBuffer = const_cast<CSAMPLE*>(m_pEngineMaster->getChannelBuffer("[Test1]"));
+    // We assume it uses MAX_BUFFER_LEN. This should probably be fixed.
+    SampleUtil::fill(pChannelBuffer, 0.1f, MAX_BUFFER_LEN);
+
+    // Instruct the mock to claim it is active, master and PFL, so it is
+    // mixed into the headphones and a crossfader bus at the same time.
+    EXPECT_CALL(*pChannel, isActive())
+            .Times(1)
+            .WillOnce(Return(true));
+    EXPECT_CALL(*pChannel, isMasterEnabled())
+            .Times(1)
+            .WillOnce(Return(true));
+    EXPECT_CALL(*pChannel, isPflEnabled())
+            .Times(1)
+            .WillOnce(Return(true));
+
+    // Instruct the mock to just return when process() gets called.
+    EXPECT_CALL(*pChannel, process(_, MAX_BUFFER_LEN))
+            .Times(1)
+            .WillOnce(Return());
+
+    m_pEngineMaster->process(MAX_BUFFER_LEN);
+
+    // Without any effects the channel is mixed directly from its buffer
+    // and the buffer is left untouched.
+    for (int i = 0; i < MAX_BUFFER_LEN; ++i) {
+        EXPECT_FLOAT_EQ(0.1f, pChannelBuffer[i]);
+    }
+    const CSAMPLE* pHeadphoneBuffer = m_pEngineMaster->getHeadphoneBuffer();
+    const CSAMPLE* pLeftBusBuffer = m_pEngineMaster->getOutputBusBuffer(EngineChannel::LEFT);
+    EXPECT_NE(0.0f, pHeadphoneBuffer[MAX_BUFFER_LEN - 1]);
+    EXPECT_NE(0.0f, pLeftBusBuffer[MAX_BUFFER_LEN - 1]);
+}
+
 }  // namespace
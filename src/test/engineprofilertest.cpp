@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "engine/engineprofiler.h"
+
+namespace {
+
+using Stage = EngineProfiler::Stage;
+
+const int kFrames = 1024;
+const int kSampleRate = 44100;
+
+class EngineProfilerTest : public testing::Test {
+  protected:
+    // Runs a callback in which the stage takes the given time. An overrun
+    // callback takes twice as long as its buffer.
+    void runCallback(Stage stage, qint64 nanos, bool overrun = false) {
+        EngineProfiler::beginCallback(kFrames, kSampleRate);
+        const qint64 start = EngineProfiler::now();
+        EngineProfiler::addStageTime(stage, start, start + nanos);
+        if (overrun) {
+            EngineProfiler::addStageTime(Stage::Callback, start,
+                    start + qint64(2) * kFrames * 1000000000 / kSampleRate);
+        }
+        EngineProfiler::endCallback();
+    }
+
+    // Lets the average durations settle on short stages
+    void settle() {
+        for (int i = 0; i < 500; ++i) {
+            runCallback(Stage::Effects, 1000);
+            runCallback(Stage::VuMeters, 1000);
+        }
+    }
+};
+
+TEST_F(EngineProfilerTest, Buckets) {
+    EXPECT_EQ(0, EngineProfiler::bucketForNanos(0));
+    EXPECT_EQ(0, EngineProfiler::bucketForNanos(999));
+    EXPECT_EQ(1, EngineProfiler::bucketForNanos(1000));
+    EXPECT_EQ(1, EngineProfiler::bucketForNanos(2999));
+    EXPECT_EQ(2, EngineProfiler::bucketForNanos(3000));
+    EXPECT_EQ(EngineProfiler::kNumBuckets - 1,
+            EngineProfiler::bucketForNanos(qint64(3600) * 1000000000));
+}
+
+TEST_F(EngineProfilerTest, SumsStagesOfACallback) {
+    quint64 countsBefore[EngineProfiler::kNumBuckets];
+    EngineProfiler::histogram(Stage::Scalers, countsBefore);
+
+    EngineProfiler::beginCallback(kFrames, kSampleRate);
+    const qint64 start = EngineProfiler::now();
+    // E.g. two decks on different threads
+    EngineProfiler::addStageTime(Stage::Scalers, start + 2000, start + 7000);
+    EngineProfiler::addStageTime(Stage::Scalers, start + 1000, start + 6000);
+    EngineProfiler::endCallback();
+
+    const QVector<EngineProfiler::CallbackRecord> records =
+            EngineProfiler::recentCallbacks();
+    ASSERT_FALSE(records.isEmpty());
+    const EngineProfiler::CallbackRecord& record = records.last();
+    EXPECT_EQ(10000, record.stageNanos[static_cast<int>(Stage::Scalers)]);
+    EXPECT_EQ(start + 1000, record.startNanos +
+            record.stageOffsetNanos[static_cast<int>(Stage::Scalers)]);
+    EXPECT_EQ(0, record.stageNanos[static_cast<int>(Stage::Sidechain)]);
+    EXPECT_GT(record.stageNanos[static_cast<int>(Stage::Callback)], 0);
+    EXPECT_EQ(-1, record.xrunStage);
+
+    quint64 countsAfter[EngineProfiler::kNumBuckets];
+    EngineProfiler::histogram(Stage::Scalers, countsAfter);
+    const int bucket = EngineProfiler::bucketForNanos(10000);
+    EXPECT_EQ(countsBefore[bucket] + 1, countsAfter[bucket]);
+}
+
+TEST_F(EngineProfilerTest, BlamesOverrunOnSlowestStage) {
+    settle();
+    const int xrunsBefore = EngineProfiler::xrunCount(Stage::Effects);
+
+    runCallback(Stage::Effects, 10000000, true);
+
+    EXPECT_EQ(xrunsBefore + 1, EngineProfiler::xrunCount(Stage::Effects));
+    EXPECT_EQ(static_cast<int>(Stage::Effects),
+            EngineProfiler::recentCallbacks().last().xrunStage);
+}
+
+TEST_F(EngineProfilerTest, AttributesReportedXrunToPreviousCallback) {
+    settle();
+    const int xrunsBefore = EngineProfiler::xrunCount(Stage::VuMeters);
+
+    runCallback(Stage::VuMeters, 5000000);
+    // The device notices the late callback when it asks for the next one
+    EngineProfiler::reportXrun();
+    runCallback(Stage::Effects, 1000);
+
+    EXPECT_EQ(xrunsBefore + 1, EngineProfiler::xrunCount(Stage::VuMeters));
+    const QVector<EngineProfiler::CallbackRecord> records =
+            EngineProfiler::recentCallbacks();
+    ASSERT_GE(records.size(), 2);
+    EXPECT_EQ(static_cast<int>(Stage::VuMeters),
+            records[records.size() - 2].xrunStage);
+    EXPECT_EQ(-1, records.last().xrunStage);
+}
+
+TEST_F(EngineProfilerTest, WritesChromeTrace) {
+    settle();
+    runCallback(Stage::Effects, 10000000, true);
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString fileName = dir.filePath("trace.json");
+    ASSERT_TRUE(EngineProfiler::writeChromeTrace(fileName));
+
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const QJsonDocument trace = QJsonDocument::fromJson(file.readAll());
+    const QJsonArray events = trace.object().value("traceEvents").toArray();
+    ASSERT_FALSE(events.isEmpty());
+    const QJsonObject lastEvent = events.last().toObject();
+    EXPECT_EQ("xrun", lastEvent.value("name").toString());
+    EXPECT_EQ("Effects",
+            lastEvent.value("args").toObject().value("stage").toString());
+}
+
+} // namespace
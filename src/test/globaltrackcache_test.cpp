@@ -1,7 +1,10 @@
+#include <benchmark/benchmark.h>
+
 #include <QThread>
 #include <QtDebug>
 
 #include <atomic>
+#include <vector>
 
 #include "test/mixxxtest.h"
 
@@ -66,6 +69,48 @@ class TrackTitleThread: public QThread {
     std::atomic<bool> m_stop;
 };
 
+// Looks up tracks without locking the whole cache like the GUI
+class TrackLookupThread: public QThread {
+  public:
+    explicit TrackLookupThread(int numTracks)
+        : m_numTracks(numTracks),
+          m_stop(false),
+          m_hits(0) {
+    }
+
+    void stop() {
+        m_stop.store(true);
+    }
+
+    int hits() const {
+        return m_hits.load();
+    }
+
+    void run() override {
+        int loopCount = 0;
+        while (!m_stop.load()) {
+            const TrackId trackId(loopCount % m_numTracks);
+            const auto track = GlobalTrackCache::lookupTrackById(trackId);
+            if (track) {
+                ASSERT_EQ(trackId, track->getId());
+                // Access the track while the owner might release it
+                track->setComment(QString::number(loopCount));
+                m_hits.fetch_add(1);
+            }
+            ++loopCount;
+        }
+    }
+
+  private:
+    const int m_numTracks;
+    std::atomic<bool> m_stop;
+    std::atomic<int> m_hits;
+};
+
+TrackFile syntheticTrackFile(int index) {
+    return TrackFile(kTestDir, QString("synthetic%1.mp3").arg(index));
+}
+
 void deleteTrack(Track* pTrack) {
     // Delete track objects directly in unit tests with
     // no main event loop
@@ -216,3 +261,146 @@ TEST_F(GlobalTrackCacheTest, evictWhileMoving) {
 
     EXPECT_TRUE(GlobalTrackCacheLocker().isEmpty());
 }
+
+TEST_F(GlobalTrackCacheTest, concurrentLookups) {
+    ASSERT_TRUE(GlobalTrackCacheLocker().isEmpty());
+
+    const int kNumTracks = 64;
+    std::vector<std::unique_ptr<TrackLookupThread>> lookupThreads;
+    for (int i = 0; i < 8; ++i) {
+        lookupThreads.push_back(std::make_unique<TrackLookupThread>(kNumTracks));
+        lookupThreads.back()->start();
+    }
+
+    // Tracks are resolved, released and evicted while the other
+    // threads keep looking them up. Every resolved track must be
+    // unique, i.e. a lookup must never return an evicted track.
+    std::vector<TrackPointer> tracks(kNumTracks);
+    for (int i = 0; i < 100000; ++i) {
+        const int index = (i * 7) % kNumTracks;
+        if (tracks[index]) {
+            tracks[index].reset();
+        } else {
+            const TrackId trackId(index);
+            GlobalTrackCacheResolver resolver(syntheticTrackFile(index), trackId);
+            tracks[index] = resolver.getTrack();
+            ASSERT_TRUE(static_cast<bool>(tracks[index]));
+            EXPECT_EQ(trackId, tracks[index]->getId());
+            EXPECT_EQ(tracks[index], GlobalTrackCache::lookupTrackById(trackId));
+        }
+        if (i % 16 == 0) {
+            // Ensure that track objects are evicted and deleted
+            QCoreApplication::processEvents();
+        }
+    }
+    tracks.clear();
+
+    int hits = 0;
+    for (const auto& pThread : lookupThreads) {
+        pThread->stop();
+        pThread->wait();
+        hits += pThread->hits();
+    }
+    EXPECT_LT(0, hits);
+
+    // Ensure that all track objects have been deleted
+    while (!GlobalTrackCacheLocker().isEmpty()) {
+        QCoreApplication::processEvents();
+    }
+}
+
+namespace {
+
+class NoSaver : public GlobalTrackCacheSaver {
+  private:
+    void saveEvictedTrack(Track* pTrack) noexcept override {
+        Q_UNUSED(pTrack);
+    }
+};
+
+// Keeps the whole cache locked most of the time like the scanner
+// and the analyzers when resolving tracks from multiple threads
+class CacheLockingThread: public QThread {
+  public:
+    CacheLockingThread()
+        : m_stop(false) {
+    }
+
+    void stop() {
+        m_stop.store(true);
+    }
+
+    void run() override {
+        while (!m_stop.load()) {
+            GlobalTrackCacheLocker locker;
+            QThread::usleep(200);
+            locker.unlockCache();
+            QThread::yieldCurrentThread();
+        }
+    }
+
+  private:
+    std::atomic<bool> m_stop;
+};
+
+} // anonymous namespace
+
+// Looks up cached tracks while another thread keeps locking the
+// whole cache. The argument selects lookups with a
+// GlobalTrackCacheLocker (0) or the sharded lookup (1).
+static void BM_LookupTrackWhileCacheIsLocked(benchmark::State& state) {
+    NoSaver saver;
+    GlobalTrackCache::createInstance(&saver, deleteTrack);
+    const int kNumTracks = 1000;
+    std::vector<TrackPointer> tracks;
+    for (int i = 0; i < kNumTracks; ++i) {
+        tracks.push_back(GlobalTrackCacheResolver(
+                syntheticTrackFile(i), TrackId(i)).getTrack());
+    }
+
+    CacheLockingThread lockingThread;
+    lockingThread.start();
+    int index = 0;
+    while (state.KeepRunning()) {
+        const TrackId trackId(index++ % kNumTracks);
+        if (state.range(0) == 0) {
+            benchmark::DoNotOptimize(
+                    GlobalTrackCacheLocker().lookupTrackById(trackId));
+        } else {
+            benchmark::DoNotOptimize(
+                    GlobalTrackCache::lookupTrackById(trackId));
+        }
+    }
+    lockingThread.stop();
+    lockingThread.wait();
+
+    state.SetLabel(state.range(0) == 0 ? "locker" : "sharded");
+    tracks.clear();
+    GlobalTrackCache::destroyInstance();
+}
+BENCHMARK(BM_LookupTrackWhileCacheIsLocked)->Arg(0)->Arg(1)->UseRealTime();
+
+// Looks up cached tracks from multiple threads without contention
+// on the lock of the whole cache
+static void BM_ConcurrentLookupTrackById(benchmark::State& state) {
+    static NoSaver s_saver;
+    static std::vector<TrackPointer> s_tracks;
+    const int kNumTracks = 1000;
+    if (state.thread_index == 0) {
+        GlobalTrackCache::createInstance(&s_saver, deleteTrack);
+        for (int i = 0; i < kNumTracks; ++i) {
+            s_tracks.push_back(GlobalTrackCacheResolver(
+                    syntheticTrackFile(i), TrackId(i)).getTrack());
+        }
+    }
+    int index = state.thread_index;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(
+                GlobalTrackCache::lookupTrackById(TrackId(index++ % kNumTracks)));
+    }
+    if (state.thread_index == 0) {
+        s_tracks.clear();
+        GlobalTrackCache::destroyInstance();
+    }
+}
+BENCHMARK(BM_ConcurrentLookupTrackById)->ThreadRange(1, 8)->UseRealTime();
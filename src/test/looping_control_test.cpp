@@ -10,6 +10,7 @@
 #include "engine/controls/loopingcontrol.h"
 #include "test/mockedenginebackendtest.h"
 #include "util/memory.h"
+#include "util/sample.h"
 
 // Due to rounding errors loop positions should be compared with EXPECT_NEAR instead of EXPECT_EQ.
 // NOTE(uklotzde, 2017-12-10): The rounding errors currently only appeared with GCC 7.2.1.
@@ -835,6 +836,33 @@ TEST_F(LoopingControlTest, Beatjump_MovesActiveLoop) {
     EXPECT_EQ(beatLength * 4, m_pLoopEndPoint->get());
 }
 
+TEST_F(LoopingControlTest, Beatjump_HintsJumpTargets) {
+    m_pTrack1->setBpm(120.0);
+    double beatLength = m_pNextBeat->get();
+    EXPECT_NE(0, beatLength);
+
+    m_pBeatJumpSize->set(4.0);
+    seekToSampleAndProcess(beatLength * 8);
+
+    HintVector hints;
+    m_pChannel1->getEngineBuffer()->m_pLoopingControl->hintReader(&hints);
+    bool forwardHinted = false;
+    bool backwardHinted = false;
+    for (const auto& hint : hints) {
+        if (hint.priority < Hint::kPriorityPrediction) {
+            continue;
+        }
+        if (hint.frame == SampleUtil::floorPlayPosToFrame(beatLength * 12)) {
+            forwardHinted = true;
+        }
+        if (hint.frame == SampleUtil::floorPlayPosToFrame(beatLength * 4)) {
+            backwardHinted = true;
+        }
+    }
+    EXPECT_TRUE(forwardHinted);
+    EXPECT_TRUE(backwardHinted);
+}
+
 TEST_F(LoopingControlTest, Beatjump_MovesLoopBoundaries) {
     // Holding down the loop in/out buttons and using beatjump should
     // move only the loop in/out point, but not shift the entire loop forward/backward
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <sndfile.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "mixer/offlinerenderer.h"
+#include "mixer/renderscript.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+
+namespace {
+
+const int kSampleRate = 44100;
+const float kAmplitude = 0.5f;
+
+class OfflineRendererTest : public MixxxTest {
+  protected:
+    QString filePath(const QString& fileName) const {
+        return QDir(m_dir.path()).filePath(fileName);
+    }
+
+    // Writes a stereo 440 Hz sine wave as a WAV file
+    bool writeSineFile(const QString& fileName, SINT frames) {
+        SF_INFO sfInfo;
+        memset(&sfInfo, 0, sizeof(sfInfo));
+        sfInfo.samplerate = kSampleRate;
+        sfInfo.channels = 2;
+        sfInfo.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        SNDFILE* pFile = sf_open(
+                QFile::encodeName(filePath(fileName)), SFM_WRITE, &sfInfo);
+        if (!pFile) {
+            return false;
+        }
+        std::vector<float> samples(frames * 2);
+        for (SINT i = 0; i < frames; ++i) {
+            const float value = kAmplitude *
+                    static_cast<float>(std::sin(2 * M_PI * 440 * i / kSampleRate));
+            samples[2 * i] = value;
+            samples[2 * i + 1] = value;
+        }
+        const bool success = sf_writef_float(pFile, samples.data(), frames) == frames;
+        sf_close(pFile);
+        return success;
+    }
+
+    bool writeScript(const QString& fileName, const QString& script) {
+        QFile file(filePath(fileName));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            return false;
+        }
+        QTextStream(&file) << script;
+        return true;
+    }
+
+    QTemporaryDir m_dir;
+};
+
+TEST_F(OfflineRendererTest, RendersScript) {
+    ASSERT_TRUE(m_dir.isValid());
+    ASSERT_TRUE(writeSineFile("sine #1.wav", 2 * kSampleRate));
+    // The end time is not a multiple of the buffer size
+    ASSERT_TRUE(writeScript("mix.txt",
+            "samplerate 44100\n"
+            "buffersize 1024\n"
+            "decks 1\n"
+            "0 load [Channel1] \"sine #1.wav\" # the generated file\n"
+            "0 set [Channel1] play 1\n"
+            "1.5 end\n"));
+
+    RenderScript script;
+    ASSERT_TRUE(script.load(filePath("mix.txt")))
+            << script.errorString().toStdString();
+    {
+        OfflineRenderer renderer(config(), script);
+        ASSERT_TRUE(renderer.render(filePath("mix.wav")));
+    }
+
+    SF_INFO sfInfo;
+    memset(&sfInfo, 0, sizeof(sfInfo));
+    SNDFILE* pFile = sf_open(
+            QFile::encodeName(filePath("mix.wav")), SFM_READ, &sfInfo);
+    ASSERT_NE(nullptr, pFile);
+    EXPECT_EQ(kSampleRate, sfInfo.samplerate);
+    EXPECT_EQ(2, sfInfo.channels);
+    const sf_count_t expectedFrames = kSampleRate * 3 / 2;
+    EXPECT_EQ(expectedFrames, sfInfo.frames);
+
+    std::vector<float> samples(sfInfo.frames * sfInfo.channels);
+    EXPECT_EQ(sfInfo.frames, sf_readf_float(pFile, samples.data(), sfInfo.frames));
+    sf_close(pFile);
+
+    // The playing deck reaches the master output
+    float peak = 0.0f;
+    for (float sample : samples) {
+        peak = math_max(peak, std::fabs(sample));
+    }
+    EXPECT_GT(peak, kAmplitude / 4);
+}
+
+} // namespace
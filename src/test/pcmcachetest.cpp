@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "sources/pcmcache.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QDir kTestDir(QDir::current().absoluteFilePath("src/test/id3-test-data"));
+
+const SINT kReadFrameCount = 4096;
+
+class PcmCacheTest : public MixxxTest {
+  protected:
+    PcmCacheTest()
+            : m_filePath(kTestDir.absoluteFilePath("cover-test.flac")),
+              m_url(QUrl::fromLocalFile(m_filePath)),
+              m_openParams(mixxx::audio::ChannelCount(2), mixxx::audio::SampleRate()) {
+    }
+
+    mixxx::PcmCachePointer createCache(qint64 byteBudget) {
+        return std::make_shared<mixxx::PcmCache>(
+                m_tempDir.path(), byteBudget);
+    }
+
+    mixxx::AudioSourcePointer openCachingAudioSource(
+            SoundSourceProxy* pProxy,
+            const mixxx::PcmCachePointer& pCache) {
+        auto pAudioSource = pProxy->openAudioSource(m_openParams);
+        EXPECT_TRUE(pAudioSource);
+        return pCache->createCachingAudioSource(
+                m_url, m_openParams, std::move(pAudioSource));
+    }
+
+    // Reads the given range in chunks and returns all samples
+    static mixxx::SampleBuffer readSampleFrames(
+            const mixxx::AudioSourcePointer& pAudioSource,
+            mixxx::IndexRange frameIndexRange) {
+        const auto& signalInfo = pAudioSource->getSignalInfo();
+        mixxx::SampleBuffer samples(
+                signalInfo.frames2samples(frameIndexRange.length()));
+        SINT sampleOffset = 0;
+        SINT frameIndex = frameIndexRange.start();
+        while (frameIndex < frameIndexRange.end()) {
+            const auto readRange = mixxx::IndexRange::forward(
+                    frameIndex,
+                    math_min(kReadFrameCount, frameIndexRange.end() - frameIndex));
+            const auto readable = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            readRange,
+                            mixxx::SampleBuffer::WritableSlice(
+                                    samples.data(sampleOffset),
+                                    signalInfo.frames2samples(readRange.length()))));
+            EXPECT_EQ(readRange, readable.frameIndexRange());
+            sampleOffset += signalInfo.frames2samples(readRange.length());
+            frameIndex = readRange.end();
+        }
+        return samples;
+    }
+
+    QTemporaryDir m_tempDir;
+    const QString m_filePath;
+    const QUrl m_url;
+    const mixxx::AudioSource::OpenParams m_openParams;
+};
+
+TEST_F(PcmCacheTest, SequentialReadFillsCache) {
+    auto pCache = createCache(256 * 1024 * 1024);
+    EXPECT_FALSE(pCache->openAudioSource(m_url, m_openParams));
+
+    SoundSourceProxy proxy(Track::newTemporary(m_filePath));
+    auto pAudioSource = openCachingAudioSource(&proxy, pCache);
+    const auto frameIndexRange = pAudioSource->frameIndexRange();
+    const auto decodedSamples = readSampleFrames(pAudioSource, frameIndexRange);
+    proxy.closeAudioSource();
+    ASSERT_TRUE(QFile::exists(pCache->cacheFilePath(m_url)));
+
+    auto pCachedAudioSource = pCache->openAudioSource(m_url, m_openParams);
+    ASSERT_TRUE(pCachedAudioSource);
+    EXPECT_EQ(pAudioSource->getSignalInfo(), pCachedAudioSource->getSignalInfo());
+    EXPECT_EQ(frameIndexRange, pCachedAudioSource->frameIndexRange());
+    const auto cachedSamples = readSampleFrames(pCachedAudioSource, frameIndexRange);
+    ASSERT_EQ(decodedSamples.size(), cachedSamples.size());
+    for (SINT i = 0; i < decodedSamples.size(); ++i) {
+        EXPECT_EQ(decodedSamples[i], cachedSamples[i]);
+    }
+
+    // Reading a range in the middle
+    const auto middleRange = mixxx::IndexRange::forward(
+            frameIndexRange.start() + frameIndexRange.length() / 2,
+            kReadFrameCount / 2);
+    const auto middleSamples = readSampleFrames(pCachedAudioSource, middleRange);
+    const SINT middleOffset = pCachedAudioSource->getSignalInfo().frames2samples(
+            middleRange.start() - frameIndexRange.start());
+    for (SINT i = 0; i < middleSamples.size(); ++i) {
+        EXPECT_EQ(decodedSamples[middleOffset + i], middleSamples[i]);
+    }
+}
+
+TEST_F(PcmCacheTest, OnlyReadWriteModeFillsCache) {
+    auto pCache = createCache(256 * 1024 * 1024);
+    SoundSourceProxy::setPcmCache(pCache);
+
+    // Batch analysis
+    {
+        SoundSourceProxy proxy(Track::newTemporary(m_filePath));
+        auto pAudioSource = proxy.openAudioSource(
+                m_openParams, SoundSourceProxy::PcmCacheMode::ReadOnly);
+        ASSERT_TRUE(pAudioSource);
+        readSampleFrames(pAudioSource, pAudioSource->frameIndexRange());
+        proxy.closeAudioSource();
+    }
+    EXPECT_FALSE(QFile::exists(pCache->cacheFilePath(m_url)));
+
+    // Loading into a deck
+    {
+        SoundSourceProxy proxy(Track::newTemporary(m_filePath));
+        auto pAudioSource = proxy.openAudioSource(
+                m_openParams, SoundSourceProxy::PcmCacheMode::ReadWrite);
+        ASSERT_TRUE(pAudioSource);
+        readSampleFrames(pAudioSource, pAudioSource->frameIndexRange());
+        proxy.closeAudioSource();
+    }
+    EXPECT_TRUE(QFile::exists(pCache->cacheFilePath(m_url)));
+
+    SoundSourceProxy::setPcmCache(nullptr);
+}
+
+TEST_F(PcmCacheTest, SeekingDiscardsCacheFile) {
+    auto pCache = createCache(256 * 1024 * 1024);
+
+    SoundSourceProxy proxy(Track::newTemporary(m_filePath));
+    auto pAudioSource = openCachingAudioSource(&proxy, pCache);
+    const auto frameIndexRange = pAudioSource->frameIndexRange();
+    // Skip the first chunk
+    readSampleFrames(pAudioSource,
+            mixxx::IndexRange::between(
+                    frameIndexRange.start() + kReadFrameCount,
+                    frameIndexRange.end()));
+    proxy.closeAudioSource();
+
+    EXPECT_FALSE(QFile::exists(pCache->cacheFilePath(m_url)));
+    EXPECT_FALSE(pCache->openAudioSource(m_url, m_openParams));
+}
+
+TEST_F(PcmCacheTest, ExceedingBudgetSkipsCaching) {
+    auto pCache = createCache(1024);
+
+    SoundSourceProxy proxy(Track::newTemporary(m_filePath));
+    auto pAudioSource = openCachingAudioSource(&proxy, pCache);
+    readSampleFrames(pAudioSource, pAudioSource->frameIndexRange());
+    proxy.closeAudioSource();
+
+    EXPECT_FALSE(QFile::exists(pCache->cacheFilePath(m_url)));
+}
+
+TEST_F(PcmCacheTest, EvictLeastRecentlyUsed) {
+    auto pCache = createCache(256 * 1024 * 1024);
+
+    SoundSourceProxy proxy(Track::newTemporary(m_filePath));
+    auto pAudioSource = openCachingAudioSource(&proxy, pCache);
+    readSampleFrames(pAudioSource, pAudioSource->frameIndexRange());
+    proxy.closeAudioSource();
+    const QString cacheFilePath = pCache->cacheFilePath(m_url);
+    ASSERT_TRUE(QFile::exists(cacheFilePath));
+
+    // Still fits into the budget
+    pCache->evictLeastRecentlyUsed();
+    EXPECT_TRUE(QFile::exists(cacheFilePath));
+
+    auto pSmallCache = createCache(QFileInfo(cacheFilePath).size() - 1);
+    pSmallCache->evictLeastRecentlyUsed();
+    EXPECT_FALSE(QFile::exists(cacheFilePath));
+}
+
+} // namespace
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "util/realtimearena.h"
+
+namespace {
+
+class RealtimeArenaTest : public testing::Test {
+  protected:
+    static const std::size_t kCapacity = 4096;
+};
+
+TEST_F(RealtimeArenaTest, allocationsAreAligned) {
+    RealtimeArena arena(kCapacity);
+    for (std::size_t bytes : {1, 3, 64, 100}) {
+        void* ptr = arena.allocate(bytes);
+        ASSERT_NE(nullptr, ptr);
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(ptr) %
+                RealtimeArena::kAlignment);
+    }
+    void* ptr = arena.allocate(4, 4);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(ptr) % 4);
+}
+
+TEST_F(RealtimeArenaTest, rewindReleasesLaterAllocations) {
+    RealtimeArena arena(kCapacity);
+    arena.allocate(100);
+    const std::size_t mark = arena.mark();
+    void* ptr = arena.allocate(200);
+    arena.allocate(300);
+    arena.rewind(mark);
+    EXPECT_EQ(mark, arena.bytesUsed());
+    // The released memory is handed out again
+    EXPECT_EQ(ptr, arena.allocate(200));
+    EXPECT_LE(600u, arena.highWaterMark());
+}
+
+TEST_F(RealtimeArenaTest, scopeInstallsAndResetsArena) {
+    RealtimeArena outer(kCapacity);
+    RealtimeArena inner(kCapacity);
+    inner.allocate(100);
+    {
+        RealtimeArena::Scope outerScope(&outer);
+        EXPECT_EQ(&outer, RealtimeArena::current());
+        {
+            RealtimeArena::Scope innerScope(&inner);
+            EXPECT_EQ(&inner, RealtimeArena::current());
+            EXPECT_EQ(0u, inner.bytesUsed());
+        }
+        EXPECT_EQ(&outer, RealtimeArena::current());
+    }
+    EXPECT_NE(&outer, RealtimeArena::current());
+}
+
+TEST_F(RealtimeArenaTest, framesRewindCurrentArena) {
+    RealtimeArena arena(kCapacity);
+    RealtimeArena::Scope scope(&arena);
+    {
+        RealtimeArena::Frame outerFrame;
+        CSAMPLE* pOuter = outerFrame.allocateSamples(16);
+        {
+            RealtimeArena::Frame innerFrame;
+            CSAMPLE* pInner = innerFrame.allocateSamples(16);
+            EXPECT_NE(pOuter, pInner);
+        }
+        EXPECT_EQ(16 * sizeof(CSAMPLE), arena.bytesUsed());
+    }
+    EXPECT_EQ(0u, arena.bytesUsed());
+}
+
+} // namespace
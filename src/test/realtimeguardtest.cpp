@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+#include "util/realtimeguard.h"
+
+namespace {
+
+class RealtimeGuardTest : public testing::Test {
+};
+
+TEST_F(RealtimeGuardTest, realtimeScopesNest) {
+    EXPECT_FALSE(RealtimeGuard::isRealtimeThread());
+    {
+        ScopedRealtimeThread outer;
+        {
+            ScopedRealtimeThread inner;
+            EXPECT_TRUE(RealtimeGuard::isRealtimeThread());
+        }
+        EXPECT_TRUE(RealtimeGuard::isRealtimeThread());
+    }
+    EXPECT_FALSE(RealtimeGuard::isRealtimeThread());
+}
+
+TEST_F(RealtimeGuardTest, violationsAreOnlyCountedOnRealtimeThreads) {
+    const int violationCount = RealtimeGuard::violationCount();
+    RealtimeGuard::check(RealtimeGuard::Violation::MutexLock);
+    EXPECT_EQ(violationCount, RealtimeGuard::violationCount());
+
+    ScopedRealtimeThread realtimeThread;
+    RealtimeGuard::check(RealtimeGuard::Violation::MutexLock);
+    EXPECT_EQ(violationCount + 1, RealtimeGuard::violationCount());
+}
+
+TEST_F(RealtimeGuardTest, allocationsAreDetected) {
+    if (!RealtimeGuard::isEnabled()) {
+        return;
+    }
+    const int violationCount = RealtimeGuard::violationCount();
+    {
+        ScopedRealtimeThread realtimeThread;
+        // volatile keeps the compiler from eliding the allocation
+        void* volatile ptr = std::malloc(16);
+        std::free(ptr);
+    }
+    EXPECT_EQ(violationCount + 2, RealtimeGuard::violationCount());
+}
+
+} // namespace
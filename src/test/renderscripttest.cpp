@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+
+#include "mixer/renderscript.h"
+
+namespace {
+
+class RenderScriptTest : public testing::Test {
+  protected:
+    bool parse(const QString& script) {
+        return m_script.parse(script, "/music");
+    }
+
+    RenderScript m_script;
+};
+
+TEST_F(RenderScriptTest, Defaults) {
+    ASSERT_TRUE(parse("10 end"));
+    EXPECT_EQ(RenderScript::kDefaultSampleRate, m_script.sampleRate());
+    EXPECT_EQ(RenderScript::kDefaultBufferSize, m_script.bufferSize());
+    EXPECT_EQ(RenderScript::kDefaultNumDecks, m_script.numDecks());
+    ASSERT_EQ(1, m_script.events().size());
+    EXPECT_DOUBLE_EQ(10.0, m_script.endTime());
+}
+
+TEST_F(RenderScriptTest, ParsesSettingsAndEvents) {
+    ASSERT_TRUE(parse(
+            "# A short mix\n"
+            "samplerate 48000\n"
+            "buffersize 512\n"
+            "decks 4\n"
+            "\n"
+            "0 load [Channel1] A Track.mp3  # with spaces\n"
+            "0.5 set [Channel1] play 1\n"
+            "  30.25   set   [Master]   crossfader   -0.5\n"
+            "60 end\n"))
+            << m_script.errorString().toStdString();
+    EXPECT_EQ(48000, m_script.sampleRate());
+    EXPECT_EQ(512, m_script.bufferSize());
+    EXPECT_EQ(4, m_script.numDecks());
+
+    const QList<RenderScript::Event>& events = m_script.events();
+    ASSERT_EQ(4, events.size());
+    EXPECT_EQ(RenderScript::Event::Type::Load, events[0].type);
+    EXPECT_EQ("[Channel1]", events[0].group);
+    EXPECT_EQ(QDir("/music").absoluteFilePath("A Track.mp3"), events[0].location);
+    EXPECT_EQ(6, events[0].line);
+
+    EXPECT_EQ(RenderScript::Event::Type::Set, events[2].type);
+    EXPECT_DOUBLE_EQ(30.25, events[2].time);
+    EXPECT_EQ("[Master]", events[2].group);
+    EXPECT_EQ("crossfader", events[2].item);
+    EXPECT_DOUBLE_EQ(-0.5, events[2].value);
+
+    EXPECT_EQ(RenderScript::Event::Type::End, events[3].type);
+    EXPECT_DOUBLE_EQ(60.0, m_script.endTime());
+}
+
+TEST_F(RenderScriptTest, QuotesFileNamesWithHashes) {
+    ASSERT_TRUE(parse(
+            "0 load [Channel1] \"Track #1.mp3\"  # comment with \"quotes\"\n"
+            "0 load [Channel2] Track 2.mp3 # comment\n"
+            "1 end\n"))
+            << m_script.errorString().toStdString();
+    const QList<RenderScript::Event>& events = m_script.events();
+    ASSERT_EQ(3, events.size());
+    EXPECT_EQ(QDir("/music").absoluteFilePath("Track #1.mp3"), events[0].location);
+    EXPECT_EQ(QDir("/music").absoluteFilePath("Track 2.mp3"), events[1].location);
+
+    EXPECT_FALSE(parse("0 load [Channel1] \"Track #1.mp3\n1 end\n"));
+    EXPECT_FALSE(parse("0 load [Channel1] \"\"\n1 end\n"));
+}
+
+TEST_F(RenderScriptTest, SortsEventsStably) {
+    ASSERT_TRUE(parse(
+            "2 set [Channel1] play 1\n"
+            "1 set [Channel1] volume 0.5\n"
+            "1 set [Channel1] volume 1\n"
+            "2 end\n"));
+    const QList<RenderScript::Event>& events = m_script.events();
+    ASSERT_EQ(4, events.size());
+    EXPECT_DOUBLE_EQ(0.5, events[0].value);
+    EXPECT_DOUBLE_EQ(1.0, events[1].value);
+    EXPECT_EQ("play", events[2].item);
+    EXPECT_EQ(RenderScript::Event::Type::End, events[3].type);
+}
+
+TEST_F(RenderScriptTest, RejectsMalformedScripts) {
+    EXPECT_FALSE(parse(""));
+    EXPECT_FALSE(parse("0 set [Channel1] play 1\n"));
+    EXPECT_FALSE(parse("0 end\n"));
+    EXPECT_FALSE(parse("5 set [Channel1] play 1\n1 end\n"));
+    EXPECT_FALSE(parse("1 end\n2 set [Channel1] play 1\n"));
+    EXPECT_FALSE(parse("0 set [Channel1] play\n1 end\n"));
+    EXPECT_FALSE(parse("0 set Channel1 play 1\n1 end\n"));
+    EXPECT_FALSE(parse("0 set [Channel1] play on\n1 end\n"));
+    EXPECT_FALSE(parse("-1 set [Channel1] play 1\n1 end\n"));
+    EXPECT_FALSE(parse("0 load [Channel1]\n1 end\n"));
+    EXPECT_FALSE(parse("0 eject [Channel1]\n1 end\n"));
+    EXPECT_FALSE(parse("0 set [Channel1] play 1\nsamplerate 48000\n1 end\n"));
+    EXPECT_FALSE(parse("samplerate 1000000\n1 end\n"));
+    EXPECT_FALSE(parse("buffersize 0\n1 end\n"));
+    EXPECT_FALSE(parse("decks 5\n1 end\n"));
+    EXPECT_TRUE(m_script.events().isEmpty());
+}
+
+TEST_F(RenderScriptTest, ReportsLineOfError) {
+    EXPECT_FALSE(parse("# comment\n\n0 jump [Channel1]\n1 end\n"));
+    EXPECT_TRUE(m_script.errorString().startsWith("Line 3:"))
+            << m_script.errorString().toStdString();
+}
+
+} // namespace
@@ -5,6 +5,10 @@
 #include <QList>
 #include <QPair>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "util/sample.h"
 #include "util/timer.h"
 
@@ -146,6 +150,40 @@ TEST_F(SampleUtilTest, add2WithGain) {
     }
 }
 
+TEST_F(SampleUtilTest, addToBothWithRampingGainMatchesAddWithRampingGain) {
+    for (int i : evenBuffers) {
+        int size = sizes[i];
+        std::vector<CSAMPLE> input(size);
+        for (int j = 0; j < size; ++j) {
+            input[j] = std::sin(j * 0.01f);
+        }
+        std::vector<CSAMPLE> expected1(size, 0.25f);
+        std::vector<CSAMPLE> expected2(size, -0.5f);
+        SampleUtil::addWithRampingGain(expected1.data(), input.data(), 1.0f, 0.3f, size);
+        SampleUtil::addWithRampingGain(expected2.data(), input.data(), 0.5f, 0.5f, size);
+
+        std::vector<CSAMPLE> actual1(size, 0.25f);
+        std::vector<CSAMPLE> actual2(size, -0.5f);
+        SampleUtil::addToBothWithRampingGain(
+                actual1.data(), 1.0f, 0.3f,
+                actual2.data(), 0.5f, 0.5f,
+                input.data(), size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_NEAR(expected1[j], actual1[j], 1e-6f);
+            EXPECT_NEAR(expected2[j], actual2[j], 1e-6f);
+        }
+
+        // A silent destination is left untouched
+        SampleUtil::addToBothWithRampingGain(
+                actual1.data(), 0.0f, 0.0f,
+                actual2.data(), 0.5f, 0.5f,
+                input.data(), size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(expected1[j], actual1[j]);
+        }
+    }
+}
+
 TEST_F(SampleUtilTest, add3WithGain) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -435,6 +473,274 @@ TEST_F(SampleUtilTest, copyReverse) {
     }
 }
 
+TEST_F(SampleUtilTest, downmixStereoToMono) {
+    if (buffers.size() > 1 && sizes[0] > 10 && sizes[1] > 10)  {
+        CSAMPLE* source = buffers[0];
+        CSAMPLE* destination = buffers[1];
+        FillBuffer(destination, 1.0f, 10);
+        for (int i = 0; i < 10; ++i) {
+            source[i] = i * 0.1;
+        }
+
+        SampleUtil::downmixStereoToMono(destination, source, 10);
+
+        EXPECT_FLOAT_EQ(destination[0], 0.05);
+        EXPECT_FLOAT_EQ(destination[1], 0.25);
+        EXPECT_FLOAT_EQ(destination[2], 0.45);
+        EXPECT_FLOAT_EQ(destination[3], 0.65);
+        EXPECT_FLOAT_EQ(destination[4], 0.85);
+        // Only half of the destination is written
+        EXPECT_FLOAT_EQ(destination[5], 1.0);
+    }
+}
+
+TEST_F(SampleUtilTest, simdLevelsMatchBaseline) {
+    const SampleUtil::SimdLevel selectedLevel = SampleUtil::simdLevel();
+    const SampleUtil::SimdLevel levels[] = {
+            SampleUtil::SimdLevel::AVX2,
+            SampleUtil::SimdLevel::AVX512,
+            SampleUtil::SimdLevel::NEON,
+    };
+    for (int i = 0; i < buffers.size(); ++i) {
+        const int size = sizes[i];
+        std::vector<CSAMPLE> input(size);
+        std::vector<CSAMPLE> input2(size);
+        for (int j = 0; j < size; ++j) {
+            // Some samples are outside the valid range
+            input[j] = static_cast<CSAMPLE>(((j * 37) % 301) - 150) / 100.0f;
+            input2[j] = static_cast<CSAMPLE>(((j * 53) % 211) - 105) / 100.0f;
+        }
+
+        // Collects the results of all kernels for the current level
+        auto runKernels = [&]() {
+            std::vector<CSAMPLE> results;
+            std::vector<CSAMPLE> buffer = input;
+            SampleUtil::applyRampingGain(buffer.data(), 0.2f, 0.9f, size);
+            results.insert(results.end(), buffer.begin(), buffer.end());
+            buffer = input;
+            SampleUtil::addWithRampingGain(buffer.data(), input2.data(), 1.0f, 0.3f, size);
+            results.insert(results.end(), buffer.begin(), buffer.end());
+            SampleUtil::copyWithRampingGain(buffer.data(), input2.data(), 0.0f, 1.0f, size);
+            results.insert(results.end(), buffer.begin(), buffer.end());
+            std::vector<CSAMPLE> buffer2 = input2;
+            SampleUtil::addToBothWithRampingGain(
+                    buffer.data(), 0.7f, 0.1f,
+                    buffer2.data(), 0.2f, 1.0f,
+                    input.data(), size);
+            results.insert(results.end(), buffer.begin(), buffer.end());
+            results.insert(results.end(), buffer2.begin(), buffer2.end());
+            SampleUtil::copyClampBuffer(buffer.data(), input.data(), size);
+            results.insert(results.end(), buffer.begin(), buffer.end());
+            std::vector<CSAMPLE> interleaved(size * 2);
+            SampleUtil::interleaveBuffer(interleaved.data(), input.data(), input2.data(), size);
+            results.insert(results.end(), interleaved.begin(), interleaved.end());
+            std::vector<CSAMPLE> left(size);
+            std::vector<CSAMPLE> right(size);
+            SampleUtil::deinterleaveBuffer(left.data(), right.data(), input.data(), size / 2);
+            results.insert(results.end(), left.begin(), left.end());
+            results.insert(results.end(), right.begin(), right.end());
+            CSAMPLE absL;
+            CSAMPLE absR;
+            SampleUtil::CLIP_STATUS clipping =
+                    SampleUtil::sumAbsPerChannel(&absL, &absR, input.data(), size);
+            results.push_back(absL);
+            results.push_back(absR);
+            results.push_back(static_cast<CSAMPLE>(static_cast<int>(clipping)));
+            return results;
+        };
+
+        ASSERT_TRUE(SampleUtil::setSimdLevel(SampleUtil::SimdLevel::Baseline));
+        const std::vector<CSAMPLE> expected = runKernels();
+        for (const auto level : levels) {
+            if (!SampleUtil::setSimdLevel(level)) {
+                continue;
+            }
+            const std::vector<CSAMPLE> actual = runKernels();
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t j = 0; j < expected.size(); ++j) {
+                // Sums are accumulated in a different order
+                EXPECT_NEAR(expected[j], actual[j], 1e-4 * std::max(1.0f, std::fabs(expected[j])))
+                        << "level " << static_cast<int>(level) << " size " << size << " index " << j;
+            }
+        }
+    }
+    SampleUtil::setSimdLevel(selectedLevel);
+}
+
+// Selects the SIMD level given as the second argument for the duration of a
+// benchmark and skips it if the level is not supported.
+class ScopedSimdLevel {
+  public:
+    explicit ScopedSimdLevel(benchmark::State& state)
+            : m_selectedLevel(SampleUtil::simdLevel()) {
+        const auto level = static_cast<SampleUtil::SimdLevel>(state.range(1));
+        if (!SampleUtil::setSimdLevel(level)) {
+            state.SkipWithError("SIMD level not supported");
+        }
+    }
+    ~ScopedSimdLevel() {
+        SampleUtil::setSimdLevel(m_selectedLevel);
+    }
+
+  private:
+    const SampleUtil::SimdLevel m_selectedLevel;
+};
+
+static void SimdLevelArguments(benchmark::internal::Benchmark* b) {
+    for (int level = static_cast<int>(SampleUtil::SimdLevel::Baseline);
+            level <= static_cast<int>(SampleUtil::SimdLevel::NEON);
+            ++level) {
+        for (int size = 64; size <= 4096; size *= 8) {
+            b->Args({size, level});
+        }
+    }
+}
+
+static void BM_ApplyRampingGain(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::applyRampingGain(buffer, 1.0f, 0.999f, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_ApplyRampingGain)->Apply(SimdLevelArguments);
+
+static void BM_AddWithRampingGain(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addWithRampingGain(buffer, buffer2, 0.1f, 0.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_AddWithRampingGain)->Apply(SimdLevelArguments);
+
+static void BM_AddToBothWithRampingGain(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addToBothWithRampingGain(
+                buffer, 0.1f, 0.2f,
+                buffer2, 0.3f, 0.4f,
+                buffer3, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_AddToBothWithRampingGain)->Apply(SimdLevelArguments);
+
+static void BM_CopyWithRampingGain(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyWithRampingGain(buffer, buffer2, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_CopyWithRampingGain)->Apply(SimdLevelArguments);
+
+static void BM_SumAbsPerChannel(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    CSAMPLE absL;
+    CSAMPLE absR;
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(
+                SampleUtil::sumAbsPerChannel(&absL, &absR, buffer, size));
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_SumAbsPerChannel)->Apply(SimdLevelArguments);
+
+static void BM_CopyClampBuffer(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 1.5f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyClampBuffer(buffer, buffer2, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_CopyClampBuffer)->Apply(SimdLevelArguments);
+
+static void BM_InterleaveBuffer(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer2, 0.5f, size / 2);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer3, -0.5f, size / 2);
+
+    while (state.KeepRunning()) {
+        SampleUtil::interleaveBuffer(buffer, buffer2, buffer3, size / 2);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_InterleaveBuffer)->Apply(SimdLevelArguments);
+
+static void BM_DeinterleaveBuffer(benchmark::State& state) {
+    ScopedSimdLevel simdLevel(state);
+    size_t size = state.range(0);
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.5f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer2, 0.0f, size / 2);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer3, 0.0f, size / 2);
+
+    while (state.KeepRunning()) {
+        SampleUtil::deinterleaveBuffer(buffer2, buffer3, buffer, size / 2);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK(BM_DeinterleaveBuffer)->Apply(SimdLevelArguments);
+
 static void BM_MemCpy(benchmark::State& state) {
     size_t size = state.range(0);
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -145,3 +145,13 @@ TEST_F(SchemaManagerTest, UpgradeFailed) {
             MixxxDb::kDefaultSchemaFile, MixxxDb::kRequiredSchemaVersion);
     EXPECT_EQ(SchemaManager::Result::UpgradeFailed, result);
 }
+
+TEST_F(SchemaManagerTest, ChecksPerformanceProfile) {
+    SchemaManager schemaManager(dbConnection());
+    EXPECT_TRUE(schemaManager.checkPerformanceProfile(
+            mixxx::DbConnection::PerformanceProfile()));
+
+    mixxx::DbConnection::PerformanceProfile fullSyncProfile;
+    fullSyncProfile.synchronous = 2;
+    EXPECT_FALSE(schemaManager.checkPerformanceProfile(fullSyncProfile));
+}
@@ -0,0 +1,284 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include <algorithm>
+
+#include "library/columnartrackindex.h"
+#include "library/searchquery.h"
+#include "test/mixxxtest.h"
+#include "util/db/dbconnection.h"
+#include "util/db/sqltransaction.h"
+
+namespace {
+
+const QStringList kColumnNames = {
+        "id", "artist", "album_artist", "title", "year", "bpm", "key_id"};
+const QStringList kTextColumns = {"artist", "album_artist", "title"};
+
+std::vector<int> tracksOf(const ColumnarTrackIndex& index, const QueryNode& node) {
+    QueryNode::IndexRows rows;
+    EXPECT_TRUE(node.search(index, &rows));
+    std::vector<int> result;
+    for (int id = 0; id < 1000; ++id) {
+        const int row = index.row(TrackId(id));
+        if (row >= 0 && (rows.neutral || rows.matching.testBit(row))) {
+            result.push_back(id);
+        }
+    }
+    return result;
+}
+
+std::unique_ptr<QueryNode> textFilter(const QStringList& columns, const QString& argument) {
+    return std::make_unique<TextFilterNode>(QSqlDatabase(), columns, argument);
+}
+
+class SearchQueryIndexTest : public MixxxTest {
+  protected:
+    SearchQueryIndexTest()
+            : m_index(kColumnNames) {
+        addTrack(1, "Daft Punk", QVariant(QVariant::String), "One More Time", "2000", 123.0, 1);
+        addTrack(2, "Röyksopp", "Röyksopp", "Eple", "2001", 99.5, 4);
+        addTrack(3, QVariant(QVariant::String), "Various", "Punk Intro", "1999", QVariant(), 1);
+        addTrack(4, "Punks", "", "Time", "", 140.0, 0);
+    }
+
+    void addTrack(int id,
+            const QVariant& artist,
+            const QVariant& albumArtist,
+            const QVariant& title,
+            const QVariant& year,
+            const QVariant& bpm,
+            int keyId) {
+        const int row = m_index.insertRow(TrackId(id));
+        m_index.setValue(row, 0, id);
+        m_index.setValue(row, 1, artist);
+        m_index.setValue(row, 2, albumArtist);
+        m_index.setValue(row, 3, title);
+        m_index.setValue(row, 4, year);
+        m_index.setValue(row, 5, bpm);
+        m_index.setValue(row, 6, keyId);
+    }
+
+    ColumnarTrackIndex m_index;
+};
+
+TEST_F(SearchQueryIndexTest, TextFilter) {
+    EXPECT_EQ(std::vector<int>({1, 3, 4}),
+            tracksOf(m_index, *textFilter(kTextColumns, "PUNK")));
+    EXPECT_EQ(std::vector<int>({2}),
+            tracksOf(m_index, *textFilter({"album_artist"}, "roy")));
+    EXPECT_EQ(std::vector<int>({1}),
+            tracksOf(m_index, *textFilter(kTextColumns, "one more")));
+    // Numbers are searched as text
+    EXPECT_EQ(std::vector<int>({2}),
+            tracksOf(m_index, *textFilter({"bpm"}, "99.5")));
+
+    QueryNode::IndexRows rows;
+    // LIKE wildcards and unknown columns require SQL
+    EXPECT_FALSE(textFilter(kTextColumns, "p%k")->search(m_index, &rows));
+    EXPECT_FALSE(textFilter({"comment"}, "punk")->search(m_index, &rows));
+}
+
+TEST_F(SearchQueryIndexTest, NotExcludesNull) {
+    // NOT (artist LIKE '%punk%') is NULL for a NULL artist
+    NotNode notNode(textFilter({"artist"}, "punk"));
+    EXPECT_EQ(std::vector<int>({2}), tracksOf(m_index, notNode));
+
+    // An OR is TRUE if any column matches
+    OrNode orNode;
+    orNode.addNode(textFilter({"artist"}, "punk"));
+    orNode.addNode(textFilter({"title"}, "intro"));
+    EXPECT_EQ(std::vector<int>({1, 3, 4}), tracksOf(m_index, orNode));
+
+    NullOrEmptyTextFilterNode nullOrEmpty(QSqlDatabase(), {"album_artist"});
+    EXPECT_EQ(std::vector<int>({1, 4}), tracksOf(m_index, nullOrEmpty));
+}
+
+TEST_F(SearchQueryIndexTest, NumericFilter) {
+    EXPECT_EQ(std::vector<int>({1, 4}),
+            tracksOf(m_index, NumericFilterNode({"bpm"}, ">120")));
+    EXPECT_EQ(std::vector<int>({1, 2}),
+            tracksOf(m_index, NumericFilterNode({"bpm"}, "99-123")));
+    EXPECT_EQ(std::vector<int>({3}),
+            tracksOf(m_index, NumericFilterNode({"bpm"}, kMissingFieldSearchTerm)));
+    EXPECT_EQ(std::vector<int>({3}),
+            tracksOf(m_index, NullNumericFilterNode({"bpm"})));
+    // The text of the year is compared with the text of the number
+    EXPECT_EQ(std::vector<int>({1, 2}),
+            tracksOf(m_index, NumericFilterNode({"year"}, ">1999")));
+    EXPECT_EQ(std::vector<int>({1}),
+            tracksOf(m_index, NumericFilterNode({"year"}, "2000")));
+}
+
+TEST_F(SearchQueryIndexTest, KeyFilter) {
+    EXPECT_EQ(std::vector<int>({1, 3}),
+            tracksOf(m_index,
+                    KeyFilterNode(mixxx::track::io::key::C_MAJOR, false)));
+}
+
+TEST_F(SearchQueryIndexTest, NeutralNodes) {
+    // Neither an unparsable number nor an empty AND restrict the result
+    AndNode andNode;
+    andNode.addNode(std::make_unique<NumericFilterNode>(QStringList{"bpm"}, "fast"));
+    andNode.addNode(std::make_unique<AndNode>());
+    QueryNode::IndexRows rows;
+    ASSERT_TRUE(andNode.search(m_index, &rows));
+    EXPECT_TRUE(rows.neutral);
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), tracksOf(m_index, andNode));
+
+    andNode.addNode(textFilter({"title"}, "time"));
+    EXPECT_EQ(std::vector<int>({1, 4}), tracksOf(m_index, andNode));
+
+    andNode.addNode(std::make_unique<SqlNode>("id > 1"));
+    EXPECT_FALSE(andNode.search(m_index, &rows));
+}
+
+// A synthetic library in an in-memory SQLite database and in an index
+class SyntheticLibrary {
+  public:
+    explicit SyntheticLibrary(int numTracks)
+            : m_connection(connectionParams(), "SyntheticLibrary"),
+              m_index(QStringList{"id", "artist", "title", "album", "year", "bpm"}) {
+        VERIFY_OR_DEBUG_ASSERT(m_connection.open()) {
+            return;
+        }
+        QSqlQuery(m_connection).exec(
+                "CREATE TABLE library (id INTEGER PRIMARY KEY, artist TEXT, "
+                "title TEXT, album TEXT, year TEXT, bpm REAL)");
+        SqlTransaction transaction(m_connection);
+        QSqlQuery insert(m_connection);
+        insert.prepare("INSERT INTO library VALUES (?, ?, ?, ?, ?, ?)");
+        for (int id = 1; id <= numTracks; ++id) {
+            const QVariantList values = {
+                    id,
+                    id % 50 == 0
+                            ? QVariant(QVariant::String)
+                            : QVariant(word(id * 7919 % (numTracks / 10 + 1)) +
+                                      " " + word(id % 97).toUpper()),
+                    word(id * 31 % 5003) + " " + word(id * 17 % 3001) +
+                            " (" + word(id % 13) + " Mix)",
+                    word(id / 12),
+                    QString::number(1970 + id % 50),
+                    80.0 + (id % 160) / 2.0};
+            const int row = m_index.insertRow(TrackId(id));
+            for (int column = 0; column < values.size(); ++column) {
+                insert.addBindValue(values[column]);
+                m_index.setValue(row, column, values[column]);
+            }
+            insert.exec();
+        }
+        transaction.commit();
+    }
+
+    const ColumnarTrackIndex& index() const {
+        return m_index;
+    }
+
+    std::vector<int> selectTracks(const QueryNode& node) const {
+        QSqlQuery query(m_connection);
+        query.setForwardOnly(true);
+        query.exec("SELECT id FROM library WHERE " + node.toSql());
+        std::vector<int> result;
+        while (query.next()) {
+            result.push_back(query.value(0).toInt());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<int> searchTracks(const QueryNode& node) const {
+        QueryNode::IndexRows rows;
+        node.search(m_index, &rows);
+        std::vector<int> result;
+        for (int row = 0; row < rows.matching.size(); ++row) {
+            if (rows.matching.testBit(row)) {
+                // The rows follow the ids
+                result.push_back(row + 1);
+            }
+        }
+        return result;
+    }
+
+  private:
+    static mixxx::DbConnection::Params connectionParams() {
+        mixxx::DbConnection::Params params;
+        params.type = "QSQLITE";
+        params.filePath = ":memory:";
+        return params;
+    }
+
+    static QString word(int n) {
+        static const QStringList kSyllables = {
+                "ka", "lo", "mi", "ne", "ru", "sa", "to", "vi", "zu", "bel", "dor", "fän"};
+        QString result;
+        do {
+            result += kSyllables[n % kSyllables.size()];
+            n /= kSyllables.size();
+        } while (n > 0);
+        return result;
+    }
+
+    mixxx::DbConnection m_connection;
+    ColumnarTrackIndex m_index;
+};
+
+const QStringList kSyntheticTextColumns = {"artist", "title", "album"};
+
+// What the search box produces for "bel fan"
+std::unique_ptr<QueryNode> typedQuery() {
+    auto pQuery = std::make_unique<AndNode>();
+    pQuery->addNode(textFilter(kSyntheticTextColumns, "bel"));
+    pQuery->addNode(textFilter(kSyntheticTextColumns, "fan"));
+    return pQuery;
+}
+
+TEST_F(SearchQueryIndexTest, MatchesSql) {
+    SyntheticLibrary library(5000);
+    std::vector<std::unique_ptr<QueryNode>> nodes;
+    nodes.push_back(typedQuery());
+    nodes.push_back(textFilter(kSyntheticTextColumns, "o m"));
+    nodes.push_back(textFilter(kSyntheticTextColumns, "z"));
+    nodes.push_back(textFilter(kSyntheticTextColumns, "ix)"));
+    nodes.push_back(std::make_unique<NotNode>(textFilter({"artist"}, "ka")));
+    nodes.push_back(std::make_unique<NumericFilterNode>(QStringList{"year"}, "1990-1999"));
+    nodes.push_back(std::make_unique<NumericFilterNode>(QStringList{"bpm"}, "<100.5"));
+    nodes.push_back(std::make_unique<NumericFilterNode>(
+            QStringList{"artist"}, kMissingFieldSearchTerm));
+    for (const auto& pNode : nodes) {
+        const std::vector<int> selected = library.selectTracks(*pNode);
+        EXPECT_FALSE(selected.empty()) << pNode->toSql().toStdString();
+        EXPECT_EQ(selected, library.searchTracks(*pNode)) << pNode->toSql().toStdString();
+    }
+}
+
+static void BM_SearchTracksInIndex(benchmark::State& state) {
+    const int numTracks = state.range(0);
+    SyntheticLibrary library(numTracks);
+    const auto pQuery = typedQuery();
+    // The first search of a column builds its token index
+    library.searchTracks(*pQuery);
+
+    while (state.KeepRunning()) {
+        QueryNode::IndexRows rows;
+        pQuery->search(library.index(), &rows);
+        benchmark::DoNotOptimize(rows);
+    }
+    state.SetItemsProcessed(state.iterations() * numTracks);
+}
+BENCHMARK(BM_SearchTracksInIndex)->Range(1000, 256000)->Unit(benchmark::kMillisecond);
+
+static void BM_SearchTracksInDatabase(benchmark::State& state) {
+    const int numTracks = state.range(0);
+    SyntheticLibrary library(numTracks);
+    const auto pQuery = typedQuery();
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(library.selectTracks(*pQuery));
+    }
+    state.SetItemsProcessed(state.iterations() * numTracks);
+}
+BENCHMARK(BM_SearchTracksInDatabase)->Range(1000, 256000)->Unit(benchmark::kMillisecond);
+
+} // namespace
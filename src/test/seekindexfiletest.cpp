@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "sources/seekindexfile.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QDir kTestDir(QDir::current().absoluteFilePath("src/test/id3-test-data"));
+
+class SeekIndexFileTest : public MixxxTest {
+  protected:
+    SeekIndexFileTest()
+            : m_audioFilePath(QDir(m_tempDir.path()).filePath("track.mp3")) {
+        mixxx::SeekIndexFile::setDirPath(
+                QDir(m_tempDir.path()).filePath("seekindex"));
+        QFile::copy(kTestDir.absoluteFilePath("cover-test-vbr.mp3"),
+                m_audioFilePath);
+    }
+    ~SeekIndexFileTest() override {
+        mixxx::SeekIndexFile::setDirPath(QString());
+    }
+
+    static mixxx::SeekIndex createSeekIndex() {
+        mixxx::SeekIndex seekIndex;
+        seekIndex.channelCount = 2;
+        seekIndex.sampleRate = 44100;
+        seekIndex.bitrate = 192;
+        seekIndex.frameLength = 5 * 1152;
+        seekIndex.seekFrameInterval = 2;
+        seekIndex.seekFrames.push_back({0, 417});
+        seekIndex.seekFrames.push_back({2 * 1152, 1253});
+        seekIndex.seekFrames.push_back({4 * 1152, 2089});
+        return seekIndex;
+    }
+
+    QTemporaryDir m_tempDir;
+    const QString m_audioFilePath;
+};
+
+TEST_F(SeekIndexFileTest, SaveAndLoad) {
+    const mixxx::SeekIndex seekIndex = createSeekIndex();
+    ASSERT_TRUE(mixxx::SeekIndexFile::save(m_audioFilePath, seekIndex));
+
+    mixxx::SeekIndex loadedSeekIndex;
+    ASSERT_TRUE(mixxx::SeekIndexFile::load(m_audioFilePath, &loadedSeekIndex));
+    EXPECT_EQ(seekIndex.channelCount, loadedSeekIndex.channelCount);
+    EXPECT_EQ(seekIndex.sampleRate, loadedSeekIndex.sampleRate);
+    EXPECT_EQ(seekIndex.bitrate, loadedSeekIndex.bitrate);
+    EXPECT_EQ(seekIndex.frameLength, loadedSeekIndex.frameLength);
+    EXPECT_EQ(seekIndex.seekFrameInterval, loadedSeekIndex.seekFrameInterval);
+    ASSERT_EQ(seekIndex.seekFrames.size(), loadedSeekIndex.seekFrames.size());
+    for (std::size_t i = 0; i < seekIndex.seekFrames.size(); ++i) {
+        EXPECT_EQ(seekIndex.seekFrames[i].frameIndex,
+                loadedSeekIndex.seekFrames[i].frameIndex);
+        EXPECT_EQ(seekIndex.seekFrames[i].byteOffset,
+                loadedSeekIndex.seekFrames[i].byteOffset);
+    }
+}
+
+TEST_F(SeekIndexFileTest, SaveAndLoadFramesAtSamePosition) {
+    mixxx::SeekIndex seekIndex = createSeekIndex();
+    seekIndex.seekFrames.push_back(seekIndex.seekFrames.back());
+    ASSERT_TRUE(mixxx::SeekIndexFile::save(m_audioFilePath, seekIndex));
+
+    mixxx::SeekIndex loadedSeekIndex;
+    ASSERT_TRUE(mixxx::SeekIndexFile::load(m_audioFilePath, &loadedSeekIndex));
+    ASSERT_EQ(seekIndex.seekFrames.size(), loadedSeekIndex.seekFrames.size());
+    EXPECT_EQ(seekIndex.seekFrames.back().frameIndex,
+            loadedSeekIndex.seekFrames.back().frameIndex);
+    EXPECT_EQ(seekIndex.seekFrames.back().byteOffset,
+            loadedSeekIndex.seekFrames.back().byteOffset);
+}
+
+TEST_F(SeekIndexFileTest, ModifiedAudioFileInvalidatesIndex) {
+    ASSERT_TRUE(mixxx::SeekIndexFile::save(m_audioFilePath, createSeekIndex()));
+
+    QFile audioFile(m_audioFilePath);
+    ASSERT_TRUE(audioFile.open(QIODevice::Append));
+    audioFile.write(QByteArray(16, '\0'));
+    audioFile.close();
+
+    mixxx::SeekIndex loadedSeekIndex;
+    EXPECT_FALSE(mixxx::SeekIndexFile::load(m_audioFilePath, &loadedSeekIndex));
+    EXPECT_FALSE(QFile::exists(mixxx::SeekIndexFile::filePath(m_audioFilePath)));
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+TEST_F(SeekIndexFileTest, EvictLeastRecentlyUsed) {
+    const QString otherAudioFilePath =
+            QDir(m_tempDir.path()).filePath("other.mp3");
+    ASSERT_TRUE(QFile::copy(m_audioFilePath, otherAudioFilePath));
+    ASSERT_TRUE(mixxx::SeekIndexFile::save(m_audioFilePath, createSeekIndex()));
+    const QString indexFilePath = mixxx::SeekIndexFile::filePath(m_audioFilePath);
+    const qint64 indexFileSize = QFileInfo(indexFilePath).size();
+
+    // Room for one file
+    mixxx::SeekIndexFile::setDirPath(
+            QDir(m_tempDir.path()).filePath("seekindex"),
+            indexFileSize);
+    // Ensure that the files are ordered by their modification time
+    QFile indexFile(indexFilePath);
+    ASSERT_TRUE(indexFile.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(indexFile.setFileTime(
+            QDateTime::currentDateTime().addSecs(-60),
+            QFileDevice::FileModificationTime));
+    indexFile.close();
+    ASSERT_TRUE(mixxx::SeekIndexFile::save(otherAudioFilePath, createSeekIndex()));
+
+    mixxx::SeekIndexFile::evictLeastRecentlyUsed();
+    EXPECT_FALSE(QFile::exists(indexFilePath));
+    EXPECT_TRUE(QFile::exists(mixxx::SeekIndexFile::filePath(otherAudioFilePath)));
+}
+#endif
+
+TEST_F(SeekIndexFileTest, DisabledWithoutDirectory) {
+    mixxx::SeekIndexFile::setDirPath(QString());
+    EXPECT_FALSE(mixxx::SeekIndexFile::save(m_audioFilePath, createSeekIndex()));
+    mixxx::SeekIndex loadedSeekIndex;
+    EXPECT_FALSE(mixxx::SeekIndexFile::load(m_audioFilePath, &loadedSeekIndex));
+}
+
+#ifdef __MAD__
+TEST_F(SeekIndexFileTest, Mp3DecodingWithSeekIndex) {
+    const mixxx::AudioSource::OpenParams openParams;
+    // The first open scans the file and saves the index
+    SoundSourceProxy scanningProxy(Track::newTemporary(m_audioFilePath));
+    auto pScannedAudioSource = scanningProxy.openAudioSource(openParams);
+    ASSERT_TRUE(pScannedAudioSource);
+    if (!QFile::exists(mixxx::SeekIndexFile::filePath(m_audioFilePath))) {
+        // Decoded by a different SoundSource
+        return;
+    }
+
+    SoundSourceProxy indexedProxy(Track::newTemporary(m_audioFilePath));
+    auto pIndexedAudioSource = indexedProxy.openAudioSource(openParams);
+    ASSERT_TRUE(pIndexedAudioSource);
+    EXPECT_EQ(pScannedAudioSource->getSignalInfo(),
+            pIndexedAudioSource->getSignalInfo());
+    EXPECT_EQ(pScannedAudioSource->getBitrate(),
+            pIndexedAudioSource->getBitrate());
+    EXPECT_EQ(pScannedAudioSource->frameIndexRange(),
+            pIndexedAudioSource->frameIndexRange());
+
+    // Seek into the middle of the stream
+    const auto readRange = mixxx::IndexRange::forward(
+            pScannedAudioSource->frameIndexMin() +
+                    pScannedAudioSource->frameLength() / 2,
+            1024);
+    const SINT sampleCount =
+            pScannedAudioSource->getSignalInfo().frames2samples(readRange.length());
+    mixxx::SampleBuffer scannedSamples(sampleCount);
+    mixxx::SampleBuffer indexedSamples(sampleCount);
+    EXPECT_EQ(readRange,
+            pScannedAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(readRange,
+                            mixxx::SampleBuffer::WritableSlice(scannedSamples)))
+                    .frameIndexRange());
+    EXPECT_EQ(readRange,
+            pIndexedAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(readRange,
+                            mixxx::SampleBuffer::WritableSlice(indexedSamples)))
+                    .frameIndexRange());
+    for (SINT i = 0; i < sampleCount; ++i) {
+        EXPECT_EQ(scannedSamples[i], indexedSamples[i]);
+    }
+}
+#endif
+
+} // namespace
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "analyzer/trackanalysisscheduler.h"
+#include "control/controlpotmeter.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class TrackAnalysisSchedulerTest : public MixxxTest {
+};
+
+TEST_F(TrackAnalysisSchedulerTest, BackgroundWorkerLimit) {
+    // All workers are active while the audio engine is idle or
+    // moderately busy
+    EXPECT_EQ(8, TrackAnalysisScheduler::backgroundWorkerLimit(8, 0.0));
+    EXPECT_EQ(8, TrackAnalysisScheduler::backgroundWorkerLimit(8, 0.125));
+
+    // Decreasing linearly with the load of the audio engine
+    EXPECT_EQ(4, TrackAnalysisScheduler::backgroundWorkerLimit(8, 0.1875));
+    EXPECT_GT(TrackAnalysisScheduler::backgroundWorkerLimit(8, 0.15),
+            TrackAnalysisScheduler::backgroundWorkerLimit(8, 0.2));
+
+    // A single worker keeps going even if the audio engine is overloaded
+    EXPECT_EQ(1, TrackAnalysisScheduler::backgroundWorkerLimit(8, 0.25));
+    EXPECT_EQ(1, TrackAnalysisScheduler::backgroundWorkerLimit(8, 1.5));
+    EXPECT_EQ(1, TrackAnalysisScheduler::backgroundWorkerLimit(1, 0.2));
+}
+
+TEST_F(TrackAnalysisSchedulerTest, BackgroundWorkerLimitFollowsAudioLatencyUsage) {
+    // Same range as in EngineMaster
+    ControlPotmeter audioLatencyUsage(
+            ConfigKey("[Master]", "audio_latency_usage"), 0.0, 0.25);
+    // Updated by the sound device, read by the scheduler
+    ControlProxy soundDeviceProxy("[Master]", "audio_latency_usage");
+    ControlProxy schedulerProxy("[Master]", "audio_latency_usage");
+
+    soundDeviceProxy.set(0.05);
+    EXPECT_EQ(8, TrackAnalysisScheduler::backgroundWorkerLimit(
+            8, schedulerProxy.get()));
+
+    soundDeviceProxy.set(0.2);
+    const int busyWorkerLimit = TrackAnalysisScheduler::backgroundWorkerLimit(
+            8, schedulerProxy.get());
+    EXPECT_LT(1, busyWorkerLimit);
+    EXPECT_GT(8, busyWorkerLimit);
+
+    // Overloaded, even if the measured value exceeds the range
+    soundDeviceProxy.set(0.9);
+    EXPECT_EQ(1, TrackAnalysisScheduler::backgroundWorkerLimit(
+            8, schedulerProxy.get()));
+}
+
+} // namespace
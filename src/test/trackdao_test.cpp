@@ -1,10 +1,41 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
 #include "test/librarytest.h"
+#include "track/cue.h"
 
 using ::testing::UnorderedElementsAre;
 
+namespace {
+
+QList<TrackId> addTracks(TrackCollection* pTrackCollection, int numTracks) {
+    const QDir dir(QDir::tempPath() + QStringLiteral("/batch"));
+    QList<TrackId> trackIds;
+    for (int i = 0; i < numTracks; ++i) {
+        TrackPointer pTrack = Track::newTemporary(
+                TrackFile(dir, QString("track%1.mp3").arg(i)));
+        pTrack->setTitle(QString("Title %1").arg(i));
+        pTrack->setMetadataSynchronized(true);
+        trackIds.append(pTrackCollection->addTrack(pTrack, false));
+    }
+    return trackIds;
+}
+
+void addHotCue(const QSqlDatabase& database, TrackId trackId, int hotCue) {
+    QSqlQuery query(database);
+    query.prepare(
+            "INSERT INTO cues (track_id, type, position, length, hotcue, label) "
+            "VALUES (:track_id, :type, :position, 0, :hotcue, '')");
+    query.bindValue(":track_id", trackId.toVariant());
+    query.bindValue(":type", static_cast<int>(mixxx::CueType::HotCue));
+    query.bindValue(":position", 1000 * (hotCue + 1));
+    query.bindValue(":hotcue", hotCue);
+    query.exec();
+}
+
+} // anonymous namespace
+
 class TrackDAOTest : public LibraryTest {
 };
 
@@ -55,3 +86,83 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, getTracksById) {
+    const QList<TrackId> trackIds = addTracks(internalCollection(), 3);
+    addHotCue(dbConnection(), trackIds[1], 0);
+    addHotCue(dbConnection(), trackIds[1], 1);
+
+    // One of the tracks is already cached
+    const TrackPointer pCachedTrack = internalCollection()->getTrackById(trackIds[2]);
+    ASSERT_TRUE(pCachedTrack);
+
+    // Invalid and unknown ids are skipped, duplicates are preserved
+    const TrackPointerList tracks = internalCollection()->getTracksById({
+            trackIds[1], TrackId(), trackIds[2], TrackId(12345), trackIds[0], trackIds[1]});
+    ASSERT_EQ(4, tracks.size());
+    EXPECT_EQ(trackIds[1], tracks[0]->getId());
+    EXPECT_EQ(pCachedTrack, tracks[1]);
+    EXPECT_EQ(trackIds[0], tracks[2]->getId());
+    EXPECT_EQ(tracks[0], tracks[3]);
+
+    EXPECT_QSTRING_EQ("Title 1", tracks[0]->getTitle());
+    EXPECT_QSTRING_EQ("Title 0", tracks[2]->getTitle());
+    EXPECT_EQ(2, tracks[0]->getCuePoints().size());
+    EXPECT_TRUE(tracks[2]->getCuePoints().isEmpty());
+
+    // The loaded tracks are cached
+    EXPECT_EQ(tracks[2], internalCollection()->getTrackById(trackIds[0]));
+}
+
+namespace {
+
+// Provides the library of the fixture for benchmarks
+class TrackDAOBenchmarkLibrary : public LibraryTest {
+  public:
+    explicit TrackDAOBenchmarkLibrary(int numTracks)
+            : m_trackIds(addTracks(internalCollection(), numTracks)) {
+        for (const auto& trackId : qAsConst(m_trackIds)) {
+            addHotCue(dbConnection(), trackId, 0);
+        }
+    }
+
+    const QList<TrackId>& trackIds() const {
+        return m_trackIds;
+    }
+
+    using LibraryTest::internalCollection;
+
+  private:
+    void TestBody() override {
+    }
+
+    QList<TrackId> m_trackIds;
+};
+
+} // anonymous namespace
+
+// Loads all tracks of a library one by one. The tracks are evicted from
+// the GlobalTrackCache when the list is released after each iteration.
+static void BM_GetTrackById(benchmark::State& state) {
+    TrackDAOBenchmarkLibrary library(state.range(0));
+    while (state.KeepRunning()) {
+        TrackPointerList tracks;
+        for (const auto& trackId : library.trackIds()) {
+            tracks.append(library.internalCollection()->getTrackById(trackId));
+        }
+        benchmark::DoNotOptimize(tracks);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetTrackById)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void BM_GetTracksById(benchmark::State& state) {
+    TrackDAOBenchmarkLibrary library(state.range(0));
+    while (state.KeepRunning()) {
+        TrackPointerList tracks =
+                library.internalCollection()->getTracksById(library.trackIds());
+        benchmark::DoNotOptimize(tracks);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetTracksById)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
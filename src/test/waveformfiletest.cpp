@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+#include "waveform/waveform.h"
+#include "waveform/waveformfile.h"
+#include "waveform/waveformpyramid.h"
+
+namespace {
+
+class WaveformFileTest : public MixxxTest {
+  protected:
+    WaveformFileTest()
+            : m_waveform(44100, 44100 * 60, 441, -1),
+              m_fileName(m_tempDir.filePath("waveform")) {
+        WaveformData* pData = m_waveform.data();
+        for (int i = 0; i < m_waveform.getDataSize(); ++i) {
+            pData[i].filtered.low = static_cast<unsigned char>(i);
+            pData[i].filtered.mid = static_cast<unsigned char>(i >> 8);
+            pData[i].filtered.high = static_cast<unsigned char>(i >> 16);
+            pData[i].filtered.all = static_cast<unsigned char>(i % 7);
+        }
+    }
+
+    QTemporaryDir m_tempDir;
+    Waveform m_waveform;
+    const QString m_fileName;
+};
+
+TEST_F(WaveformFileTest, WriteAndMap) {
+    ASSERT_TRUE(WaveformFile::write(m_fileName, m_waveform));
+    EXPECT_TRUE(WaveformFile::isWaveformFile(m_fileName));
+
+    WaveformPointer pMapped = WaveformFile::map(
+            m_fileName, WaveformFile::headerChecksum(m_waveform));
+    ASSERT_TRUE(pMapped);
+#ifndef __WINDOWS__
+    EXPECT_TRUE(pMapped->isMapped());
+#endif
+    EXPECT_TRUE(pMapped->isValid());
+    EXPECT_EQ(m_waveform.getDataSize(), pMapped->getDataSize());
+    EXPECT_EQ(m_waveform.getTextureStride(), pMapped->getTextureStride());
+    EXPECT_DOUBLE_EQ(m_waveform.getAudioVisualRatio(),
+            pMapped->getAudioVisualRatio());
+    EXPECT_EQ(pMapped->getDataSize(), pMapped->getCompletion());
+    // Only the rows that contain data are stored
+    EXPECT_EQ(0, pMapped->getTextureSize() % pMapped->getTextureStride());
+    EXPECT_GE(pMapped->getTextureSize(), pMapped->getDataSize());
+    EXPECT_LT(pMapped->getTextureSize(),
+            pMapped->getDataSize() + pMapped->getTextureStride());
+    EXPECT_LE(pMapped->getTextureSize(), m_waveform.getTextureSize());
+    for (int i = 0; i < m_waveform.getDataSize(); ++i) {
+        ASSERT_EQ(m_waveform.get(i).m_i, pMapped->get(i).m_i) << i;
+    }
+
+    // The pyramid is stored with the data
+    const WaveformPyramid* pPyramid = pMapped->getPyramid();
+    ASSERT_NE(nullptr, pPyramid);
+    WaveformPyramid expectedPyramid(m_waveform.data(), m_waveform.getDataSize());
+    ASSERT_EQ(expectedPyramid.levelCount(), pPyramid->levelCount());
+    for (int level = 1; level < pPyramid->levelCount(); ++level) {
+        const WaveformData* pExpected = expectedPyramid.levelData(level);
+        const WaveformData* pActual = pPyramid->levelData(level);
+        for (int i = 0; i < pPyramid->levelSize(level); ++i) {
+            ASSERT_EQ(pExpected[i].m_i, pActual[i].m_i) << level << i;
+        }
+    }
+}
+
+TEST_F(WaveformFileTest, ReplaceMappedFile) {
+    ASSERT_TRUE(WaveformFile::write(m_fileName, m_waveform));
+    WaveformPointer pMapped = WaveformFile::map(
+            m_fileName, WaveformFile::headerChecksum(m_waveform));
+    ASSERT_TRUE(pMapped);
+
+    Waveform summary(44100, 44100 * 60, 441, 2 * 1920);
+    ASSERT_TRUE(WaveformFile::write(m_fileName, summary));
+    WaveformPointer pMappedSummary = WaveformFile::map(
+            m_fileName, WaveformFile::headerChecksum(summary));
+    ASSERT_TRUE(pMappedSummary);
+    EXPECT_EQ(summary.getDataSize(), pMappedSummary->getDataSize());
+
+    // The previous mapping is not affected
+    EXPECT_EQ(m_waveform.getDataSize(), pMapped->getDataSize());
+    EXPECT_EQ(m_waveform.get(m_waveform.getDataSize() - 1).m_i,
+            pMapped->get(m_waveform.getDataSize() - 1).m_i);
+}
+
+TEST_F(WaveformFileTest, RejectChecksumMismatch) {
+    ASSERT_TRUE(WaveformFile::write(m_fileName, m_waveform));
+    const quint16 checksum = WaveformFile::headerChecksum(m_waveform);
+    EXPECT_FALSE(WaveformFile::map(
+            m_fileName, static_cast<quint16>(checksum + 1)));
+}
+
+TEST_F(WaveformFileTest, RejectTruncatedFile) {
+    ASSERT_TRUE(WaveformFile::write(m_fileName, m_waveform));
+    QFile file(m_fileName);
+    ASSERT_TRUE(file.resize(file.size() - 1));
+    EXPECT_FALSE(WaveformFile::map(
+            m_fileName, WaveformFile::headerChecksum(m_waveform)));
+}
+
+TEST_F(WaveformFileTest, DetectLegacyBlob) {
+    QFile file(m_fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(qCompress(m_waveform.toByteArray()));
+    file.close();
+    EXPECT_FALSE(WaveformFile::isWaveformFile(m_fileName));
+    EXPECT_FALSE(WaveformFile::map(m_fileName, 0));
+
+    EXPECT_FALSE(WaveformFile::isWaveformFile(m_tempDir.filePath("missing")));
+}
+
+} // namespace
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
+
+namespace {
+
+WaveformData makeData(int low, int mid, int high, int all) {
+    WaveformData data;
+    data.filtered.low = static_cast<unsigned char>(low);
+    data.filtered.mid = static_cast<unsigned char>(mid);
+    data.filtered.high = static_cast<unsigned char>(high);
+    data.filtered.all = static_cast<unsigned char>(all);
+    return data;
+}
+
+TEST(WaveformPyramidTest, LevelSizes) {
+    // 5 frames of interleaved left and right samples
+    std::vector<WaveformData> data(10, makeData(0, 0, 0, 0));
+    WaveformPyramid pyramid(data.data(), static_cast<int>(data.size()));
+    ASSERT_EQ(4, pyramid.levelCount());
+    EXPECT_EQ(10, pyramid.levelSize(0));
+    EXPECT_EQ(6, pyramid.levelSize(1));
+    EXPECT_EQ(4, pyramid.levelSize(2));
+    EXPECT_EQ(2, pyramid.levelSize(3));
+    EXPECT_EQ(6 + 4 + 2, WaveformPyramid::storageSize(10));
+    EXPECT_EQ(data.data(), pyramid.levelData(0));
+
+    EXPECT_EQ(0, WaveformPyramid::storageSize(0));
+    EXPECT_EQ(0, WaveformPyramid::storageSize(2));
+}
+
+TEST(WaveformPyramidTest, MaximumOfBandsPerChannel) {
+    std::vector<WaveformData> data;
+    for (int frame = 0; frame < 5; ++frame) {
+        // left
+        data.push_back(makeData(frame, 10 - frame, frame % 2, 2 * frame));
+        // right
+        data.push_back(makeData(100 + frame, 0, 0, 50));
+    }
+    WaveformPyramid pyramid(data.data(), static_cast<int>(data.size()));
+
+    const WaveformData* pLevel1 = pyramid.levelData(1);
+    EXPECT_EQ(1, pLevel1[0].filtered.low);
+    EXPECT_EQ(10, pLevel1[0].filtered.mid);
+    EXPECT_EQ(1, pLevel1[0].filtered.high);
+    EXPECT_EQ(2, pLevel1[0].filtered.all);
+    EXPECT_EQ(101, pLevel1[1].filtered.low);
+    EXPECT_EQ(3, pLevel1[2].filtered.low);
+    EXPECT_EQ(8, pLevel1[2].filtered.mid);
+    EXPECT_EQ(103, pLevel1[3].filtered.low);
+    // The last frame has no neighbor
+    EXPECT_EQ(4, pLevel1[4].filtered.low);
+    EXPECT_EQ(6, pLevel1[4].filtered.mid);
+    EXPECT_EQ(104, pLevel1[5].filtered.low);
+
+    const WaveformData* pTop = pyramid.levelData(pyramid.levelCount() - 1);
+    EXPECT_EQ(4, pTop[0].filtered.low);
+    EXPECT_EQ(10, pTop[0].filtered.mid);
+    EXPECT_EQ(1, pTop[0].filtered.high);
+    EXPECT_EQ(8, pTop[0].filtered.all);
+    EXPECT_EQ(104, pTop[1].filtered.low);
+    EXPECT_EQ(50, pTop[1].filtered.all);
+}
+
+TEST(WaveformPyramidTest, AdoptLevels) {
+    std::vector<WaveformData> data;
+    for (int i = 0; i < 2 * 1000; ++i) {
+        data.push_back(makeData(i % 251, i % 13, i % 7, i % 256));
+    }
+    const int dataSize = static_cast<int>(data.size());
+    WaveformPyramid built(data.data(), dataSize);
+    WaveformPyramid adopted(data.data(), dataSize, built.levels());
+    ASSERT_EQ(built.levelCount(), adopted.levelCount());
+    for (int level = 1; level < built.levelCount(); ++level) {
+        ASSERT_EQ(built.levelSize(level), adopted.levelSize(level));
+        EXPECT_EQ(built.levelData(level), adopted.levelData(level));
+    }
+}
+
+TEST(WaveformPyramidTest, LevelForFrames) {
+    std::vector<WaveformData> data(2 * 1024, makeData(0, 0, 0, 0));
+    WaveformPyramid pyramid(data.data(), static_cast<int>(data.size()));
+    ASSERT_EQ(11, pyramid.levelCount());
+    EXPECT_EQ(0, pyramid.levelForFrames(0.5));
+    EXPECT_EQ(0, pyramid.levelForFrames(1.9));
+    EXPECT_EQ(1, pyramid.levelForFrames(2.0));
+    EXPECT_EQ(1, pyramid.levelForFrames(3.9));
+    EXPECT_EQ(5, pyramid.levelForFrames(40.0));
+    // Limited by the coarsest level
+    EXPECT_EQ(10, pyramid.levelForFrames(1e6));
+}
+
+} // namespace
@@ -1,8 +1,11 @@
 #include "track/globaltrackcache.h"
 
 #include <QApplication>
+#include <QSet>
 #include <QThread>
 
+#include <atomic>
+
 #include "util/assert.h"
 #include "util/logger.h"
 
@@ -14,7 +17,12 @@ constexpr std::size_t kUnorderedCollectionMinCapacity = 1024;
 const mixxx::Logger kLogger("GlobalTrackCache");
 
 //static
-GlobalTrackCache* volatile s_pInstance = nullptr;
+std::atomic<GlobalTrackCache*> s_pInstance(nullptr);
+
+// The number of lookups that are accessing the singular instance
+// without locking the cache. destroyInstance() waits until they
+// have finished.
+std::atomic<int> s_numLockFreeLookups(0);
 
 // Enforce logging during tests
 constexpr bool kLogEnabled = false;
@@ -34,6 +42,28 @@ TrackRef createTrackRef(const Track& track) {
     return TrackRef::fromFileInfo(track.getFileInfo(), track.getId());
 }
 
+// Keeps the singular instance alive while looking up a track
+// without locking the cache
+class LockFreeLookupScope {
+  public:
+    LockFreeLookupScope() {
+        // Both the increment and the following load must be sequentially
+        // consistent to pair with the exchange in destroyInstance()
+        s_numLockFreeLookups.fetch_add(1);
+        m_pInstance = s_pInstance.load();
+    }
+    ~LockFreeLookupScope() {
+        s_numLockFreeLookups.fetch_sub(1);
+    }
+
+    GlobalTrackCache* instance() const {
+        return m_pInstance;
+    }
+
+  private:
+    GlobalTrackCache* m_pInstance;
+};
+
 class EvictAndSaveFunctor {
   public:
     explicit EvictAndSaveFunctor(
@@ -80,16 +110,17 @@ GlobalTrackCacheLocker::~GlobalTrackCacheLocker() {
 }
 
 void GlobalTrackCacheLocker::lockCache() {
-    DEBUG_ASSERT(s_pInstance);
+    GlobalTrackCache* pInstance = s_pInstance.load();
+    DEBUG_ASSERT(pInstance);
     DEBUG_ASSERT(!m_pInstance);
     if (traceLogEnabled()) {
         kLogger.trace() << "Locking cache";
     }
-    s_pInstance->m_mutex.lock();
+    pInstance->m_mutex.lock();
     if (traceLogEnabled()) {
         kLogger.trace() << "Cache is locked";
     }
-    m_pInstance = s_pInstance;
+    m_pInstance = pInstance;
 }
 
 void GlobalTrackCacheLocker::unlockCache() {
@@ -100,9 +131,9 @@ void GlobalTrackCacheLocker::unlockCache() {
         if (kLogStats && debugLogEnabled()) {
             kLogger.debug()
                     << "#tracksById ="
-                    << m_pInstance->m_tracksById.size()
+                    << m_pInstance->countTracksById()
                     << "/ #tracksByCanonicalLocation ="
-                    << m_pInstance->m_tracksByCanonicalLocation.size();
+                    << m_pInstance->countTracksByCanonicalLocation();
         }
         m_pInstance->m_mutex.unlock();
         if (traceLogEnabled()) {
@@ -197,23 +228,27 @@ void GlobalTrackCacheResolver::initTrackIdAndUnlockCache(TrackId trackId) {
 void GlobalTrackCache::createInstance(
         GlobalTrackCacheSaver* pSaver,
         deleteTrackFn_t deleteTrackFn) {
-    DEBUG_ASSERT(!s_pInstance);
+    DEBUG_ASSERT(!s_pInstance.load());
     kLogger.info() << "Creating instance";
-    s_pInstance = new GlobalTrackCache(pSaver, deleteTrackFn);
+    s_pInstance.store(new GlobalTrackCache(pSaver, deleteTrackFn));
 }
 
 //static
 void GlobalTrackCache::destroyInstance() {
-    DEBUG_ASSERT(s_pInstance);
+    DEBUG_ASSERT(s_pInstance.load());
     kLogger.info() << "Destroying instance";
     // Processing all pending events is required to evict all
     // remaining references from the cache.
     QCoreApplication::processEvents();
     // Now the cache should be empty
     DEBUG_ASSERT(GlobalTrackCacheLocker().isEmpty());
-    GlobalTrackCache* pInstance = s_pInstance;
     // Reset the static/global pointer before entering the destructor
-    s_pInstance = nullptr;
+    GlobalTrackCache* pInstance = s_pInstance.exchange(nullptr);
+    // Wait for lookups that are still accessing the instance without
+    // a lock. Subsequent lookups will not find the instance anymore.
+    while (s_numLockFreeLookups.load() > 0) {
+        QThread::yieldCurrentThread();
+    }
     // Delete the singular instance
     DEBUG_ASSERT(QThread::currentThread() == pInstance->thread());
     pInstance->deleteLater();
@@ -252,14 +287,15 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
     // conditions before locking the cache this pointer might
     // already have been either deleted or reused by a second
     // shared_ptr.
-    if (s_pInstance) {
+    GlobalTrackCache* pInstance = s_pInstance.load();
+    if (pInstance) {
         QMetaObject::invokeMethod(
-                s_pInstance,
+                pInstance,
 #if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
                 "evictAndSave"
 #else
-                [cacheEntryPtr = std::move(cacheEntryPtr)] {
-                    s_pInstance->evictAndSave(cacheEntryPtr);
+                [pInstance, cacheEntryPtr = std::move(cacheEntryPtr)] {
+                    pInstance->evictAndSave(cacheEntryPtr);
                 }
 #endif
                 // Qt will choose either a direct or a queued connection
@@ -282,15 +318,73 @@ void GlobalTrackCache::evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cach
     }
 }
 
+//static
+TrackPointer GlobalTrackCache::lookupTrackById(
+        const TrackId& trackId) {
+    {
+        const LockFreeLookupScope lookupScope;
+        GlobalTrackCache* pInstance = lookupScope.instance();
+        VERIFY_OR_DEBUG_ASSERT(pInstance) {
+            return TrackPointer();
+        }
+        const auto entryPtr = pInstance->findById(trackId);
+        if (!entryPtr) {
+            // Cache miss
+            return TrackPointer();
+        }
+        TrackPointer strongPtr = entryPtr->lock();
+        if (strongPtr) {
+            // Cache hit
+            return strongPtr;
+        }
+    }
+    // The track is about to be evicted and needs to be revived
+    // while the whole cache is locked
+    return GlobalTrackCacheLocker().lookupTrackById(trackId);
+}
+
+//static
+TrackPointer GlobalTrackCache::lookupTrackByRef(
+        const TrackRef& trackRef) {
+    if (trackRef.hasId()) {
+        return lookupTrackById(trackRef.getId());
+    }
+    {
+        const LockFreeLookupScope lookupScope;
+        GlobalTrackCache* pInstance = lookupScope.instance();
+        VERIFY_OR_DEBUG_ASSERT(pInstance) {
+            return TrackPointer();
+        }
+        const auto entryPtr = pInstance->findByCanonicalLocation(
+                trackRef.getCanonicalLocation());
+        if (!entryPtr) {
+            // Cache miss
+            return TrackPointer();
+        }
+        TrackPointer strongPtr = entryPtr->lock();
+        if (strongPtr) {
+            // Cache hit
+            return strongPtr;
+        }
+    }
+    // The track is about to be evicted and needs to be revived
+    // while the whole cache is locked
+    return GlobalTrackCacheLocker().lookupTrackByRef(trackRef);
+}
+
 GlobalTrackCache::GlobalTrackCache(
         GlobalTrackCacheSaver* pSaver,
         deleteTrackFn_t deleteTrackFn)
     : m_mutex(QMutex::Recursive),
       m_pSaver(pSaver),
-      m_deleteTrackFn(deleteTrackFn),
-      m_tracksById(kUnorderedCollectionMinCapacity, DbId::hash_fun) {
+      m_deleteTrackFn(deleteTrackFn) {
     DEBUG_ASSERT(m_pSaver);
     qRegisterMetaType<GlobalTrackCacheEntryPointer>("GlobalTrackCacheEntryPointer");
+    for (auto& shard : m_tracksById) {
+        shard.index = TracksById(
+                kUnorderedCollectionMinCapacity / kShardCount,
+                DbId::hash_fun);
+    }
 }
 
 GlobalTrackCache::~GlobalTrackCache() {
@@ -303,53 +397,67 @@ void GlobalTrackCache::relocateTracks(
         kLogger.debug()
                 << "Relocating tracks";
     }
-    TracksByCanonicalLocation relocatedTracksByCanonicalLocation;
-    for (auto&&
-            i = m_tracksByCanonicalLocation.begin();
-            i != m_tracksByCanonicalLocation.end();
-            ++i) {
-        const QString oldCanonicalLocation = i->first;
-        Track* plainPtr = i->second->getPlainPtr();
-        auto fileInfo = plainPtr->getFileInfo();
-        TrackRef trackRef = TrackRef::fromFileInfo(
-                fileInfo,
-                plainPtr->getId());
-        if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
-            auto relocatedFileInfo = pRelocator->relocateCachedTrack(
-                        trackRef.getId(),
-                        fileInfo);
-            if (fileInfo != relocatedFileInfo) {
-                plainPtr->relocate(relocatedFileInfo);
-                trackRef = TrackRef::fromFileInfo(
-                        relocatedFileInfo,
-                        trackRef.getId());
-                fileInfo = std::move(relocatedFileInfo);
-            }
-        }
-        if (!trackRef.hasCanonicalLocation()) {
-            kLogger.warning()
-                    << "Failed to relocate track"
-                    << oldCanonicalLocation
-                    << trackRef;
-            continue;
+    std::array<TracksByCanonicalLocation, kShardCount> relocatedTracksByCanonicalLocation;
+    for (const auto& shard : m_tracksByCanonicalLocation) {
+        // The relocator accesses the database and must not be
+        // invoked while holding the mutex of the shard
+        TracksByCanonicalLocation tracksByCanonicalLocation;
+        {
+            QMutexLocker locker(&shard.mutex);
+            tracksByCanonicalLocation = shard.index;
         }
-        QString newCanonicalLocation = trackRef.getCanonicalLocation();
-        if (oldCanonicalLocation == newCanonicalLocation) {
-            // Copy the entry unmodified into the new map
-            relocatedTracksByCanonicalLocation.insert(*i);
-            continue;
-        }
-        if (debugLogEnabled()) {
-            kLogger.debug()
-                    << "Relocating track"
-                    << "from" << oldCanonicalLocation
-                    << "to" << newCanonicalLocation;
+        for (auto&&
+                i = tracksByCanonicalLocation.begin();
+                i != tracksByCanonicalLocation.end();
+                ++i) {
+            const QString oldCanonicalLocation = i->first;
+            Track* plainPtr = i->second->getPlainPtr();
+            auto fileInfo = plainPtr->getFileInfo();
+            TrackRef trackRef = TrackRef::fromFileInfo(
+                    fileInfo,
+                    plainPtr->getId());
+            if (!trackRef.hasCanonicalLocation() && trackRef.hasId() && pRelocator) {
+                auto relocatedFileInfo = pRelocator->relocateCachedTrack(
+                            trackRef.getId(),
+                            fileInfo);
+                if (fileInfo != relocatedFileInfo) {
+                    plainPtr->relocate(relocatedFileInfo);
+                    trackRef = TrackRef::fromFileInfo(
+                            relocatedFileInfo,
+                            trackRef.getId());
+                    fileInfo = std::move(relocatedFileInfo);
+                }
+            }
+            if (!trackRef.hasCanonicalLocation()) {
+                kLogger.warning()
+                        << "Failed to relocate track"
+                        << oldCanonicalLocation
+                        << trackRef;
+                continue;
+            }
+            QString newCanonicalLocation = trackRef.getCanonicalLocation();
+            if (oldCanonicalLocation == newCanonicalLocation) {
+                // Copy the entry unmodified into the new map
+                relocatedTracksByCanonicalLocation[shardOf(oldCanonicalLocation)].insert(*i);
+                continue;
+            }
+            if (debugLogEnabled()) {
+                kLogger.debug()
+                        << "Relocating track"
+                        << "from" << oldCanonicalLocation
+                        << "to" << newCanonicalLocation;
+            }
+            relocatedTracksByCanonicalLocation[shardOf(newCanonicalLocation)].insert(
+                    std::make_pair(
+                            std::move(newCanonicalLocation),
+                            i->second));
         }
-        relocatedTracksByCanonicalLocation.insert(std::make_pair(
-                std::move(newCanonicalLocation),
-                i->second));
     }
-    m_tracksByCanonicalLocation = std::move(relocatedTracksByCanonicalLocation);
+    for (int i = 0; i < kShardCount; ++i) {
+        auto& shard = m_tracksByCanonicalLocation[i];
+        QMutexLocker locker(&shard.mutex);
+        shard.index = std::move(relocatedTracksByCanonicalLocation[i]);
+    }
 }
 
 void GlobalTrackCache::saveEvictedTrack(Track* pEvictedTrack) const {
@@ -380,29 +488,40 @@ void GlobalTrackCache::deactivate() {
     // exiting the application.
     kLogger.warning()
             << "Evicting all remaining"
-            << m_tracksById.size()
+            << countTracksById()
             << '/'
-            << m_tracksByCanonicalLocation.size()
+            << countTracksByCanonicalLocation()
             << "tracks from cache";
 
-    while (!m_tracksById.empty()) {
-        auto i = m_tracksById.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(plainPtr->getCanonicalLocation());
-        m_tracksById.erase(i);
+    // All entries are removed from the indices before saving
+    // the tracks, which must not be done while holding the
+    // mutex of a shard.
+    std::vector<GlobalTrackCacheEntryPointer> evictedEntries;
+    QSet<Track*> evictedTracks;
+    for (auto& shard : m_tracksById) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto&& entry : shard.index) {
+            evictedTracks.insert(entry.second->getPlainPtr());
+            evictedEntries.push_back(std::move(entry.second));
+        }
+        shard.index.clear();
+    }
+    for (auto& shard : m_tracksByCanonicalLocation) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto&& entry : shard.index) {
+            if (!evictedTracks.contains(entry.second->getPlainPtr())) {
+                evictedTracks.insert(entry.second->getPlainPtr());
+                evictedEntries.push_back(std::move(entry.second));
+            }
+        }
+        shard.index.clear();
     }
-
-    while (!m_tracksByCanonicalLocation.empty()) {
-        auto i = m_tracksByCanonicalLocation.begin();
-        Track* plainPtr= i->second->getPlainPtr();
-        saveEvictedTrack(plainPtr);
-        m_tracksByCanonicalLocation.erase(i);
+    for (const auto& entryPtr : evictedEntries) {
+        saveEvictedTrack(entryPtr->getPlainPtr());
     }
 
     // Verify that all cached tracks have been evicted
-    DEBUG_ASSERT(m_tracksById.empty());
-    DEBUG_ASSERT(m_tracksByCanonicalLocation.empty());
+    DEBUG_ASSERT(isEmpty());
 
     // The singular cache instance is already unavailable and
     // all allocated tracks will simply be deleted when their
@@ -412,21 +531,73 @@ void GlobalTrackCache::deactivate() {
 }
 
 bool GlobalTrackCache::isEmpty() const {
-    return m_tracksById.empty() && m_tracksByCanonicalLocation.empty();
+    return countTracksById() == 0 && countTracksByCanonicalLocation() == 0;
+}
+
+std::size_t GlobalTrackCache::countTracksById() const {
+    std::size_t count = 0;
+    for (const auto& shard : m_tracksById) {
+        QMutexLocker locker(&shard.mutex);
+        count += shard.index.size();
+    }
+    return count;
+}
+
+std::size_t GlobalTrackCache::countTracksByCanonicalLocation() const {
+    std::size_t count = 0;
+    for (const auto& shard : m_tracksByCanonicalLocation) {
+        QMutexLocker locker(&shard.mutex);
+        count += shard.index.size();
+    }
+    return count;
+}
+
+//static
+int GlobalTrackCache::shardOf(const TrackId& trackId) {
+    return qHash(trackId) % kShardCount;
+}
+
+//static
+int GlobalTrackCache::shardOf(const QString& canonicalLocation) {
+    return qHash(canonicalLocation) % kShardCount;
+}
+
+GlobalTrackCacheEntryPointer GlobalTrackCache::findById(
+        const TrackId& trackId) const {
+    const auto& shard = m_tracksById[shardOf(trackId)];
+    QMutexLocker locker(&shard.mutex);
+    const auto trackById(shard.index.find(trackId));
+    if (shard.index.end() != trackById) {
+        return trackById->second;
+    } else {
+        return GlobalTrackCacheEntryPointer();
+    }
+}
+
+GlobalTrackCacheEntryPointer GlobalTrackCache::findByCanonicalLocation(
+        const QString& canonicalLocation) const {
+    const auto& shard = m_tracksByCanonicalLocation[shardOf(canonicalLocation)];
+    QMutexLocker locker(&shard.mutex);
+    const auto trackByCanonicalLocation(shard.index.find(canonicalLocation));
+    if (shard.index.end() != trackByCanonicalLocation) {
+        return trackByCanonicalLocation->second;
+    } else {
+        return GlobalTrackCacheEntryPointer();
+    }
 }
 
 TrackPointer GlobalTrackCache::lookupById(
         const TrackId& trackId) {
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
+    auto entryPtr = findById(trackId);
+    if (entryPtr) {
         // Cache hit
         if (traceLogEnabled()) {
             kLogger.trace()
                     << "Cache hit for"
                     << trackId
-                    << trackById->second->getPlainPtr();
+                    << entryPtr->getPlainPtr();
         }
-        return revive(trackById->second);
+        return revive(std::move(entryPtr));
     } else {
         // Cache miss
         if (traceLogEnabled()) {
@@ -444,17 +615,16 @@ TrackPointer GlobalTrackCache::lookupByRef(
         return lookupById(trackRef.getId());
     } else {
         const auto canonicalLocation = trackRef.getCanonicalLocation();
-        const auto trackByCanonicalLocation(
-                m_tracksByCanonicalLocation.find(canonicalLocation));
-        if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+        auto entryPtr = findByCanonicalLocation(canonicalLocation);
+        if (entryPtr) {
             // Cache hit
             if (traceLogEnabled()) {
                 kLogger.trace()
                         << "Cache hit for"
                         << canonicalLocation
-                        << trackByCanonicalLocation->second->getPlainPtr();
+                        << entryPtr->getPlainPtr();
             }
-            return revive(trackByCanonicalLocation->second);
+            return revive(std::move(entryPtr));
         } else {
             // Cache miss
             if (traceLogEnabled()) {
@@ -592,17 +762,21 @@ void GlobalTrackCache::resolve(
 
     if (trackRef.hasId()) {
         // Insert item by id
-        DEBUG_ASSERT(m_tracksById.find(
-                trackRef.getId()) == m_tracksById.end());
-        m_tracksById.insert(std::make_pair(
+        auto& shard = m_tracksById[shardOf(trackRef.getId())];
+        QMutexLocker locker(&shard.mutex);
+        DEBUG_ASSERT(shard.index.find(
+                trackRef.getId()) == shard.index.end());
+        shard.index.insert(std::make_pair(
                 trackRef.getId(),
                 cacheEntryPtr));
     }
     if (trackRef.hasCanonicalLocation()) {
         // Insert item by track location
-        DEBUG_ASSERT(m_tracksByCanonicalLocation.find(
-                trackRef.getCanonicalLocation()) == m_tracksByCanonicalLocation.end());
-        m_tracksByCanonicalLocation.insert(std::make_pair(
+        auto& shard = m_tracksByCanonicalLocation[shardOf(trackRef.getCanonicalLocation())];
+        QMutexLocker locker(&shard.mutex);
+        DEBUG_ASSERT(shard.index.find(
+                trackRef.getCanonicalLocation()) == shard.index.end());
+        shard.index.insert(std::make_pair(
                 trackRef.getCanonicalLocation(),
                 cacheEntryPtr));
     }
@@ -633,15 +807,20 @@ TrackRef GlobalTrackCache::initTrackId(
     EvictAndSaveFunctor* pDel = std::get_deleter<EvictAndSaveFunctor>(strongPtr);
     DEBUG_ASSERT(pDel);
 
-    // Insert item by id
-    DEBUG_ASSERT(m_tracksById.find(trackId) == m_tracksById.end());
-    m_tracksById.insert(std::make_pair(
-            trackId,
-            pDel->getCacheEntryPointer()));
-
+    // The id is set before the track becomes visible in the index
     strongPtr->initId(trackId);
     DEBUG_ASSERT(createTrackRef(*strongPtr) == trackRefWithId);
-    DEBUG_ASSERT(m_tracksById.find(trackId) != m_tracksById.end());
+
+    // Insert item by id
+    {
+        auto& shard = m_tracksById[shardOf(trackId)];
+        QMutexLocker locker(&shard.mutex);
+        DEBUG_ASSERT(shard.index.find(trackId) == shard.index.end());
+        shard.index.insert(std::make_pair(
+                trackId,
+                pDel->getCacheEntryPointer()));
+    }
+    DEBUG_ASSERT(findById(trackId));
 
     return trackRefWithId;
 }
@@ -649,12 +828,18 @@ TrackRef GlobalTrackCache::initTrackId(
 void GlobalTrackCache::purgeTrackId(TrackId trackId) {
     DEBUG_ASSERT(trackId.isValid());
 
-    const auto trackById(m_tracksById.find(trackId));
-    if (m_tracksById.end() != trackById) {
-        Track* track = trackById->second->getPlainPtr();
-        track->resetId();
-        m_tracksById.erase(trackById);
+    Track* track = nullptr;
+    {
+        auto& shard = m_tracksById[shardOf(trackId)];
+        QMutexLocker locker(&shard.mutex);
+        const auto trackById(shard.index.find(trackId));
+        if (shard.index.end() == trackById) {
+            return;
+        }
+        track = trackById->second->getPlainPtr();
+        shard.index.erase(trackById);
     }
+    track->resetId();
 }
 
 void GlobalTrackCache::evictAndSave(
@@ -718,10 +903,12 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
                 << plainPtr;
     }
     if (trackRef.hasId()) {
-        const auto trackById = m_tracksById.find(trackRef.getId());
-        if (trackById != m_tracksById.end()) {
+        auto& shard = m_tracksById[shardOf(trackRef.getId())];
+        QMutexLocker locker(&shard.mutex);
+        const auto trackById = shard.index.find(trackRef.getId());
+        if (trackById != shard.index.end()) {
             if (trackById->second->getPlainPtr() == plainPtr) {
-                m_tracksById.erase(trackById);
+                shard.index.erase(trackById);
                 evicted = true;
             } else {
                 notEvicted = true;
@@ -729,11 +916,13 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
         }
     }
     if (trackRef.hasCanonicalLocation()) {
+        auto& shard = m_tracksByCanonicalLocation[shardOf(trackRef.getCanonicalLocation())];
+        QMutexLocker locker(&shard.mutex);
         const auto trackByCanonicalLocation(
-                m_tracksByCanonicalLocation.find(trackRef.getCanonicalLocation()));
-        if (m_tracksByCanonicalLocation.end() != trackByCanonicalLocation) {
+                shard.index.find(trackRef.getCanonicalLocation()));
+        if (shard.index.end() != trackByCanonicalLocation) {
             if (trackByCanonicalLocation->second->getPlainPtr() == plainPtr) {
-                m_tracksByCanonicalLocation.erase(
+                shard.index.erase(
                         trackByCanonicalLocation);
                 evicted = true;
             } else {
@@ -748,14 +937,20 @@ bool GlobalTrackCache::tryEvict(Track* plainPtr) {
 }
 
 bool GlobalTrackCache::isCached(Track* plainPtr) const {
-    for (auto&& entry: m_tracksById) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-            return true;
+    for (const auto& shard : m_tracksById) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto&& entry: shard.index) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
     }
-    for (auto&& entry: m_tracksByCanonicalLocation) {
-        if (entry.second->getPlainPtr() == plainPtr) {
-              return true;
+    for (const auto& shard : m_tracksByCanonicalLocation) {
+        QMutexLocker locker(&shard.mutex);
+        for (auto&& entry: shard.index) {
+            if (entry.second->getPlainPtr() == plainPtr) {
+                return true;
+            }
         }
     }
     return false;
@@ -1,6 +1,9 @@
 #pragma once
 
 
+#include <QMutex>
+
+#include <array>
 #include <map>
 #include <unordered_map>
 
@@ -40,6 +43,9 @@ class GlobalTrackCacheEntry final {
     // The second one counts the references outside Mixxx, if it
     // is not longer referenced, the track is saved and evicted
     // from the cache.
+    // The weak pointer is guarded by its own mutex, because it
+    // is accessed while looking up tracks without locking the
+    // whole cache.
   public:
     class TrackDeleter {
     public:
@@ -58,9 +64,10 @@ class GlobalTrackCacheEntry final {
         : m_deletingPtr(std::move(deletingPtr)) {
     }
     GlobalTrackCacheEntry(const GlobalTrackCacheEntry& other) = delete;
-    GlobalTrackCacheEntry(GlobalTrackCacheEntry&&) = default;
+    GlobalTrackCacheEntry(GlobalTrackCacheEntry&&) = delete;
 
     void init(TrackWeakPointer savingWeakPtr) {
+        QMutexLocker locker(&m_mutex);
         // Uninitialized or expired
         DEBUG_ASSERT(!m_savingWeakPtr.lock());
         m_savingWeakPtr = std::move(savingWeakPtr);
@@ -71,14 +78,17 @@ class GlobalTrackCacheEntry final {
     }
 
     TrackPointer lock() const {
+        QMutexLocker locker(&m_mutex);
         return m_savingWeakPtr.lock();
     }
     bool expired() const {
+        QMutexLocker locker(&m_mutex);
         return m_savingWeakPtr.expired();
     }
 
   private:
     std::unique_ptr<Track, TrackDeleter> m_deletingPtr;
+    mutable QMutex m_mutex;
     TrackWeakPointer m_savingWeakPtr;
 };
 
@@ -201,6 +211,17 @@ public:
     // Deleter callbacks for the smart-pointer
     static void evictAndSaveCachedTrack(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
+    // Lookup an existing Track object in the cache without a
+    // GlobalTrackCacheLocker. Tracks that are still referenced
+    // are found by only locking a single shard of the cache.
+    // The whole cache is only locked for reviving a track that
+    // is about to be evicted. Use these functions for lookups
+    // from the GUI and other latency sensitive threads.
+    static TrackPointer lookupTrackById(
+            const TrackId& trackId);
+    static TrackPointer lookupTrackByRef(
+            const TrackRef& trackRef);
+
 private slots:
     void evictAndSave(GlobalTrackCacheEntryPointer cacheEntryPtr);
 
@@ -240,6 +261,8 @@ private:
     bool isCached(Track* plainPtr) const;
 
     bool isEmpty() const;
+    std::size_t countTracksById() const;
+    std::size_t countTracksByCanonicalLocation() const;
 
     void deactivate();
 
@@ -252,11 +275,32 @@ private:
 
     deleteTrackFn_t m_deleteTrackFn;
 
+    // Both indices are partitioned into shards that are locked
+    // individually. Modifying a shard requires both m_mutex and
+    // the mutex of the shard, reading a shard only requires the
+    // mutex of the shard. The mutex of a shard is never held
+    // while locking m_mutex or while calling out of the cache.
+    static constexpr int kShardCount = 16;
+
+    template<typename Index>
+    struct Shard {
+        mutable QMutex mutex;
+        Index index;
+    };
+
+    static int shardOf(const TrackId& trackId);
+    static int shardOf(const QString& canonicalLocation);
+
+    GlobalTrackCacheEntryPointer findById(
+            const TrackId& trackId) const;
+    GlobalTrackCacheEntryPointer findByCanonicalLocation(
+            const QString& canonicalLocation) const;
+
     // This caches the unsaved Tracks by ID
     typedef std::unordered_map<TrackId, GlobalTrackCacheEntryPointer, TrackId::hash_fun_t> TracksById;
-    TracksById m_tracksById;
+    std::array<Shard<TracksById>, kShardCount> m_tracksById;
 
     // This caches the unsaved Tracks by location
     typedef std::map<QString, GlobalTrackCacheEntryPointer> TracksByCanonicalLocation;
-    TracksByCanonicalLocation m_tracksByCanonicalLocation;
+    std::array<Shard<TracksByCanonicalLocation>, kShardCount> m_tracksByCanonicalLocation;
 };
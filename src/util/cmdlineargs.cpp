@@ -58,6 +58,12 @@ bool CmdlineArgs::Parse(int &argc, char **argv) {
         } else if (argv[i] == QString("--timelinePath") && i+1 < argc) {
             m_timelinePath = QString::fromLocal8Bit(argv[i+1]);
             i++;
+        } else if (argv[i] == QString("--render") && i+1 < argc) {
+            m_renderScriptPath = QString::fromLocal8Bit(argv[i+1]);
+            i++;
+        } else if (argv[i] == QString("--renderOutput") && i+1 < argc) {
+            m_renderOutputPath = QString::fromLocal8Bit(argv[i+1]);
+            i++;
         } else if (argv[i] == QString("--logLevel") && i+1 < argc) {
             logLevelSet = true;
             auto level = QLatin1String(argv[i+1]);
@@ -156,6 +162,14 @@ void CmdlineArgs::printUsage() {
 \n\
 -f, --fullScreen        Starts Mixxx in full-screen mode\n\
 \n\
+--render SCRIPT         Runs the mixing engine without sound devices and\n\
+                        GUI as fast as possible, replays the control\n\
+                        changes of the render SCRIPT, prints the engine\n\
+                        throughput and exits\n\
+\n\
+--renderOutput FILE     Writes the master output of --render to FILE as\n\
+                        32-bit float WAV\n\
+\n\
 --logLevel LEVEL        Sets the verbosity of command line logging\n\
                         critical - Critical/Fatal only\n\
                         warning  - Above + Warnings\n\
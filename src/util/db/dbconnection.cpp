@@ -1,5 +1,6 @@
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -301,18 +302,63 @@ bool initDatabase(QSqlDatabase database, StringCollator* pCollator) {
     return true;
 }
 
+bool isSqliteDatabase(const QSqlDatabase& database) {
+    return database.driverName() == QStringLiteral("QSQLITE");
+}
+
+QVariant queryPragma(const QSqlDatabase& database, const QString& pragma) {
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("PRAGMA %1").arg(pragma)) || !query.next()) {
+        // SQLite silently ignores unsupported settings, e.g. mmap_size
+        // if memory mapping has been disabled at compile time
+        return QVariant();
+    }
+    return query.value(0);
+}
+
+void applyPerformanceProfile(
+        const QSqlDatabase& database,
+        const DbConnection::PerformanceProfile& profile) {
+    if (!isSqliteDatabase(database)) {
+        return;
+    }
+    const QStringList pragmas = {
+            QStringLiteral("journal_mode=%1").arg(profile.journalMode),
+            QStringLiteral("synchronous=%1").arg(profile.synchronous),
+            QStringLiteral("mmap_size=%1").arg(profile.mmapSize),
+            QStringLiteral("cache_size=%1").arg(profile.cacheSize),
+            QStringLiteral("temp_store=%1").arg(profile.tempStore),
+    };
+    for (const auto& pragma : pragmas) {
+        QSqlQuery query(database);
+        if (!query.exec(QStringLiteral("PRAGMA ") + pragma)) {
+            kLogger.warning()
+                    << "Failed to apply"
+                    << pragma
+                    << query.lastError();
+        }
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Applied performance profile"
+                << DbConnection::queryPerformanceProfile(database);
+    }
+}
+
 } // anonymous namespace
 
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_performanceProfile(params.performanceProfile) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_performanceProfile(prototype.m_performanceProfile) {
 }
 
 DbConnection::~DbConnection() {
@@ -340,6 +386,9 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+    // Applied to every connection, because all settings except the
+    // journal mode only affect the connection that sets them
+    applyPerformanceProfile(m_sqlDatabase, m_performanceProfile);
     return true;
 }
 
@@ -389,6 +438,40 @@ void DbConnection::makeStringLatinLow(QString* string) {
     makeLatinLow(string->data(), string->length());
 }
 
+//static
+DbConnection::PerformanceProfile DbConnection::queryPerformanceProfile(
+        const QSqlDatabase& database) {
+    PerformanceProfile profile;
+    if (!isSqliteDatabase(database)) {
+        return profile;
+    }
+    profile.journalMode = queryPragma(database, "journal_mode").toString().toLower();
+    profile.synchronous = queryPragma(database, "synchronous").toInt();
+    profile.mmapSize = queryPragma(database, "mmap_size").toLongLong();
+    profile.cacheSize = queryPragma(database, "cache_size").toInt();
+    profile.tempStore = queryPragma(database, "temp_store").toInt();
+    return profile;
+}
+
+bool operator==(
+        const DbConnection::PerformanceProfile& lhs,
+        const DbConnection::PerformanceProfile& rhs) {
+    return lhs.journalMode == rhs.journalMode &&
+            lhs.synchronous == rhs.synchronous &&
+            lhs.mmapSize == rhs.mmapSize &&
+            lhs.cacheSize == rhs.cacheSize &&
+            lhs.tempStore == rhs.tempStore;
+}
+
+QDebug operator<<(QDebug debug, const DbConnection::PerformanceProfile& profile) {
+    return debug
+            << "journal_mode =" << profile.journalMode
+            << "synchronous =" << profile.synchronous
+            << "mmap_size =" << profile.mmapSize
+            << "cache_size =" << profile.cacheSize
+            << "temp_store =" << profile.tempStore;
+}
+
 QDebug operator<<(QDebug debug, const DbConnection& connection) {
     return debug
             << connection.name()
@@ -24,6 +24,28 @@ class DbConnection final {
 
     static void makeStringLatinLow(QString* string);
 
+    // The SQLite settings that every connection applies when it is opened.
+    // The defaults let readers and writers of different threads run
+    // concurrently and keep more of the database in memory.
+    struct PerformanceProfile {
+        // With a write-ahead log readers neither block the writer nor
+        // are blocked by it
+        QString journalMode = QStringLiteral("wal");
+        // 1 = NORMAL: With WAL a power loss might only roll back the most
+        // recent transactions, but never corrupts the database
+        int synchronous = 1;
+        // In bytes
+        qint64 mmapSize = 256 * 1024 * 1024;
+        // Negative values are KiB per connection
+        int cacheSize = -16 * 1024;
+        // 2 = MEMORY
+        int tempStore = 2;
+    };
+
+    // Reads the settings of an open SQLite connection
+    static PerformanceProfile queryPerformanceProfile(
+            const QSqlDatabase& database);
+
     struct Params {
         QString type;
         QString connectOptions;
@@ -31,6 +53,7 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        PerformanceProfile performanceProfile;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -65,8 +88,21 @@ class DbConnection final {
 
     QSqlDatabase m_sqlDatabase;
     StringCollator m_collator;
+    const PerformanceProfile m_performanceProfile;
 };
 
+bool operator==(
+        const DbConnection::PerformanceProfile& lhs,
+        const DbConnection::PerformanceProfile& rhs);
+
+inline bool operator!=(
+        const DbConnection::PerformanceProfile& lhs,
+        const DbConnection::PerformanceProfile& rhs) {
+    return !(lhs == rhs);
+}
+
+QDebug operator<<(QDebug debug, const DbConnection::PerformanceProfile& profile);
+
 } // namespace mixxx
 
 
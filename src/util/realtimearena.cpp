@@ -0,0 +1,79 @@
+#include "util/realtimearena.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include "util/assert.h"
+#include "util/defs.h"
+
+// EngineEffectsManager, EngineEffectRack and EngineEffectChain each use two
+// nested buffers while processing a channel
+const std::size_t RealtimeArena::kDefaultCapacity =
+        8 * MAX_BUFFER_LEN * sizeof(CSAMPLE);
+
+thread_local RealtimeArena* RealtimeArena::s_pCurrent = nullptr;
+
+namespace {
+
+thread_local std::unique_ptr<RealtimeArena> s_pFallbackArena;
+
+} // anonymous namespace
+
+RealtimeArena::RealtimeArena(std::size_t capacity)
+        : m_pStorage(static_cast<char*>(std::malloc(capacity + kAlignment))),
+          m_pBegin(m_pStorage),
+          m_capacity(capacity),
+          m_bytesUsed(0),
+          m_highWaterMark(0) {
+    const std::uintptr_t misalignment =
+            reinterpret_cast<std::uintptr_t>(m_pStorage) % kAlignment;
+    if (misalignment != 0) {
+        m_pBegin += kAlignment - misalignment;
+    }
+}
+
+RealtimeArena::~RealtimeArena() {
+    DEBUG_ASSERT(s_pCurrent != this);
+    std::free(m_pStorage);
+}
+
+void* RealtimeArena::allocate(std::size_t bytes, std::size_t alignment) {
+    DEBUG_ASSERT(alignment <= kAlignment);
+    DEBUG_ASSERT((alignment & (alignment - 1)) == 0);
+    const std::size_t offset = (m_bytesUsed + alignment - 1) & ~(alignment - 1);
+    VERIFY_OR_DEBUG_ASSERT(offset + bytes <= m_capacity) {
+        return nullptr;
+    }
+    m_bytesUsed = offset + bytes;
+    if (m_bytesUsed > m_highWaterMark) {
+        m_highWaterMark = m_bytesUsed;
+    }
+    return m_pBegin + offset;
+}
+
+void RealtimeArena::rewind(std::size_t mark) {
+    DEBUG_ASSERT(mark <= m_bytesUsed);
+    m_bytesUsed = mark;
+}
+
+// static
+RealtimeArena* RealtimeArena::current() {
+    if (s_pCurrent) {
+        return s_pCurrent;
+    }
+    if (!s_pFallbackArena) {
+        s_pFallbackArena = std::make_unique<RealtimeArena>();
+    }
+    return s_pFallbackArena.get();
+}
+
+RealtimeArena::Scope::Scope(RealtimeArena* pArena)
+        : m_pPrevious(s_pCurrent) {
+    pArena->reset();
+    s_pCurrent = pArena;
+}
+
+RealtimeArena::Scope::~Scope() {
+    s_pCurrent = m_pPrevious;
+}
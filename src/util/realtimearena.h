@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+
+#include "util/class.h"
+#include "util/types.h"
+
+// A bump allocator for the scratch buffers of the realtime audio threads.
+//
+// All memory is allocated up front. Allocating from the arena just advances
+// an offset and never calls into the general purpose allocator or takes a
+// lock. Memory is not freed individually; Frame rewinds the arena at the end
+// of a scope and Scope resets it at the start of every engine callback.
+//
+// An arena is not thread-safe. Every realtime thread installs its own arena
+// with a Scope, and code running on that thread finds it with current().
+class RealtimeArena {
+  public:
+    // Enough for the widest SIMD registers and a cache line
+    static constexpr std::size_t kAlignment = 64;
+
+    // Enough for a few nested levels of double buffering at MAX_BUFFER_LEN
+    static const std::size_t kDefaultCapacity;
+
+    explicit RealtimeArena(std::size_t capacity = kDefaultCapacity);
+    ~RealtimeArena();
+
+    // Returns nullptr if the arena is exhausted.
+    void* allocate(std::size_t bytes, std::size_t alignment = kAlignment);
+    CSAMPLE* allocateSamples(SINT numSamples) {
+        return static_cast<CSAMPLE*>(allocate(numSamples * sizeof(CSAMPLE)));
+    }
+
+    std::size_t mark() const {
+        return m_bytesUsed;
+    }
+    // Releases everything allocated since mark() returned the given value.
+    void rewind(std::size_t mark);
+    void reset() {
+        m_bytesUsed = 0;
+    }
+
+    std::size_t capacity() const {
+        return m_capacity;
+    }
+    std::size_t bytesUsed() const {
+        return m_bytesUsed;
+    }
+    // The largest number of bytes that have been in use at the same time
+    std::size_t highWaterMark() const {
+        return m_highWaterMark;
+    }
+
+    // The arena installed for the calling thread. Threads that have not
+    // installed one get a thread local arena on first use, which allocates.
+    static RealtimeArena* current();
+
+    // Resets the arena and installs it for the calling thread until the end
+    // of the scope.
+    class Scope {
+      public:
+        explicit Scope(RealtimeArena* pArena);
+        ~Scope();
+
+      private:
+        RealtimeArena* const m_pPrevious;
+
+        DISALLOW_COPY_AND_ASSIGN(Scope);
+    };
+
+    // Scratch memory of the current arena that is released at the end of
+    // the scope.
+    class Frame {
+      public:
+        Frame()
+                : m_pArena(current()),
+                  m_mark(m_pArena->mark()) {
+        }
+        ~Frame() {
+            m_pArena->rewind(m_mark);
+        }
+
+        CSAMPLE* allocateSamples(SINT numSamples) {
+            return m_pArena->allocateSamples(numSamples);
+        }
+
+      private:
+        RealtimeArena* const m_pArena;
+        const std::size_t m_mark;
+
+        DISALLOW_COPY_AND_ASSIGN(Frame);
+    };
+
+  private:
+    char* m_pStorage;
+    char* m_pBegin;
+    const std::size_t m_capacity;
+    std::size_t m_bytesUsed;
+    std::size_t m_highWaterMark;
+
+    static thread_local RealtimeArena* s_pCurrent;
+
+    DISALLOW_COPY_AND_ASSIGN(RealtimeArena);
+};
@@ -0,0 +1,336 @@
+#include "util/realtimeguard.h"
+
+#include <QtGlobal>
+
+#include <cstdlib>
+
+#include <atomic>
+
+#ifdef MIXXX_RT_ALLOC_DETECTOR
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <pthread.h>
+
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QtDebug>
+#endif
+
+thread_local int RealtimeGuard::s_realtimeDepth = 0;
+
+namespace {
+
+std::atomic<int> s_violationCount(0);
+
+} // anonymous namespace
+
+#ifndef MIXXX_RT_ALLOC_DETECTOR
+
+// static
+bool RealtimeGuard::isEnabled() {
+    return false;
+}
+
+// static
+void RealtimeGuard::install() {
+}
+
+// static
+void RealtimeGuard::uninstall() {
+}
+
+// static
+void RealtimeGuard::reportViolation(Violation violation) {
+    Q_UNUSED(violation);
+    s_violationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+#else // MIXXX_RT_ALLOC_DETECTOR
+
+#ifndef __GLIBC__
+#error "The realtime allocation detector requires the GNU C library"
+#endif
+
+namespace {
+
+const int kMaxFrames = 48;
+const int kNumRecords = 64;
+// How often the reporter thread looks for new records.
+const unsigned long kReportIntervalMillis = 250;
+
+enum RecordState {
+    kRecordFree,
+    kRecordWriting,
+    kRecordReady,
+};
+
+// A call stack captured on a realtime thread. Records are written with
+// nothing but atomic operations and backtrace(), which does not allocate
+// after it has been primed in RealtimeGuard::install().
+struct ViolationRecord {
+    std::atomic<int> state;
+    RealtimeGuard::Violation violation;
+    int numFrames;
+    void* frames[kMaxFrames];
+};
+
+ViolationRecord s_records[kNumRecords];
+std::atomic<unsigned int> s_nextRecord(0);
+std::atomic<int> s_droppedRecords(0);
+std::atomic<bool> s_recording(false);
+
+// Set while a violation is recorded, so that allocations and locks made by
+// backtrace() itself are not recorded.
+thread_local bool s_inHook = false;
+
+const char* violationName(RealtimeGuard::Violation violation) {
+    switch (violation) {
+    case RealtimeGuard::Violation::Allocation:
+        return "allocation";
+    case RealtimeGuard::Violation::Deallocation:
+        return "deallocation";
+    case RealtimeGuard::Violation::MutexLock:
+        return "mutex lock";
+    }
+    return "unknown";
+}
+
+class ReporterThread : public QThread {
+  public:
+    ReporterThread()
+            : m_bStop(false) {
+        setObjectName("RealtimeGuard");
+    }
+
+    void stop() {
+        m_bStop.store(true);
+    }
+
+  protected:
+    void run() override {
+        while (!m_bStop.load()) {
+            msleep(kReportIntervalMillis);
+            reportRecords();
+        }
+        reportRecords();
+    }
+
+  private:
+    void reportRecords() {
+        for (ViolationRecord& record : s_records) {
+            if (record.state.load(std::memory_order_acquire) != kRecordReady) {
+                continue;
+            }
+            const uint hash = qHashBits(record.frames,
+                    record.numFrames * sizeof(void*),
+                    static_cast<uint>(record.violation));
+            if (!m_reportedStacks.contains(hash)) {
+                m_reportedStacks.insert(hash);
+                qWarning() << "RealtimeGuard:"
+                           << violationName(record.violation)
+                           << "on realtime thread, call stack:";
+                char** symbols = backtrace_symbols(
+                        record.frames, record.numFrames);
+                // Skip reportViolation() and the hook itself
+                for (int i = 2; i < record.numFrames; ++i) {
+                    qWarning() << "    " << (symbols ? symbols[i] : "?");
+                }
+                std::free(symbols);
+            }
+            record.state.store(kRecordFree, std::memory_order_release);
+        }
+        const int dropped = s_droppedRecords.exchange(0);
+        if (dropped > 0) {
+            qWarning() << "RealtimeGuard:" << dropped
+                       << "violations were not recorded";
+        }
+    }
+
+    std::atomic<bool> m_bStop;
+    QSet<uint> m_reportedStacks;
+};
+
+ReporterThread* s_pReporterThread = nullptr;
+
+// Looks up the next definition of a hooked symbol, i.e. the one in the
+// library that we are hiding.
+template<typename Function>
+Function nextSymbol(std::atomic<Function>* pFunction, const char* name) {
+    Function function = pFunction->load(std::memory_order_relaxed);
+    if (!function) {
+        function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        pFunction->store(function, std::memory_order_relaxed);
+    }
+    return function;
+}
+
+typedef int (*PthreadMutexLockFunction)(pthread_mutex_t*);
+typedef void (*QtLockFunction)(void*);
+
+std::atomic<PthreadMutexLockFunction> s_pthreadMutexLock(nullptr);
+std::atomic<QtLockFunction> s_qBasicMutexLockInternal(nullptr);
+std::atomic<QtLockFunction> s_qReadWriteLockLockForRead(nullptr);
+std::atomic<QtLockFunction> s_qReadWriteLockLockForWrite(nullptr);
+
+const char kQBasicMutexLockInternal[] = "_ZN11QBasicMutex12lockInternalEv";
+const char kQReadWriteLockLockForRead[] = "_ZN14QReadWriteLock11lockForReadEv";
+const char kQReadWriteLockLockForWrite[] = "_ZN14QReadWriteLock12lockForWriteEv";
+
+} // anonymous namespace
+
+// static
+bool RealtimeGuard::isEnabled() {
+    return true;
+}
+
+// static
+void RealtimeGuard::install() {
+    if (s_pReporterThread) {
+        return;
+    }
+    // The first call of backtrace() loads the unwinder, which allocates
+    void* frames[kMaxFrames];
+    backtrace(frames, kMaxFrames);
+    nextSymbol(&s_pthreadMutexLock, "pthread_mutex_lock");
+    nextSymbol(&s_qBasicMutexLockInternal, kQBasicMutexLockInternal);
+    nextSymbol(&s_qReadWriteLockLockForRead, kQReadWriteLockLockForRead);
+    nextSymbol(&s_qReadWriteLockLockForWrite, kQReadWriteLockLockForWrite);
+
+    s_pReporterThread = new ReporterThread();
+    s_pReporterThread->start(QThread::LowestPriority);
+    s_recording.store(true);
+    qDebug() << "RealtimeGuard: reporting allocations and locks on realtime threads";
+}
+
+// static
+void RealtimeGuard::uninstall() {
+    if (!s_pReporterThread) {
+        return;
+    }
+    s_recording.store(false);
+    s_pReporterThread->stop();
+    s_pReporterThread->wait();
+    delete s_pReporterThread;
+    s_pReporterThread = nullptr;
+}
+
+// static
+void RealtimeGuard::reportViolation(Violation violation) {
+    if (s_inHook) {
+        return;
+    }
+    s_inHook = true;
+    s_violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (s_recording.load(std::memory_order_relaxed)) {
+        ViolationRecord& record = s_records[
+                s_nextRecord.fetch_add(1, std::memory_order_relaxed) % kNumRecords];
+        int expected = kRecordFree;
+        if (record.state.compare_exchange_strong(expected, kRecordWriting,
+                    std::memory_order_acquire)) {
+            record.violation = violation;
+            record.numFrames = backtrace(record.frames, kMaxFrames);
+            record.state.store(kRecordReady, std::memory_order_release);
+        } else {
+            // The reporter has not caught up yet
+            s_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    s_inHook = false;
+}
+
+// The hooks below replace the definitions in glibc and Qt for the whole
+// process, because symbols of the executable take precedence over those of
+// shared libraries. They forward to the original definitions.
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) __THROW {
+    RealtimeGuard::check(RealtimeGuard::Violation::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) __THROW {
+    RealtimeGuard::check(RealtimeGuard::Violation::Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) __THROW {
+    RealtimeGuard::check(RealtimeGuard::Violation::Allocation);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) __THROW {
+    RealtimeGuard::check(RealtimeGuard::Violation::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) __THROW {
+    RealtimeGuard::check(RealtimeGuard::Violation::Allocation);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pPtr, size_t alignment, size_t size) __THROW {
+    RealtimeGuard::check(RealtimeGuard::Violation::Allocation);
+    if (alignment % sizeof(void*) != 0 ||
+            (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *pPtr = ptr;
+    return 0;
+}
+
+void free(void* ptr) __THROW {
+    if (ptr) {
+        RealtimeGuard::check(RealtimeGuard::Violation::Deallocation);
+    }
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* pMutex) __THROWNL {
+    RealtimeGuard::check(RealtimeGuard::Violation::MutexLock);
+    return nextSymbol(&s_pthreadMutexLock, "pthread_mutex_lock")(pMutex);
+}
+
+// QMutex::lock() is inline and only calls into QtCore if the mutex is
+// contended, which is the case that blocks.
+void mixxxQBasicMutexLockInternal(void* pMutex)
+        __asm__("_ZN11QBasicMutex12lockInternalEv");
+void mixxxQBasicMutexLockInternal(void* pMutex) {
+    RealtimeGuard::check(RealtimeGuard::Violation::MutexLock);
+    nextSymbol(&s_qBasicMutexLockInternal, kQBasicMutexLockInternal)(pMutex);
+}
+
+void mixxxQReadWriteLockLockForRead(void* pLock)
+        __asm__("_ZN14QReadWriteLock11lockForReadEv");
+void mixxxQReadWriteLockLockForRead(void* pLock) {
+    RealtimeGuard::check(RealtimeGuard::Violation::MutexLock);
+    nextSymbol(&s_qReadWriteLockLockForRead, kQReadWriteLockLockForRead)(pLock);
+}
+
+void mixxxQReadWriteLockLockForWrite(void* pLock)
+        __asm__("_ZN14QReadWriteLock12lockForWriteEv");
+void mixxxQReadWriteLockLockForWrite(void* pLock) {
+    RealtimeGuard::check(RealtimeGuard::Violation::MutexLock);
+    nextSymbol(&s_qReadWriteLockLockForWrite, kQReadWriteLockLockForWrite)(pLock);
+}
+
+} // extern "C"
+
+#endif // MIXXX_RT_ALLOC_DETECTOR
+
+// static
+int RealtimeGuard::violationCount() {
+    return s_violationCount.load(std::memory_order_relaxed);
+}
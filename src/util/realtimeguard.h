@@ -0,0 +1,68 @@
+#pragma once
+
+#include "util/class.h"
+
+// Detection of blocking operations on the realtime audio threads.
+//
+// Threads that must never block, i.e. the sound device callbacks and the
+// engine helper threads, mark themselves with a ScopedRealtimeThread while
+// they process audio. Builds configured with MIXXX_RT_ALLOC_DETECTOR
+// (cmake -DRT_ALLOC_DETECTOR=ON or scons rt_alloc_detector=1) hook malloc(),
+// free() and their relatives, contended QMutex locks, QReadWriteLock locks
+// and pthread mutex locks. Every call from a marked thread is recorded with
+// its call stack, and a background thread logs each distinct call stack once.
+//
+// Without the detector marking a thread is a thread local increment.
+class RealtimeGuard {
+  public:
+    enum class Violation {
+        Allocation,
+        Deallocation,
+        MutexLock,
+    };
+
+    // Whether the hooks are compiled in.
+    static bool isEnabled();
+
+    // Primes the stack unwinder and starts the thread that logs the
+    // recorded call stacks. Call once from the main thread before any audio
+    // runs. Violations are only counted, but not recorded, before that.
+    static void install();
+    static void uninstall();
+
+    static bool isRealtimeThread() {
+        return s_realtimeDepth > 0;
+    }
+
+    // Records a violation of the calling thread if it is marked realtime.
+    static void check(Violation violation) {
+        if (isRealtimeThread()) {
+            reportViolation(violation);
+        }
+    }
+
+    // The number of violations since the start of the process.
+    static int violationCount();
+
+  private:
+    static void reportViolation(Violation violation);
+
+    static thread_local int s_realtimeDepth;
+
+    friend class ScopedRealtimeThread;
+};
+
+// Marks the calling thread as realtime until the end of the scope. Scopes
+// may be nested.
+class ScopedRealtimeThread {
+  public:
+    ScopedRealtimeThread() {
+        ++RealtimeGuard::s_realtimeDepth;
+    }
+    ~ScopedRealtimeThread() {
+        --RealtimeGuard::s_realtimeDepth;
+    }
+
+  private:
+    DISALLOW_COPY_AND_ASSIGN(ScopedRealtimeThread);
+};
@@ -3,6 +3,7 @@
 
 #include "util/sample.h"
 #include "util/math.h"
+#include "util/sample_simd.h"
 
 #ifdef __WINDOWS__
 #include <QtGlobal>
@@ -34,8 +35,176 @@ constexpr bool useAlignedAlloc() {
             sizeof(CSAMPLE*) == sizeof(size_t);
 }
 
+// The scalar reference implementations of the kernels in
+// mixxx::simd::SampleKernels as vectorized by the compiler.
+
+void applyRampingGainBaseline(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        // a loop counter i += 2 prevents vectorizing.
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+void addWithRampingGainBaseline(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void copyWithRampingGainBaseline(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    // note: LOOP VECTORIZED only with "int i"
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addToBothWithRampingGainBaseline(
+        CSAMPLE* M_RESTRICT pDest1, CSAMPLE_GAIN startGain1, CSAMPLE_GAIN gainDelta1,
+        CSAMPLE* M_RESTRICT pDest2, CSAMPLE_GAIN startGain2, CSAMPLE_GAIN gainDelta2,
+        const CSAMPLE* M_RESTRICT pSrc, SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        const CSAMPLE left = pSrc[i * 2];
+        const CSAMPLE right = pSrc[i * 2 + 1];
+        pDest1[i * 2] += left * gain1;
+        pDest1[i * 2 + 1] += right * gain1;
+        pDest2[i * 2] += left * gain2;
+        pDest2[i * 2 + 1] += right * gain2;
+    }
+}
+
+void sumAbsPerChannelBaseline(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+        int* pClippedL, int* pClippedR,
+        const CSAMPLE* pBuffer, SINT numFrames) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE clippedL = 0;
+    CSAMPLE clippedR = 0;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = static_cast<int>(clippedL);
+    *pClippedR = static_cast<int>(clippedR);
+}
+
+void copyClampBufferBaseline(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc, SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = SampleUtil::clampSample(pSrc[i]);
+    }
+}
+
+void interleaveBufferBaseline(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBufferBaseline(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const mixxx::simd::SampleKernels kBaselineSampleKernels = {
+        applyRampingGainBaseline,
+        addWithRampingGainBaseline,
+        copyWithRampingGainBaseline,
+        addToBothWithRampingGainBaseline,
+        sumAbsPerChannelBaseline,
+        copyClampBufferBaseline,
+        interleaveBufferBaseline,
+        deinterleaveBufferBaseline,
+};
+
+const mixxx::simd::SampleKernels* sampleKernelsForLevel(
+        SampleUtil::SimdLevel level) {
+    switch (level) {
+    case SampleUtil::SimdLevel::Baseline:
+        return &kBaselineSampleKernels;
+    case SampleUtil::SimdLevel::AVX2:
+        return mixxx::simd::avx2SampleKernels();
+    case SampleUtil::SimdLevel::AVX512:
+        return mixxx::simd::avx512SampleKernels();
+    case SampleUtil::SimdLevel::NEON:
+        return mixxx::simd::neonSampleKernels();
+    }
+    return nullptr;
+}
+
+// Constant initialized, i.e. valid even if SampleUtil is used by other
+// static initializers before the best level has been selected below.
+const mixxx::simd::SampleKernels* s_pSampleKernels = &kBaselineSampleKernels;
+SampleUtil::SimdLevel s_simdLevel = SampleUtil::SimdLevel::Baseline;
+
+bool selectBestSimdLevel() {
+    return SampleUtil::setSimdLevel(SampleUtil::SimdLevel::AVX512) ||
+            SampleUtil::setSimdLevel(SampleUtil::SimdLevel::AVX2) ||
+            SampleUtil::setSimdLevel(SampleUtil::SimdLevel::NEON);
+}
+
+const bool s_bSimdLevelSelected = selectBestSimdLevel();
+
 } // anonymous namespace
 
+// static
+SampleUtil::SimdLevel SampleUtil::simdLevel() {
+    return s_simdLevel;
+}
+
+// static
+bool SampleUtil::isSimdLevelSupported(SimdLevel level) {
+    return sampleKernelsForLevel(level) != nullptr;
+}
+
+// static
+bool SampleUtil::setSimdLevel(SimdLevel level) {
+    const mixxx::simd::SampleKernels* pKernels = sampleKernelsForLevel(level);
+    if (!pKernels) {
+        return false;
+    }
+    s_pSampleKernels = pKernels;
+    s_simdLevel = level;
+    return true;
+}
+
 // static
 CSAMPLE* SampleUtil::alloc(SINT size) {
     // To speed up vectorization we align our sample buffers to 16-byte (128
@@ -137,13 +306,8 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
+        s_pSampleKernels->applyRampingGain(
+                pBuffer, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -245,12 +409,8 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
+        s_pSampleKernels->addWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -259,6 +419,30 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
     }
 }
 
+// static
+void SampleUtil::addToBothWithRampingGain(
+        CSAMPLE* M_RESTRICT pDest1, CSAMPLE_GAIN old_gain1, CSAMPLE_GAIN new_gain1,
+        CSAMPLE* M_RESTRICT pDest2, CSAMPLE_GAIN old_gain2, CSAMPLE_GAIN new_gain2,
+        const CSAMPLE* M_RESTRICT pSrc, SINT numSamples) {
+    if (old_gain1 == CSAMPLE_GAIN_ZERO && new_gain1 == CSAMPLE_GAIN_ZERO) {
+        return addWithRampingGain(pDest2, pSrc, old_gain2, new_gain2, numSamples);
+    }
+    if (old_gain2 == CSAMPLE_GAIN_ZERO && new_gain2 == CSAMPLE_GAIN_ZERO) {
+        return addWithRampingGain(pDest1, pSrc, old_gain1, new_gain1, numSamples);
+    }
+
+    const CSAMPLE_GAIN gain_delta1 = (new_gain1 - old_gain1)
+            / CSAMPLE_GAIN(numSamples / 2);
+    const CSAMPLE_GAIN start_gain1 = old_gain1 + gain_delta1;
+    const CSAMPLE_GAIN gain_delta2 = (new_gain2 - old_gain2)
+            / CSAMPLE_GAIN(numSamples / 2);
+    const CSAMPLE_GAIN start_gain2 = old_gain2 + gain_delta2;
+    s_pSampleKernels->addToBothWithRampingGain(
+            pDest1, start_gain1, gain_delta1,
+            pDest2, start_gain2, gain_delta2,
+            pSrc, numSamples / 2);
+}
+
 // static
 void SampleUtil::add2WithGain(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1, CSAMPLE_GAIN gain1,
@@ -338,12 +522,8 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i"
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        s_pSampleKernels->copyWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (SINT i = 0; i < numSamples; ++i) {
@@ -384,24 +564,11 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
-    CSAMPLE clippedL = 0;
-    CSAMPLE clippedR = 0;
+    int clippedL = 0;
+    int clippedR = 0;
+    s_pSampleKernels->sumAbsPerChannel(
+            pfAbsL, pfAbsR, &clippedL, &clippedR, pBuffer, numSamples / 2);
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
-
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
     SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
     if (clippedL > 0) {
         clipping |= SampleUtil::CLIPPING_LEFT;
@@ -415,10 +582,7 @@ SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
 // static
 void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < iNumSamples; ++i) {
-        pDest[i] = clampSample(pSrc[i]);
-    }
+    s_pSampleKernels->copyClampBuffer(pDest, pSrc, iNumSamples);
 }
 
 // static
@@ -426,11 +590,7 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    s_pSampleKernels->interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
@@ -438,11 +598,7 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
         CSAMPLE* M_RESTRICT pDest2,
         const CSAMPLE* M_RESTRICT pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 2];
-        pDest2[i] = pSrc[i * 2 + 1];
-    }
+    s_pSampleKernels->deinterleaveBuffer(pDest1, pDest2, pSrc, numFrames);
 }
 
 // static
@@ -474,6 +630,17 @@ void SampleUtil::mixStereoToMono(CSAMPLE* pDest, const CSAMPLE* pSrc,
     }
 }
 
+// static
+void SampleUtil::downmixStereoToMono(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc, SINT numSamples) {
+    const CSAMPLE_GAIN mixScale = CSAMPLE_GAIN_ONE
+            / (CSAMPLE_GAIN_ONE + CSAMPLE_GAIN_ONE);
+    // note: LOOP VECTORIZED
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        pDest[i] = (pSrc[i * 2] + pSrc[i * 2 + 1]) * mixScale;
+    }
+}
+
 // static
 void SampleUtil::doubleMonoToDualMono(CSAMPLE* pBuffer, SINT numFrames) {
     // backward loop
@@ -21,6 +21,25 @@ class SampleUtil {
     };
     Q_DECLARE_FLAGS(CLIP_STATUS, CLIP_FLAG);
 
+    // The instruction set extensions that are used by the hot kernels
+    // applyRampingGain(), addWithRampingGain(), copyWithRampingGain(),
+    // sumAbsPerChannel(), copyClampBuffer(), interleaveBuffer() and
+    // deinterleaveBuffer(). The best level that is supported by the CPU is
+    // selected at startup. Baseline uses the code as vectorized by the
+    // compiler for the target of the build.
+    enum class SimdLevel {
+        Baseline,
+        AVX2,
+        AVX512,
+        NEON,
+    };
+    static SimdLevel simdLevel();
+    static bool isSimdLevelSupported(SimdLevel level);
+    // Switches the kernels to the given level. Returns false and keeps the
+    // current level if it is not supported. Not thread-safe, intended for
+    // tests and benchmarks.
+    static bool setSimdLevel(SimdLevel level);
+
     // The PlayPosition, Loops and Cue Points used in the Database and
     // Mixxx CO interface are expressed as a floating point number of stereo samples.
     // This is some legacy, we cannot easily revert.
@@ -173,6 +192,14 @@ class SampleUtil {
             CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain,
             SINT numSamples);
 
+    // Add each sample of pSrc, multiplied by a ramping gain for each
+    // destination, to pDest1 and pDest2. Same as two calls of
+    // addWithRampingGain(), but pSrc is only read once.
+    static void addToBothWithRampingGain(
+            CSAMPLE* pDest1, CSAMPLE_GAIN old_gain1, CSAMPLE_GAIN new_gain1,
+            CSAMPLE* pDest2, CSAMPLE_GAIN old_gain2, CSAMPLE_GAIN new_gain2,
+            const CSAMPLE* pSrc, SINT numSamples);
+
     // Add to each sample of pDest, pSrc1 multiplied by gain1 plus pSrc2
     // multiplied by gain2
     static void add2WithGain(CSAMPLE* pDest, const CSAMPLE* pSrc1,
@@ -237,6 +264,12 @@ class SampleUtil {
     static void mixStereoToMono(CSAMPLE* pDest, const CSAMPLE* pSrc,
             SINT numSamples);
 
+    // Mix a stereo buffer down to a mono buffer with (L+R)/2.
+    // (numSamples) samples will be read from pSrc
+    // (numSamples / 2) samples will be written into pDest
+    static void downmixStereoToMono(CSAMPLE* pDest, const CSAMPLE* pSrc,
+            SINT numSamples);
+
     // In-place doubles the mono samples in pBuffer to dual mono samples.
     // (numFrames) samples will be read from pBuffer
     // (numFrames * 2) samples will be written into pBuffer
@@ -0,0 +1,773 @@
+#include "util/sample_simd.h"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MIXXX_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC accepts all intrinsics without enabling the instruction set
+#define MIXXX_TARGET_AVX2
+#define MIXXX_TARGET_AVX512
+#else
+#include <cpuid.h>
+#define MIXXX_TARGET_AVX2 __attribute__((target("avx2")))
+#define MIXXX_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MIXXX_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace mixxx {
+
+namespace simd {
+
+namespace {
+
+#ifdef MIXXX_SIMD_X86
+
+void cpuid(int leaf, int subleaf, unsigned int regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuidex(info, leaf, subleaf);
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned int>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+unsigned int maxCpuidLeaf() {
+    unsigned int regs[4];
+    cpuid(0, 0, regs);
+    return regs[0];
+}
+
+// The enabled register states in XCR0. The OS must save and restore the
+// wide registers on context switches, otherwise they can't be used.
+unsigned long long xgetbv0() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    unsigned int eax;
+    unsigned int edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+constexpr unsigned int kCpuid1EcxOsxsave = 1u << 27;
+constexpr unsigned int kCpuid1EcxAvx = 1u << 28;
+constexpr unsigned int kCpuid7EbxAvx2 = 1u << 5;
+constexpr unsigned int kCpuid7EbxAvx512f = 1u << 16;
+constexpr unsigned long long kXcr0SseAvx = 0x06;
+constexpr unsigned long long kXcr0Avx512 = 0xE0;
+
+bool cpuSupportsAvx(unsigned long long* pXcr0) {
+    if (maxCpuidLeaf() < 7) {
+        return false;
+    }
+    unsigned int regs[4];
+    cpuid(1, 0, regs);
+    if ((regs[2] & kCpuid1EcxOsxsave) == 0 || (regs[2] & kCpuid1EcxAvx) == 0) {
+        return false;
+    }
+    *pXcr0 = xgetbv0();
+    return (*pXcr0 & kXcr0SseAvx) == kXcr0SseAvx;
+}
+
+bool cpuSupportsAvx2() {
+    unsigned long long xcr0;
+    if (!cpuSupportsAvx(&xcr0)) {
+        return false;
+    }
+    unsigned int regs[4];
+    cpuid(7, 0, regs);
+    return (regs[1] & kCpuid7EbxAvx2) != 0;
+}
+
+bool cpuSupportsAvx512f() {
+    unsigned long long xcr0;
+    if (!cpuSupportsAvx(&xcr0) || (xcr0 & kXcr0Avx512) != kXcr0Avx512) {
+        return false;
+    }
+    unsigned int regs[4];
+    cpuid(7, 0, regs);
+    return (regs[1] & kCpuid7EbxAvx512f) != 0;
+}
+
+// AVX2: 8 samples = 4 stereo frames per register
+
+MIXXX_TARGET_AVX2
+void applyRampingGainAvx2(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const __m256 frameOffsets = _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 delta = _mm256_set1_ps(gainDelta);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 frames = _mm256_add_ps(
+                _mm256_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m256 gain = _mm256_add_ps(start, _mm256_mul_ps(delta, frames));
+        const __m256 samples = _mm256_loadu_ps(pBuffer + i * 2);
+        _mm256_storeu_ps(pBuffer + i * 2, _mm256_mul_ps(samples, gain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+MIXXX_TARGET_AVX2
+void addWithRampingGainAvx2(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const __m256 frameOffsets = _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 delta = _mm256_set1_ps(gainDelta);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 frames = _mm256_add_ps(
+                _mm256_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m256 gain = _mm256_add_ps(start, _mm256_mul_ps(delta, frames));
+        const __m256 src = _mm256_loadu_ps(pSrc + i * 2);
+        const __m256 dest = _mm256_loadu_ps(pDest + i * 2);
+        _mm256_storeu_ps(pDest + i * 2,
+                _mm256_add_ps(dest, _mm256_mul_ps(src, gain)));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+MIXXX_TARGET_AVX2
+void addToBothWithRampingGainAvx2(
+        CSAMPLE* pDest1, CSAMPLE_GAIN startGain1, CSAMPLE_GAIN gainDelta1,
+        CSAMPLE* pDest2, CSAMPLE_GAIN startGain2, CSAMPLE_GAIN gainDelta2,
+        const CSAMPLE* pSrc, SINT numFrames) {
+    const __m256 frameOffsets = _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256 start1 = _mm256_set1_ps(startGain1);
+    const __m256 delta1 = _mm256_set1_ps(gainDelta1);
+    const __m256 start2 = _mm256_set1_ps(startGain2);
+    const __m256 delta2 = _mm256_set1_ps(gainDelta2);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 frames = _mm256_add_ps(
+                _mm256_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m256 gain1 = _mm256_add_ps(start1, _mm256_mul_ps(delta1, frames));
+        const __m256 gain2 = _mm256_add_ps(start2, _mm256_mul_ps(delta2, frames));
+        const __m256 src = _mm256_loadu_ps(pSrc + i * 2);
+        const __m256 dest1 = _mm256_loadu_ps(pDest1 + i * 2);
+        const __m256 dest2 = _mm256_loadu_ps(pDest2 + i * 2);
+        _mm256_storeu_ps(pDest1 + i * 2,
+                _mm256_add_ps(dest1, _mm256_mul_ps(src, gain1)));
+        _mm256_storeu_ps(pDest2 + i * 2,
+                _mm256_add_ps(dest2, _mm256_mul_ps(src, gain2)));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest1[i * 2] += pSrc[i * 2] * gain1;
+        pDest1[i * 2 + 1] += pSrc[i * 2 + 1] * gain1;
+        pDest2[i * 2] += pSrc[i * 2] * gain2;
+        pDest2[i * 2 + 1] += pSrc[i * 2 + 1] * gain2;
+    }
+}
+
+MIXXX_TARGET_AVX2
+void copyWithRampingGainAvx2(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const __m256 frameOffsets = _mm256_setr_ps(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 delta = _mm256_set1_ps(gainDelta);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 frames = _mm256_add_ps(
+                _mm256_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m256 gain = _mm256_add_ps(start, _mm256_mul_ps(delta, frames));
+        const __m256 src = _mm256_loadu_ps(pSrc + i * 2);
+        _mm256_storeu_ps(pDest + i * 2, _mm256_mul_ps(src, gain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+MIXXX_TARGET_AVX2
+void sumAbsPerChannelAvx2(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+        int* pClippedL, int* pClippedR,
+        const CSAMPLE* pBuffer, SINT numFrames) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 peak = _mm256_set1_ps(CSAMPLE_PEAK);
+    __m256 sums = _mm256_setzero_ps();
+    __m256i clipped = _mm256_setzero_si256();
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 abs = _mm256_and_ps(_mm256_loadu_ps(pBuffer + i * 2), absMask);
+        sums = _mm256_add_ps(sums, abs);
+        // The comparison yields -1 for every clipped sample
+        clipped = _mm256_sub_epi32(clipped,
+                _mm256_castps_si256(_mm256_cmp_ps(abs, peak, _CMP_GT_OQ)));
+    }
+    float laneSums[8];
+    int laneClipped[8];
+    _mm256_storeu_ps(laneSums, sums);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(laneClipped), clipped);
+    CSAMPLE fAbsL = laneSums[0] + laneSums[2] + laneSums[4] + laneSums[6];
+    CSAMPLE fAbsR = laneSums[1] + laneSums[3] + laneSums[5] + laneSums[7];
+    int clippedL = laneClipped[0] + laneClipped[2] + laneClipped[4] + laneClipped[6];
+    int clippedR = laneClipped[1] + laneClipped[3] + laneClipped[5] + laneClipped[7];
+    for (; i < numFrames; ++i) {
+        const CSAMPLE absl = std::abs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        const CSAMPLE absr = std::abs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = clippedL;
+    *pClippedR = clippedR;
+}
+
+MIXXX_TARGET_AVX2
+void copyClampBufferAvx2(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        SINT numSamples) {
+    const __m256 max = _mm256_set1_ps(CSAMPLE_PEAK);
+    const __m256 min = _mm256_set1_ps(-CSAMPLE_PEAK);
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m256 samples = _mm256_loadu_ps(pSrc + i);
+        _mm256_storeu_ps(pDest + i,
+                _mm256_min_ps(_mm256_max_ps(samples, min), max));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE_clamp(pSrc[i]);
+    }
+}
+
+MIXXX_TARGET_AVX2
+void interleaveBufferAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1, const CSAMPLE* pSrc2, SINT numFrames) {
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256 src1 = _mm256_loadu_ps(pSrc1 + i);
+        const __m256 src2 = _mm256_loadu_ps(pSrc2 + i);
+        // Unpacking works within the 128-bit lanes: 0 1 4 5 and 2 3 6 7
+        const __m256 lo = _mm256_unpacklo_ps(src1, src2);
+        const __m256 hi = _mm256_unpackhi_ps(src1, src2);
+        _mm256_storeu_ps(pDest + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(pDest + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+MIXXX_TARGET_AVX2
+void deinterleaveBufferAvx2(CSAMPLE* pDest1, CSAMPLE* pDest2,
+        const CSAMPLE* pSrc, SINT numFrames) {
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256 frames0 = _mm256_loadu_ps(pSrc + i * 2);
+        const __m256 frames1 = _mm256_loadu_ps(pSrc + i * 2 + 8);
+        // Shuffling works within the 128-bit lanes: 0 1 4 5 2 3 6 7
+        const __m256 left = _mm256_shuffle_ps(frames0, frames1, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m256 right = _mm256_shuffle_ps(frames0, frames1, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm256_storeu_ps(pDest1 + i, _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(left), _MM_SHUFFLE(3, 1, 2, 0))));
+        _mm256_storeu_ps(pDest2 + i, _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(right), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    for (; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const SampleKernels kAvx2SampleKernels = {
+        applyRampingGainAvx2,
+        addWithRampingGainAvx2,
+        copyWithRampingGainAvx2,
+        addToBothWithRampingGainAvx2,
+        sumAbsPerChannelAvx2,
+        copyClampBufferAvx2,
+        interleaveBufferAvx2,
+        deinterleaveBufferAvx2,
+};
+
+// AVX-512: 16 samples = 8 stereo frames per register
+
+alignas(64) const float kAvx512FrameOffsets[16] = {
+        0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7};
+// Indices into the concatenation of two registers for permutex2var
+alignas(64) const int kAvx512InterleaveLo[16] = {
+        0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23};
+alignas(64) const int kAvx512InterleaveHi[16] = {
+        8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31};
+alignas(64) const int kAvx512Even[16] = {
+        0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30};
+alignas(64) const int kAvx512Odd[16] = {
+        1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31};
+
+MIXXX_TARGET_AVX512
+void applyRampingGainAvx512(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const __m512 frameOffsets = _mm512_load_ps(kAvx512FrameOffsets);
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 delta = _mm512_set1_ps(gainDelta);
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 frames = _mm512_add_ps(
+                _mm512_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(delta, frames));
+        const __m512 samples = _mm512_loadu_ps(pBuffer + i * 2);
+        _mm512_storeu_ps(pBuffer + i * 2, _mm512_mul_ps(samples, gain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+MIXXX_TARGET_AVX512
+void addWithRampingGainAvx512(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const __m512 frameOffsets = _mm512_load_ps(kAvx512FrameOffsets);
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 delta = _mm512_set1_ps(gainDelta);
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 frames = _mm512_add_ps(
+                _mm512_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(delta, frames));
+        const __m512 src = _mm512_loadu_ps(pSrc + i * 2);
+        const __m512 dest = _mm512_loadu_ps(pDest + i * 2);
+        _mm512_storeu_ps(pDest + i * 2,
+                _mm512_add_ps(dest, _mm512_mul_ps(src, gain)));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+MIXXX_TARGET_AVX512
+void addToBothWithRampingGainAvx512(
+        CSAMPLE* pDest1, CSAMPLE_GAIN startGain1, CSAMPLE_GAIN gainDelta1,
+        CSAMPLE* pDest2, CSAMPLE_GAIN startGain2, CSAMPLE_GAIN gainDelta2,
+        const CSAMPLE* pSrc, SINT numFrames) {
+    const __m512 frameOffsets = _mm512_load_ps(kAvx512FrameOffsets);
+    const __m512 start1 = _mm512_set1_ps(startGain1);
+    const __m512 delta1 = _mm512_set1_ps(gainDelta1);
+    const __m512 start2 = _mm512_set1_ps(startGain2);
+    const __m512 delta2 = _mm512_set1_ps(gainDelta2);
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 frames = _mm512_add_ps(
+                _mm512_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m512 gain1 = _mm512_add_ps(start1, _mm512_mul_ps(delta1, frames));
+        const __m512 gain2 = _mm512_add_ps(start2, _mm512_mul_ps(delta2, frames));
+        const __m512 src = _mm512_loadu_ps(pSrc + i * 2);
+        const __m512 dest1 = _mm512_loadu_ps(pDest1 + i * 2);
+        const __m512 dest2 = _mm512_loadu_ps(pDest2 + i * 2);
+        _mm512_storeu_ps(pDest1 + i * 2,
+                _mm512_add_ps(dest1, _mm512_mul_ps(src, gain1)));
+        _mm512_storeu_ps(pDest2 + i * 2,
+                _mm512_add_ps(dest2, _mm512_mul_ps(src, gain2)));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest1[i * 2] += pSrc[i * 2] * gain1;
+        pDest1[i * 2 + 1] += pSrc[i * 2 + 1] * gain1;
+        pDest2[i * 2] += pSrc[i * 2] * gain2;
+        pDest2[i * 2 + 1] += pSrc[i * 2 + 1] * gain2;
+    }
+}
+
+MIXXX_TARGET_AVX512
+void copyWithRampingGainAvx512(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const __m512 frameOffsets = _mm512_load_ps(kAvx512FrameOffsets);
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 delta = _mm512_set1_ps(gainDelta);
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 frames = _mm512_add_ps(
+                _mm512_set1_ps(static_cast<float>(i)), frameOffsets);
+        const __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(delta, frames));
+        const __m512 src = _mm512_loadu_ps(pSrc + i * 2);
+        _mm512_storeu_ps(pDest + i * 2, _mm512_mul_ps(src, gain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+MIXXX_TARGET_AVX512
+void sumAbsPerChannelAvx512(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+        int* pClippedL, int* pClippedR,
+        const CSAMPLE* pBuffer, SINT numFrames) {
+    const __m512i absMask = _mm512_set1_epi32(0x7FFFFFFF);
+    const __m512 peak = _mm512_set1_ps(CSAMPLE_PEAK);
+    const __m512i one = _mm512_set1_epi32(1);
+    __m512 sums = _mm512_setzero_ps();
+    __m512i clipped = _mm512_setzero_si512();
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 abs = _mm512_castsi512_ps(_mm512_and_epi32(
+                _mm512_castps_si512(_mm512_loadu_ps(pBuffer + i * 2)), absMask));
+        sums = _mm512_add_ps(sums, abs);
+        const __mmask16 clippedMask = _mm512_cmp_ps_mask(abs, peak, _CMP_GT_OQ);
+        clipped = _mm512_mask_add_epi32(clipped, clippedMask, clipped, one);
+    }
+    float laneSums[16];
+    int laneClipped[16];
+    _mm512_storeu_ps(laneSums, sums);
+    _mm512_storeu_si512(laneClipped, clipped);
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    int clippedL = 0;
+    int clippedR = 0;
+    for (int lane = 0; lane < 16; lane += 2) {
+        fAbsL += laneSums[lane];
+        fAbsR += laneSums[lane + 1];
+        clippedL += laneClipped[lane];
+        clippedR += laneClipped[lane + 1];
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE absl = std::abs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        const CSAMPLE absr = std::abs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = clippedL;
+    *pClippedR = clippedR;
+}
+
+MIXXX_TARGET_AVX512
+void copyClampBufferAvx512(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        SINT numSamples) {
+    const __m512 max = _mm512_set1_ps(CSAMPLE_PEAK);
+    const __m512 min = _mm512_set1_ps(-CSAMPLE_PEAK);
+    SINT i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        const __m512 samples = _mm512_loadu_ps(pSrc + i);
+        _mm512_storeu_ps(pDest + i,
+                _mm512_min_ps(_mm512_max_ps(samples, min), max));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE_clamp(pSrc[i]);
+    }
+}
+
+MIXXX_TARGET_AVX512
+void interleaveBufferAvx512(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1, const CSAMPLE* pSrc2, SINT numFrames) {
+    const __m512i lo = _mm512_load_si512(kAvx512InterleaveLo);
+    const __m512i hi = _mm512_load_si512(kAvx512InterleaveHi);
+    SINT i = 0;
+    for (; i + 16 <= numFrames; i += 16) {
+        const __m512 src1 = _mm512_loadu_ps(pSrc1 + i);
+        const __m512 src2 = _mm512_loadu_ps(pSrc2 + i);
+        _mm512_storeu_ps(pDest + i * 2, _mm512_permutex2var_ps(src1, lo, src2));
+        _mm512_storeu_ps(pDest + i * 2 + 16, _mm512_permutex2var_ps(src1, hi, src2));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+MIXXX_TARGET_AVX512
+void deinterleaveBufferAvx512(CSAMPLE* pDest1, CSAMPLE* pDest2,
+        const CSAMPLE* pSrc, SINT numFrames) {
+    const __m512i even = _mm512_load_si512(kAvx512Even);
+    const __m512i odd = _mm512_load_si512(kAvx512Odd);
+    SINT i = 0;
+    for (; i + 16 <= numFrames; i += 16) {
+        const __m512 frames0 = _mm512_loadu_ps(pSrc + i * 2);
+        const __m512 frames1 = _mm512_loadu_ps(pSrc + i * 2 + 16);
+        _mm512_storeu_ps(pDest1 + i, _mm512_permutex2var_ps(frames0, even, frames1));
+        _mm512_storeu_ps(pDest2 + i, _mm512_permutex2var_ps(frames0, odd, frames1));
+    }
+    for (; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const SampleKernels kAvx512SampleKernels = {
+        applyRampingGainAvx512,
+        addWithRampingGainAvx512,
+        copyWithRampingGainAvx512,
+        addToBothWithRampingGainAvx512,
+        sumAbsPerChannelAvx512,
+        copyClampBufferAvx512,
+        interleaveBufferAvx512,
+        deinterleaveBufferAvx512,
+};
+
+#endif // MIXXX_SIMD_X86
+
+#ifdef MIXXX_SIMD_NEON
+
+// NEON: 4 samples = 2 stereo frames per register, or 4 frames per
+// register pair when loading deinterleaved with vld2q
+
+void applyRampingGainNeon(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const float frameOffsetsArray[4] = {0, 0, 1, 1};
+    const float32x4_t frameOffsets = vld1q_f32(frameOffsetsArray);
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t delta = vdupq_n_f32(gainDelta);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const float32x4_t frames = vaddq_f32(
+                vdupq_n_f32(static_cast<float>(i)), frameOffsets);
+        const float32x4_t gain = vaddq_f32(start, vmulq_f32(delta, frames));
+        const float32x4_t samples = vld1q_f32(pBuffer + i * 2);
+        vst1q_f32(pBuffer + i * 2, vmulq_f32(samples, gain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+void addWithRampingGainNeon(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const float frameOffsetsArray[4] = {0, 0, 1, 1};
+    const float32x4_t frameOffsets = vld1q_f32(frameOffsetsArray);
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t delta = vdupq_n_f32(gainDelta);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const float32x4_t frames = vaddq_f32(
+                vdupq_n_f32(static_cast<float>(i)), frameOffsets);
+        const float32x4_t gain = vaddq_f32(start, vmulq_f32(delta, frames));
+        const float32x4_t src = vld1q_f32(pSrc + i * 2);
+        const float32x4_t dest = vld1q_f32(pDest + i * 2);
+        vst1q_f32(pDest + i * 2, vaddq_f32(dest, vmulq_f32(src, gain)));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addToBothWithRampingGainNeon(
+        CSAMPLE* pDest1, CSAMPLE_GAIN startGain1, CSAMPLE_GAIN gainDelta1,
+        CSAMPLE* pDest2, CSAMPLE_GAIN startGain2, CSAMPLE_GAIN gainDelta2,
+        const CSAMPLE* pSrc, SINT numFrames) {
+    const float frameOffsetsArray[4] = {0, 0, 1, 1};
+    const float32x4_t frameOffsets = vld1q_f32(frameOffsetsArray);
+    const float32x4_t start1 = vdupq_n_f32(startGain1);
+    const float32x4_t delta1 = vdupq_n_f32(gainDelta1);
+    const float32x4_t start2 = vdupq_n_f32(startGain2);
+    const float32x4_t delta2 = vdupq_n_f32(gainDelta2);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const float32x4_t frames = vaddq_f32(
+                vdupq_n_f32(static_cast<float>(i)), frameOffsets);
+        const float32x4_t gain1 = vaddq_f32(start1, vmulq_f32(delta1, frames));
+        const float32x4_t gain2 = vaddq_f32(start2, vmulq_f32(delta2, frames));
+        const float32x4_t src = vld1q_f32(pSrc + i * 2);
+        const float32x4_t dest1 = vld1q_f32(pDest1 + i * 2);
+        const float32x4_t dest2 = vld1q_f32(pDest2 + i * 2);
+        vst1q_f32(pDest1 + i * 2, vaddq_f32(dest1, vmulq_f32(src, gain1)));
+        vst1q_f32(pDest2 + i * 2, vaddq_f32(dest2, vmulq_f32(src, gain2)));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest1[i * 2] += pSrc[i * 2] * gain1;
+        pDest1[i * 2 + 1] += pSrc[i * 2 + 1] * gain1;
+        pDest2[i * 2] += pSrc[i * 2] * gain2;
+        pDest2[i * 2 + 1] += pSrc[i * 2 + 1] * gain2;
+    }
+}
+
+void copyWithRampingGainNeon(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames) {
+    const float frameOffsetsArray[4] = {0, 0, 1, 1};
+    const float32x4_t frameOffsets = vld1q_f32(frameOffsetsArray);
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t delta = vdupq_n_f32(gainDelta);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const float32x4_t frames = vaddq_f32(
+                vdupq_n_f32(static_cast<float>(i)), frameOffsets);
+        const float32x4_t gain = vaddq_f32(start, vmulq_f32(delta, frames));
+        const float32x4_t src = vld1q_f32(pSrc + i * 2);
+        vst1q_f32(pDest + i * 2, vmulq_f32(src, gain));
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void sumAbsPerChannelNeon(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+        int* pClippedL, int* pClippedR,
+        const CSAMPLE* pBuffer, SINT numFrames) {
+    const float32x4_t peak = vdupq_n_f32(CSAMPLE_PEAK);
+    float32x4_t sumsL = vdupq_n_f32(0);
+    float32x4_t sumsR = vdupq_n_f32(0);
+    uint32x4_t clippedL = vdupq_n_u32(0);
+    uint32x4_t clippedR = vdupq_n_u32(0);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const float32x4x2_t frames = vld2q_f32(pBuffer + i * 2);
+        const float32x4_t absL = vabsq_f32(frames.val[0]);
+        const float32x4_t absR = vabsq_f32(frames.val[1]);
+        sumsL = vaddq_f32(sumsL, absL);
+        sumsR = vaddq_f32(sumsR, absR);
+        // The comparison yields all bits set, i.e. -1, for clipped samples
+        clippedL = vsubq_u32(clippedL, vcgtq_f32(absL, peak));
+        clippedR = vsubq_u32(clippedR, vcgtq_f32(absR, peak));
+    }
+    float laneSumsL[4];
+    float laneSumsR[4];
+    uint32_t laneClippedL[4];
+    uint32_t laneClippedR[4];
+    vst1q_f32(laneSumsL, sumsL);
+    vst1q_f32(laneSumsR, sumsR);
+    vst1q_u32(laneClippedL, clippedL);
+    vst1q_u32(laneClippedR, clippedR);
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    int countL = 0;
+    int countR = 0;
+    for (int lane = 0; lane < 4; ++lane) {
+        fAbsL += laneSumsL[lane];
+        fAbsR += laneSumsR[lane];
+        countL += static_cast<int>(laneClippedL[lane]);
+        countR += static_cast<int>(laneClippedR[lane]);
+    }
+    for (; i < numFrames; ++i) {
+        const CSAMPLE absl = std::abs(pBuffer[i * 2]);
+        fAbsL += absl;
+        countL += absl > CSAMPLE_PEAK ? 1 : 0;
+        const CSAMPLE absr = std::abs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        countR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = countL;
+    *pClippedR = countR;
+}
+
+void copyClampBufferNeon(CSAMPLE* pDest, const CSAMPLE* pSrc,
+        SINT numSamples) {
+    const float32x4_t max = vdupq_n_f32(CSAMPLE_PEAK);
+    const float32x4_t min = vdupq_n_f32(-CSAMPLE_PEAK);
+    SINT i = 0;
+    for (; i + 4 <= numSamples; i += 4) {
+        const float32x4_t samples = vld1q_f32(pSrc + i);
+        vst1q_f32(pDest + i, vminq_f32(vmaxq_f32(samples, min), max));
+    }
+    for (; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE_clamp(pSrc[i]);
+    }
+}
+
+void interleaveBufferNeon(CSAMPLE* pDest,
+        const CSAMPLE* pSrc1, const CSAMPLE* pSrc2, SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        float32x4x2_t frames;
+        frames.val[0] = vld1q_f32(pSrc1 + i);
+        frames.val[1] = vld1q_f32(pSrc2 + i);
+        vst2q_f32(pDest + i * 2, frames);
+    }
+    for (; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBufferNeon(CSAMPLE* pDest1, CSAMPLE* pDest2,
+        const CSAMPLE* pSrc, SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const float32x4x2_t frames = vld2q_f32(pSrc + i * 2);
+        vst1q_f32(pDest1 + i, frames.val[0]);
+        vst1q_f32(pDest2 + i, frames.val[1]);
+    }
+    for (; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const SampleKernels kNeonSampleKernels = {
+        applyRampingGainNeon,
+        addWithRampingGainNeon,
+        copyWithRampingGainNeon,
+        addToBothWithRampingGainNeon,
+        sumAbsPerChannelNeon,
+        copyClampBufferNeon,
+        interleaveBufferNeon,
+        deinterleaveBufferNeon,
+};
+
+#endif // MIXXX_SIMD_NEON
+
+} // anonymous namespace
+
+const SampleKernels* avx2SampleKernels() {
+#ifdef MIXXX_SIMD_X86
+    static const bool supported = cpuSupportsAvx2();
+    return supported ? &kAvx2SampleKernels : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const SampleKernels* avx512SampleKernels() {
+#ifdef MIXXX_SIMD_X86
+    static const bool supported = cpuSupportsAvx512f();
+    return supported ? &kAvx512SampleKernels : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+const SampleKernels* neonSampleKernels() {
+#ifdef MIXXX_SIMD_NEON
+    // NEON is part of the ABI when the compiler is allowed to use it
+    return &kNeonSampleKernels;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace simd
+
+} // namespace mixxx
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "util/types.h"
+
+// Hand-written SIMD implementations of the hot SampleUtil kernels. They are
+// only used by SampleUtil, which picks the best supported instruction set
+// at runtime. Distribution builds only target the SSE2 baseline, so
+// the compiler will never use wider registers on its own.
+//
+// All ramping kernels process stereo frames and apply the gain
+// startGain + gainDelta * i to both samples of frame i, exactly like the
+// scalar reference in sample.cpp.
+namespace mixxx {
+
+namespace simd {
+
+struct SampleKernels {
+    void (*applyRampingGain)(CSAMPLE* pBuffer,
+            CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames);
+    void (*addWithRampingGain)(CSAMPLE* pDest, const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames);
+    void (*copyWithRampingGain)(CSAMPLE* pDest, const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain, CSAMPLE_GAIN gainDelta, SINT numFrames);
+    // Reads each sample of pSrc only once for both destinations
+    void (*addToBothWithRampingGain)(
+            CSAMPLE* pDest1, CSAMPLE_GAIN startGain1, CSAMPLE_GAIN gainDelta1,
+            CSAMPLE* pDest2, CSAMPLE_GAIN startGain2, CSAMPLE_GAIN gainDelta2,
+            const CSAMPLE* pSrc, SINT numFrames);
+    // Returns the number of clipped samples in the left and right channel
+    // in pClippedL and pClippedR.
+    void (*sumAbsPerChannel)(CSAMPLE* pfAbsL, CSAMPLE* pfAbsR,
+            int* pClippedL, int* pClippedR,
+            const CSAMPLE* pBuffer, SINT numFrames);
+    void (*copyClampBuffer)(CSAMPLE* pDest, const CSAMPLE* pSrc,
+            SINT numSamples);
+    void (*interleaveBuffer)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc1, const CSAMPLE* pSrc2, SINT numFrames);
+    void (*deinterleaveBuffer)(CSAMPLE* pDest1, CSAMPLE* pDest2,
+            const CSAMPLE* pSrc, SINT numFrames);
+};
+
+// The kernels for an instruction set or nullptr if they are not available
+// in this build or not supported by the CPU.
+const SampleKernels* avx2SampleKernels();
+const SampleKernels* avx512SampleKernels();
+const SampleKernels* neonSampleKernels();
+
+} // namespace simd
+
+} // namespace mixxx
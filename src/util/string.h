@@ -22,6 +22,12 @@ class StringCollator {
         return m_collator.compare(s1, s2);
     }
 
+    // Comparing sort keys is much faster than comparing the strings when
+    // each string is compared many times.
+    QCollatorSortKey sortKey(const QString& s) const {
+        return m_collator.sortKey(s);
+    }
+
   private:
     QCollator m_collator;
 };
@@ -2,6 +2,7 @@
 
 #include "waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
 #include "waveform/waveformwidgetfactory.h"
 #include "control/controlproxy.h"
 #include "widget/wskincolor.h"
@@ -69,6 +70,13 @@ void WaveformRendererFilteredSignal::draw(QPainter* painter,
     const double gain = (lastVisualIndex - firstVisualIndex) /
             (double)m_waveformRenderer->getLength();
 
+    // When zoomed out read from the level of the pyramid that has about one
+    // entry per pixel instead of scanning all visual samples of each pixel.
+    const WaveformPyramid* pPyramid = waveform->getPyramid();
+    const int level = pPyramid ? pPyramid->levelForFrames(gain / 2.0) : 0;
+    const WaveformData* levelData = level > 0 ? pPyramid->levelData(level) : data;
+    const int levelDataSize = level > 0 ? pPyramid->levelSize(level) : dataSize;
+
     // Per-band gain from the EQ knobs.
     float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
     getGains(&allGain, &lowGain, &midGain, &highGain);
@@ -124,8 +132,8 @@ void WaveformRendererFilteredSignal::draw(QPainter* painter,
         visualFrameStart = math_clamp(visualFrameStart, 0, lastVisualFrame);
         visualFrameStop = math_clamp(visualFrameStop, 0, lastVisualFrame);
 
-        int visualIndexStart = visualFrameStart * 2;
-        int visualIndexStop = visualFrameStop * 2;
+        int visualIndexStart = (visualFrameStart >> level) * 2;
+        int visualIndexStop = (visualFrameStop >> level) * 2;
 
         // if (x == m_waveformRenderer->getLength() / 2) {
         //     qDebug() << "audioVisualRatio" << waveform->getAudioVisualRatio();
@@ -143,9 +151,9 @@ void WaveformRendererFilteredSignal::draw(QPainter* painter,
         unsigned char maxHigh[2] = {0, 0};
 
         for (int i = visualIndexStart;
-             i >= 0 && i + 1 < dataSize && i + 1 <= visualIndexStop; i += 2) {
-            const WaveformData& waveformData = *(data + i);
-            const WaveformData& waveformDataNext = *(data + i + 1);
+             i >= 0 && i + 1 < levelDataSize && i + 1 <= visualIndexStop; i += 2) {
+            const WaveformData& waveformData = *(levelData + i);
+            const WaveformData& waveformDataNext = *(levelData + i + 1);
             maxLow[0] = math_max(maxLow[0], waveformData.filtered.low);
             maxLow[1] = math_max(maxLow[1], waveformDataNext.filtered.low);
             maxMid[0] = math_max(maxMid[0], waveformData.filtered.mid);
@@ -2,6 +2,7 @@
 
 #include "waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
 #include "waveform/waveformwidgetfactory.h"
 
 #include "widget/wskincolor.h"
@@ -65,6 +66,13 @@ void WaveformRendererHSV::draw(QPainter* painter,
     const double gain = (lastVisualIndex - firstVisualIndex) /
             (double)m_waveformRenderer->getLength();
 
+    // When zoomed out read from the level of the pyramid that has about one
+    // entry per pixel instead of scanning all visual samples of each pixel.
+    const WaveformPyramid* pPyramid = waveform->getPyramid();
+    const int level = pPyramid ? pPyramid->levelForFrames(gain / 2.0) : 0;
+    const WaveformData* levelData = level > 0 ? pPyramid->levelData(level) : data;
+    const int levelDataSize = level > 0 ? pPyramid->levelSize(level) : dataSize;
+
     float allGain(1.0);
     getGains(&allGain, NULL, NULL, NULL);
 
@@ -120,8 +128,8 @@ void WaveformRendererHSV::draw(QPainter* painter,
         visualFrameStart = math_clamp(visualFrameStart, 0, lastVisualFrame);
         visualFrameStop = math_clamp(visualFrameStop, 0, lastVisualFrame);
 
-        int visualIndexStart = visualFrameStart * 2;
-        int visualIndexStop = visualFrameStop * 2;
+        int visualIndexStart = (visualFrameStart >> level) * 2;
+        int visualIndexStop = (visualFrameStop >> level) * 2;
 
         int maxLow[2] = {0, 0};
         int maxHigh[2] = {0, 0};
@@ -129,9 +137,9 @@ void WaveformRendererHSV::draw(QPainter* painter,
         int maxAll[2] = {0, 0};
 
         for (int i = visualIndexStart;
-             i >= 0 && i + 1 < dataSize && i + 1 <= visualIndexStop; i += 2) {
-            const WaveformData& waveformData = *(data + i);
-            const WaveformData& waveformDataNext = *(data + i + 1);
+             i >= 0 && i + 1 < levelDataSize && i + 1 <= visualIndexStop; i += 2) {
+            const WaveformData& waveformData = *(levelData + i);
+            const WaveformData& waveformDataNext = *(levelData + i + 1);
             maxLow[0] = math_max(maxLow[0], (int)waveformData.filtered.low);
             maxLow[1] = math_max(maxLow[1], (int)waveformDataNext.filtered.low);
             maxMid[0] = math_max(maxMid[0], (int)waveformData.filtered.mid);
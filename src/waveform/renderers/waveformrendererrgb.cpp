@@ -2,6 +2,7 @@
 
 #include "waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
 #include "waveform/waveformwidgetfactory.h"
 
 #include "widget/wskincolor.h"
@@ -64,6 +65,13 @@ void WaveformRendererRGB::draw(QPainter* painter,
     const double gain = (lastVisualIndex - firstVisualIndex) /
             (double)m_waveformRenderer->getLength();
 
+    // When zoomed out read from the level of the pyramid that has about one
+    // entry per pixel instead of scanning all visual samples of each pixel.
+    const WaveformPyramid* pPyramid = waveform->getPyramid();
+    const int level = pPyramid ? pPyramid->levelForFrames(gain / 2.0) : 0;
+    const WaveformData* levelData = level > 0 ? pPyramid->levelData(level) : data;
+    const int levelDataSize = level > 0 ? pPyramid->levelSize(level) : dataSize;
+
     // Per-band gain from the EQ knobs.
     float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
     getGains(&allGain, &lowGain, &midGain, &highGain);
@@ -111,8 +119,8 @@ void WaveformRendererRGB::draw(QPainter* painter,
         visualFrameStart = math_clamp(visualFrameStart, 0, lastVisualFrame);
         visualFrameStop = math_clamp(visualFrameStop, 0, lastVisualFrame);
 
-        int visualIndexStart = visualFrameStart * 2;
-        int visualIndexStop  = visualFrameStop * 2;
+        int visualIndexStart = (visualFrameStart >> level) * 2;
+        int visualIndexStop  = (visualFrameStop >> level) * 2;
 
         unsigned char maxLow  = 0;
         unsigned char maxMid  = 0;
@@ -121,9 +129,9 @@ void WaveformRendererRGB::draw(QPainter* painter,
         float maxAllNext = 0.;
 
         for (int i = visualIndexStart;
-             i >= 0 && i + 1 < dataSize && i + 1 <= visualIndexStop; i += 2) {
-            const WaveformData& waveformData = data[i];
-            const WaveformData& waveformDataNext = data[i + 1];
+             i >= 0 && i + 1 < levelDataSize && i + 1 <= visualIndexStop; i += 2) {
+            const WaveformData& waveformData = levelData[i];
+            const WaveformData& waveformDataNext = levelData[i + 1];
 
             maxLow  = math_max3(maxLow,  waveformData.filtered.low,  waveformDataNext.filtered.low);
             maxMid  = math_max3(maxMid,  waveformData.filtered.mid,  waveformDataNext.filtered.mid);
@@ -1,6 +1,8 @@
+#include <QFile>
 #include <QtDebug>
 
 #include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
 #include "proto/waveform.pb.h"
 
 using namespace mixxx::track;
@@ -21,6 +23,9 @@ Waveform::Waveform(const QByteArray data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
+          m_textureSize(0),
+          m_pPyramid(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
@@ -33,6 +38,9 @@ Waveform::Waveform(int audioSampleRate, int audioSamples,
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
+          m_textureSize(0),
+          m_pPyramid(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
@@ -64,7 +72,48 @@ Waveform::Waveform(int audioSampleRate, int audioSamples,
     setCompletion(0);
 }
 
+Waveform::Waveform(std::unique_ptr<QFile> pMappedFile,
+        std::vector<WaveformData> storage,
+        WaveformData* pMappedData,
+        int dataSize,
+        int textureStride,
+        int textureSize,
+        double visualSampleRate,
+        double audioVisualRatio,
+        const WaveformData* pMappedPyramidLevels)
+        : m_id(-1),
+          m_saveState(SaveState::Saved),
+          m_dataSize(dataSize),
+          // Moving the vector keeps the address of its data
+          m_data(std::move(storage)),
+          m_pData(pMappedData),
+          m_textureSize(textureSize),
+          m_pMappedFile(std::move(pMappedFile)),
+          m_pPyramid(nullptr),
+          m_visualSampleRate(visualSampleRate),
+          m_audioVisualRatio(audioVisualRatio),
+          m_textureStride(textureStride),
+          m_completion(dataSize) {
+    if (pMappedPyramidLevels) {
+        m_pPyramid.storeRelease(new WaveformPyramid(
+                m_pData, m_dataSize, pMappedPyramidLevels));
+    }
+}
+
 Waveform::~Waveform() {
+    delete m_pPyramid.loadAcquire();
+}
+
+void Waveform::buildPyramid() {
+    if (m_pPyramid.loadAcquire()) {
+        return;
+    }
+    auto pPyramid = new WaveformPyramid(m_pData, m_dataSize);
+    // Only the analyzer or the loading thread builds the pyramid, but
+    // renderers might read it concurrently
+    if (!m_pPyramid.testAndSetOrdered(nullptr, pPyramid)) {
+        delete pPyramid;
+    }
 }
 
 QByteArray Waveform::toByteArray() const {
@@ -108,7 +157,7 @@ QByteArray Waveform::toByteArray() const {
 
     int dataSize = getDataSize();
     for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
+        const WaveformData& datum = m_pData[i];
         all->add_value(datum.filtered.all);
         low->add_value(datum.filtered.low);
         mid->add_value(datum.filtered.mid);
@@ -185,13 +234,13 @@ void Waveform::readByteArray(const QByteArray& data) {
     bool mid_valid = mid.units() == io::Waveform::RMS;
     bool high_valid = high.units() == io::Waveform::RMS;
     for (int i = 0; i < dataSize; ++i) {
-        m_data[i].filtered.all = static_cast<unsigned char>(all.value(i));
+        m_pData[i].filtered.all = static_cast<unsigned char>(all.value(i));
         bool use_low = low_valid && i < low.value_size();
         bool use_mid = mid_valid && i < mid.value_size();
         bool use_high = high_valid && i < high.value_size();
-        m_data[i].filtered.low = use_low ? static_cast<unsigned char>(low.value(i)) : 0;
-        m_data[i].filtered.mid = use_mid ? static_cast<unsigned char>(mid.value(i)) : 0;
-        m_data[i].filtered.high = use_high ? static_cast<unsigned char>(high.value(i)) : 0;
+        m_pData[i].filtered.low = use_low ? static_cast<unsigned char>(low.value(i)) : 0;
+        m_pData[i].filtered.mid = use_mid ? static_cast<unsigned char>(mid.value(i)) : 0;
+        m_pData[i].filtered.high = use_high ? static_cast<unsigned char>(high.value(i)) : 0;
     }
     m_completion = dataSize;
     m_saveState = SaveState::Saved;
@@ -201,12 +250,16 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    m_pData = m_data.data();
+    m_textureSize = static_cast<int>(m_data.size());
 }
 
 void Waveform::assign(int size, int value) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, value);
+    m_pData = m_data.data();
+    m_textureSize = static_cast<int>(m_data.size());
     m_saveState = SaveState::SavePending;
 }
 
@@ -214,6 +267,8 @@ void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size("+QString::number(getDataSize())+")"
              << "textureStride("+QString::number(m_textureStride)+")"
+             << "textureSize("+QString::number(m_textureSize)+")"
+             << "mapped("+QString(isMapped() ? "true" : "false")+")"
              << "completion("+QString::number(getCompletion())+")"
              << "visualSampleRate("+QString::number(m_visualSampleRate)+")"
              << "audioVisualRatio("+QString::number(m_audioVisualRatio)+")";
@@ -1,18 +1,23 @@
 #ifndef WAVEFORM_H
 #define WAVEFORM_H
 
+#include <memory>
 #include <vector>
 
 #include <QMutex>
 #include <QByteArray>
 #include <QString>
 #include <QAtomicInt>
+#include <QAtomicPointer>
 #include <QSharedPointer>
 #include <QMutexLocker>
 
 #include "util/class.h"
 #include "util/compatibility.h"
 
+class QFile;
+class WaveformPyramid;
+
 enum FilterIndex { Low = 0, Mid = 1, High = 2, FilterCount = 3};
 enum ChannelIndex { Left = 0, Right = 1, ChannelCount = 2};
 
@@ -110,41 +115,70 @@ class Waveform {
     // the constructor runs.
     inline int getTextureStride() const { return m_textureStride; }
 
-    // We do not lock the mutex since m_data is not resized after the
+    // We do not lock the mutex since m_textureSize is not changed after the
     // constructor runs.
-    inline int getTextureSize() const { return static_cast<int>(m_data.size()); }
+    inline int getTextureSize() const { return m_textureSize; }
 
     // Atomically get the number of data elements in this Waveform. We do not
     // lock the mutex since m_dataSize is not changed after the constructor
     // runs.
     inline int getDataSize() const { return m_dataSize; }
 
-    inline const WaveformData& get(int i) const { return m_data[i];}
-    inline unsigned char getLow(int i) const { return m_data[i].filtered.low;}
-    inline unsigned char getMid(int i) const { return m_data[i].filtered.mid;}
-    inline unsigned char getHigh(int i) const { return m_data[i].filtered.high;}
-    inline unsigned char getAll(int i) const { return m_data[i].filtered.all;}
+    inline const WaveformData& get(int i) const { return m_pData[i];}
+    inline unsigned char getLow(int i) const { return m_pData[i].filtered.low;}
+    inline unsigned char getMid(int i) const { return m_pData[i].filtered.mid;}
+    inline unsigned char getHigh(int i) const { return m_pData[i].filtered.high;}
+    inline unsigned char getAll(int i) const { return m_pData[i].filtered.all;}
 
-    // We do not lock the mutex since m_data is not resized after the
+    // We do not lock the mutex since m_pData is not changed after the
     // constructor runs.
-    WaveformData* data() { return &m_data[0];}
+    WaveformData* data() { return m_pData;}
 
-    // We do not lock the mutex since m_data is not resized after the
+    // We do not lock the mutex since m_pData is not changed after the
     // constructor runs.
-    const WaveformData* data() const { return &m_data[0];}
+    const WaveformData* data() const { return m_pData;}
+
+    // True if the data is mapped from a file (see WaveformFile) instead
+    // of being allocated on the heap.
+    bool isMapped() const {
+        return static_cast<bool>(m_pMappedFile);
+    }
+
+    // Builds the WaveformPyramid of the data once the waveform has been
+    // analyzed completely. Does nothing if it already exists.
+    void buildPyramid();
+
+    // Returns nullptr until the pyramid has been built or loaded. The
+    // pyramid lives as long as the waveform.
+    const WaveformPyramid* getPyramid() const {
+        return m_pPyramid.loadAcquire();
+    }
 
     void dump() const;
 
   private:
+    friend class WaveformFile;
+    // Adopts the data of a waveform file that is either mapped into memory
+    // (pMappedFile) or has been read into storage
+    Waveform(std::unique_ptr<QFile> pMappedFile,
+            std::vector<WaveformData> storage,
+            WaveformData* pMappedData,
+            int dataSize,
+            int textureStride,
+            int textureSize,
+            double visualSampleRate,
+            double audioVisualRatio,
+            const WaveformData* pMappedPyramidLevels);
+
     void readByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size, int value = 0);
 
-    inline WaveformData& at(int i) { return m_data[i];}
-    inline unsigned char& low(int i) { return m_data[i].filtered.low;}
-    inline unsigned char& mid(int i) { return m_data[i].filtered.mid;}
-    inline unsigned char& high(int i) { return m_data[i].filtered.high;}
-    inline unsigned char& all(int i) { return m_data[i].filtered.all;}
+    inline WaveformData& at(int i) { return m_pData[i];}
+    inline unsigned char& low(int i) { return m_pData[i].filtered.low;}
+    inline unsigned char& mid(int i) { return m_pData[i].filtered.mid;}
+    inline unsigned char& high(int i) { return m_pData[i].filtered.high;}
+    inline unsigned char& all(int i) { return m_pData[i].filtered.all;}
     double getVisualSampleRate() const { return m_visualSampleRate; }
 
     // If stored in the database, the ID of the waveform.
@@ -162,9 +196,18 @@ class Waveform {
     // a texture in the GLSL renderer. The size is not allowed to change after
     // the constructor runs. We use a std::vector to avoid the cost of bounds
     // checking when accessing the vector.
-    // TODO(XXX): In the future we should switch to QVector and use the raw data
-    // pointer when performance matters.
+    // Empty if the data is mapped from a file. Holds the pyramid levels
+    // after the data if read from a file.
     std::vector<WaveformData> m_data;
+    // Points to either the data of m_data or into the mapped file.
+    WaveformData* m_pData;
+    // The number of elements available at m_pData, a multiple of
+    // m_textureStride. Not allowed to change after the constructor runs.
+    int m_textureSize;
+    // Owns the mapping of the data
+    std::unique_ptr<QFile> m_pMappedFile;
+    // Published once and owned by the waveform
+    QAtomicPointer<const WaveformPyramid> m_pPyramid;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
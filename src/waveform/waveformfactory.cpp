@@ -4,9 +4,15 @@
 #include "waveform/waveform.h"
 
 // static
-Waveform* WaveformFactory::loadWaveformFromAnalysis(
+WaveformPointer WaveformFactory::loadWaveformFromAnalysis(
         const AnalysisDao::AnalysisInfo& analysis) {
-    Waveform* pWaveform = new Waveform(analysis.data);
+    WaveformPointer pWaveform = analysis.pWaveform;
+    if (!pWaveform) {
+        pWaveform = WaveformPointer(new Waveform(analysis.data));
+    }
+    // Legacy blobs and files of version 1 have no pyramid. Building it
+    // only takes a single pass over the data.
+    pWaveform->buildPyramid();
     pWaveform->setId(analysis.analysisId);
     pWaveform->setVersion(analysis.version);
     pWaveform->setDescription(analysis.description);
@@ -2,8 +2,7 @@
 #define WAVEFORMFACTORY_H
 
 #include "library/dao/analysisdao.h"
-
-class Waveform;
+#include "waveform/waveform.h"
 
 #define WAVEFORM_2_VERSION "Waveform-2.0"
 #define WAVEFORMSUMMARY_2_VERSION "WaveformSummary-2.0"
@@ -42,7 +41,9 @@ class WaveformFactory {
         VC_REMOVE
     };
 
-    static Waveform* loadWaveformFromAnalysis(
+    // Mapped analyses are shared with the AnalysisInfo, legacy blobs
+    // are deserialized into a new waveform.
+    static WaveformPointer loadWaveformFromAnalysis(
             const AnalysisDao::AnalysisInfo& analysis);
     static VersionClass waveformVersionToVersionClass(const QString& version);
     static VersionClass waveformSummaryVersionToVersionClass(const QString& version);
@@ -0,0 +1,254 @@
+#include "waveform/waveformfile.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "waveform/waveformpyramid.h"
+
+namespace {
+
+mixxx::Logger kLogger("WaveformFile");
+
+const QByteArray kMagic = QByteArrayLiteral("MIXXWAVE");
+
+QByteArray serializeHeader(const WaveformFile::Header& header) {
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    stream.writeRawData(kMagic.constData(), kMagic.size());
+    stream << header.formatVersion
+           << header.headerSize
+           << header.dataSize
+           << header.textureStride
+           << header.textureSize
+           << header.visualSampleRate
+           << header.audioVisualRatio
+           << header.pyramidSize;
+    DEBUG_ASSERT(bytes.size() <= WaveformFile::kHeaderSize);
+    // Reserved for future use
+    bytes.append(WaveformFile::kHeaderSize - bytes.size(), '\0');
+    return bytes;
+}
+
+bool deserializeHeader(const QByteArray& bytes, WaveformFile::Header* pHeader) {
+    if (bytes.size() < WaveformFile::kHeaderSize ||
+            !bytes.startsWith(kMagic)) {
+        return false;
+    }
+    QDataStream stream(bytes);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::DoublePrecision);
+    stream.skipRawData(kMagic.size());
+    stream >> pHeader->formatVersion
+           >> pHeader->headerSize
+           >> pHeader->dataSize
+           >> pHeader->textureStride
+           >> pHeader->textureSize
+           >> pHeader->visualSampleRate
+           >> pHeader->audioVisualRatio
+           >> pHeader->pyramidSize;
+    return stream.status() == QDataStream::Ok;
+}
+
+QByteArray readHeader(QFile* pFile) {
+    return pFile->read(WaveformFile::kHeaderSize);
+}
+
+quint16 checksum(const QByteArray& bytes) {
+    return qChecksum(bytes.constData(), bytes.size());
+}
+
+} // anonymous namespace
+
+// static
+WaveformFile::Header WaveformFile::headerOf(const Waveform& waveform) {
+    const int dataSize = waveform.getDataSize();
+    const int textureStride = waveform.getTextureStride();
+    DEBUG_ASSERT(textureStride > 0);
+    // The padding of the texture is only stored up to the last row
+    // that contains data. The GLSL renderer only requires the texture
+    // size to be a multiple of the stride.
+    const int textureRows = (dataSize + textureStride - 1) / textureStride;
+    Header header;
+    header.formatVersion = kFormatVersion;
+    header.headerSize = kHeaderSize;
+    header.dataSize = dataSize;
+    header.textureStride = textureStride;
+    header.textureSize = textureRows * textureStride;
+    header.visualSampleRate = waveform.getVisualSampleRate();
+    header.audioVisualRatio = waveform.getAudioVisualRatio();
+    header.pyramidSize = WaveformPyramid::storageSize(dataSize);
+    return header;
+}
+
+// static
+bool WaveformFile::isWaveformFile(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return file.read(kMagic.size()) == kMagic;
+}
+
+// static
+quint16 WaveformFile::headerChecksum(const Waveform& waveform) {
+    return checksum(serializeHeader(headerOf(waveform)));
+}
+
+// static
+bool WaveformFile::write(
+        const QString& fileName,
+        const Waveform& waveform) {
+    const Header header = headerOf(waveform);
+    VERIFY_OR_DEBUG_ASSERT(header.textureSize <= waveform.getTextureSize()) {
+        return false;
+    }
+    const QByteArray headerBytes = serializeHeader(header);
+
+    // Waveforms that have been loaded from legacy blobs or files without
+    // a pyramid are written with a temporary one
+    std::unique_ptr<WaveformPyramid> pTemporaryPyramid;
+    const WaveformPyramid* pPyramid = waveform.getPyramid();
+    if (!pPyramid) {
+        pTemporaryPyramid = std::make_unique<WaveformPyramid>(
+                waveform.data(), waveform.getDataSize());
+        pPyramid = pTemporaryPyramid.get();
+    }
+
+    // Mapped files are never modified. QSaveFile writes a temporary file
+    // that replaces the previous file atomically on commit(). Mappings of
+    // the previous file keep its contents.
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning()
+                << "Failed to open"
+                << fileName
+                << file.errorString();
+        return false;
+    }
+    // WaveformData consists of 4 bytes and does not depend on the byte order
+    const qint64 dataBytes =
+            static_cast<qint64>(header.textureSize) * sizeof(WaveformData);
+    const qint64 pyramidBytes =
+            static_cast<qint64>(header.pyramidSize) * sizeof(WaveformData);
+    if (file.write(headerBytes) != headerBytes.size() ||
+            file.write(reinterpret_cast<const char*>(waveform.data()),
+                    dataBytes) != dataBytes ||
+            file.write(reinterpret_cast<const char*>(pPyramid->levels()),
+                    pyramidBytes) != pyramidBytes ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to write"
+                << fileName
+                << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// static
+WaveformPointer WaveformFile::map(
+        const QString& fileName,
+        quint16 expectedHeaderChecksum) {
+    auto pFile = std::make_unique<QFile>(fileName);
+    if (!pFile->open(QIODevice::ReadOnly)) {
+        return WaveformPointer();
+    }
+    const QByteArray headerBytes = readHeader(pFile.get());
+    Header header;
+    if (!deserializeHeader(headerBytes, &header)) {
+        kLogger.warning()
+                << "Invalid header of"
+                << fileName;
+        return WaveformPointer();
+    }
+    if (checksum(headerBytes) != expectedHeaderChecksum) {
+        kLogger.warning()
+                << "Corrupt header of"
+                << fileName;
+        return WaveformPointer();
+    }
+    if (header.formatVersion < 1 ||
+            header.formatVersion > static_cast<quint32>(kFormatVersion)) {
+        kLogger.info()
+                << "Unsupported format version"
+                << header.formatVersion
+                << "of"
+                << fileName;
+        return WaveformPointer();
+    }
+    if (header.headerSize < static_cast<quint32>(kHeaderSize) ||
+            header.dataSize < 0 ||
+            header.textureStride <= 0 ||
+            header.textureSize < header.dataSize ||
+            header.textureSize % header.textureStride != 0 ||
+            (header.pyramidSize != 0 &&
+                    header.pyramidSize !=
+                            WaveformPyramid::storageSize(header.dataSize))) {
+        kLogger.warning()
+                << "Inconsistent header of"
+                << fileName;
+        return WaveformPointer();
+    }
+    const qint64 dataBytes =
+            static_cast<qint64>(header.textureSize) * sizeof(WaveformData);
+    // Files of version 1 have no pyramid
+    const qint64 pyramidBytes =
+            static_cast<qint64>(header.pyramidSize) * sizeof(WaveformData);
+    if (pFile->size() < header.headerSize + dataBytes + pyramidBytes) {
+        kLogger.warning()
+                << "Truncated file"
+                << fileName;
+        return WaveformPointer();
+    }
+    WaveformData* pData = nullptr;
+    std::vector<WaveformData> storage;
+#ifdef __WINDOWS__
+    // Windows does not allow to replace a file while it is mapped, which
+    // would prevent write() from updating the analysis of a loaded track.
+    // The contents are read instead.
+    storage.resize(header.textureSize + header.pyramidSize);
+    pData = storage.data();
+    if (!pFile->seek(header.headerSize) ||
+            pFile->read(reinterpret_cast<char*>(pData),
+                    dataBytes + pyramidBytes) != dataBytes + pyramidBytes) {
+        kLogger.warning()
+                << "Failed to read"
+                << fileName
+                << pFile->errorString();
+        return WaveformPointer();
+    }
+    pFile.reset();
+#else
+    if (dataBytes + pyramidBytes > 0) {
+        // Private mappings are never written back to the file. The file
+        // must not be modified while it is mapped, it is only ever
+        // replaced by a new file.
+        uchar* pMapped = pFile->map(header.headerSize,
+                dataBytes + pyramidBytes,
+                QFileDevice::MapPrivateOption);
+        if (!pMapped) {
+            kLogger.warning()
+                    << "Failed to map"
+                    << fileName
+                    << pFile->errorString();
+            return WaveformPointer();
+        }
+        pData = reinterpret_cast<WaveformData*>(pMapped);
+    }
+#endif
+    return WaveformPointer(new Waveform(
+            std::move(pFile),
+            std::move(storage),
+            pData,
+            header.dataSize,
+            header.textureStride,
+            header.textureSize,
+            header.visualSampleRate,
+            header.audioVisualRatio,
+            header.pyramidSize > 0 ? pData + header.textureSize : nullptr));
+}
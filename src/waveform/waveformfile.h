@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include "waveform/waveform.h"
+
+// Stores the data of a Waveform uncompressed in a versioned file that can
+// be mapped into memory instead of being read, inflated and deserialized.
+//
+// The file starts with a fixed size header (little-endian) that is followed
+// by the padded texture data of the waveform and the levels of its
+// WaveformPyramid. Pages of the data are only read when they are accessed
+// and are shared by the page cache if the same file is mapped more than
+// once.
+//
+// Only the header is covered by the checksum since checking the data would
+// require reading the whole file on every load.
+//
+// On Windows the file is read instead of mapped, because a mapped file
+// cannot be replaced.
+class WaveformFile {
+  public:
+    // Version 2 appends the levels of the WaveformPyramid to the data
+    static constexpr int kFormatVersion = 2;
+    static constexpr int kHeaderSize = 64;
+
+    struct Header {
+        Header()
+                : formatVersion(0),
+                  headerSize(0),
+                  dataSize(0),
+                  textureStride(0),
+                  textureSize(0),
+                  visualSampleRate(0),
+                  audioVisualRatio(0),
+                  pyramidSize(0) {
+        }
+        quint32 formatVersion;
+        // The offset of the data
+        quint32 headerSize;
+        qint32 dataSize;
+        qint32 textureStride;
+        // The number of stored elements, a multiple of textureStride
+        qint32 textureSize;
+        double visualSampleRate;
+        double audioVisualRatio;
+        // The number of entries of the pyramid that follows the data
+        qint32 pyramidSize;
+    };
+
+    // Returns true if the file starts with the magic of a waveform file.
+    // Files with other contents are legacy analyses, i.e. compressed
+    // protobuf messages.
+    static bool isWaveformFile(const QString& fileName);
+
+    // Returns the checksum of the header of the file that write() creates
+    // for the waveform. It is stored in the database.
+    static quint16 headerChecksum(const Waveform& waveform);
+
+    // Replaces the file atomically, i.e. mappings of the previous file are
+    // not affected.
+    static bool write(
+            const QString& fileName,
+            const Waveform& waveform);
+
+    // Returns a null pointer if the file is missing, corrupt or has an
+    // unsupported version.
+    static WaveformPointer map(
+            const QString& fileName,
+            quint16 expectedHeaderChecksum);
+
+  private:
+    WaveformFile() = delete;
+
+    static Header headerOf(const Waveform& waveform);
+};
@@ -0,0 +1,95 @@
+#include "waveform/waveformpyramid.h"
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+// Levels contain both channels of each visual frame
+inline int nextLevelSize(int size) {
+    const int frames = size / ChannelCount;
+    return ((frames + 1) / 2) * ChannelCount;
+}
+
+inline WaveformData maxOf(const WaveformData& a, const WaveformData& b) {
+    WaveformData result;
+    result.filtered.low = math_max(a.filtered.low, b.filtered.low);
+    result.filtered.mid = math_max(a.filtered.mid, b.filtered.mid);
+    result.filtered.high = math_max(a.filtered.high, b.filtered.high);
+    result.filtered.all = math_max(a.filtered.all, b.filtered.all);
+    return result;
+}
+
+} // anonymous namespace
+
+WaveformPyramid::WaveformPyramid(const WaveformData* pData, int dataSize)
+        : m_pData(pData),
+          m_pLevels(nullptr) {
+    initLevels(dataSize);
+    m_ownedLevels.resize(storageSize(dataSize));
+    m_pLevels = m_ownedLevels.data();
+    for (int level = 1; level < levelCount(); ++level) {
+        const WaveformData* pPrevious = levelData(level - 1);
+        const int previousFrames = levelSize(level - 1) / ChannelCount;
+        WaveformData* pLevel = m_ownedLevels.data() + m_levelOffsets[level];
+        const int frames = levelSize(level) / ChannelCount;
+        for (int frame = 0; frame < frames; ++frame) {
+            const int first = 2 * frame;
+            // The last frame of an odd number of frames has no neighbor
+            const int second = math_min(first + 1, previousFrames - 1);
+            for (int channel = 0; channel < ChannelCount; ++channel) {
+                pLevel[frame * ChannelCount + channel] = maxOf(
+                        pPrevious[first * ChannelCount + channel],
+                        pPrevious[second * ChannelCount + channel]);
+            }
+        }
+    }
+}
+
+WaveformPyramid::WaveformPyramid(const WaveformData* pData, int dataSize,
+        const WaveformData* pLevels)
+        : m_pData(pData),
+          m_pLevels(pLevels) {
+    initLevels(dataSize);
+}
+
+// static
+int WaveformPyramid::storageSize(int dataSize) {
+    int size = 0;
+    int levelSize = dataSize;
+    while (levelSize > ChannelCount) {
+        levelSize = nextLevelSize(levelSize);
+        size += levelSize;
+    }
+    return size;
+}
+
+void WaveformPyramid::initLevels(int dataSize) {
+    DEBUG_ASSERT(dataSize % ChannelCount == 0);
+    m_levelOffsets.push_back(0);
+    m_levelSizes.push_back(dataSize);
+    int offset = 0;
+    int levelSize = dataSize;
+    while (levelSize > ChannelCount) {
+        levelSize = nextLevelSize(levelSize);
+        m_levelOffsets.push_back(offset);
+        m_levelSizes.push_back(levelSize);
+        offset += levelSize;
+    }
+}
+
+const WaveformData* WaveformPyramid::levelData(int level) const {
+    DEBUG_ASSERT(level >= 0 && level < levelCount());
+    if (level == 0) {
+        return m_pData;
+    }
+    return m_pLevels + m_levelOffsets[level];
+}
+
+int WaveformPyramid::levelForFrames(double frames) const {
+    int level = 0;
+    while (level + 1 < levelCount() && (2 << level) <= frames) {
+        ++level;
+    }
+    return level;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "util/class.h"
+#include "waveform/waveform.h"
+
+// Precomputed levels of decreasing resolution of the data of a Waveform.
+//
+// Level 0 is the waveform data itself. Each following level holds the
+// maximum of each band of two adjacent visual frames of the previous
+// level, i.e. level k decimates the waveform by 2^k. Like the waveform
+// data all levels consist of interleaved left and right samples.
+//
+// Renderers can pick the level that matches their zoom and read about
+// one entry per pixel instead of scanning the whole visible range of
+// the waveform data.
+class WaveformPyramid {
+  public:
+    // Builds all levels from the data of a completely analyzed waveform
+    WaveformPyramid(const WaveformData* pData, int dataSize);
+    // Adopts levels 1..n that have been built before, e.g. by mapping a
+    // WaveformFile. The data must outlive the pyramid.
+    WaveformPyramid(const WaveformData* pData, int dataSize,
+            const WaveformData* pLevels);
+
+    // The number of entries of levels 1..n for a waveform of dataSize
+    static int storageSize(int dataSize);
+
+    int levelCount() const {
+        return static_cast<int>(m_levelOffsets.size());
+    }
+    const WaveformData* levelData(int level) const;
+    int levelSize(int level) const {
+        return m_levelSizes[level];
+    }
+
+    // Returns the coarsest level whose entries each cover no more than
+    // the given number of visual frames of level 0.
+    int levelForFrames(double frames) const;
+
+    // Returns the beginning of levels 1..n, see storageSize()
+    const WaveformData* levels() const {
+        return m_pLevels;
+    }
+
+  private:
+    void initLevels(int dataSize);
+
+    const WaveformData* const m_pData;
+    std::vector<WaveformData> m_ownedLevels;
+    const WaveformData* m_pLevels;
+    // Offsets of the levels into m_pLevels, unused for level 0
+    std::vector<int> m_levelOffsets;
+    std::vector<int> m_levelSizes;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformPyramid);
+};
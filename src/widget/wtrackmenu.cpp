@@ -576,15 +576,8 @@ void WTrackMenu::loadTracks(TrackIdList trackIdList) {
     // duplicate state with TrackIdList and QModelIndexList.
     DEBUG_ASSERT(!m_pTrackModel);
 
-    TrackPointerList trackPointers;
-    trackPointers.reserve(trackIdList.size());
-    for (const auto& trackId : trackIdList) {
-        TrackPointer pTrack = m_pTrackCollectionManager->internalCollection()->getTrackById(trackId);
-        if (pTrack) {
-            trackPointers.push_back(pTrack);
-        }
-    }
-    m_pTrackPointerList = trackPointers;
+    m_pTrackPointerList =
+            m_pTrackCollectionManager->internalCollection()->getTracksById(trackIdList);
 
     if (!m_pTrackPointerList.empty()) {
         updateMenus();
@@ -83,7 +83,7 @@ WTrackTableView::~WTrackTableView() {
 void WTrackTableView::enableCachedOnly() {
     if (!m_loadCachedOnly) {
         // don't try to load and search covers, drawing only
-        // covers which are already in the QPixmapCache.
+        // covers which are already in the CoverArtCache.
         emit onlyCachedCoverArt(true);
         m_loadCachedOnly = true;
     }